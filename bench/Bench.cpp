@@ -0,0 +1,79 @@
+//******************************************************************************************
+//  File: Bench.cpp
+//
+//  Summary:  Shared helpers for the host benchmark suites (see Bench.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+namespace bench
+{
+	unsigned long long nowNanos()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	void report(const char *suite, const char *scenario, double value, const char *unit)
+	{
+		printf("%-8s %-48s %14.1f %s\n", suite, scenario, value, unit);
+		fflush(stdout);
+	}
+
+	bool runIsolated(void (*fn)(void *), void *arg)
+	{
+		fflush(stdout);
+		pid_t pid = fork();
+		if (pid < 0)
+		{
+			return false;
+		}
+		if (pid == 0)
+		{
+			fn(arg);
+			fflush(stdout);
+			_exit(0);
+		}
+
+		int status = 0;
+		waitpid(pid, &status, 0);
+		return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	}
+
+	const __FlashStringHelper *deviceName(const char *prefix, unsigned int n)
+	{
+		//names must outlive the devices, which keep only the pointer (as with F() on a board)
+		static char names[256][24];
+		static unsigned int next = 0;
+		char *name = names[next++ % 256];
+		snprintf(name, sizeof(names[0]), "%s%u", prefix, n);
+		return reinterpret_cast<const __FlashStringHelper *>(name);
+	}
+
+	NullTransport::NullTransport(SmartThingsCallout_t *callout, int transmitInterval) :
+		SmartThings(callout, "Bench", false, transmitInterval),
+		sent(0),
+		bytes(0)
+	{
+
+	}
+
+	void NullTransport::send(String message)
+	{
+		sent++;
+		bytes += message.length();
+	}
+}
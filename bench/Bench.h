@@ -0,0 +1,99 @@
+//******************************************************************************************
+//  File: Bench.h
+//
+//  Summary:  Shared helpers for the host benchmark suites built by [env:native] in
+//            platformio.ini against lib/ArduinoNative.
+//
+//            Every suite is a plain function registered in main.cpp.  Because st::Everything
+//            keeps all of its state in static members, each scenario is run in a forked
+//            child process (bench::runIsolated) so it starts from a clean st::Everything.
+//
+//            Build and run:   pio run -e native && .pio/build/native/program [suite...]
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Added the batch suite
+//    2026-10-16  Per Ivar Nerseth  Added the sched suite
+//    2026-10-16  Per Ivar Nerseth  Added the dispatch suite
+//    2026-10-16  Per Ivar Nerseth  Added the edge suite
+//    2026-10-16  Per Ivar Nerseth  Added the report suite
+//    2026-10-16  Per Ivar Nerseth  Added the metrics suite
+//    2026-10-16  Per Ivar Nerseth  Added the http suite
+//    2026-10-16  Per Ivar Nerseth  Added the conn suite
+//    2026-10-16  Per Ivar Nerseth  Added the async suite
+//    2026-10-16  Per Ivar Nerseth  Added the mqtt suite
+//    2026-10-16  Per Ivar Nerseth  Added the udp suite
+//    2026-10-16  Per Ivar Nerseth  Added the outage suite
+//    2026-10-16  Per Ivar Nerseth  Added the link suite
+//    2026-10-16  Per Ivar Nerseth  Added the retry suite
+//    2026-10-17  Per Ivar Nerseth  Added the core suite
+//    2026-10-17  Per Ivar Nerseth  Added the rssi suite
+//    2026-10-17  Per Ivar Nerseth  Added the dht suite
+//    2026-10-17  Per Ivar Nerseth  Added the am2320 suite
+//    2026-10-17  Per Ivar Nerseth  Added the ds18b20 suite
+//    2026-10-17  Per Ivar Nerseth  Added the voltage suite
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_H
+#define ST_BENCH_H
+
+#include <Arduino.h>
+#include <SmartThings.h>
+
+namespace bench
+{
+	//monotonic host time in nanoseconds (not affected by the simulated delay() clock)
+	unsigned long long nowNanos();
+
+	//prints one result line: "<suite> <scenario> <value> <unit>"
+	void report(const char *suite, const char *scenario, double value, const char *unit);
+
+	//runs fn(arg) in a forked child process and waits for it - returns false if the child failed
+	bool runIsolated(void (*fn)(void *), void *arg);
+
+	//name for the n-th generated device, e.g. deviceName("contact", 3) == "contact3"
+	const __FlashStringHelper *deviceName(const char *prefix, unsigned int n);
+
+	//stand-in for the hub transport - counts messages instead of opening sockets
+	class NullTransport: public st::SmartThings
+	{
+		public:
+			NullTransport(SmartThingsCallout_t *callout, int transmitInterval = 100);
+
+			virtual void init(void) {}
+			virtual void run(void) {}
+			virtual void send(String message);
+
+			unsigned long sent;		//number of send() calls
+			unsigned long bytes;	//total message bytes passed to send()
+	};
+}
+
+//benchmark suites
+void benchLoop();
+void benchBatch();
+void benchSched();
+void benchDispatch();
+void benchEdge();
+void benchReport();
+void benchMetrics();
+void benchHttp();
+void benchConn();
+void benchAsync();
+void benchMqtt();
+void benchUdp();
+void benchOutage();
+void benchLink();
+void benchRetry();
+void benchCore();
+void benchRssi();
+void benchDht();
+void benchAm2320();
+void benchDs18b20();
+void benchVoltage();
+
+#endif
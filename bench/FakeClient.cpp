@@ -0,0 +1,124 @@
+//******************************************************************************************
+//  File: FakeClient.cpp
+//
+//  Summary:  In-memory stand-in for the hub behind an Arduino Client (see FakeClient.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "FakeClient.h"
+
+#include <stdlib.h>
+
+namespace bench
+{
+	FakeClient::FakeClient() :
+		m_bOpen(false),
+		m_nHighest(0),
+		downFrom(0),
+		downUntil(0),
+		failEvery(0),
+		failMillis(0),
+		connects(0),
+		failures(0),
+		events(0),
+		outOfOrder(0)
+	{
+	}
+
+	bool FakeClient::connectFails()
+	{
+		unsigned long now = millis();
+		if (now >= downFrom && now < downUntil)
+		{
+			return true;
+		}
+		return failEvery > 0 && connects % failEvery == 0;
+	}
+
+	int FakeClient::connect(IPAddress ip, uint16_t port)
+	{
+		stop();
+		connects++;
+		if (connectFails())
+		{
+			failures++;
+			native::advanceMillis(failMillis);
+			return 0;
+		}
+		m_bOpen = true;
+		return 1;
+	}
+
+	int FakeClient::connect(const char *host, uint16_t port)
+	{
+		return connect(IPAddress(), port);
+	}
+
+	size_t FakeClient::write(uint8_t c)
+	{
+		return write(&c, 1);
+	}
+
+	size_t FakeClient::write(const uint8_t *buf, size_t size)
+	{
+		if (!m_bOpen)
+		{
+			return 0;
+		}
+		m_Request.append(reinterpret_cast<const char *>(buf), size);
+		return size;
+	}
+
+	void FakeClient::stop()
+	{
+		if (m_bOpen && !m_Request.empty())
+		{
+			receive();
+		}
+		m_bOpen = false;
+		m_Request.clear();
+	}
+
+	void FakeClient::receive()
+	{
+		size_t body = m_Request.find("\r\n\r\n");
+		if (body == std::string::npos)
+		{
+			return;
+		}
+		size_t start = body + 4;
+		while (start < m_Request.size())
+		{
+			size_t end = m_Request.find('\n', start);
+			end = end == std::string::npos ? m_Request.size() : end;
+			std::string line = m_Request.substr(start, end - start);
+			start = end + 1;
+			if (!line.empty() && line[line.size() - 1] == '\r')
+			{
+				line.erase(line.size() - 1);
+			}
+			if (line.empty())
+			{
+				continue;
+			}
+
+			events++;
+			size_t space = line.rfind(' ');
+			unsigned long number = strtoul(line.c_str() + (space == std::string::npos ? 0 : space + 1), NULL, 10);
+			if (number <= m_nHighest)
+			{
+				outOfOrder++;
+			}
+			else
+			{
+				m_nHighest = number;
+			}
+		}
+	}
+}
@@ -0,0 +1,77 @@
+//******************************************************************************************
+//  File: FakeClient.h
+//
+//  Summary:  In-memory stand-in for the hub behind an Arduino Client, whose connects fail on
+//            a schedule, used by the retry benchmark suite.
+//
+//            bench::FakeClient implements the Client interface as EthernetClient and
+//            WiFiClient do, without sockets.  connect() fails while the simulated clock is
+//            inside the down window (a rebooting hub), and on every failEvery-th connect
+//            (a flaky link); a failed connect takes failMillis of the simulated clock, as a
+//            connect timeout does on the board.  What is written on a connection that
+//            succeeded is taken as one POST when it is stopped: the body lines are counted
+//            as events, and those whose trailing number is not above every one before are
+//            counted as out of order or twice.  The hub closes the connection after each
+//            request, so connected() is false once something has been written.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_FAKECLIENT_H
+#define ST_FAKECLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+#include <string>
+
+namespace bench
+{
+	class FakeClient: public Client
+	{
+		private:
+			bool m_bOpen;
+			std::string m_Request;			//written since the last connect
+			unsigned long m_nHighest;		//highest event number received
+
+			bool connectFails();
+			void receive();					//takes m_Request as one POST
+
+		public:
+			FakeClient();
+
+			//schedule - a failed connect takes failMillis
+			unsigned long downFrom;			//connects fail while downFrom <= millis() < downUntil
+			unsigned long downUntil;
+			unsigned long failEvery;		//every failEvery-th connect fails, 0 == never
+			unsigned long failMillis;
+
+			//counters
+			unsigned long connects;			//connect() calls
+			unsigned long failures;			//connects that failed
+			unsigned long events;			//body lines received
+			unsigned long outOfOrder;		//events not numbered above every one before
+
+			virtual int connect(IPAddress ip, uint16_t port);
+			virtual int connect(const char *host, uint16_t port);
+			virtual size_t write(uint8_t c);
+			virtual size_t write(const uint8_t *buf, size_t size);
+			virtual int available() { return 0; }
+			virtual int read() { return -1; }
+			virtual int read(uint8_t *buf, size_t size) { return -1; }
+			virtual int peek() { return -1; }
+			virtual void flush() {}
+			virtual void stop();
+			virtual uint8_t connected() { return m_bOpen && m_Request.empty(); }
+			virtual operator bool() { return m_bOpen; }
+
+			using Print::write;
+	};
+}
+
+#endif
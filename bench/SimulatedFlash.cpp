@@ -0,0 +1,74 @@
+//******************************************************************************************
+//  File: SimulatedFlash.cpp
+//
+//  Summary:  In-memory stand-in for the flash behind st::EventLog (see SimulatedFlash.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "SimulatedFlash.h"
+
+#include <string.h>
+
+namespace bench
+{
+	SimulatedFlash::SimulatedFlash() :
+		m_nBytesWritten(0),
+		m_bCutPower(false)
+	{
+		for (byte i = 0; i < EVENTLOG_SEGMENTS; i++)
+		{
+			m_nErases[i] = 0;
+		}
+	}
+
+	size_t SimulatedFlash::size(byte segment)
+	{
+		return m_Segments[segment].size();
+	}
+
+	size_t SimulatedFlash::read(byte segment, size_t offset, void *data, size_t length)
+	{
+		const std::vector<unsigned char> &bytes = m_Segments[segment];
+		if (offset >= bytes.size())
+		{
+			return 0;
+		}
+		length = length < bytes.size() - offset ? length : bytes.size() - offset;
+		memcpy(data, &bytes[offset], length);
+		return length;
+	}
+
+	bool SimulatedFlash::append(byte segment, const void *data, size_t length)
+	{
+		std::vector<unsigned char> &bytes = m_Segments[segment];
+		if (bytes.size() + length > EVENTLOG_SEGMENT_SIZE)
+		{
+			return false;
+		}
+
+		const unsigned char *from = static_cast<const unsigned char *>(data);
+		if (m_bCutPower)
+		{
+			//the board resets half way through the write
+			m_bCutPower = false;
+			bytes.insert(bytes.end(), from, from + length / 2);
+			m_nBytesWritten += length / 2;
+			return false;
+		}
+		bytes.insert(bytes.end(), from, from + length);
+		m_nBytesWritten += length;
+		return true;
+	}
+
+	void SimulatedFlash::erase(byte segment)
+	{
+		m_Segments[segment].clear();
+		m_nErases[segment]++;
+	}
+}
@@ -0,0 +1,54 @@
+//******************************************************************************************
+//  File: SimulatedFlash.h
+//
+//  Summary:  In-memory stand-in for the flash behind st::EventLog, used by the outage
+//            benchmark suite.
+//
+//            bench::SimulatedFlash keeps EVENTLOG_SEGMENTS segments of EVENTLOG_SEGMENT_SIZE
+//            bytes, as EventLogFS keeps them in files of LittleFS, and counts the bytes
+//            written and the erases of each segment.  cutPower() makes the next append write
+//            only part of its record and fail, as a reset in the middle of a flash write
+//            does; the contents survive, so a new st::EventLog on the same SimulatedFlash
+//            recovers what a rebooted board would.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_SIMULATEDFLASH_H
+#define ST_SIMULATEDFLASH_H
+
+#include <EventLog.h>
+
+#include <vector>
+
+namespace bench
+{
+	class SimulatedFlash: public st::EventLogStorage
+	{
+		private:
+			std::vector<unsigned char> m_Segments[EVENTLOG_SEGMENTS];
+			unsigned long m_nErases[EVENTLOG_SEGMENTS];
+			unsigned long m_nBytesWritten;
+			bool m_bCutPower;
+
+		public:
+			SimulatedFlash();
+
+			virtual size_t size(byte segment);
+			virtual size_t read(byte segment, size_t offset, void *data, size_t length);
+			virtual bool append(byte segment, const void *data, size_t length);
+			virtual void erase(byte segment);
+
+			void cutPower() { m_bCutPower = true; }		//the next append is torn
+
+			unsigned long bytesWritten() const { return m_nBytesWritten; }
+			unsigned long erases(byte segment) const { return m_nErases[segment]; }
+	};
+}
+
+#endif
@@ -0,0 +1,404 @@
+//******************************************************************************************
+//  File: StandInBroker.cpp
+//
+//  Summary:  Local stand-in for an MQTT broker and a POSIX socket Client (see StandInBroker.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "StandInBroker.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace bench
+{
+	namespace
+	{
+		enum
+		{
+			COUNT_CONNECTIONS,
+			COUNT_PUBLISHES,
+			COUNT_DISTINCT,
+			COUNT_DUPLICATES,
+			COUNT_SIZE
+		};
+
+		const size_t SHARED_SIZE = COUNT_SIZE * sizeof(unsigned long) + StandInBroker::MAX_EVENTS;
+
+		bool writeAll(int fd, const unsigned char *data, size_t len)
+		{
+			while (len > 0)
+			{
+				ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+				if (n < 0 && errno == EINTR) continue;
+				if (n <= 0) return false;
+				data += n;
+				len -= n;
+			}
+			return true;
+		}
+
+		bool readAll(int fd, unsigned char *data, size_t len)
+		{
+			while (len > 0)
+			{
+				ssize_t n = read(fd, data, len);
+				if (n < 0 && errno == EINTR) continue;
+				if (n <= 0) return false;
+				data += n;
+				len -= n;
+			}
+			return true;
+		}
+
+		//reads one packet - returns its fixed header byte, or -1 if the peer closed
+		int readPacket(int fd, unsigned char *body, size_t size, size_t &length)
+		{
+			unsigned char header;
+			if (!readAll(fd, &header, 1)) return -1;
+			length = 0;
+			for (int shift = 0; shift < 28; shift += 7)
+			{
+				unsigned char c;
+				if (!readAll(fd, &c, 1)) return -1;
+				length |= (size_t)(c & 0x7F) << shift;
+				if (!(c & 0x80)) break;
+			}
+			if (length > size || !readAll(fd, body, length)) return -1;
+			return header;
+		}
+	}
+
+	StandInBroker::StandInBroker() :
+		m_nListen(-1),
+		m_pCounts(0),
+		m_pSeen(0),
+		m_nPid(-1),
+		m_nPort(0),
+		m_nDropEvery(0)
+	{
+
+	}
+
+	StandInBroker::~StandInBroker()
+	{
+		stop();
+	}
+
+	bool StandInBroker::start(unsigned int dropEvery)
+	{
+		m_nDropEvery = dropEvery;
+		m_nListen = socket(AF_INET, SOCK_STREAM, 0);
+		if (m_nListen < 0) return false;
+
+		int on = 1;
+		setsockopt(m_nListen, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		socklen_t len = sizeof(addr);
+		if (bind(m_nListen, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+			listen(m_nListen, 16) < 0 ||
+			getsockname(m_nListen, (struct sockaddr *)&addr, &len) < 0)
+		{
+			stop();
+			return false;
+		}
+		m_nPort = ntohs(addr.sin_port);
+
+		void *shared = mmap(0, SHARED_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (shared == MAP_FAILED)
+		{
+			stop();
+			return false;
+		}
+		memset(shared, 0, SHARED_SIZE);
+		m_pCounts = static_cast<volatile unsigned long *>(shared);
+		m_pSeen = reinterpret_cast<volatile unsigned char *>(m_pCounts + COUNT_SIZE);
+
+		fflush(stdout);
+		m_nPid = fork();
+		if (m_nPid == 0)
+		{
+			serve();
+		}
+		close(m_nListen);
+		m_nListen = -1;
+		return m_nPid > 0;
+	}
+
+	void StandInBroker::stop()
+	{
+		if (m_nPid > 0)
+		{
+			kill(m_nPid, SIGTERM);
+			waitpid(m_nPid, 0, 0);
+			m_nPid = -1;
+		}
+		if (m_nListen >= 0) close(m_nListen);
+		m_nListen = -1;
+		if (m_pCounts)
+		{
+			munmap((void *)m_pCounts, SHARED_SIZE);
+			m_pCounts = 0;
+			m_pSeen = 0;
+		}
+	}
+
+	void StandInBroker::serve()
+	{
+		for (;;)
+		{
+			int fd = accept(m_nListen, 0, 0);
+			if (fd < 0)
+			{
+				if (errno == EINTR) continue;
+				_exit(1);
+			}
+			__sync_fetch_and_add(&m_pCounts[COUNT_CONNECTIONS], 1UL);
+			serveConnection(fd);
+			close(fd);
+		}
+	}
+
+	void StandInBroker::serveConnection(int fd)
+	{
+		unsigned char body[4096];
+		unsigned char reply[64];
+		size_t length;
+		unsigned int publishes = 0;
+		int header;
+		while ((header = readPacket(fd, body, sizeof(body), length)) >= 0)
+		{
+			switch (header & 0xF0)
+			{
+			case 0x10:		//CONNECT
+			{
+				const unsigned char connack[] = { 0x20, 0x02, 0x00, 0x00 };
+				writeAll(fd, connack, sizeof(connack));
+				break;
+			}
+
+			case 0x80:		//SUBSCRIBE - acknowledged, then one command on the topic
+			{
+				if (length < 5) return;
+				size_t topicLength = (body[2] << 8) | body[3];
+				const unsigned char suback[] = { 0x90, 0x03, body[0], body[1], body[4 + topicLength] };
+				writeAll(fd, suback, sizeof(suback));
+
+				static const char command[] = "switch1 on";
+				size_t n = 0;
+				reply[n++] = 0x30;
+				reply[n++] = 2 + topicLength + sizeof(command) - 1;
+				memcpy(reply + n, body + 2, 2 + topicLength);
+				n += 2 + topicLength;
+				memcpy(reply + n, command, sizeof(command) - 1);
+				n += sizeof(command) - 1;
+				writeAll(fd, reply, n);
+				break;
+			}
+
+			case 0x30:		//PUBLISH
+			{
+				if (length < 2) return;
+				size_t topicLength = (body[0] << 8) | body[1];
+				int qos = (header >> 1) & 0x03;
+				size_t payload = 2 + topicLength + (qos ? 2 : 0);
+				if (payload > length) return;
+
+				const char *status = "/status";
+				bool isStatus = topicLength >= 7 && memcmp(body + 2 + topicLength - 7, status, 7) == 0;
+				if (!isStatus)
+				{
+					if (m_nDropEvery && ++publishes % m_nDropEvery == 0)
+					{
+						return;		//gone before storing or acknowledging it
+					}
+
+					__sync_fetch_and_add(&m_pCounts[COUNT_PUBLISHES], 1UL);
+					char number[16];
+					size_t numberLength = length - payload < sizeof(number) - 1 ? length - payload : sizeof(number) - 1;
+					memcpy(number, body + payload, numberLength);
+					number[numberLength] = 0;
+					unsigned long event = strtoul(number, 0, 10) % MAX_EVENTS;
+					if (m_pSeen[event])
+					{
+						__sync_fetch_and_add(&m_pCounts[COUNT_DUPLICATES], 1UL);
+					}
+					else
+					{
+						m_pSeen[event] = 1;
+						__sync_fetch_and_add(&m_pCounts[COUNT_DISTINCT], 1UL);
+					}
+				}
+				if (qos == 1)
+				{
+					const unsigned char puback[] = { 0x40, 0x02, body[payload - 2], body[payload - 1] };
+					writeAll(fd, puback, sizeof(puback));
+				}
+				break;
+			}
+
+			case 0xC0:		//PINGREQ
+			{
+				const unsigned char pingresp[] = { 0xD0, 0x00 };
+				writeAll(fd, pingresp, sizeof(pingresp));
+				break;
+			}
+
+			case 0xE0:		//DISCONNECT
+				return;
+			}
+		}
+	}
+
+	unsigned long StandInBroker::connections() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_CONNECTIONS], 0UL) : 0;
+	}
+
+	unsigned long StandInBroker::publishes() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_PUBLISHES], 0UL) : 0;
+	}
+
+	unsigned long StandInBroker::distinct() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_DISTINCT], 0UL) : 0;
+	}
+
+	unsigned long StandInBroker::duplicates() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_DUPLICATES], 0UL) : 0;
+	}
+
+	SocketClient::SocketClient() :
+		m_nSocket(-1),
+		connects(0)
+	{
+
+	}
+
+	SocketClient::~SocketClient()
+	{
+		stop();
+	}
+
+	int SocketClient::connect(IPAddress ip, uint16_t port)
+	{
+		stop();
+		m_nSocket = socket(AF_INET, SOCK_STREAM, 0);
+		if (m_nSocket < 0)
+		{
+			return 0;
+		}
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = (uint32_t)ip;
+		addr.sin_port = htons(port);
+		if (::connect(m_nSocket, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		{
+			stop();
+			return 0;
+		}
+		connects++;
+		return 1;
+	}
+
+	int SocketClient::connect(const char *host, uint16_t port)
+	{
+		return connect(IPAddress(127, 0, 0, 1), port);
+	}
+
+	size_t SocketClient::write(uint8_t c)
+	{
+		return write(&c, 1);
+	}
+
+	size_t SocketClient::write(const uint8_t *buf, size_t size)
+	{
+		if (m_nSocket < 0 || !writeAll(m_nSocket, buf, size))
+		{
+			return 0;
+		}
+		return size;
+	}
+
+	int SocketClient::available()
+	{
+		int count = 0;
+		if (m_nSocket < 0 || ioctl(m_nSocket, FIONREAD, &count) < 0)
+		{
+			return 0;
+		}
+		return count;
+	}
+
+	int SocketClient::read()
+	{
+		uint8_t c;
+		return read(&c, 1) == 1 ? c : -1;
+	}
+
+	int SocketClient::read(uint8_t *buf, size_t size)
+	{
+		if (m_nSocket < 0)
+		{
+			return -1;
+		}
+		ssize_t n = recv(m_nSocket, buf, size, MSG_DONTWAIT);
+		return n > 0 ? (int)n : -1;
+	}
+
+	int SocketClient::peek()
+	{
+		uint8_t c;
+		if (m_nSocket < 0 || recv(m_nSocket, &c, 1, MSG_DONTWAIT | MSG_PEEK) != 1)
+		{
+			return -1;
+		}
+		return c;
+	}
+
+	void SocketClient::stop()
+	{
+		if (m_nSocket >= 0)
+		{
+			close(m_nSocket);
+			m_nSocket = -1;
+		}
+	}
+
+	uint8_t SocketClient::connected()
+	{
+		if (m_nSocket < 0)
+		{
+			return 0;
+		}
+		//open while there is data to read, or a read would wait - 0 from recv is the peer's FIN
+		uint8_t c;
+		ssize_t n = recv(m_nSocket, &c, 1, MSG_DONTWAIT | MSG_PEEK);
+		return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? 1 : 0;
+	}
+}
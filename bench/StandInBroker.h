@@ -0,0 +1,93 @@
+//******************************************************************************************
+//  File: StandInBroker.h
+//
+//  Summary:  Local stand-in for an MQTT broker and a POSIX socket Client, used by the mqtt
+//            benchmark suite to run SmartThingsMQTT on the host.
+//
+//            bench::StandInBroker listens on a loopback port in a forked process and speaks
+//            just enough MQTT 3.1.1 for one client at a time: CONNACK, SUBACK (followed by one
+//            "switch1 on" on the subscribed command topic), PUBACK for QoS 1 and PINGRESP.  It
+//            counts connections and event publishes in memory shared with the benchmark
+//            process; an event's payload is its number, so distinct events can be told from
+//            repeats.  It can drop the connection right after reading every n-th publish,
+//            before storing or acknowledging it, like a broker restart.
+//
+//            bench::SocketClient implements the Arduino Client interface on a TCP socket, as
+//            WiFiClient does on the board: available() and read() never wait.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_STANDINBROKER_H
+#define ST_STANDINBROKER_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+#include <sys/types.h>
+
+namespace bench
+{
+	class StandInBroker
+	{
+		private:
+			int m_nListen;				//listening socket
+			volatile unsigned long *m_pCounts;	//shared with the broker process, see the COUNT_ indices
+			volatile unsigned char *m_pSeen;	//shared: one flag per event number
+			pid_t m_nPid;				//broker process
+			uint16_t m_nPort;
+			unsigned int m_nDropEvery;	//publishes after which the connection is dropped (0 = never)
+
+			void serve();				//broker process main loop - never returns
+			void serveConnection(int fd);
+
+		public:
+			static const unsigned long MAX_EVENTS = 1UL << 16;
+
+			StandInBroker();
+			~StandInBroker();
+
+			bool start(unsigned int dropEvery = 0);	//listens on 127.0.0.1 (any free port) and forks the broker process
+			void stop();
+
+			uint16_t port() const { return m_nPort; }
+			unsigned long connections() const;
+			unsigned long publishes() const;	//event publishes read, including repeats
+			unsigned long distinct() const;		//different event numbers received
+			unsigned long duplicates() const;	//event publishes whose number had been received before
+	};
+
+	class SocketClient: public Client
+	{
+		private:
+			int m_nSocket;
+
+		public:
+			SocketClient();
+			~SocketClient();
+
+			virtual int connect(IPAddress ip, uint16_t port);
+			virtual int connect(const char *host, uint16_t port);	//host is ignored - always 127.0.0.1
+			virtual size_t write(uint8_t c);
+			virtual size_t write(const uint8_t *buf, size_t size);
+			virtual int available();
+			virtual int read();
+			virtual int read(uint8_t *buf, size_t size);
+			virtual int peek();
+			virtual void flush() {}
+			virtual void stop();
+			virtual uint8_t connected();
+			virtual operator bool() { return m_nSocket >= 0; }
+
+			using Print::write;
+
+			unsigned long connects;		//connections opened
+	};
+}
+
+#endif
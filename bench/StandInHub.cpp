@@ -0,0 +1,534 @@
+//******************************************************************************************
+//  File: StandInHub.cpp
+//
+//  Summary:  Local stand-in for the SmartThings hub (see StandInHub.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Keep-alive connections
+//    2026-10-16  Per Ivar Nerseth  Hub outages, event order and the event log
+//
+//******************************************************************************************
+
+#include "StandInHub.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace bench
+{
+	namespace
+	{
+		enum
+		{
+			COUNT_REQUESTS,
+			COUNT_EVENTS,
+			COUNT_OUT_OF_ORDER,
+			COUNT_REPLAYS,
+			COUNT_DOWN,			//set by setDown()
+			COUNT_LISTENING,	//set by the hub process
+			COUNT_SIZE
+		};
+
+		const size_t SHARED_SIZE = COUNT_SIZE * sizeof(unsigned long);
+
+		//trailing number of each body line, e.g. 17 of "contact1 17" - checked against the highest before it
+		struct EventOrder
+		{
+			unsigned long highest;
+			unsigned long value;
+			bool digits;
+			unsigned long outOfOrder;
+
+			EventOrder() : highest(0), value(0), digits(false), outOfOrder(0) {}
+
+			void add(char c)
+			{
+				if (c >= '0' && c <= '9')
+				{
+					value = (digits ? value * 10 : 0) + (c - '0');
+					digits = true;
+				}
+				else if (c == '\n')
+				{
+					endLine();
+				}
+				else if (c != '\r')
+				{
+					digits = false;
+				}
+			}
+
+			void endLine()
+			{
+				if (digits)
+				{
+					if (value <= highest)
+					{
+						outOfOrder++;
+					}
+					else
+					{
+						highest = value;
+					}
+				}
+				digits = false;
+			}
+		};
+
+		bool writeAll(int fd, const char *data, size_t len)
+		{
+			while (len > 0)
+			{
+				ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);	//a closed peer is an error, not SIGPIPE
+				if (n < 0 && errno == EINTR) continue;
+				if (n <= 0) return false;
+				data += n;
+				len -= n;
+			}
+			return true;
+		}
+
+		//reads one request from fd - returns the number of body lines, or -1 if the peer closed first
+		long readRequest(int fd, bool &keepAlive, bool &replay, EventOrder &order)
+		{
+			keepAlive = false;
+			replay = false;
+			char buf[4096];
+			size_t used = 0;
+			char *body = 0;
+			while (!body)
+			{
+				if (used == sizeof(buf) - 1) return -1;
+				ssize_t n = read(fd, buf + used, sizeof(buf) - 1 - used);
+				if (n <= 0) return -1;
+				used += n;
+				buf[used] = 0;
+				body = strstr(buf, "\r\n\r\n");
+			}
+			*body = 0;
+			body += 4;
+
+			size_t length = 0;
+			for (char *line = buf; line; )
+			{
+				if (strncasecmp(line, "CONTENT-LENGTH:", 15) == 0)
+				{
+					length = strtoul(line + 15, 0, 10);
+				}
+				else if (strncasecmp(line, "CONNECTION:", 11) == 0)
+				{
+					keepAlive = strcasestr(line + 11, "keep-alive") != 0;
+				}
+				else if (strncasecmp(line, "EVENT-AGE:", 10) == 0)
+				{
+					replay = true;
+				}
+				char *next = strstr(line, "\r\n");
+				line = next ? next + 2 : 0;
+			}
+
+			//the body may arrive in pieces, and may be larger than buf - only its line breaks are counted
+			size_t have = used - (body - buf);
+			long lines = length ? 1 : 0;
+			for (size_t i = 0; i < have && i < length; i++)
+			{
+				if (body[i] == '\n') lines++;
+				order.add(body[i]);
+			}
+			while (have < length)
+			{
+				ssize_t n = read(fd, buf, sizeof(buf) < length - have ? sizeof(buf) : length - have);
+				if (n <= 0) return -1;
+				for (ssize_t i = 0; i < n; i++)
+				{
+					if (buf[i] == '\n') lines++;
+					order.add(buf[i]);
+				}
+				have += n;
+			}
+			order.endLine();
+			return lines;
+		}
+
+		//listens on 127.0.0.1:port (0 == any free port) - returns the socket, -1 on failure
+		int listenOn(uint16_t &port)
+		{
+			int fd = socket(AF_INET, SOCK_STREAM, 0);
+			if (fd < 0) return -1;
+
+			int on = 1;
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+			struct sockaddr_in addr;
+			memset(&addr, 0, sizeof(addr));
+			addr.sin_family = AF_INET;
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			addr.sin_port = htons(port);
+			socklen_t len = sizeof(addr);
+			if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+				listen(fd, 16) < 0 ||
+				getsockname(fd, (struct sockaddr *)&addr, &len) < 0)
+			{
+				close(fd);
+				return -1;
+			}
+			port = ntohs(addr.sin_port);
+			return fd;
+		}
+	}
+
+	StandInHub::StandInHub() :
+		m_nListen(-1),
+		m_pCounts(0),
+		m_nPid(-1),
+		m_nPort(0),
+		m_nMaxRequests(0)
+	{
+
+	}
+
+	StandInHub::~StandInHub()
+	{
+		stop();
+	}
+
+	bool StandInHub::start(unsigned int maxRequestsPerConnection)
+	{
+		m_nMaxRequests = maxRequestsPerConnection;
+		m_nPort = 0;
+		m_nListen = listenOn(m_nPort);
+		if (m_nListen < 0) return false;
+
+		void *counts = mmap(0, SHARED_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (counts == MAP_FAILED)
+		{
+			stop();
+			return false;
+		}
+		m_pCounts = static_cast<volatile unsigned long *>(counts);
+		memset(counts, 0, SHARED_SIZE);
+		m_pCounts[COUNT_LISTENING] = 1;
+
+		fflush(stdout);
+		m_nPid = fork();
+		if (m_nPid == 0)
+		{
+			serve();
+		}
+		close(m_nListen);
+		m_nListen = -1;
+		return m_nPid > 0;
+	}
+
+	void StandInHub::stop()
+	{
+		if (m_nPid > 0)
+		{
+			kill(m_nPid, SIGTERM);
+			waitpid(m_nPid, 0, 0);
+			m_nPid = -1;
+		}
+		if (m_nListen >= 0) close(m_nListen);
+		m_nListen = -1;
+		if (m_pCounts)
+		{
+			munmap((void *)m_pCounts, SHARED_SIZE);
+			m_pCounts = 0;
+		}
+	}
+
+	void StandInHub::serve()
+	{
+		static const char replyClose[] = "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+		static const char replyKeep[] = "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
+
+		EventOrder order;
+		for (;;)
+		{
+			//an outage: nothing listens on the port, so connections are refused
+			bool down = m_pCounts[COUNT_DOWN] != 0;
+			if (down && m_nListen >= 0)
+			{
+				close(m_nListen);
+				m_nListen = -1;
+				m_pCounts[COUNT_LISTENING] = 0;
+			}
+			else if (!down && m_nListen < 0)
+			{
+				m_nListen = listenOn(m_nPort);
+				m_pCounts[COUNT_LISTENING] = m_nListen >= 0 ? 1 : 0;
+			}
+			if (m_nListen < 0)
+			{
+				usleep(1000);
+				continue;
+			}
+
+			struct pollfd pfd = { m_nListen, POLLIN, 0 };
+			if (poll(&pfd, 1, 10) <= 0)
+			{
+				continue;
+			}
+			int fd = accept(m_nListen, 0, 0);
+			if (fd < 0)
+			{
+				if (errno == EINTR) continue;
+				_exit(1);
+			}
+
+			//serve requests on this connection until the client or a "close" request ends it - or, like a hub
+			//dropping idle connections, until m_nMaxRequests have been served, without announcing it
+			bool keepAlive = true;
+			for (unsigned int served = 0; keepAlive && (m_nMaxRequests == 0 || served < m_nMaxRequests); served++)
+			{
+				bool replay;
+				unsigned long outOfOrder = order.outOfOrder;
+				long lines = readRequest(fd, keepAlive, replay, order);
+				if (lines < 0) break;
+
+				__sync_fetch_and_add(&m_pCounts[COUNT_REQUESTS], 1UL);
+				__sync_fetch_and_add(&m_pCounts[COUNT_EVENTS], (unsigned long)lines);
+				__sync_fetch_and_add(&m_pCounts[COUNT_OUT_OF_ORDER], order.outOfOrder - outOfOrder);
+				if (replay)
+				{
+					__sync_fetch_and_add(&m_pCounts[COUNT_REPLAYS], 1UL);
+				}
+				if (keepAlive)
+				{
+					writeAll(fd, replyKeep, sizeof(replyKeep) - 1);
+				}
+				else
+				{
+					writeAll(fd, replyClose, sizeof(replyClose) - 1);
+				}
+			}
+			close(fd);
+		}
+	}
+
+	void StandInHub::setDown(bool down)
+	{
+		if (!m_pCounts) return;
+		__sync_lock_test_and_set(&m_pCounts[COUNT_DOWN], down ? 1UL : 0UL);
+		while (__sync_fetch_and_add(&m_pCounts[COUNT_LISTENING], 0UL) != (down ? 0UL : 1UL))
+		{
+			usleep(500);
+		}
+	}
+
+	unsigned long StandInHub::events() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_EVENTS], 0UL) : 0;
+	}
+
+	unsigned long StandInHub::requests() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_REQUESTS], 0UL) : 0;
+	}
+
+	unsigned long StandInHub::outOfOrder() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_OUT_OF_ORDER], 0UL) : 0;
+	}
+
+	unsigned long StandInHub::replays() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_REPLAYS], 0UL) : 0;
+	}
+
+	HttpTransport::HttpTransport(uint16_t hubPort, SmartThingsCallout_t *callout, int transmitInterval) :
+		SmartThings(callout, "BenchHttp", false, transmitInterval),
+		m_nHubPort(hubPort),
+		m_nSocket(-1),
+		m_bKeepAlive(false),
+		connections(0),
+		failures(0),
+		reconnects(0)
+	{
+		m_Request.reserve(256);
+	}
+
+	HttpTransport::~HttpTransport()
+	{
+		setKeepAlive(false);
+	}
+
+	bool HttpTransport::setKeepAlive(bool enable)
+	{
+		if (!enable && m_nSocket >= 0)
+		{
+			close(m_nSocket);
+			m_nSocket = -1;
+		}
+		m_bKeepAlive = enable;
+		return true;
+	}
+
+	int HttpTransport::connectHub()
+	{
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			return -1;
+		}
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(m_nHubPort);
+		if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		{
+			close(fd);
+			return -1;
+		}
+		connections++;
+		return fd;
+	}
+
+	bool HttpTransport::writeRequest(int fd, const String &message, long ageMillis)
+	{
+		//same request as SmartThingsESP8266WiFi::writeRequest()
+		m_Request = F("POST / HTTP/1.1\r\nHOST: 127.0.0.1:");
+		m_Request += m_nHubPort;
+		m_Request += F("\r\nCONTENT-TYPE: text\r\nCONTENT-LENGTH: ");
+		m_Request += message.length();
+		if (ageMillis >= 0)
+		{
+			m_Request += F("\r\nEVENT-AGE: ");
+			m_Request += ageMillis;
+		}
+		if (m_bKeepAlive)
+		{
+			m_Request += F("\r\nCONNECTION: keep-alive\r\n\r\n");
+			m_Request += message;
+		}
+		else
+		{
+			m_Request += F("\r\n\r\n");
+			m_Request += message;
+			m_Request += F("\r\n");
+		}
+		return writeAll(fd, m_Request.c_str(), m_Request.length());
+	}
+
+	int HttpTransport::readResponse(int fd)
+	{
+		char buf[512];
+		size_t used = 0;
+		char *body = 0;
+		while (!body)
+		{
+			if (used == sizeof(buf) - 1) return -1;
+			ssize_t n = read(fd, buf + used, sizeof(buf) - 1 - used);
+			if (n <= 0) return -1;
+			used += n;
+			buf[used] = 0;
+			body = strstr(buf, "\r\n\r\n");
+		}
+		*body = 0;
+
+		size_t length = 0;
+		bool keepAlive = true;
+		for (char *line = buf; line; )
+		{
+			if (strncasecmp(line, "Content-Length:", 15) == 0)
+			{
+				length = strtoul(line + 15, 0, 10);
+			}
+			else if (strncasecmp(line, "Connection:", 11) == 0)
+			{
+				keepAlive = strcasestr(line + 11, "close") == 0;
+			}
+			char *next = strstr(line, "\r\n");
+			line = next ? next + 2 : 0;
+		}
+
+		//discard the body
+		size_t have = used - (body + 4 - buf);
+		while (have < length)
+		{
+			ssize_t n = read(fd, buf, sizeof(buf) < length - have ? sizeof(buf) : length - have);
+			if (n <= 0) return 0;
+			have += n;
+		}
+		return keepAlive ? 1 : 0;
+	}
+
+	void HttpTransport::send(String message)
+	{
+		//as SmartThingsESP8266WiFi::send() - kept in the event log, or held for a retry
+		deliverOrKeep(message);
+	}
+
+	bool HttpTransport::deliver(const String &message, long ageMillis)
+	{
+		if (m_bKeepAlive)
+		{
+			//reuse the open connection - if the hub has dropped it, reconnect and send once more
+			for (int attempt = 0; attempt < 2; attempt++)
+			{
+				bool reused = m_nSocket >= 0;
+				if (!reused)
+				{
+					m_nSocket = connectHub();
+					if (m_nSocket < 0)
+					{
+						failures++;
+						continue;
+					}
+				}
+
+				int response = writeRequest(m_nSocket, message, ageMillis) ? readResponse(m_nSocket) : -1;
+				if (response == 1)
+				{
+					return true;
+				}
+				close(m_nSocket);
+				m_nSocket = -1;
+				if (response == 0 || !reused)
+				{
+					if (response < 0) failures++;
+					return true;
+				}
+				reconnects++;
+			}
+			return false;
+		}
+
+		int fd = connectHub();
+		if (fd < 0)
+		{
+			failures++;
+			return false;
+		}
+		bool written = writeRequest(fd, message, ageMillis);
+		if (!written)
+		{
+			failures++;
+		}
+
+		//drain the reply until the hub closes the connection
+		char buf[256];
+		while (read(fd, buf, sizeof(buf)) > 0)
+		{
+		}
+		close(fd);
+		return written;
+	}
+}
@@ -0,0 +1,101 @@
+//******************************************************************************************
+//  File: StandInHub.h
+//
+//  Summary:  Local stand-in for the SmartThings hub and an HTTP transport that talks to it,
+//            used by the host benchmark suites.
+//
+//            bench::StandInHub listens on a loopback port in a forked process and answers
+//            every POST the way the hub does.  It counts the requests and events (body lines)
+//            it receives in memory shared with the benchmark process.  setDown() takes it off
+//            the network (connections are refused) until it is brought up again on the same
+//            port, and it counts the body lines whose trailing number is not above every one
+//            before it (events numbered in order that arrive out of order or twice).
+//
+//            bench::HttpTransport sends to it over real POSIX sockets, following
+//            SmartThingsESP8266WiFi::send(): by default one connection per send() (connect,
+//            POST, read the reply until the hub closes, stop), or in keep-alive mode one
+//            persistent connection whose replies are read by their Content-Length.  What it
+//            cannot deliver is held in the retry queue, or with an st::EventLog set stored and
+//            replayed, as SmartThingsESP8266WiFi does.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Keep-alive mode, as in SmartThingsESP8266WiFi
+//    2026-10-16  Per Ivar Nerseth  Hub outages, event order and the event log
+//    2026-10-16  Per Ivar Nerseth  Undelivered messages are held in the retry queue
+//
+//******************************************************************************************
+
+#ifndef ST_STANDINHUB_H
+#define ST_STANDINHUB_H
+
+#include <Arduino.h>
+#include <SmartThings.h>
+
+#include <sys/types.h>
+
+namespace bench
+{
+	class StandInHub
+	{
+		private:
+			int m_nListen;				//listening socket
+			volatile unsigned long *m_pCounts;	//shared with the hub process, see the COUNT_ indices
+			pid_t m_nPid;				//hub process
+			uint16_t m_nPort;
+			unsigned int m_nMaxRequests;	//keep-alive connections are dropped after this many requests (0 = never)
+
+			void serve();				//hub process main loop - never returns
+
+		public:
+			StandInHub();
+			~StandInHub();
+
+			bool start(unsigned int maxRequestsPerConnection = 0);	//listens on 127.0.0.1 (any free port) and forks the hub process
+			void stop();
+
+			uint16_t port() const { return m_nPort; }
+			void setDown(bool down);		//returns once the hub has stopped or started listening
+
+			unsigned long events() const;	//events received (a POST is counted before the hub replies to it)
+			unsigned long requests() const;
+			unsigned long outOfOrder() const;	//events whose number is not above every earlier event's
+			unsigned long replays() const;		//requests with an EVENT-AGE header
+	};
+
+	class HttpTransport: public st::SmartThings
+	{
+		private:
+			uint16_t m_nHubPort;
+			String m_Request;			//reusable request buffer
+			int m_nSocket;				//open connection in keep-alive mode, -1 if none
+			bool m_bKeepAlive;
+
+			int connectHub();			//new connection to the hub, -1 on failure
+			bool writeRequest(int fd, const String &message, long ageMillis);
+			int readResponse(int fd);	//-1 no reply, 0 reply and the hub closes, 1 reply and the connection stays open
+
+		protected:
+			virtual bool deliver(const String &message, long ageMillis);
+
+		public:
+			HttpTransport(uint16_t hubPort, SmartThingsCallout_t *callout, int transmitInterval = 100);
+			~HttpTransport();
+
+			virtual void init(void) {}
+			virtual void run(void) { retryKept(); }
+			virtual void send(String message);
+			virtual bool setBatchMode(bool enable) { m_bBatchMode = enable; return true; }
+			virtual bool setKeepAlive(bool enable);
+			virtual bool setEventLog(st::EventLog *log) { m_pEventLog = log; return true; }
+
+			unsigned long connections;	//TCP connections opened
+			unsigned long failures;		//connections refused or broken
+			unsigned long reconnects;	//keep-alive connections found closed and replaced
+	};
+}
+
+#endif
@@ -0,0 +1,391 @@
+//******************************************************************************************
+//  File: StandInReceiver.cpp
+//
+//  Summary:  Local stand-in for the receiver of SmartThingsUDP and a POSIX socket UDP
+//            (see StandInReceiver.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Commands in two sessions, "C <session> <id>"
+//    2026-10-17  Per Ivar Nerseth  Receiver outages
+//
+//******************************************************************************************
+
+#include "StandInReceiver.h"
+#include "Bench.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace bench
+{
+	namespace
+	{
+		enum
+		{
+			COUNT_DISTINCT,
+			COUNT_REPEATS,
+			COUNT_COMMANDS_ACKED,
+			COUNT_DOWN,				//1 while the receiver is off the air
+			COUNT_SIZE
+		};
+
+		const size_t SHARED_SIZE = COUNT_SIZE * sizeof(unsigned long) + StandInReceiver::MAX_EVENTS * sizeof(unsigned long long);
+		const int COMMAND_REPEAT_MS = 20;
+
+		struct sockaddr_in loopback(uint16_t port)
+		{
+			struct sockaddr_in addr;
+			memset(&addr, 0, sizeof(addr));
+			addr.sin_family = AF_INET;
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			addr.sin_port = htons(port);
+			return addr;
+		}
+	}
+
+	StandInReceiver::StandInReceiver() :
+		m_nSocket(-1),
+		m_pCounts(0),
+		m_pArrival(0),
+		m_nPid(-1),
+		m_nPort(0),
+		m_nLossPercent(0)
+	{
+
+	}
+
+	StandInReceiver::~StandInReceiver()
+	{
+		stop();
+	}
+
+	bool StandInReceiver::start(unsigned int lossPercent)
+	{
+		m_nLossPercent = lossPercent;
+		m_nSocket = socket(AF_INET, SOCK_DGRAM, 0);
+		if (m_nSocket < 0) return false;
+
+		struct sockaddr_in addr = loopback(0);
+		socklen_t len = sizeof(addr);
+		if (bind(m_nSocket, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+			getsockname(m_nSocket, (struct sockaddr *)&addr, &len) < 0)
+		{
+			stop();
+			return false;
+		}
+		m_nPort = ntohs(addr.sin_port);
+
+		void *shared = mmap(0, SHARED_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (shared == MAP_FAILED)
+		{
+			stop();
+			return false;
+		}
+		memset(shared, 0, SHARED_SIZE);
+		m_pCounts = static_cast<volatile unsigned long *>(shared);
+		m_pArrival = reinterpret_cast<volatile unsigned long long *>(m_pCounts + COUNT_SIZE);
+
+		fflush(stdout);
+		m_nPid = fork();
+		if (m_nPid == 0)
+		{
+			serve();
+		}
+		close(m_nSocket);
+		m_nSocket = -1;
+		return m_nPid > 0;
+	}
+
+	void StandInReceiver::stop()
+	{
+		if (m_nPid > 0)
+		{
+			kill(m_nPid, SIGTERM);
+			waitpid(m_nPid, 0, 0);
+			m_nPid = -1;
+		}
+		if (m_nSocket >= 0) close(m_nSocket);
+		m_nSocket = -1;
+		if (m_pCounts)
+		{
+			munmap((void *)m_pCounts, SHARED_SIZE);
+			m_pCounts = 0;
+			m_pArrival = 0;
+		}
+	}
+
+	void StandInReceiver::serve()
+	{
+		static bool seen[MAX_EVENTS + 1];		//by <seq> - one session per run
+		unsigned long all = 0;					//every <seq> up to here has arrived
+		unsigned long random = 12345;
+		struct sockaddr_in device;
+		bool deviceKnown = false;
+		unsigned long commandSession = 1;		//then 2: a restarted receiver, whose ids start over at 1
+		bool commandAcked = false;
+		unsigned long long commandDue = 0;
+
+		for (;;)
+		{
+			struct pollfd pfd = { m_nSocket, POLLIN, 0 };
+			poll(&pfd, 1, deviceKnown && !commandAcked ? 1 : 100);
+
+			char buf[2048];
+			struct sockaddr_in from;
+			socklen_t fromLen = sizeof(from);
+			ssize_t n;
+			while ((n = recvfrom(m_nSocket, buf, sizeof(buf) - 1, MSG_DONTWAIT, (struct sockaddr *)&from, &fromLen)) > 0)
+			{
+				buf[n] = 0;
+				if (m_pCounts[COUNT_DOWN])
+				{
+					continue;		//not listening
+				}
+				random = random * 1103515245UL + 12345UL;
+				if ((random >> 16) % 100 < m_nLossPercent)
+				{
+					continue;		//lost on the way in
+				}
+
+				if (buf[0] == 'K')
+				{
+					if (strtoul(buf + 2, 0, 10) == commandSession)
+					{
+						__sync_fetch_and_add(&m_pCounts[COUNT_COMMANDS_ACKED], 1UL);
+						commandAcked = commandSession == 2;
+						commandSession = 2;
+					}
+					continue;
+				}
+				if (buf[0] != 'E')
+				{
+					continue;
+				}
+				device = from;
+				deviceKnown = true;
+
+				char *end;
+				unsigned long session = strtoul(buf + 2, &end, 10);
+				unsigned long seq = strtoul(end, &end, 10);
+				bool repeat = seq > MAX_EVENTS || seen[seq];
+				if (!repeat)
+				{
+					seen[seq] = true;
+					while (all < MAX_EVENTS && seen[all + 1])
+					{
+						all++;
+					}
+				}
+
+				random = random * 1103515245UL + 12345UL;
+				if ((random >> 16) % 100 >= m_nLossPercent)
+				{
+					char ack[64];
+					int len = snprintf(ack, sizeof(ack), "A %lu %lu %lu", session, seq, all);
+					sendto(m_nSocket, ack, len, 0, (struct sockaddr *)&from, fromLen);
+				}
+
+				if (repeat)
+				{
+					__sync_fetch_and_add(&m_pCounts[COUNT_REPEATS], 1UL);
+					continue;
+				}
+				unsigned long long now = nowNanos();
+				for (char *line = strchr(end, '\n'); line; line = strchr(line, '\n'))
+				{
+					line++;
+					char *space = strchr(line, ' ');
+					if (space == NULL)
+					{
+						break;
+					}
+					unsigned long event = strtoul(space + 1, 0, 10) % MAX_EVENTS;
+					if (m_pArrival[event] == 0)
+					{
+						m_pArrival[event] = now;
+						__sync_fetch_and_add(&m_pCounts[COUNT_DISTINCT], 1UL);
+					}
+				}
+			}
+
+			if (deviceKnown && !commandAcked && !m_pCounts[COUNT_DOWN] && nowNanos() >= commandDue)
+			{
+				commandDue = nowNanos() + COMMAND_REPEAT_MS * 1000000ULL;
+				random = random * 1103515245UL + 12345UL;
+				if ((random >> 16) % 100 >= m_nLossPercent)
+				{
+					char command[32];
+					int len = snprintf(command, sizeof(command), "C %lu 1\nswitch1 on", commandSession);
+					sendto(m_nSocket, command, len, 0, (struct sockaddr *)&device, sizeof(device));
+				}
+			}
+		}
+	}
+
+	void StandInReceiver::setDown(bool down)
+	{
+		if (m_pCounts)
+		{
+			__sync_lock_test_and_set(&m_pCounts[COUNT_DOWN], down ? 1UL : 0UL);
+		}
+	}
+
+	unsigned long StandInReceiver::distinct() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_DISTINCT], 0UL) : 0;
+	}
+
+	unsigned long StandInReceiver::repeats() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_REPEATS], 0UL) : 0;
+	}
+
+	unsigned long StandInReceiver::commandsAcked() const
+	{
+		return m_pCounts ? __sync_fetch_and_add(&m_pCounts[COUNT_COMMANDS_ACKED], 0UL) : 0;
+	}
+
+	SocketUDP::SocketUDP() :
+		m_nSocket(-1),
+		m_nTxUsed(0),
+		m_nRxUsed(0),
+		m_nRxRead(0)
+	{
+		memset(&m_Destination, 0, sizeof(m_Destination));
+		memset(&m_Remote, 0, sizeof(m_Remote));
+	}
+
+	SocketUDP::~SocketUDP()
+	{
+		stop();
+	}
+
+	uint8_t SocketUDP::begin(uint16_t port)
+	{
+		stop();
+		m_nSocket = socket(AF_INET, SOCK_DGRAM, 0);
+		if (m_nSocket < 0)
+		{
+			return 0;
+		}
+		struct sockaddr_in addr = loopback(port);
+		if (bind(m_nSocket, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		{
+			stop();
+			return 0;
+		}
+		return 1;
+	}
+
+	void SocketUDP::stop()
+	{
+		if (m_nSocket >= 0)
+		{
+			close(m_nSocket);
+			m_nSocket = -1;
+		}
+	}
+
+	int SocketUDP::beginPacket(IPAddress ip, uint16_t port)
+	{
+		m_Destination = loopback(port);
+		m_Destination.sin_addr.s_addr = (uint32_t)ip;
+		m_nTxUsed = 0;
+		return m_nSocket >= 0 ? 1 : 0;
+	}
+
+	int SocketUDP::beginPacket(const char *host, uint16_t port)
+	{
+		return beginPacket(IPAddress(127, 0, 0, 1), port);
+	}
+
+	int SocketUDP::endPacket()
+	{
+		if (m_nSocket < 0)
+		{
+			return 0;
+		}
+		ssize_t n = sendto(m_nSocket, m_TxBuffer, m_nTxUsed, 0, (struct sockaddr *)&m_Destination, sizeof(m_Destination));
+		m_nTxUsed = 0;
+		return n >= 0 ? 1 : 0;
+	}
+
+	size_t SocketUDP::write(uint8_t c)
+	{
+		return write(&c, 1);
+	}
+
+	size_t SocketUDP::write(const uint8_t *buffer, size_t size)
+	{
+		size_t room = sizeof(m_TxBuffer) - m_nTxUsed;
+		size = size < room ? size : room;
+		memcpy(m_TxBuffer + m_nTxUsed, buffer, size);
+		m_nTxUsed += size;
+		return size;
+	}
+
+	int SocketUDP::parsePacket()
+	{
+		m_nRxUsed = 0;
+		m_nRxRead = 0;
+		if (m_nSocket < 0)
+		{
+			return 0;
+		}
+		socklen_t len = sizeof(m_Remote);
+		ssize_t n = recvfrom(m_nSocket, m_RxBuffer, sizeof(m_RxBuffer), MSG_DONTWAIT, (struct sockaddr *)&m_Remote, &len);
+		if (n <= 0)
+		{
+			return 0;
+		}
+		m_nRxUsed = n;
+		return n;
+	}
+
+	int SocketUDP::available()
+	{
+		return m_nRxUsed - m_nRxRead;
+	}
+
+	int SocketUDP::read()
+	{
+		return m_nRxRead < m_nRxUsed ? m_RxBuffer[m_nRxRead++] : -1;
+	}
+
+	int SocketUDP::read(unsigned char *buffer, size_t len)
+	{
+		size_t count = m_nRxUsed - m_nRxRead;
+		count = count < len ? count : len;
+		memcpy(buffer, m_RxBuffer + m_nRxRead, count);
+		m_nRxRead += count;
+		return count;
+	}
+
+	int SocketUDP::peek()
+	{
+		return m_nRxRead < m_nRxUsed ? m_RxBuffer[m_nRxRead] : -1;
+	}
+
+	IPAddress SocketUDP::remoteIP()
+	{
+		return IPAddress((uint32_t)m_Remote.sin_addr.s_addr);
+	}
+
+	uint16_t SocketUDP::remotePort()
+	{
+		return ntohs(m_Remote.sin_port);
+	}
+}
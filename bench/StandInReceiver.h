@@ -0,0 +1,111 @@
+//******************************************************************************************
+//  File: StandInReceiver.h
+//
+//  Summary:  Local stand-in for the receiver of SmartThingsUDP and a POSIX socket UDP, used
+//            by the udp benchmark suite.
+//
+//            bench::StandInReceiver speaks the protocol of SmartThingsUDP.h (as the reference
+//            receiver lib/SmartThingsUDP/extras/st_udp_receiver.py does) in a forked process
+//            on a loopback port, over a lossy link: each datagram in either direction is lost
+//            with the given probability.  Once the device has sent its first event it sends
+//            one command, "switch1 on", repeating it until the device acknowledges it, then
+//            the same command id again in a new session, as a restarted receiver would.  It
+//            records in memory shared with the benchmark process when each event (numbered
+//            by its value) first arrived, and counts repeats.  setDown() takes it off the
+//            air: while down it drops every datagram and sends nothing, as a receiver that
+//            is restarting or unreachable.
+//
+//            bench::SocketUDP implements the Arduino UDP interface on a datagram socket, as
+//            WiFiUDP does on the board: parsePacket() never waits.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Commands in two sessions, "C <session> <id>"
+//    2026-10-17  Per Ivar Nerseth  Receiver outages
+//
+//******************************************************************************************
+
+#ifndef ST_STANDINRECEIVER_H
+#define ST_STANDINRECEIVER_H
+
+#include <Arduino.h>
+#include <Udp.h>
+
+#include <sys/types.h>
+#include <netinet/in.h>
+
+namespace bench
+{
+	class StandInReceiver
+	{
+		private:
+			int m_nSocket;
+			volatile unsigned long *m_pCounts;		//shared with the receiver process, see the COUNT_ indices
+			volatile unsigned long long *m_pArrival;	//shared: bench::nowNanos() of each event's first arrival, 0 == not yet
+			pid_t m_nPid;							//receiver process
+			uint16_t m_nPort;
+			unsigned int m_nLossPercent;
+
+			void serve();							//receiver process main loop - never returns
+
+		public:
+			static const unsigned long MAX_EVENTS = 4096;
+
+			StandInReceiver();
+			~StandInReceiver();
+
+			bool start(unsigned int lossPercent = 0);	//binds 127.0.0.1 (any free port) and forks the receiver process
+			void stop();
+
+			uint16_t port() const { return m_nPort; }
+			void setDown(bool down);
+			unsigned long long arrival(unsigned long event) const { return m_pArrival[event % MAX_EVENTS]; }
+			unsigned long distinct() const;		//different events received
+			unsigned long repeats() const;		//event datagrams received again (their ack was lost, or late)
+			unsigned long commandsAcked() const;	//"K" received for the commands
+	};
+
+	class SocketUDP: public UDP
+	{
+		private:
+			int m_nSocket;
+			struct sockaddr_in m_Destination;
+			struct sockaddr_in m_Remote;
+			uint8_t m_TxBuffer[2048];
+			size_t m_nTxUsed;
+			uint8_t m_RxBuffer[2048];
+			size_t m_nRxUsed;
+			size_t m_nRxRead;
+
+		public:
+			SocketUDP();
+			~SocketUDP();
+
+			virtual uint8_t begin(uint16_t port);		//binds 127.0.0.1
+			virtual void stop();
+
+			virtual int beginPacket(IPAddress ip, uint16_t port);
+			virtual int beginPacket(const char *host, uint16_t port);	//host is ignored - always 127.0.0.1
+			virtual int endPacket();
+			virtual size_t write(uint8_t c);
+			virtual size_t write(const uint8_t *buffer, size_t size);
+
+			virtual int parsePacket();
+			virtual int available();
+			virtual int read();
+			virtual int read(unsigned char *buffer, size_t len);
+			virtual int read(char *buffer, size_t len) { return read((unsigned char *)buffer, len); }
+			virtual int peek();
+			virtual void flush() {}
+
+			virtual IPAddress remoteIP();
+			virtual uint16_t remotePort();
+
+			using Print::write;
+	};
+}
+
+#endif
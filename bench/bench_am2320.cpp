@@ -0,0 +1,231 @@
+//******************************************************************************************
+//  File: bench_am2320.cpp
+//
+//  Summary:  PS_TemperatureHumidity_AM2320 with the split-phase DHT_AM2320 reader
+//            (start()/poll()/complete()), on a waveform played into the pin as the reader
+//            samples it.
+//
+//            The waveform follows the datasheet timing: the sensor answers 30us after the
+//            line is released, response 80us low and 80us high, then per bit 50us low and
+//            26us (0) or 70us (1) high.  Each digitalRead() of the busy-wait loop costs 1us of
+//            simulated time.  A "WiFi interrupt" comes in every 500us and takes 0, 20 or 40us
+//            to run; while interrupts are off it waits for the reader's next interrupts().
+//
+//            "poll": the sensor polled every 10s by st::Everything for 10 simulated minutes.
+//            Reported: reads and correct values, time blocked in delay() per read, the longest
+//            pass of st::Everything::run() in simulated time, the longest interrupts-off window
+//            and their sum per read, the transfer (which the old reader kept interrupts off
+//            for, from the release of the line to the last bit), and the longest time a WiFi
+//            interrupt waited.  "blocking read" is DHT_AM2320::read(), as getData() used it.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <Everything.h>
+#include <PS_TemperatureHumidity-AM2320.h>
+
+namespace
+{
+	const byte PIN = 4;
+	const unsigned long POLL_MS = 600000UL;
+	const unsigned long WIFI_PERIOD = 500;		//us between two WiFi interrupts
+
+	//the sensor's answer: 45.6%, 23.4C
+	const byte BYTES[5] = { 0x01, 0xC8, 0x00, 0xEA, (byte)(0x01 + 0xC8 + 0x00 + 0xEA) };
+
+	//state of the simulated line and WiFi interrupts
+	bool woken = false;					//the line was held low - the next release starts a transfer
+	bool playing = false;
+	unsigned long lineMicros = 0;		//simulated time since the release of the line - the host's own time left out
+	unsigned long transfers = 0;
+	unsigned long wifiIsr = 0;			//us a WiFi interrupt takes
+	unsigned long nextWifi = 0;
+	unsigned long wifiWaitMax = 0;
+
+	//level of the line t microseconds after its release
+	byte level(unsigned long t)
+	{
+		if (t < 30)
+		{
+			return HIGH;
+		}
+		t -= 30;
+		if (t < 80)
+		{
+			return LOW;
+		}
+		t -= 80;
+		if (t < 80)
+		{
+			return HIGH;
+		}
+		t -= 80;
+		for (byte i = 0; i < 40; i++)
+		{
+			if (t < 50)
+			{
+				return LOW;
+			}
+			t -= 50;
+			unsigned long high = BYTES[i / 8] & (128 >> (i % 8)) ? 70 : 26;
+			if (t < high)
+			{
+				return HIGH;
+			}
+			t -= high;
+		}
+		if (t < 50)
+		{
+			return LOW;		//end of the last bit
+		}
+		playing = false;
+		return HIGH;
+	}
+
+	//runs the WiFi interrupts that are due, if interrupts are on
+	void serviceWifi()
+	{
+		if (!playing || wifiIsr == 0)
+		{
+			return;
+		}
+		while (native::interruptsOn() && lineMicros >= nextWifi)
+		{
+			unsigned long waited = lineMicros - nextWifi;
+			if (waited > wifiWaitMax)
+			{
+				wifiWaitMax = waited;
+			}
+			lineMicros += wifiIsr;
+			native::advanceMicros(wifiIsr);
+			nextWifi += WIFI_PERIOD;
+		}
+	}
+
+	//called while the reader waits (delay(), and after each st::Everything::run())
+	void checkWake()
+	{
+		if (native::getPinMode(PIN) == OUTPUT && native::getDigitalPin(PIN) == LOW)
+		{
+			woken = true;
+		}
+	}
+
+	void readHook(uint8_t pin)
+	{
+		if (pin != PIN)
+		{
+			return;
+		}
+		if (woken && !playing && native::getPinMode(PIN) == INPUT_PULLUP)
+		{
+			//the reader drove the line high for 40us and waited 10us before its first read
+			woken = false;
+			playing = true;
+			lineMicros = 50;
+			nextWifi = (transfers * 137) % WIFI_PERIOD;
+			transfers++;
+		}
+		serviceWifi();
+		if (playing)
+		{
+			native::setDigitalPin(PIN, level(lineMicros));
+		}
+		lineMicros++;
+		native::advanceMicros(1);
+	}
+
+	void runPoll(void *arg)
+	{
+		wifiIsr = *static_cast<unsigned long *>(arg);
+		char name[64];
+		snprintf(name, sizeof(name), "poll, WiFi interrupt %luus", wifiIsr);
+
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::PS_TemperatureHumidity_AM2320 sensor(F("temphumid1"), 10, 0, PIN, AM2320, "temperature1", "humidity1", true);
+		st::Everything::addSensor(&sensor);
+		native::setReadHook(readHook);
+		native::setInterruptsHook(serviceWifi);
+		native::setYieldHook(checkWake);
+		st::Everything::initDevices();
+		native::resetBlockedMicros();
+
+		unsigned long correct = 0;
+		unsigned long reads = 0;
+		unsigned long lockedMax = 0;
+		unsigned long long lockedTotal = 0;
+		unsigned long captureMax = 0;
+		unsigned long longest = 0;
+		unsigned long start = millis();
+		while (millis() - start < POLL_MS)
+		{
+			unsigned long before = transfers;
+			unsigned long pass = micros();
+			st::Everything::run();
+			pass = micros() - pass;
+			if (pass > longest)
+			{
+				longest = pass;
+			}
+			checkWake();
+			playing = false;
+			if (transfers != before)
+			{
+				const DHT_AM2320 &dht = sensor.getDHT();
+				reads++;
+				lockedTotal += dht.lockedTotalMicros();
+				if (dht.lockedMaxMicros() > lockedMax)
+				{
+					lockedMax = dht.lockedMaxMicros();
+				}
+				if (dht.captureMicros() > captureMax)
+				{
+					captureMax = dht.captureMicros();
+				}
+				correct += dht.complete() && sensor.getTemperatureSensorValue() > 23.35 && sensor.getTemperatureSensorValue() < 23.45 && sensor.getHumiditySensorValue() > 45.55 && sensor.getHumiditySensorValue() < 45.65;
+			}
+			native::advanceMillis(1);
+		}
+
+		bench::report("am2320", name, reads, "reads");
+		bench::report("am2320", name, correct, "reads with the right values");
+		bench::report("am2320", name, reads ? native::blockedMicros() / 1000.0 / reads : 0, "ms blocked in delay() per read");
+		bench::report("am2320", name, longest / 1000.0, "ms longest run() pass");
+		bench::report("am2320", name, lockedMax, "us longest interrupts-off window");
+		bench::report("am2320", name, reads ? (double)lockedTotal / reads : 0, "us interrupts off per read");
+		bench::report("am2320", name, captureMax, "us transfer (the old interrupts-off window)");
+		bench::report("am2320", name, wifiWaitMax, "us longest WiFi interrupt wait");
+
+		//the blocking read getData() used before
+		DHT_AM2320 blocking(PIN, AM2320);
+		blocking.begin();
+		native::resetBlockedMicros();
+		unsigned long blockingStart = micros();
+		bool ok = blocking.read(true);
+		playing = false;
+		snprintf(name, sizeof(name), "blocking read, WiFi interrupt %luus", wifiIsr);
+		bench::report("am2320", name, (micros() - blockingStart) / 1000.0, "ms in read()");
+		bench::report("am2320", name, ok ? 1 : 0, "read with the right checksum (1 = yes)");
+	}
+}
+
+void benchAm2320()
+{
+	static unsigned long isrMicros[] = { 0, 20, 40 };
+	for (unsigned int i = 0; i < sizeof(isrMicros) / sizeof(isrMicros[0]); i++)
+	{
+		bench::runIsolated(runPoll, &isrMicros[i]);
+	}
+}
@@ -0,0 +1,329 @@
+//******************************************************************************************
+//  File: bench_async.cpp
+//
+//  Summary:  Command-to-pin latency, SmartThingsESP8266WiFi versus SmartThingsESP8266WiFiAsync.
+//
+//            An EX_Switch on pin 13 receives "switch1 on"/"switch1 off" every 0.5 to 2.5s for
+//            two simulated minutes while the loop also polls 10 PS_Voltage sensors every
+//            second, a sensor that waits 750ms in delay() for a conversion every 5s (as the
+//            DS18B20 library does) and one that computes for 15ms without yielding every
+//            second.
+//
+//            Both sides are the real transports, built against the stand-ins in bench/esp8266,
+//            with a callout that passes each command to receiveSmartString() and times it:
+//            -"WiFiServer": SmartThingsESP8266WiFi, whose WiFiServer/WiFiClient are loopback
+//             sockets.  Each command is a connection to its st_server, opened when the command
+//             is due; run() reads it on the next pass of the loop.
+//            -"ESPAsyncTCP": SmartThingsESP8266WiFiAsync.  Each command is a connection to its
+//             AsyncServer (asynctcp::connect()); asynctcp::runStack() hands it to st_server's
+//             onClient and the request to onData between passes of the loop and whenever the
+//             sketch yields (native::setYieldHook()), as the ESP8266 core runs the TCP stack.
+//            Events go to a bench::StandInHub, and to the hub of the ESPAsyncTCP stand-in.
+//
+//            Reported: mean, 95th percentile and worst time from the request arriving to
+//            the pin changing, and the commands that changed the pin.
+//
+//            "transport": the real SmartThingsESP8266WiFiAsync, built against the stand-ins
+//            for ESP8266WiFi, ESPAsyncTCP and ArduinoOTA in bench/esp8266.  The WiFi join
+//            takes 4s; an event ("energy1 <n>") is due every 2s for 3 minutes and is sent
+//            once isReady(), as Everything's SendQueue does; the hub refuses connections from
+//            30s to 90s.  "retry queue" keeps what fails in the shared retry queue (default
+//            policy), "event log" in an st::EventLog on a bench::SimulatedFlash.  Reported:
+//            the time init() took, ms to isReady(), events received of those sent, out of
+//            order, retries, dead letters and replays.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  The real SmartThingsESP8266WiFiAsync on the ESPAsyncTCP stand-in
+//    2026-10-17  Per Ivar Nerseth  Commands go through the real transports, not a model of them
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "SimulatedFlash.h"
+#include "StandInHub.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <vector>
+
+#include <Everything.h>
+#include <EX_Switch.h>
+#include <PS_Voltage.h>
+#include <EventLog.h>
+#include <SmartThingsESP8266WiFi.h>
+#include <SmartThingsESP8266WiFiAsync.h>
+
+namespace
+{
+	const unsigned long SIMULATED_MS = 120000UL;
+	const byte SWITCH_PIN = 13;
+
+	struct Command
+	{
+		unsigned long arrivesAt;	//relative to the start of the run
+		bool on;
+	};
+
+	std::vector<Command> commands;
+	size_t nextCommand;				//the next to arrive
+	size_t handledCommands;			//commands that reached the callout
+	bool async;
+	uint16_t serverPort;			//st_server of SmartThingsESP8266WiFi
+	std::vector<int> sockets;		//connections opened to it, closed at the end
+	unsigned long startMillis;
+	std::vector<unsigned long> latencies;
+	unsigned long pinChanges;
+
+	unsigned long elapsed()
+	{
+		return millis() - startMillis;
+	}
+
+	class ConversionSensor: public st::PollingSensor
+	{
+		public:
+			ConversionSensor() : PollingSensor(F("temperature1"), 5) {}
+			virtual void getData() { delay(750); }		//waits for the conversion, yielding
+	};
+
+	class BusySensor: public st::PollingSensor
+	{
+		public:
+			BusySensor() : PollingSensor(F("busy1"), 1) {}
+			virtual void getData() { native::advanceMillis(15); }	//computes, does not yield
+	};
+
+	//the callout of both transports - the command is passed on, and its time from arrival to the pin taken
+	void benchCallout(String message)
+	{
+		byte before = native::getDigitalPin(SWITCH_PIN);
+		st::receiveSmartString(message);
+		if (native::getDigitalPin(SWITCH_PIN) != before)
+		{
+			pinChanges++;
+		}
+		if (handledCommands < nextCommand)
+		{
+			latencies.push_back(elapsed() - commands[handledCommands++].arrivesAt);
+		}
+	}
+
+	//the Hub's request for each command that has arrived, on a new connection to the transport
+	void openArrived()
+	{
+		while (nextCommand < commands.size() && elapsed() >= commands[nextCommand].arrivesAt)
+		{
+			const char *request = commands[nextCommand].on ? "POST /switch1%20on? HTTP/1.1\r\nHOST: 192.168.1.226:8090\r\n\r\n"
+														   : "POST /switch1%20off? HTTP/1.1\r\nHOST: 192.168.1.226:8090\r\n\r\n";
+			nextCommand++;
+			if (async)
+			{
+				asynctcp::connect(8090, request, strlen(request));
+				continue;
+			}
+			int fd = socket(AF_INET, SOCK_STREAM, 0);
+			sockaddr_in addr;
+			memset(&addr, 0, sizeof(addr));
+			addr.sin_family = AF_INET;
+			addr.sin_port = htons(serverPort);
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			if (fd >= 0 && connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0)
+			{
+				ssize_t written = write(fd, request, strlen(request));
+				(void)written;
+			}
+			sockets.push_back(fd);
+		}
+	}
+
+	//what the ESP8266 core does between passes of loop() and when the sketch yields
+	void systemTasks()
+	{
+		static bool busy = false;
+		if (busy)
+		{
+			return;
+		}
+		busy = true;
+		openArrived();
+		if (async)
+		{
+			asynctcp::runStack();
+		}
+		busy = false;
+	}
+
+	class WiFiTransport: public st::SmartThingsESP8266WiFi
+	{
+		public:
+			WiFiTransport(uint16_t hubPort) : SmartThingsESP8266WiFi("bench", "password", 0, IPAddress(127, 0, 0, 1), hubPort, benchCallout) {}
+
+			uint16_t port() const { return st_server.port(); }
+	};
+
+	void runAsyncScenario(void *arg)
+	{
+		async = arg != NULL;
+		const char *name = async ? "ESPAsyncTCP" : "WiFiServer";
+
+		unsigned long random = 8266;
+		unsigned long at = 1000;
+		bool on = true;
+		while (at < SIMULATED_MS - 3000)
+		{
+			Command command = { at, on };
+			commands.push_back(command);
+			on = !on;
+			random = random * 1103515245UL + 12345UL;
+			at += 500 + (random >> 16) % 2001;
+		}
+		nextCommand = 0;
+		handledCommands = 0;
+		pinChanges = 0;
+
+		bench::StandInHub hub;
+		if (!async && !hub.start())
+		{
+			fprintf(stderr, "async: stand-in hub did not start\n");
+			return;
+		}
+		asynctcp::resetHub();
+		WiFi.setJoinMillis(500);
+		st::SmartThings *transport;
+		if (async)
+		{
+			transport = new st::SmartThingsESP8266WiFiAsync("bench", "password", 8090, IPAddress(192, 168, 1, 149), 39500, benchCallout);
+		}
+		else
+		{
+			transport = new WiFiTransport(hub.port());
+		}
+		st::Everything::SmartThing = transport;
+		st::Everything::init();
+		if (!async)
+		{
+			serverPort = static_cast<WiFiTransport *>(transport)->port();
+		}
+		st::Everything::addExecutor(new st::EX_Switch(F("switch1"), SWITCH_PIN, LOW));
+		for (unsigned int i = 0; i < 10; i++)
+		{
+			st::Everything::addSensor(new st::PS_Voltage(bench::deviceName("voltage", i), 1, i * 97 % 1000, i));
+		}
+		st::Everything::addSensor(new ConversionSensor());
+		st::Everything::addSensor(new BusySensor());
+		st::Everything::initDevices();
+
+		startMillis = millis();
+		native::setYieldHook(systemTasks);
+		while (elapsed() < SIMULATED_MS)
+		{
+			st::Everything::run();
+			systemTasks();
+			native::advanceMillis(1);
+		}
+		native::setYieldHook(NULL);
+		for (size_t i = 0; i < sockets.size(); i++)
+		{
+			close(sockets[i]);
+		}
+
+		std::sort(latencies.begin(), latencies.end());
+		double total = 0;
+		for (size_t i = 0; i < latencies.size(); i++)
+		{
+			total += latencies[i];
+		}
+
+		char scenario[64];
+		snprintf(scenario, sizeof(scenario), "%s mean command-to-pin", name);
+		bench::report("async", scenario, latencies.empty() ? 0 : total / latencies.size(), "ms");
+		snprintf(scenario, sizeof(scenario), "%s p95 command-to-pin", name);
+		bench::report("async", scenario, latencies.empty() ? 0 : latencies[latencies.size() * 95 / 100], "ms");
+		snprintf(scenario, sizeof(scenario), "%s worst command-to-pin", name);
+		bench::report("async", scenario, latencies.empty() ? 0 : latencies.back(), "ms");
+		snprintf(scenario, sizeof(scenario), "%s pin changes", name);
+		bench::report("async", scenario, pinChanges, "commands");
+		snprintf(scenario, sizeof(scenario), "%s commands sent", name);
+		bench::report("async", scenario, commands.size(), "commands");
+	}
+
+	class AsyncTransport: public st::SmartThingsESP8266WiFiAsync
+	{
+		public:
+			AsyncTransport() : SmartThingsESP8266WiFiAsync("bench", "password", 8090, IPAddress(192, 168, 1, 149), 39500, st::receiveSmartString) {}
+
+			unsigned long retries() const { return m_Retry.getRetries(); }
+			unsigned long deadLetters() const { return m_Retry.getDeadLetters(); }
+	};
+
+	void runTransportScenario(void *arg)
+	{
+		const bool withLog = arg != NULL;
+		const char *name = withLog ? "transport, event log" : "transport, retry queue";
+		const unsigned long EVENTS = 90;
+
+		asynctcp::resetHub();
+		WiFi.setJoinMillis(4000);
+		bench::SimulatedFlash flash;
+		st::EventLog log(flash);
+		log.begin();
+		AsyncTransport transport;
+		if (withLog)
+		{
+			transport.setEventLog(&log);
+		}
+
+		unsigned long start = millis();
+		transport.init();
+		unsigned long initMillis = millis() - start;
+
+		unsigned long sent = 0;
+		unsigned long readyAt = 0;
+		unsigned long t = 0;
+		while (sent < EVENTS || (t < 300000 && (log.getPending() > 0 || asynctcp::hubEvents() < sent)))
+		{
+			t = millis() - start;
+			asynctcp::setHubUp(t < 30000 || t >= 90000);
+			if (readyAt == 0 && transport.isReady())
+			{
+				readyAt = t;
+			}
+			if (sent < EVENTS && t >= sent * 2000 && transport.isReady())
+			{
+				sent++;
+				transport.send("energy1 " + String(sent));
+			}
+			transport.run();
+			asynctcp::runStack();	//the core's system tasks between two passes of loop()
+			native::advanceMillis(1);
+		}
+
+		bench::report("async", name, initMillis, "ms in init()");
+		bench::report("async", name, readyAt, "ms to isReady()");
+		bench::report("async", name, asynctcp::hubEvents(), "events received");
+		bench::report("async", name, sent, "events sent");
+		bench::report("async", name, asynctcp::hubOutOfOrder(), "out of order");
+		bench::report("async", name, transport.retries(), "retries");
+		bench::report("async", name, transport.deadLetters(), "dead letters");
+		bench::report("async", name, asynctcp::hubReplays(), "replayed from the log");
+	}
+}
+
+void benchAsync()
+{
+	static int async = 1;
+	static int withLog = 1;
+	bench::runIsolated(runAsyncScenario, NULL);
+	bench::runIsolated(runAsyncScenario, &async);
+	bench::runIsolated(runTransportScenario, NULL);
+	bench::runIsolated(runTransportScenario, &withLog);
+}
@@ -0,0 +1,139 @@
+//******************************************************************************************
+//  File: bench_batch.cpp
+//
+//  Summary:  Single-event versus batched HTTP POST to the hub, with and without keep-alive.
+//
+//            A refresh storm (one event from every device, i.e. a full SendQueue) is queued
+//            and st::Everything::run() is called until the queue is empty, sending
+//            to a bench::StandInHub over loopback TCP.
+//
+//            "storm" scenarios use a transmit interval of 0, so the host's connection cost
+//            is all that limits the rate.  Reported: events per second of host time, time
+//            per send(), TCP connections opened, and the events the hub counted (must equal
+//            events queued).  One keep-alive scenario has the hub silently drop the
+//            connection every 10 requests, so the transparent reconnect is exercised.
+//
+//            "paced" scenarios use the usual 100ms transmit interval on the simulated
+//            clock and report how long one storm takes to reach the hub.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Keep-alive scenarios
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "StandInHub.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <Constants.h>
+#include <Everything.h>
+
+namespace
+{
+	const unsigned int STORM_ROUNDS = 200;
+	const unsigned int STORM_EVENTS = st::Constants::RETURN_QUEUE_SIZE;
+
+	struct BatchScenario
+	{
+		bool batch;
+		bool keepAlive;
+		unsigned int hubMaxRequests;	//hub drops keep-alive connections after this many requests (0 = never)
+		int transmitInterval;
+	};
+
+	void queueStorm(unsigned int round)
+	{
+		char msg[st::Constants::RETURN_MESSAGE_LENGTH];
+		for (unsigned int i = 0; i < STORM_EVENTS; i++)
+		{
+			int len = snprintf(msg, sizeof(msg), "temperature%u %u.%u", i + 1, 60 + (round + i) % 30, i % 10);
+			st::Everything::SendQueue.push(msg, len, st::PRIORITY_LOW);
+		}
+	}
+
+	void runBatchScenario(void *arg)
+	{
+		const BatchScenario &sc = *static_cast<BatchScenario *>(arg);
+		char mode[48];
+		snprintf(mode, sizeof(mode), "%s%s%s", sc.batch ? "batched POST" : "single-event POST",
+			sc.keepAlive ? " keep-alive" : "", sc.hubMaxRequests ? " (hub drops)" : "");
+
+		bench::StandInHub hub;
+		if (!hub.start(sc.hubMaxRequests))
+		{
+			fprintf(stderr, "batch: stand-in hub did not start\n");
+			_exit(1);
+		}
+
+		bench::HttpTransport transport(hub.port(), st::receiveSmartString, sc.transmitInterval);
+		transport.setBatchMode(sc.batch);
+		transport.setKeepAlive(sc.keepAlive);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		char scenario[64];
+		if (sc.transmitInterval == 0)
+		{
+			unsigned long long start = bench::nowNanos();
+			for (unsigned int round = 0; round < STORM_ROUNDS; round++)
+			{
+				queueStorm(round);
+				while (!st::Everything::SendQueue.empty())
+				{
+					st::Everything::run();	//no devices - run() only sends
+				}
+			}
+			unsigned long long elapsed = bench::nowNanos() - start;
+			unsigned long queued = (unsigned long)STORM_ROUNDS * STORM_EVENTS;
+
+			snprintf(scenario, sizeof(scenario), "storm %s", mode);
+			bench::report("batch", scenario, queued * 1e9 / elapsed, "events/s");
+			bench::report("batch", scenario, elapsed / 1000.0 / hub.requests(), "us per send()");
+			bench::report("batch", scenario, transport.connections, "connections opened");
+			bench::report("batch", scenario, hub.events(), "events received by hub");
+			bench::report("batch", scenario, queued, "events queued");
+			bench::report("batch", scenario, transport.failures, "failed sends");
+			if (sc.keepAlive)
+			{
+				bench::report("batch", scenario, transport.reconnects, "reconnects");
+			}
+		}
+		else
+		{
+			queueStorm(0);
+			unsigned long simStart = millis();
+			while (!st::Everything::SendQueue.empty())
+			{
+				native::advanceMillis(1);
+				st::Everything::run();	//no devices - run() only sends
+			}
+
+			snprintf(scenario, sizeof(scenario), "paced %dms %s", sc.transmitInterval, mode);
+			bench::report("batch", scenario, millis() - simStart, "ms to deliver one storm");
+			bench::report("batch", scenario, transport.connections, "connections opened");
+			bench::report("batch", scenario, hub.events(), "events received by hub");
+		}
+		hub.stop();
+	}
+}
+
+void benchBatch()
+{
+	BatchScenario scenarios[] =
+	{
+		{ false, false, 0, 0 }, { false, true, 0, 0 }, { false, true, 10, 0 },
+		{ true, false, 0, 0 }, { true, true, 0, 0 },
+		{ false, false, 0, 100 }, { true, false, 0, 100 },
+	};
+
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runBatchScenario, &scenarios[i]);
+	}
+}
@@ -0,0 +1,313 @@
+//******************************************************************************************
+//  File: bench_conn.cpp
+//
+//  Summary:  Slow and half-open clients of the device's HTTP server.
+//
+//            10 PS_Voltage sensors poll every second for 10 simulated seconds at one loop
+//            pass per ms, while a stand-in server (handing out each connection once, as
+//            the ESP8266 WiFiServer does) receives:
+//              t=1.0s  a client that connects, sends nothing and goes away at t=6s
+//              t=2.0s  "switch1 on", one byte every 20ms
+//              t=2.1s  "switch2 on", all at once
+//              t=2.2s  a client that sends one byte every 500ms and gives up at t=9s
+//              t=7.0s  "switch3 on", all at once
+//
+//            "blocking" reads each request to its end before run() returns, as the
+//            transports did (the busy wait moves the simulated clock 1ms per turn);
+//            "st_connections" is the HttpConnections table the transports use now.
+//            "st_connections, 1 slot" is the table as the Ethernet, WiFi101 and WiFiEsp
+//            transports have it: one slot, behind a server whose available() offers
+//            every connection with data (or closed by the client) again on each pass.
+//
+//            Reported: the longest loop pass, sensor reports sent, the time from connect
+//            to the callout for each command, connections closed by the read timeout,
+//            and for one slot the connections counted busy (st_http_busy).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  One slot behind a server that offers connections again
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <Everything.h>
+#include <PS_Voltage.h>
+#include <HttpConnections.h>
+
+namespace
+{
+	const unsigned long SIMULATED_MS = 10000UL;
+	const unsigned int SENSORS = 10;
+	const unsigned long NEVER = 0xFFFFFFFFUL;
+
+	struct Script
+	{
+		unsigned long connectAt;	//all times relative to the start of the run
+		std::string data;
+		unsigned long firstByteAt;
+		unsigned long byteEvery;	//0 == all at once
+		unsigned long goneAt;		//the client closes its end
+		const char *command;		//what the callout should receive, NULL if nothing
+		size_t pos;
+		bool stopped;
+	};
+
+	unsigned long startMillis;
+
+	unsigned long elapsed()
+	{
+		return millis() - startMillis;
+	}
+
+	//a copyable handle on one scripted connection, like a WiFiClient
+	class BenchClient: public Print
+	{
+		public:
+			BenchClient() : m_pScript(NULL) {}
+			explicit BenchClient(Script *script) : m_pScript(script) {}
+
+			operator bool() const { return m_pScript != NULL; }
+			bool operator==(const BenchClient &other) const { return m_pScript == other.m_pScript; }
+
+			int available()
+			{
+				if (m_pScript == NULL || m_pScript->stopped || elapsed() < m_pScript->firstByteAt)
+				{
+					return 0;
+				}
+				size_t arrived = m_pScript->data.size();
+				if (m_pScript->byteEvery)
+				{
+					size_t sent = 1 + (elapsed() - m_pScript->firstByteAt) / m_pScript->byteEvery;
+					arrived = sent < arrived ? sent : arrived;
+				}
+				return arrived - m_pScript->pos;
+			}
+
+			int read(uint8_t *buf, size_t size)
+			{
+				size_t count = available();
+				count = count < size ? count : size;
+				memcpy(buf, m_pScript->data.data() + m_pScript->pos, count);
+				m_pScript->pos += count;
+				return count;
+			}
+
+			uint8_t connected()
+			{
+				return m_pScript != NULL && !m_pScript->stopped && (elapsed() < m_pScript->goneAt || available() > 0);
+			}
+
+			void stop()
+			{
+				if (m_pScript)
+				{
+					m_pScript->stopped = true;
+				}
+			}
+
+			virtual size_t write(uint8_t) { return 1; }
+			virtual size_t write(const uint8_t *, size_t size) { return size; }
+
+		private:
+			Script *m_pScript;
+	};
+
+	class BenchServer
+	{
+		public:
+			std::vector<Script> scripts;
+			size_t next;
+			bool offersAgain;	//as EthernetServer: any connection with data or closed by the client, each pass
+
+			BenchServer() : next(0), offersAgain(false) {}
+
+			BenchClient available()
+			{
+				if (offersAgain)
+				{
+					for (size_t i = 0; i < scripts.size() && elapsed() >= scripts[i].connectAt; i++)
+					{
+						BenchClient client(&scripts[i]);
+						if (!scripts[i].stopped && (client.available() > 0 || elapsed() >= scripts[i].goneAt))
+						{
+							return client;
+						}
+					}
+					return BenchClient();
+				}
+				if (next < scripts.size() && elapsed() >= scripts[next].connectAt)
+				{
+					return BenchClient(&scripts[next++]);
+				}
+				return BenchClient();
+			}
+	};
+
+	unsigned long calloutAt[3];
+
+	void recordCommand(String message)
+	{
+		if (message.length() == 10 && message.startsWith("switch") && message.endsWith(" on"))
+		{
+			calloutAt[message[6] - '1'] = elapsed();
+		}
+	}
+
+	template <byte SLOTS> class ServerTransport: public st::SmartThings
+	{
+		public:
+			BenchServer server;
+			st::HttpConnections<BenchClient, SLOTS> connections;
+			bool blocking;
+			unsigned long sent;
+
+			ServerTransport(bool isBlocking) : SmartThings(recordCommand, "Bench", false, 0), blocking(isBlocking), sent(0) {}
+
+			virtual void init(void) {}
+			virtual void send(String message) { sent++; }
+
+			virtual void run(void)
+			{
+				if (blocking)
+				{
+					BenchClient client = server.available();
+					if (client)
+					{
+						st::HttpRequestParser request;
+						while (client.connected() && !request.done())
+						{
+							request.read(client);
+							if (!request.done())
+							{
+								native::advanceMillis(1);	//spinning on client.available()
+							}
+						}
+						answer(client, request);
+					}
+					return;
+				}
+
+				BenchClient client = server.available();
+				if (client && !connections.accept(client) && SLOTS > 1)
+				{
+					client.stop();		//one slot: it is offered again
+				}
+				typename st::HttpConnections<BenchClient, SLOTS>::Connection *connection;
+				while ((connection = connections.poll()) != NULL)
+				{
+					answer(connection->client, connection->request);
+					connections.close(*connection);
+				}
+			}
+
+		private:
+			void answer(BenchClient &client, st::HttpRequestParser &request)
+			{
+				client.println(request.complete() ? F("HTTP/1.1 200 OK") : request.getErrorStatus());
+				client.println();
+				client.stop();
+				if (request.complete() && request.commandLength() > 0)
+				{
+					_calloutFunction(String(request.command()));
+				}
+			}
+	};
+
+	enum Mode { BLOCKING, CONNECTIONS, ONE_SLOT };
+
+	template <byte SLOTS> void runConnScenario(Mode mode)
+	{
+		const bool blocking = mode == BLOCKING;
+		const char *name = blocking ? "blocking" : mode == ONE_SLOT ? "st_connections, 1 slot," : "st_connections";
+
+		ServerTransport<SLOTS> transport(blocking);
+		transport.server.offersAgain = mode == ONE_SLOT;
+		const Script scripts[] =
+		{
+			{ 1000, "", 0, 0, 6000, NULL, 0, false },
+			{ 2000, "POST /switch1%20on? HTTP/1.1\r\n\r\n", 2000, 20, NEVER, "switch1 on", 0, false },
+			{ 2100, "POST /switch2%20on? HTTP/1.1\r\nHOST: 192.168.1.226:8090\r\n\r\n", 2100, 0, NEVER, "switch2 on", 0, false },
+			{ 2200, "POST /relaySwitch1%20off? HTTP/1.1\r\n\r\n", 2200, 500, 9000, NULL, 0, false },
+			{ 7000, "POST /switch3%20on? HTTP/1.1\r\n\r\n", 7000, 0, NEVER, "switch3 on", 0, false },
+		};
+		transport.server.scripts.assign(scripts, scripts + sizeof(scripts) / sizeof(scripts[0]));
+		for (int i = 0; i < 3; i++)
+		{
+			calloutAt[i] = NEVER;
+		}
+
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			st::Everything::addSensor(new st::PS_Voltage(bench::deviceName("voltage", i), 1, 0, i));
+		}
+		st::Everything::initDevices();
+		unsigned long initialReports = transport.sent;
+
+		startMillis = millis();
+		unsigned long worstPass = 0;
+		while (elapsed() < SIMULATED_MS)
+		{
+			unsigned long before = millis();
+			st::Everything::run();
+			if (millis() - before > worstPass)
+			{
+				worstPass = millis() - before;
+			}
+			native::advanceMillis(1);
+		}
+
+		char scenario[64];
+		snprintf(scenario, sizeof(scenario), "%s longest loop pass", name);
+		bench::report("conn", scenario, worstPass, "ms");
+		snprintf(scenario, sizeof(scenario), "%s sensor reports", name);
+		bench::report("conn", scenario, transport.sent - initialReports, "reports");
+		for (int i = 0; i < 3; i++)
+		{
+			const Script &script = transport.server.scripts[i == 2 ? 4 : i + 1];
+			snprintf(scenario, sizeof(scenario), "%s %s connect to callout", name, script.command);
+			if (calloutAt[i] == NEVER)
+			{
+				bench::report("conn", scenario, -1, "ms (never)");
+			}
+			else
+			{
+				bench::report("conn", scenario, calloutAt[i] - script.connectAt, "ms");
+			}
+		}
+		if (!blocking)
+		{
+			snprintf(scenario, sizeof(scenario), "%s read timeouts", name);
+			bench::report("conn", scenario, transport.connections.getTimeouts(), "connections");
+			snprintf(scenario, sizeof(scenario), "%s dropped by client", name);
+			bench::report("conn", scenario, transport.connections.getDropped(), "connections");
+		}
+		if (mode == ONE_SLOT)
+		{
+			snprintf(scenario, sizeof(scenario), "%s busy", name);
+			bench::report("conn", scenario, transport.connections.getBusy(), "connections");
+		}
+	}
+
+	void runBlocking(void *) { runConnScenario<HTTP_MAX_CONNECTIONS>(BLOCKING); }
+	void runConnections(void *) { runConnScenario<HTTP_MAX_CONNECTIONS>(CONNECTIONS); }
+	void runOneSlot(void *) { runConnScenario<1>(ONE_SLOT); }
+}
+
+void benchConn()
+{
+	bench::runIsolated(runBlocking, NULL);
+	bench::runIsolated(runConnections, NULL);
+	bench::runIsolated(runOneSlot, NULL);
+}
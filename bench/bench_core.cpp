@@ -0,0 +1,298 @@
+//******************************************************************************************
+//  File: bench_core.cpp
+//
+//  Summary:  The HTTP transport engine of the LAN transports (SmartThingsHttpCore.h) under
+//            load on Linux, as st::SmartThingsNative on real loopback sockets.
+//
+//            "send": 5000 numbered events ("energy1 <n>") sent as fast as send() returns to
+//            a bench::StandInHub - one connection per event (the default) and keep-alive.
+//            bench::HttpTransport, the bench's own copy of the ESP8266 send path, is run the
+//            same way for comparison.
+//
+//            "serve": 1 and 8 load clients, each in its own process, send 2000 requests each
+//            ("GET /switch1%20on", connect - request - read the reply until the device
+//            closes) to the device's server port while the device loops run().  A 200 reply
+//            is counted as served, a 503 as busy (every one of the HTTP_MAX_CONNECTIONS slots
+//            held).  GET /metrics at the end must report the same number of 503s.
+//            "serve, 1 slot" is the engine as the Ethernet, WiFi101 and WiFiEsp transports
+//            run it: one slot, behind a NativeServer that offers every connection with data
+//            again (setOffersAgain()) - no 503s, a client waits until the slot is free, and
+//            st_http_busy counts each connection that had to wait once.
+//
+//            Reported: events or requests per second of host time, events received and out
+//            of order, callouts, replies 200 and 503, and connections closed by the read
+//            timeout.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  "serve, 1 slot" behind a server that offers connections again
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "StandInHub.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include <SmartThingsNative.h>
+
+namespace
+{
+	const unsigned long SEND_EVENTS = 5000;
+	const unsigned int LOAD_CLIENTS = 8;
+	const unsigned long REQUESTS_PER_CLIENT = 2000;
+
+	unsigned long callouts = 0;
+
+	void countCallout(String message)
+	{
+		callouts++;
+	}
+
+	//SmartThingsNative with the statistics of its server in reach
+	class Device: public st::SmartThingsNative
+	{
+		public:
+			Device(uint16_t hubPort) :
+				SmartThingsNative(0, IPAddress(127, 0, 0, 1), hubPort, countCallout, "Native", false, 0)
+			{
+			}
+
+			const Connections &connections() const { return st_connections; }
+	};
+
+	//the engine with one slot, as the Ethernet, WiFi101 and WiFiEsp transports have it
+	class OneSlotDevice: public st::SmartThingsHttpCore<NativeServer, NativeClient, 1>
+	{
+		public:
+			OneSlotDevice(uint16_t hubPort) :
+				SmartThingsHttpCore(0, IPAddress(127, 0, 0, 1), hubPort, countCallout, "Native", false, 0, true)
+			{
+			}
+
+			virtual void init(void)
+			{
+				st_server.setOffersAgain(true);
+				st_server.begin();
+			}
+
+			uint16_t getServerPort() const { return st_server.port(); }
+			const Connections &connections() const { return st_connections; }
+	};
+
+	struct SendScenario
+	{
+		const char *name;
+		bool keepAlive;
+		bool standIn;		//bench::HttpTransport instead of st::SmartThingsNative
+	};
+
+	void runSendScenario(void *arg)
+	{
+		const SendScenario *scenario = static_cast<const SendScenario *>(arg);
+
+		bench::StandInHub hub;
+		if (!hub.start())
+		{
+			fprintf(stderr, "core: stand-in hub did not start\n");
+			_exit(1);
+		}
+
+		Device device(hub.port());
+		bench::HttpTransport standIn(hub.port(), countCallout, 0);
+		st::SmartThings &transport = scenario->standIn ? static_cast<st::SmartThings &>(standIn) : device;
+		transport.init();
+		transport.setKeepAlive(scenario->keepAlive);
+
+		unsigned long long start = bench::nowNanos();
+		for (unsigned long n = 1; n <= SEND_EVENTS; n++)
+		{
+			char msg[32];
+			snprintf(msg, sizeof(msg), "energy1 %lu", n);
+			transport.send(msg);
+		}
+		double seconds = (bench::nowNanos() - start) / 1e9;
+
+		//the hub counts a POST before its reply, so every event sent is counted by now
+		bench::report("core", scenario->name, SEND_EVENTS / seconds, "events/s");
+		bench::report("core", scenario->name, hub.events(), "events received");
+		bench::report("core", scenario->name, hub.outOfOrder(), "events out of order or twice");
+		bench::report("core", scenario->name, transport.getRetryQueue().getPending() + transport.getRetryQueue().getDeadLetters(), "events held or given up");
+		hub.stop();
+	}
+
+	//one request on a new connection - returns the status code of the reply, 0 if there was none
+	int request(uint16_t port, const char *text, String *reply = NULL)
+	{
+		int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			return 0;
+		}
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || send(fd, text, strlen(text), MSG_NOSIGNAL) < 0)
+		{
+			close(fd);
+			return 0;
+		}
+
+		//the device closes the connection after its reply
+		char buf[512];
+		char status[16] = "";
+		size_t got = 0;
+		ssize_t n;
+		while ((n = recv(fd, buf, sizeof(buf) - 1, 0)) > 0)
+		{
+			if (got < sizeof(status) - 1)
+			{
+				size_t take = (size_t)n < sizeof(status) - 1 - got ? (size_t)n : sizeof(status) - 1 - got;
+				memcpy(status + got, buf, take);
+				got += take;
+				status[got] = 0;
+			}
+			if (reply)
+			{
+				buf[n] = 0;
+				*reply += buf;
+			}
+		}
+		close(fd);
+		return strncmp(status, "HTTP/1.1 ", 9) == 0 ? atoi(status + 9) : 0;
+	}
+
+	enum
+	{
+		COUNT_OK,
+		COUNT_BUSY,
+		COUNT_OTHER,
+		COUNT_SIZE
+	};
+
+	struct ServeScenario
+	{
+		const char *name;
+		unsigned int clients;
+		bool oneSlot;		//OneSlotDevice instead of Device
+	};
+
+	template <class D> void serve(const ServeScenario *scenario)
+	{
+		//no hub - the device only serves here
+		D device(1);
+		device.init();
+		uint16_t port = device.getServerPort();
+
+		volatile unsigned long *counts = static_cast<volatile unsigned long *>(mmap(0, COUNT_SIZE * sizeof(unsigned long), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+		memset((void *)counts, 0, COUNT_SIZE * sizeof(unsigned long));
+
+		unsigned long long start = bench::nowNanos();
+		pid_t pids[LOAD_CLIENTS];
+		for (unsigned int c = 0; c < scenario->clients; c++)
+		{
+			pids[c] = fork();
+			if (pids[c] == 0)
+			{
+				for (unsigned long r = 0; r < REQUESTS_PER_CLIENT; r++)
+				{
+					int status = request(port, "GET /switch1%20on HTTP/1.1\r\nHOST: 127.0.0.1\r\n\r\n");
+					__sync_fetch_and_add(&counts[status == 200 ? COUNT_OK : status == 503 ? COUNT_BUSY : COUNT_OTHER], 1);
+				}
+				_exit(0);
+			}
+		}
+
+		//the device's loop, until every load client is done
+		unsigned int running = scenario->clients;
+		while (running > 0)
+		{
+			device.run();
+			while (running > 0 && waitpid(-1, NULL, WNOHANG) > 0)
+			{
+				running--;
+			}
+		}
+		double seconds = (bench::nowNanos() - start) / 1e9;
+		unsigned long total = scenario->clients * REQUESTS_PER_CLIENT;
+
+		bench::report("core", scenario->name, total / seconds, "requests/s");
+		bench::report("core", scenario->name, counts[COUNT_OK], "replies 200");
+		bench::report("core", scenario->name, counts[COUNT_BUSY], "replies 503");
+		bench::report("core", scenario->name, counts[COUNT_OTHER], "requests without a reply");
+		bench::report("core", scenario->name, callouts, "callouts");
+		bench::report("core", scenario->name, device.connections().getTimeouts(), "read timeouts");
+		if (scenario->oneSlot)
+		{
+			bench::report("core", scenario->name, device.connections().getBusy(), "connections counted busy");
+		}
+
+		//the counters on /metrics must agree with what the clients saw - served from a forked client again
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			String reply;
+			int status = request(port, "GET /metrics HTTP/1.1\r\n\r\n", &reply);
+			int at = reply.indexOf("st_http_busy ");
+			unsigned long busy = scenario->oneSlot ? device.connections().getBusy() : counts[COUNT_BUSY];
+			_exit(status == 200 && at >= 0 && strtoul(reply.c_str() + at + 13, NULL, 10) == busy ? 0 : 1);
+		}
+		int status = 0;
+		while (waitpid(pid, &status, WNOHANG) == 0)
+		{
+			device.run();
+		}
+		bench::report("core", scenario->name, WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 1 : 0, "/metrics busy count matches (1 = yes)");
+	}
+
+	void runServeScenario(void *arg)
+	{
+		const ServeScenario *scenario = static_cast<const ServeScenario *>(arg);
+		if (scenario->oneSlot)
+		{
+			serve<OneSlotDevice>(scenario);
+		}
+		else
+		{
+			serve<Device>(scenario);
+		}
+	}
+}
+
+void benchCore()
+{
+	static const SendScenario sendScenarios[] =
+	{
+		{ "send, connection per event", false, false },
+		{ "send, keep-alive", true, false },
+		{ "send, bench::HttpTransport, connection per event", false, true },
+		{ "send, bench::HttpTransport, keep-alive", true, true },
+	};
+	for (unsigned int i = 0; i < sizeof(sendScenarios) / sizeof(sendScenarios[0]); i++)
+	{
+		bench::runIsolated(runSendScenario, const_cast<SendScenario *>(&sendScenarios[i]));
+	}
+
+	static const ServeScenario serveScenarios[] =
+	{
+		{ "serve, 1 client", 1, false },
+		{ "serve, 8 clients", LOAD_CLIENTS, false },
+		{ "serve, 1 slot, 8 clients", LOAD_CLIENTS, true },
+	};
+	for (unsigned int i = 0; i < sizeof(serveScenarios) / sizeof(serveScenarios[0]); i++)
+	{
+		bench::runIsolated(runServeScenario, const_cast<ServeScenario *>(&serveScenarios[i]));
+	}
+}
@@ -0,0 +1,321 @@
+//******************************************************************************************
+//  File: bench_dht.cpp
+//
+//  Summary:  The split-phase DHT reader (dht::start()/poll()/decode() in lib/DHT) on edge
+//            traces, and PS_TemperatureHumidity polling with it.
+//
+//            The traces are the falling edges of DHT transfers built from the datasheet
+//            timing: response 80us low and 80us high, then per bit 50us low and 27us (0) or
+//            70us (1) high, every phase with up to 3us of jitter.  "WiFi latency" delays the
+//            time stamp of one edge in 8 by up to the given number of microseconds, as an
+//            interrupt routine held up by the WiFi stack would.
+//
+//            "decode": 1000 random readings per latency must decode to their own bytes, and
+//            malformed traces (a stray edge before the response, an edge missing, a glitch
+//            inside a bit, no reply) must give the right result code.
+//
+//            "poll": a DHT22 and a DHT11 on two pins, both polled every 10s by st::Everything
+//            for 10 simulated minutes.  The bench plays a transfer into the pin (through its
+//            interrupt) whenever the sensor releases the line after a wake pulse.  Reported:
+//            reads and correct values, time blocked in delay() per read, and the longest pass
+//            of st::Everything::run().  "blocking read" is the old dht::read22()/read11()
+//            for comparison: its wake delay as measured, plus the transfer it busy-waits
+//            through on a board.
+//
+//            "no interrupt": a DHT22 on a pin without an external interrupt (pin 22 of the
+//            MEGA), where the sensor falls back to the blocking read - the bench plays the
+//            transfer to its digitalRead() loop, 1us per read.  Reported as "poll".
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  A DHT22 on a pin without an interrupt
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <Everything.h>
+#include <PS_TemperatureHumidity.h>
+#include <dht.h>
+
+namespace
+{
+	const unsigned int TRACES = 1000;
+	const byte DHT22_PIN = 4;
+	const byte DHT11_PIN = 5;
+	const byte NO_INTERRUPT_PIN = 22;
+	const unsigned long POLL_MS = 600000UL;
+
+	//levels and durations (us) of one transfer, from the release of the line
+	struct Phase
+	{
+		byte level;
+		unsigned int micros;
+	};
+	const byte PHASES = 2 + 2 + 2 * 40 + 1;
+
+	unsigned int jittered(unsigned int us, unsigned long &random)
+	{
+		random = random * 1103515245UL + 12345UL;
+		return us - 3 + (unsigned int)((random >> 16) % 7);
+	}
+
+	//the waveform of a transfer of bytes[5]
+	void buildPhases(const byte *bytes, unsigned long &random, Phase *phases)
+	{
+		byte n = 0;
+		phases[n].level = HIGH; phases[n++].micros = jittered(30, random);	//released, until the sensor answers
+		phases[n].level = LOW;  phases[n++].micros = jittered(80, random);	//response
+		phases[n].level = HIGH; phases[n++].micros = jittered(80, random);
+		for (byte i = 0; i < 40; i++)
+		{
+			bool one = bytes[i / 8] & (128 >> (i % 8));
+			phases[n].level = LOW;  phases[n++].micros = jittered(50, random);
+			phases[n].level = HIGH; phases[n++].micros = jittered(one ? 70 : 27, random);
+		}
+		phases[n].level = LOW;  phases[n++].micros = jittered(50, random);	//end of the last bit
+		phases[n].level = HIGH; phases[n++].micros = 0;
+	}
+
+	//falling edges of the phases as an interrupt routine would time-stamp them
+	byte buildEdges(const Phase *phases, unsigned long &random, unsigned int latency, uint32_t *edges)
+	{
+		uint32_t t = 1000000UL;
+		byte count = 0;
+		for (byte p = 0; p < PHASES; p++)
+		{
+			if (phases[p].level == LOW)
+			{
+				random = random * 1103515245UL + 12345UL;
+				unsigned int late = latency > 0 && (random >> 16) % 8 == 0 ? (unsigned int)((random >> 20) % (latency + 1)) : 0;
+				edges[count++] = t + late;
+			}
+			t += phases[p].micros;
+		}
+		return count;
+	}
+
+	void randomReading(unsigned long &random, byte *bytes)
+	{
+		for (byte i = 0; i < 4; i++)
+		{
+			random = random * 1103515245UL + 12345UL;
+			bytes[i] = (byte)(random >> 16);
+		}
+		bytes[4] = bytes[0] + bytes[1] + bytes[2] + bytes[3];
+	}
+
+	void runDecode(void *arg)
+	{
+		static const unsigned int latencies[] = { 0, 10, 20, 30 };
+		unsigned long random = 2017;
+		Phase phases[PHASES];
+		uint32_t edges[DHTLIB_EDGE_BUFFER];
+		byte bytes[5];
+		byte bits[5];
+
+		for (unsigned int l = 0; l < sizeof(latencies) / sizeof(latencies[0]); l++)
+		{
+			unsigned long decoded = 0;
+			unsigned long long nanos = 0;
+			for (unsigned int n = 0; n < TRACES; n++)
+			{
+				randomReading(random, bytes);
+				buildPhases(bytes, random, phases);
+				byte count = buildEdges(phases, random, latencies[l], edges);
+
+				unsigned long long start = bench::nowNanos();
+				int rv = dht::decode(edges, count, bits);
+				nanos += bench::nowNanos() - start;
+				if (rv == DHTLIB_OK && memcmp(bits, bytes, 5) == 0)
+				{
+					decoded++;
+				}
+			}
+			char name[64];
+			snprintf(name, sizeof(name), "decode, WiFi latency up to %uus", latencies[l]);
+			bench::report("dht", name, decoded, "of 1000 traces decoded");
+			bench::report("dht", name, (double)nanos / TRACES, "ns per decode");
+		}
+
+		//malformed traces
+		randomReading(random, bytes);
+		buildPhases(bytes, random, phases);
+		byte count = buildEdges(phases, random, 0, edges + 1);
+		unsigned long right = 0;
+
+		edges[0] = edges[1] - 5000;		//a stray edge 5ms before the response
+		right += dht::decode(edges, count + 1, bits) == DHTLIB_OK && memcmp(bits, bytes, 5) == 0;
+		right += dht::decode(edges + 1, count - 1, bits) == DHTLIB_ERROR_TIMEOUT;		//the last edge missing
+		uint32_t saved = edges[20];
+		edges[20] = edges[19] + 20;		//a glitch inside a bit
+		right += dht::decode(edges + 1, count, bits) == DHTLIB_ERROR_SIGNAL;
+		edges[20] = saved;
+		right += dht::decode(edges + 1, 0, bits) == DHTLIB_ERROR_TIMEOUT;				//no reply
+		bench::report("dht", "decode, malformed traces", right, "of 4 with the right result");
+	}
+
+	//the sensors: bytes each one sends
+	const byte DHT22_BYTES[5] = { 0x01, 0xC8, 0x00, 0xEA, (byte)(0x01 + 0xC8 + 0x00 + 0xEA) };	//45.6%, 23.4C
+	const byte DHT11_BYTES[5] = { 45, 0, 23, 0, 45 + 23 };
+
+	//plays a transfer into pin once its line has been released after a wake pulse - true if it did
+	bool answer(byte pin, const byte *bytes, unsigned long &random)
+	{
+		if (native::getPinMode(pin) != INPUT || native::getDigitalPin(pin) != LOW)
+		{
+			return false;
+		}
+		Phase phases[PHASES];
+		buildPhases(bytes, random, phases);
+		for (byte p = 0; p < PHASES; p++)
+		{
+			native::setDigitalPin(pin, phases[p].level);
+			native::advanceMicros(phases[p].micros);
+		}
+		return true;
+	}
+
+	//plays a transfer to the blocking reader's digitalRead() loop on NO_INTERRUPT_PIN, from the
+	//first read after the line is released
+	Phase blockingPhases[PHASES];
+	bool blockingPlaying = false;
+	unsigned long blockingStart;
+	unsigned long blockingRandom = 7;
+	unsigned long blockingReads = 0;
+
+	void playToReads(uint8_t pin)
+	{
+		if (pin != NO_INTERRUPT_PIN)
+		{
+			return;
+		}
+		if (native::getPinMode(pin) != INPUT || (blockingPlaying && micros() - blockingStart > 10000UL))
+		{
+			blockingPlaying = false;	//the wake pulse, or a read long after the transfer - the next one starts
+			if (native::getPinMode(pin) != INPUT)
+			{
+				return;
+			}
+		}
+		if (!blockingPlaying)
+		{
+			buildPhases(DHT22_BYTES, blockingRandom, blockingPhases);
+			blockingPlaying = true;
+			blockingStart = micros() - 40;		//the reader waits 40us before its first read
+			blockingReads++;
+		}
+		native::advanceMicros(1);
+		unsigned long t = micros() - blockingStart;
+		byte level = HIGH;
+		for (byte p = 0; p < PHASES; p++)
+		{
+			if (t < blockingPhases[p].micros || p == PHASES - 1)
+			{
+				level = blockingPhases[p].level;
+				break;
+			}
+			t -= blockingPhases[p].micros;
+		}
+		native::setDigitalPin(pin, level);
+	}
+
+	void runNoInterrupt(void *arg)
+	{
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		native::setInterruptPin(NO_INTERRUPT_PIN, false);
+		native::setReadHook(playToReads);
+		st::PS_TemperatureHumidity dht22(F("temphumid1"), 10, 0, NO_INTERRUPT_PIN, st::PS_TemperatureHumidity::DHT22, "temperature1", "humidity1", true);
+		st::Everything::addSensor(&dht22);
+		native::setDigitalPin(NO_INTERRUPT_PIN, HIGH);
+		st::Everything::initDevices();
+		native::resetBlockedMicros();
+
+		unsigned long start = millis();
+		while (millis() - start < POLL_MS)
+		{
+			st::Everything::run();
+			native::advanceMillis(1);
+		}
+		bool correct = dht22.getTemperatureSensorValue() > 23.35 && dht22.getTemperatureSensorValue() < 23.45 && dht22.getHumiditySensorValue() > 45.55 && dht22.getHumiditySensorValue() < 45.65;
+
+		bench::report("dht", "poll, DHT22 on a pin without an interrupt", blockingReads, "reads");
+		bench::report("dht", "poll, DHT22 on a pin without an interrupt", correct ? 1 : 0, "right values (1 = yes)");
+		bench::report("dht", "poll, DHT22 on a pin without an interrupt", transport.sent, "messages sent");
+		bench::report("dht", "poll, DHT22 on a pin without an interrupt", blockingReads ? native::blockedMicros() / 1000.0 / blockingReads : 0, "ms blocked in delay() per read");
+	}
+
+	void runPoll(void *arg)
+	{
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::PS_TemperatureHumidity dht22(F("temphumid1"), 10, 0, DHT22_PIN, st::PS_TemperatureHumidity::DHT22, "temperature1", "humidity1", true);
+		st::PS_TemperatureHumidity dht11(F("temphumid2"), 10, 0, DHT11_PIN, st::PS_TemperatureHumidity::DHT11, "temperature2", "humidity2", true);
+		st::Everything::addSensor(&dht22);
+		st::Everything::addSensor(&dht11);
+		native::setDigitalPin(DHT22_PIN, HIGH);
+		native::setDigitalPin(DHT11_PIN, HIGH);
+		st::Everything::initDevices();
+		native::resetBlockedMicros();
+
+		unsigned long random = 42;
+		unsigned long reads = 0;
+		unsigned long correct = 0;
+		unsigned long long longest = 0;
+		unsigned long start = millis();
+		while (millis() - start < POLL_MS)
+		{
+			unsigned long long pass = bench::nowNanos();
+			st::Everything::run();
+			pass = bench::nowNanos() - pass;
+			if (pass > longest)
+			{
+				longest = pass;
+			}
+			reads += answer(DHT22_PIN, DHT22_BYTES, random);
+			reads += answer(DHT11_PIN, DHT11_BYTES, random);
+			native::advanceMillis(1);
+		}
+		correct += dht22.getTemperatureSensorValue() > 23.35 && dht22.getTemperatureSensorValue() < 23.45 && dht22.getHumiditySensorValue() > 45.55 && dht22.getHumiditySensorValue() < 45.65;
+		correct += dht11.getTemperatureSensorValue() == 23 && dht11.getHumiditySensorValue() == 45;
+
+		bench::report("dht", "poll, DHT22 + DHT11", reads, "reads");
+		bench::report("dht", "poll, DHT22 + DHT11", correct, "of 2 sensors with the right values");
+		bench::report("dht", "poll, DHT22 + DHT11", transport.sent, "messages sent");
+		bench::report("dht", "poll, DHT22 + DHT11", reads ? native::blockedMicros() / 1000.0 / reads : 0, "ms blocked in delay() per read");
+		bench::report("dht", "poll, DHT22 + DHT11", longest / 1000.0, "us longest run() pass");
+
+		//the blocking reader, for comparison - nothing answers here, so it gives up after the wake pulse
+		Phase phases[PHASES];
+		buildPhases(DHT22_BYTES, random, phases);
+		unsigned long transfer = 0;
+		for (byte p = 0; p < PHASES; p++)
+		{
+			transfer += phases[p].micros;
+		}
+		dht blocking;
+		native::resetBlockedMicros();
+		blocking.read22(DHT22_PIN);
+		bench::report("dht", "blocking read, DHT22", (native::blockedMicros() + transfer) / 1000.0, "ms blocked per read");
+		native::resetBlockedMicros();
+		blocking.read11(DHT11_PIN);
+		bench::report("dht", "blocking read, DHT11", (native::blockedMicros() + transfer) / 1000.0, "ms blocked per read");
+	}
+}
+
+void benchDht()
+{
+	bench::runIsolated(runDecode, NULL);
+	bench::runIsolated(runPoll, NULL);
+	bench::runIsolated(runNoInterrupt, NULL);
+}
@@ -0,0 +1,143 @@
+//******************************************************************************************
+//  File: bench_dispatch.cpp
+//
+//  Summary:  Cost of dispatching one hub command to its device at 50 devices (30 sensors,
+//            20 executors - the MAX_SENSOR_COUNT / MAX_EXECUTOR_COUNT limit).
+//
+//            The devices do nothing in beSmart(), so only the dispatch is measured.  The
+//            commands cycle through every device name, plus one unknown name.
+//
+//            "legacy lookup" is a copy of the old getDeviceByName(): substring() of the
+//            name token, then a linear scan building getName() Strings.  "index lookup" is
+//            st::Everything::getDeviceByName() on the token in place, and "receiveSmartString()"
+//            is the whole path a command from the hub takes.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <Constants.h>
+#include <Everything.h>
+
+namespace
+{
+	const unsigned int SENSORS = st::Constants::MAX_SENSOR_COUNT;
+	const unsigned int EXECUTORS = st::Constants::MAX_EXECUTOR_COUNT;
+	const unsigned int DEVICES = SENSORS + EXECUTORS;
+	const unsigned long DISPATCH_ITERATIONS = 200000;
+
+	const char *const sensorKinds[] = { "temperature", "humidity", "contact", "motion", "illuminance", "water" };
+	const char *const executorKinds[] = { "switch", "dimmerSwitch", "alarm", "rgbSwitch" };
+
+	unsigned long beSmartCalls = 0;
+
+	class IdleSensor: public st::Sensor
+	{
+		public:
+			IdleSensor(const __FlashStringHelper *name) : Sensor(name) {}
+			virtual void init() {}
+			virtual void update() {}
+			virtual void beSmart(const String &str) { beSmartCalls++; }
+	};
+
+	class IdleExecutor: public st::Executor
+	{
+		public:
+			IdleExecutor(const __FlashStringHelper *name) : Executor(name) {}
+			virtual void init() {}
+			virtual void beSmart(const String &str) { beSmartCalls++; }
+	};
+
+	st::Device *devices[DEVICES];
+
+	//the getDeviceByName() lookup this index replaced, including receiveSmartString()'s substring()
+	st::Device *legacyLookup(const String &message)
+	{
+		String name = message.substring(0, message.indexOf(' '));
+		for (unsigned int i = 0; i < DEVICES; i++)
+		{
+			if (devices[i]->getName() == name)
+				return devices[i];
+		}
+		return 0;
+	}
+
+	void runDispatch(void *)
+	{
+		bench::NullTransport transport(st::receiveSmartString);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			IdleSensor *s = new IdleSensor(bench::deviceName(sensorKinds[i % 6], i / 6 + 1));
+			devices[i] = s;
+			st::Everything::addSensor(s);
+		}
+		for (unsigned int i = 0; i < EXECUTORS; i++)
+		{
+			IdleExecutor *e = new IdleExecutor(bench::deviceName(executorKinds[i % 4], i / 4 + 1));
+			devices[SENSORS + i] = e;
+			st::Everything::addExecutor(e);
+		}
+		st::Everything::initDevices();
+
+		//one command per device, plus one for a device that does not exist
+		String commands[DEVICES + 1];
+		for (unsigned int i = 0; i < DEVICES; i++)
+		{
+			commands[i] = devices[i]->getName() + F(" on");
+		}
+		commands[DEVICES] = F("unknown7 on");
+
+		unsigned long found = 0;
+		unsigned long long t0 = bench::nowNanos();
+		for (unsigned long i = 0; i < DISPATCH_ITERATIONS; i++)
+		{
+			found += legacyLookup(commands[i % (DEVICES + 1)]) != 0;
+		}
+		unsigned long long legacy = bench::nowNanos() - t0;
+		unsigned long legacyFound = found;
+
+		found = 0;
+		t0 = bench::nowNanos();
+		for (unsigned long i = 0; i < DISPATCH_ITERATIONS; i++)
+		{
+			const String &command = commands[i % (DEVICES + 1)];
+			int space = command.indexOf(' ');
+			found += st::Everything::getDeviceByName(command.c_str(), space) != 0;
+		}
+		unsigned long long indexed = bench::nowNanos() - t0;
+
+		t0 = bench::nowNanos();
+		for (unsigned long i = 0; i < DISPATCH_ITERATIONS; i++)
+		{
+			st::receiveSmartString(commands[i % (DEVICES + 1)]);
+		}
+		unsigned long long received = bench::nowNanos() - t0;
+
+		if (found != legacyFound || beSmartCalls != found)
+		{
+			fprintf(stderr, "dispatch: lookups disagree (legacy %lu, index %lu, beSmart %lu)\n", legacyFound, found, beSmartCalls);
+			_exit(1);
+		}
+
+		bench::report("dispatch", "legacy lookup 50 devices", (double)legacy / DISPATCH_ITERATIONS, "ns/command");
+		bench::report("dispatch", "index lookup 50 devices", (double)indexed / DISPATCH_ITERATIONS, "ns/command");
+		bench::report("dispatch", "receiveSmartString() 50 devices", (double)received / DISPATCH_ITERATIONS, "ns/command");
+	}
+}
+
+void benchDispatch()
+{
+	bench::runIsolated(runDispatch, 0);
+}
@@ -0,0 +1,334 @@
+//******************************************************************************************
+//  File: bench_ds18b20.cpp
+//
+//  Summary:  PS_DS18B20_Temperature with eight probes on one pin, and twenty on three pins, on
+//            the simulated 1-Wire buses of the stand-in OneWire and DallasTemperature libraries
+//            (bench/onewire), where every bus transaction costs its 1-Wire time in
+//            delayMicroseconds().
+//
+//            "blocking getData()" is the bus work of the old getData(): requestTemperatures()
+//            waiting for the conversion, then getTempCByIndex() for each probe, which searches
+//            the bus from the start up to that probe.  "blocking init()" adds the old init():
+//            begin(), setResolution(), a conversion and delay(500).
+//
+//            "poll": the sensor as it is now, polled every 30s by st::Everything for 10
+//            simulated minutes at 10 bits (the default) and 12 bits.  Reported: conversions,
+//            values received that match the probe (in ROM order, quantized to the resolution),
+//            time blocked on the bus and in delay() per conversion and in init(), and the
+//            longest pass of st::Everything::run() in simulated time.  "20 probes on 3 pins"
+//            is one sensor with a bus per pin, all converting at once, against the old blocking
+//            getData() with the 20 probes on one pin.  "1 missing": the last probe is taken away
+//            after init() - it is sent as -99.0, and searched for at most once every
+//            PS_DS18B20_SEARCH_BACKOFF conversions, one ROM code per loop pass.
+//
+//            "names": eight probes, then probe 4 taken away and a new one whose ROM code comes
+//            first in the search order, then a reset with the same probes, the ProbeTable kept in
+//            a simulated flash record across the resets.  Reported: names of the seven probes
+//            that stayed which moved - numbered in search order (the old getTempCByIndex())
+//            and by ROM code - and the flash writes of each start.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  20 probes on 3 pins, and names across a probe change and resets
+//    2026-10-17  Per Ivar Nerseth  A probe missing after init()
+//    2026-10-17  Per Ivar Nerseth  The search for the missing probe is spread over loop passes
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Everything.h>
+#include <PS_DS18B20_Temperature.h>
+
+namespace
+{
+	const byte PIN = 13;
+	const byte PROBES = 8;
+	const byte MANY_PINS[] = { 12, 13, 14 };
+	const byte MANY_PROBES = 20;
+	const unsigned long POLL_MS = 600000UL;
+
+	struct Setup
+	{
+		byte resolution;
+		byte probes;			//spread over the pins, in turn by blocks
+		byte pins;				//1: PIN, 3: MANY_PINS
+		bool missing;			//the last probe taken away after init()
+	};
+
+	//a probe's temperature - what its scratchpad holds at any resolution
+	float celsius(byte index)
+	{
+		return 18.0 + 1.25 * index;
+	}
+
+	//DS18B20 ROM codes (family 0x28), in ascending order
+	void probeRom(byte index, uint8_t *rom)
+	{
+		uint8_t code[8] = { 0x28, (uint8_t)(0x10 + index * 0x09), 0x3C, 0x01, 0xB5, 0x16, 0x00, 0 };
+		code[7] = OneWire::crc8(code, 7);
+		memcpy(rom, code, 8);
+	}
+
+	//the probes in blocks, one block per pin - probe i is number i+1 at the first start
+	void addProbes(const Setup &setup)
+	{
+		OneWire::clearProbes();
+		const byte *pins = setup.pins == 1 ? &PIN : MANY_PINS;
+		byte perPin = (setup.probes + setup.pins - 1) / setup.pins;
+		for (byte i = 0; i < setup.probes; i++)
+		{
+			uint8_t rom[8];
+			probeRom(i, rom);
+			OneWire::addProbe(pins[i / perPin], rom, celsius(i));
+		}
+	}
+
+	//counts the values sent that match their probe
+	class Transport: public bench::NullTransport
+	{
+		public:
+			unsigned long values;
+			unsigned long matching;
+			byte probes;
+
+			Transport(byte n) : NullTransport(st::receiveSmartString, 0), values(0), matching(0), probes(n) {}
+
+			virtual void send(String message)
+			{
+				NullTransport::send(message);
+				unsigned int index;
+				float value;
+				if (sscanf(message.c_str(), "temperature%u %f", &index, &value) == 2 && index >= 1 && index <= probes)
+				{
+					values++;
+					matching += value == celsius(index - 1);
+				}
+			}
+	};
+
+	void runBlocking(void *arg)
+	{
+		const Setup &setup = *static_cast<Setup *>(arg);
+		char name[64];
+		Setup onePin = { setup.resolution, setup.probes, 1, false };
+		addProbes(onePin);
+
+		OneWire bus(PIN);
+		DallasTemperature ds18b20(&bus);
+		native::resetBlockedMicros();
+		ds18b20.begin();
+		ds18b20.setResolution(setup.resolution);
+		ds18b20.requestTemperatures();
+		delay(500);
+		unsigned long long initMicros = native::blockedMicros();
+
+		native::resetBlockedMicros();
+		ds18b20.requestTemperatures();
+		unsigned long matching = 0;
+		for (byte i = 0; i < setup.probes; i++)
+		{
+			matching += ds18b20.getTempCByIndex(i) == celsius(i);
+		}
+		unsigned long long pollMicros = native::blockedMicros();
+
+		snprintf(name, sizeof(name), "blocking, %u probes on 1 pin, %u bits", setup.probes, setup.resolution);
+		bench::report("ds18b20", name, initMicros / 1000.0 + pollMicros / 1000.0, "ms blocked in init()");
+		bench::report("ds18b20", name, pollMicros / 1000.0, "ms blocked per getData()");
+		bench::report("ds18b20", name, matching, "values that match their probe");
+	}
+
+	void runPoll(void *arg)
+	{
+		const Setup &setup = *static_cast<Setup *>(arg);
+		char name[64];
+		snprintf(name, sizeof(name), "poll, %u probes on %u pin%s, %u bits%s", setup.probes, setup.pins, setup.pins > 1 ? "s" : "", setup.resolution, setup.missing ? ", 1 missing" : "");
+		addProbes(setup);
+
+		Transport transport(setup.probes);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::PS_DS18B20_Temperature *sensor;
+		if (setup.pins == 1)
+		{
+			sensor = new st::PS_DS18B20_Temperature(F("temperature"), 30, 0, PIN, true, setup.resolution, setup.probes);
+		}
+		else
+		{
+			sensor = new st::PS_DS18B20_Temperature(F("temperature"), 30, 0, MANY_PINS, setup.pins, true, setup.resolution, setup.probes);
+		}
+		st::Everything::addSensor(sensor);
+		native::resetBlockedMicros();
+		st::Everything::initDevices();
+		unsigned long long initMicros = native::blockedMicros();
+		if (setup.missing)
+		{
+			uint8_t rom[8];
+			probeRom(setup.probes - 1, rom);
+			OneWire::removeProbe(rom);
+		}
+		native::resetBlockedMicros();
+
+		unsigned long longest = 0;
+		unsigned long start = millis();
+		while (millis() - start < POLL_MS)
+		{
+			unsigned long pass = micros();
+			st::Everything::run();
+			pass = micros() - pass;
+			if (pass > longest)
+			{
+				longest = pass;
+			}
+			native::advanceMillis(1);
+		}
+		unsigned long conversions = transport.values / setup.probes;
+
+		bench::report("ds18b20", name, conversions, "conversions");
+		bench::report("ds18b20", name, transport.matching, "values that match their probe");
+		bench::report("ds18b20", name, initMicros / 1000.0, "ms blocked in init()");
+		bench::report("ds18b20", name, conversions ? native::blockedMicros() / 1000.0 / conversions : 0, "ms blocked per conversion");
+		bench::report("ds18b20", name, longest / 1000.0, "ms longest run() pass");
+	}
+
+	//the flash record of a ProbeTable, kept across the simulated resets
+	class SimulatedFlash: public st::ProbeTableStorage
+	{
+		public:
+			byte record[256];
+			size_t length;
+			unsigned long writes;
+
+			SimulatedFlash() : length(0), writes(0) {}
+
+			virtual size_t load(void *data, size_t size)
+			{
+				size_t bytes = length < size ? length : size;
+				memcpy(data, record, bytes);
+				return bytes;
+			}
+
+			virtual bool save(const void *data, size_t size)
+			{
+				if (size > sizeof(record))
+				{
+					return false;
+				}
+				memcpy(record, data, size);
+				length = size;
+				writes++;
+				return true;
+			}
+	};
+
+	//number (1..) of the probe in the search order of PIN, as getTempCByIndex() counted
+	int searchNumber(const uint8_t *rom)
+	{
+		OneWire bus(PIN);
+		uint8_t addr[8];
+		bus.reset_search();
+		for (int number = 1; bus.search(addr); number++)
+		{
+			if (memcmp(addr, rom, 8) == 0)
+			{
+				return number;
+			}
+		}
+		return 0;
+	}
+
+	//one start of the sensor with the probes now on PIN - ROM-keyed number of each probe
+	unsigned long start(SimulatedFlash &flash, int *numbers, byte count)
+	{
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::PS_DS18B20_Temperature sensor(F("temperature"), 30, 0, PIN, true, 10, PROBES);
+		sensor.setProbeStorage(&flash);
+		unsigned long writes = flash.writes;
+		sensor.init();
+		for (byte i = 0; i < count; i++)
+		{
+			uint8_t rom[8];
+			probeRom(i, rom);
+			numbers[i] = sensor.getProbes().slotOf(rom) + 1;
+		}
+		return flash.writes - writes;
+	}
+
+	void runNames(void *arg)
+	{
+		Setup setup = { 10, PROBES, 1, false };
+		SimulatedFlash flash;
+		int byRom[PROBES], bySearch[PROBES];
+		int byRomAfter[PROBES], bySearchAfter[PROBES];
+		const byte gone = 3;
+
+		addProbes(setup);
+		unsigned long firstWrites = start(flash, byRom, PROBES);
+		for (byte i = 0; i < PROBES; i++)
+		{
+			uint8_t rom[8];
+			probeRom(i, rom);
+			bySearch[i] = searchNumber(rom);
+		}
+
+		//probe 4 replaced by one that comes first in the search order
+		uint8_t rom[8];
+		probeRom(gone, rom);
+		OneWire::removeProbe(rom);
+		uint8_t added[8] = { 0x28, 0x01, 0x3C, 0x01, 0xB5, 0x16, 0x00, 0 };
+		added[7] = OneWire::crc8(added, 7);
+		OneWire::addProbe(PIN, added, celsius(PROBES));
+		unsigned long changeWrites = start(flash, byRomAfter, PROBES);
+		for (byte i = 0; i < PROBES; i++)
+		{
+			probeRom(i, rom);
+			bySearchAfter[i] = searchNumber(rom);
+		}
+
+		int unchanged[PROBES];
+		unsigned long resetWrites = start(flash, unchanged, PROBES);
+
+		unsigned long movedSearch = 0, movedRom = 0, movedReset = 0;
+		for (byte i = 0; i < PROBES; i++)
+		{
+			if (i == gone)
+			{
+				continue;
+			}
+			movedSearch += bySearch[i] != bySearchAfter[i];
+			movedRom += byRom[i] != byRomAfter[i];
+			movedReset += unchanged[i] != byRomAfter[i];
+		}
+
+		bench::report("ds18b20", "names, probe 4 replaced", movedSearch, "of 7 names moved, in search order");
+		bench::report("ds18b20", "names, probe 4 replaced", movedRom, "of 7 names moved, by ROM code");
+		bench::report("ds18b20", "names, flash writes", firstWrites, "first start");
+		bench::report("ds18b20", "names, flash writes", changeWrites, "start after the change");
+		bench::report("ds18b20", "names, flash writes", resetWrites, "start with the same probes");
+		bench::report("ds18b20", "names, reset with the same probes", movedReset, "of 7 names moved");
+	}
+}
+
+void benchDs18b20()
+{
+	static Setup setups[] = { { 10, PROBES, 1, false }, { 12, PROBES, 1, false }, { 12, MANY_PROBES, 3, false } };
+	for (unsigned int i = 0; i < sizeof(setups) / sizeof(setups[0]); i++)
+	{
+		bench::runIsolated(runBlocking, &setups[i]);
+		bench::runIsolated(runPoll, &setups[i]);
+	}
+	static Setup missing = { 10, PROBES, 1, true };
+	bench::runIsolated(runPoll, &missing);
+	bench::runIsolated(runNames, NULL);
+}
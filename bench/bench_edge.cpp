@@ -0,0 +1,196 @@
+//******************************************************************************************
+//  File: bench_edge.cpp
+//
+//  Summary:  Interrupt sensor debounce under loop load.
+//
+//            A button (active LOW, as IS_Button) is pressed for a random 30 to 300ms every
+//            0.8 to 2.8s for 10 simulated minutes.  Each press and each release bounces for
+//            2ms: 3 edges, or 11 in "11 bounce edges" - more than the 7 an EdgeCapture ring
+//            holds, so a 9ms pass or a stall over a press and its release fills the ring.
+//            Each pass of the loop takes a random 1 to 9ms, and every 7s one pass stalls
+//            for 500ms, as a blocking network call would.
+//
+//            "polled" debounces by counting update() calls (numReqCounts, 500 in the example
+//            sketches), "edge" uses InterruptSensor::enableEdgeCapture() with a 5ms debounce.
+//
+//            Reported: share of presses detected, latency from the press to runInterrupt(),
+//            and how far getEventMillis() is from the time of the press.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Bounces with more edges than the ring holds
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <InterruptSensor.h>
+
+namespace
+{
+	const byte PIN = 5;
+	const unsigned long SIMULATED_MS = 600000UL;
+	const unsigned long STALL_EVERY_MS = 7000;
+	const unsigned long STALL_MS = 500;
+	const unsigned long BOUNCE_MICROS = 2000;
+	const unsigned int MAX_PRESSES = 1000;
+	const unsigned int MAX_BOUNCE_EDGES = 11;
+
+	struct Scenario
+	{
+		const char *name;
+		long numReqCounts;
+		unsigned long debounceMicros;	//0 == polled mode
+		unsigned int bounceEdges;		//edges of each press and each release - odd, at most MAX_BOUNCE_EDGES
+	};
+
+	unsigned long pressMillis[MAX_PRESSES];	//millis() of the first edge of each press
+	unsigned int pressCount;
+
+	class RecordingSensor: public st::InterruptSensor
+	{
+		public:
+			unsigned long detected;
+			unsigned long totalLatency;
+			unsigned long worstLatency;
+			long totalEventError;
+
+			RecordingSensor(long numReqCounts) :
+				InterruptSensor(F("button1"), PIN, LOW, true, numReqCounts),
+				detected(0),
+				totalLatency(0),
+				worstLatency(0),
+				totalEventError(0)
+			{
+			}
+
+			virtual void runInterrupt()
+			{
+				if (pressCount == 0)
+				{
+					return;
+				}
+				unsigned long pressed = pressMillis[pressCount - 1];
+				unsigned long latency = millis() - pressed;
+				detected++;
+				totalLatency += latency;
+				if (latency > worstLatency)
+				{
+					worstLatency = latency;
+				}
+				totalEventError += (long)(getEventMillis() - pressed);
+			}
+
+			virtual void runInterruptEnded() {}
+	};
+
+	void runEdgeScenario(void *arg)
+	{
+		const Scenario *scenario = static_cast<const Scenario *>(arg);
+
+		native::setDigitalPin(PIN, HIGH);
+		RecordingSensor sensor(scenario->numReqCounts);
+		if (scenario->debounceMicros)
+		{
+			sensor.enableEdgeCapture(scenario->debounceMicros);
+		}
+		sensor.init();
+		for (int i = 0; i < 1000; i++)
+		{
+			sensor.update();	//settle the released state
+		}
+
+		//pin edges in micros, relative to start: press at t, bounce, release at t + length, bounce
+		const unsigned int perPress = 2 * scenario->bounceEdges;
+		static unsigned long edges[MAX_PRESSES * 2 * MAX_BOUNCE_EDGES];
+		static byte levels[MAX_PRESSES * 2 * MAX_BOUNCE_EDGES];
+		unsigned int edgeCount = 0;
+		unsigned long random = 4242;
+		unsigned long t = 1000;
+		while (edgeCount + perPress <= MAX_PRESSES * perPress)
+		{
+			random = random * 1103515245UL + 12345UL;
+			unsigned long length = 30 + (random >> 16) % 271;
+			random = random * 1103515245UL + 12345UL;
+			unsigned long gap = 800 + (random >> 16) % 2001;
+			if (t + length + gap >= SIMULATED_MS)
+			{
+				break;
+			}
+			for (unsigned int i = 0; i < perPress; i++)
+			{
+				unsigned int bounce = i % scenario->bounceEdges;
+				unsigned long start = i < scenario->bounceEdges ? t : t + length;
+				edges[edgeCount] = start * 1000 + bounce * BOUNCE_MICROS / (scenario->bounceEdges - 1);
+				levels[edgeCount] = (i < scenario->bounceEdges) == (bounce % 2 == 0) ? LOW : HIGH;
+				edgeCount++;
+			}
+			t += length + gap;
+		}
+
+		unsigned long elapsed = 0;
+		unsigned int nextEdge = 0;
+		unsigned long nextStall = STALL_EVERY_MS;
+		pressCount = 0;
+		while (elapsed < SIMULATED_MS)
+		{
+			sensor.update();
+
+			random = random * 1103515245UL + 12345UL;
+			unsigned long pass = 1 + (random >> 16) % 9;
+			if (elapsed + pass >= nextStall)
+			{
+				pass += STALL_MS;
+				nextStall += STALL_EVERY_MS;
+			}
+
+			//the pin changes while the rest of the loop runs
+			unsigned long passEnd = elapsed + pass;
+			unsigned long elapsedMicros = elapsed * 1000;
+			while (nextEdge < edgeCount && edges[nextEdge] <= passEnd * 1000)
+			{
+				native::advanceMicros(edges[nextEdge] - elapsedMicros);
+				elapsedMicros = edges[nextEdge];
+				if (nextEdge % perPress == 0)
+				{
+					pressMillis[pressCount++] = millis();
+				}
+				native::setDigitalPin(PIN, levels[nextEdge]);
+				nextEdge++;
+			}
+			native::advanceMicros(passEnd * 1000 - elapsedMicros);
+			elapsed = passEnd;
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%s presses detected", scenario->name);
+		bench::report("edge", name, 100.0 * sensor.detected / pressCount, "%");
+		snprintf(name, sizeof(name), "%s mean latency", scenario->name);
+		bench::report("edge", name, sensor.detected ? (double)sensor.totalLatency / sensor.detected : 0.0, "ms");
+		snprintf(name, sizeof(name), "%s worst latency", scenario->name);
+		bench::report("edge", name, sensor.worstLatency, "ms");
+		snprintf(name, sizeof(name), "%s mean getEventMillis() error", scenario->name);
+		bench::report("edge", name, sensor.detected ? (double)sensor.totalEventError / sensor.detected : 0.0, "ms");
+	}
+}
+
+void benchEdge()
+{
+	static const Scenario scenarios[] =
+	{
+		{ "polled 500 counts", 500, 0, 3 },
+		{ "polled 20 counts", 20, 0, 3 },
+		{ "edge 5ms", 0, 5000, 3 },
+		{ "edge 5ms, 11 bounce edges", 0, 5000, 11 },
+	};
+
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runEdgeScenario, const_cast<Scenario *>(&scenarios[i]));
+	}
+}
@@ -0,0 +1,392 @@
+//******************************************************************************************
+//  File: bench_http.cpp
+//
+//  Summary:  st::HttpRequestParser, which the server transports use to read the Hub's
+//            requests.
+//
+//            Fuzz: 200000 generated requests - commands with percent escapes and unescaped
+//            spaces, a query or none, random headers, the command in the path or in a POST
+//            body - arrive through a stand-in client in random segments.  The command must
+//            match the one generated, and feeding the same bytes in one piece or one byte
+//            at a time must give the same result.  Then 200000 mutated requests (bytes
+//            flipped, dropped or cut short) and 200000 of random bytes must never leave the
+//            parser with a path or body outside its buffer.
+//
+//            Throughput: a typical Hub request (98 bytes) parsed by the old char-by-char
+//            String loop of SmartThingsESP8266WiFi::run() and by the parser, byte by byte and
+//            in bulk.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#include <HttpRequestParser.h>
+
+namespace
+{
+	const unsigned long FUZZ_REQUESTS = 200000UL;
+	const unsigned long THROUGHPUT_REQUESTS = 200000UL;
+
+	const char TYPICAL_REQUEST[] =
+		"POST /switch1%20on? HTTP/1.1\r\n"
+		"Accept: */*\r\n"
+		"User-Agent: Linux UPnP/1.0 SmartThings\r\n"
+		"HOST: 192.168.1.226:8090\r\n"
+		"\r\n";
+
+	unsigned long random32(unsigned long &seed)
+	{
+		seed = seed * 1103515245UL + 12345UL;
+		return (seed >> 8) & 0xFFFFFF;
+	}
+
+	//hands out its data in random segments, as a TCP stack would
+	class StandInClient
+	{
+		public:
+			StandInClient(const std::string &data, unsigned long &seed) : m_Data(data), m_nPos(0), m_Seed(seed) {}
+
+			int available()
+			{
+				if (m_nPos >= m_Data.size())
+				{
+					return 0;
+				}
+				return 1 + random32(m_Seed) % (m_Data.size() - m_nPos);
+			}
+
+			int read(uint8_t *buf, size_t size)
+			{
+				size_t count = m_Data.size() - m_nPos < size ? m_Data.size() - m_nPos : size;
+				memcpy(buf, m_Data.data() + m_nPos, count);
+				m_nPos += count;
+				return count;
+			}
+
+		private:
+			const std::string &m_Data;
+			size_t m_nPos;
+			unsigned long &m_Seed;
+	};
+
+	//what a finished parse left behind - compared between the ways of feeding it
+	std::string outcome(const st::HttpRequestParser &parser)
+	{
+		char head[32];
+		snprintf(head, sizeof(head), "%d/%d/%d|", parser.getState(), parser.getError(), parser.keepAlive());
+		std::string result(head);
+		if (parser.complete())
+		{
+			result += parser.getMethod();
+			result += '|';
+			result += std::string(parser.getPath(), parser.getPathLength());
+			result += '|';
+			result += std::string(parser.getBody(), parser.getBodyLength());
+		}
+		return result;
+	}
+
+	//path and body must lie inside the buffer and end with a 0
+	bool sane(const st::HttpRequestParser &parser)
+	{
+		if (!parser.complete())
+		{
+			return true;
+		}
+		const char *base = parser.getMethod();
+		const char *path = parser.getPath();
+		const char *body = parser.getBody();
+		return path >= base && path + parser.getPathLength() < base + HTTP_REQUEST_BUFFER_SIZE && path[parser.getPathLength()] == 0
+			&& body >= base && body + parser.getBodyLength() < base + HTTP_REQUEST_BUFFER_SIZE && body[parser.getBodyLength()] == 0
+			&& strlen(path) == parser.getPathLength();
+	}
+
+	//a request with a known command: returns the request, command gets what the callout should see
+	std::string generateRequest(unsigned long &seed, std::string &command)
+	{
+		static const char *const devices[] = { "switch1", "dimmerSwitch2", "alarm1", "relaySwitch3", "doorControl1" };
+		static const char *const values[] = { "on", "off", "50", "both", "push", "refresh" };
+
+		command = devices[random32(seed) % 5];
+		if (random32(seed) % 8 != 0)
+		{
+			command += ' ';
+			command += values[random32(seed) % 6];
+		}
+		if (random32(seed) % 4 == 0)
+		{
+			command += " 100%/x&y";		//characters that have to be escaped
+		}
+
+		bool inBody = random32(seed) % 4 == 0;
+		std::string escaped;
+		for (size_t i = 0; i < command.size(); i++)
+		{
+			char c = command[i];
+			unsigned long how = random32(seed) % 3;
+			if (c == ' ' && how == 0 && !inBody)
+			{
+				escaped += ' ';				//unescaped, as the SmartThings Hub sends it
+			}
+			else if (c == ' ' || c == '%' || c == '?' || (how == 1 && !inBody))
+			{
+				char hex[4];
+				snprintf(hex, sizeof(hex), random32(seed) % 2 ? "%%%02X" : "%%%02x", (unsigned char)c);
+				escaped += hex;
+			}
+			else
+			{
+				escaped += c;
+			}
+		}
+
+		std::string request = inBody ? "POST /" : (random32(seed) % 2 ? "POST /" : "GET /");
+		if (!inBody)
+		{
+			request += escaped;
+			if (random32(seed) % 2)
+			{
+				request += "?t=12&v=a%20b";
+			}
+			else if (random32(seed) % 2)
+			{
+				request += '?';
+			}
+		}
+		request += random32(seed) % 5 ? " HTTP/1.1\r\n" : " HTTP/1.0\n";
+
+		unsigned long headers = random32(seed) % 6;
+		for (unsigned long h = 0; h < headers; h++)
+		{
+			request += "X-Header-";
+			request += (char)('a' + h);
+			request += ": ";
+			request.append(random32(seed) % 300, 'v');	//longer than the buffer, sometimes
+			request += "\r\n";
+		}
+		if (inBody)
+		{
+			std::string body = command;
+			if (random32(seed) % 2)
+			{
+				body += "\r\n";
+			}
+			char length[48];
+			snprintf(length, sizeof(length), random32(seed) % 2 ? "Content-Length: %u\r\n" : "content-length:%u\r\n", (unsigned)body.size());
+			request += length;
+			request += "\r\n";
+			request += body;
+		}
+		else
+		{
+			request += "\r\n";
+		}
+		return request;
+	}
+
+	std::string mutate(const std::string &request, unsigned long &seed)
+	{
+		std::string result = request;
+		unsigned long edits = 1 + random32(seed) % 4;
+		for (unsigned long e = 0; e < edits && !result.empty(); e++)
+		{
+			size_t at = random32(seed) % result.size();
+			switch (random32(seed) % 4)
+			{
+				case 0: result[at] = (char)random32(seed); break;
+				case 1: result.erase(at, 1); break;
+				case 2: result.insert(at, 1, "%\r\n ?/:0"[random32(seed) % 8]); break;
+				default: result.resize(at); break;
+			}
+		}
+		return result;
+	}
+
+	void parseWhole(st::HttpRequestParser &parser, const std::string &data)
+	{
+		parser.reset();
+		parser.feed(data.data(), data.size());
+	}
+
+	void parseBytewise(st::HttpRequestParser &parser, const std::string &data)
+	{
+		parser.reset();
+		for (size_t i = 0; i < data.size() && !parser.done(); i++)
+		{
+			parser.feed(data.data() + i, 1);
+		}
+	}
+
+	void runFuzz(void *)
+	{
+		st::HttpRequestParser whole;
+		st::HttpRequestParser bytewise;
+		st::HttpRequestParser segmented;
+		unsigned long seed = 20261016UL;
+		unsigned long wrong = 0;
+		unsigned long inconsistent = 0;
+		unsigned long insane = 0;
+		unsigned long failed = 0;
+
+		for (unsigned long n = 0; n < FUZZ_REQUESTS; n++)
+		{
+			std::string command;
+			std::string request = generateRequest(seed, command);
+			StandInClient client(request, seed);
+			segmented.reset();
+			while (!segmented.done() && client.available())
+			{
+				segmented.read(client);
+			}
+			parseWhole(whole, request);
+
+			if (!segmented.complete())
+			{
+				failed++;
+			}
+			else if (std::string(segmented.command(), segmented.commandLength()) != command)
+			{
+				wrong++;
+			}
+			if (outcome(segmented) != outcome(whole))
+			{
+				inconsistent++;
+			}
+		}
+		bench::report("http", "fuzz generated requests", FUZZ_REQUESTS, "requests");
+		bench::report("http", "fuzz generated not completed", failed, "requests");
+		bench::report("http", "fuzz generated wrong command", wrong, "requests");
+
+		unsigned long mutated[3] = {0, 0, 0};	//complete, failed, incomplete
+		for (unsigned long n = 0; n < 2 * FUZZ_REQUESTS; n++)
+		{
+			std::string command;
+			std::string data;
+			if (n < FUZZ_REQUESTS)
+			{
+				data = mutate(generateRequest(seed, command), seed);
+			}
+			else
+			{
+				data.resize(random32(seed) % 400);
+				for (size_t i = 0; i < data.size(); i++)
+				{
+					data[i] = random32(seed) % 4 ? (char)random32(seed) : "\r\n %/?:"[random32(seed) % 7];
+				}
+			}
+			parseWhole(whole, data);
+			parseBytewise(bytewise, data);
+			if (!sane(whole) || !sane(bytewise))
+			{
+				insane++;
+			}
+			if (outcome(whole) != outcome(bytewise))
+			{
+				inconsistent++;
+			}
+			mutated[whole.complete() ? 0 : whole.getState() == st::HttpRequestParser::FAILED ? 1 : 2]++;
+		}
+		bench::report("http", "fuzz mutated/random requests", 2 * FUZZ_REQUESTS, "requests");
+		bench::report("http", "fuzz mutated/random complete", mutated[0], "requests");
+		bench::report("http", "fuzz mutated/random rejected", mutated[1], "requests");
+		bench::report("http", "fuzz mutated/random incomplete", mutated[2], "requests");
+		bench::report("http", "fuzz path/body outside buffer", insane, "requests");
+		bench::report("http", "fuzz whole/bytewise/segmented differ", inconsistent, "requests");
+	}
+
+	//SmartThingsESP8266WiFi::run() before HttpRequestParser, minus the client
+	String legacyParse(const char *data, size_t len)
+	{
+		String readString;
+		String tempString;
+		boolean currentLineIsBlank = true;
+		for (size_t i = 0; i < len; i++)
+		{
+			char c = data[i];
+			if (readString.length() < 200)
+			{
+				readString += c;
+			}
+			if (c == '\n' && currentLineIsBlank)
+			{
+				tempString = readString.substring(readString.indexOf('/') + 1, readString.indexOf('?'));
+				break;
+			}
+			if (c == '\n')
+			{
+				currentLineIsBlank = true;
+			}
+			else if (c != '\r')
+			{
+				currentLineIsBlank = false;
+			}
+		}
+		tempString.replace("%20", " ");
+		return tempString;
+	}
+
+	void reportThroughput(const char *scenario, unsigned long long nanos, size_t bytes)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "%s per request", scenario);
+		bench::report("http", name, (double)nanos / THROUGHPUT_REQUESTS, "ns");
+		snprintf(name, sizeof(name), "%s throughput", scenario);
+		bench::report("http", name, (double)bytes * THROUGHPUT_REQUESTS * 1000.0 / nanos, "MB/s");
+	}
+
+	void runThroughput(void *)
+	{
+		const size_t len = sizeof(TYPICAL_REQUEST) - 1;
+		unsigned long checksum = 0;
+
+		unsigned long long begin = bench::nowNanos();
+		for (unsigned long n = 0; n < THROUGHPUT_REQUESTS; n++)
+		{
+			checksum += legacyParse(TYPICAL_REQUEST, len).length();
+		}
+		reportThroughput("String loop", bench::nowNanos() - begin, len);
+
+		st::HttpRequestParser parser;
+		begin = bench::nowNanos();
+		for (unsigned long n = 0; n < THROUGHPUT_REQUESTS; n++)
+		{
+			parser.reset();
+			for (size_t i = 0; i < len; i++)
+			{
+				parser.feed(TYPICAL_REQUEST + i, 1);
+			}
+			checksum += parser.commandLength();
+		}
+		reportThroughput("parser byte by byte", bench::nowNanos() - begin, len);
+
+		begin = bench::nowNanos();
+		for (unsigned long n = 0; n < THROUGHPUT_REQUESTS; n++)
+		{
+			parser.reset();
+			parser.feed(TYPICAL_REQUEST, len);
+			checksum += parser.commandLength();
+		}
+		reportThroughput("parser bulk", bench::nowNanos() - begin, len);
+
+		if (checksum != 3 * THROUGHPUT_REQUESTS * strlen("switch1 on"))
+		{
+			fprintf(stderr, "http: unexpected command length\n");
+		}
+	}
+}
+
+void benchHttp()
+{
+	bench::runIsolated(runFuzz, 0);
+	bench::runIsolated(runThroughput, 0);
+}
@@ -0,0 +1,164 @@
+//******************************************************************************************
+//  File: bench_link.cpp
+//
+//  Summary:  st::Everything while the link to the hub is down - at power-on, while WiFi
+//            joins, and during an outage.
+//
+//            A door (IS_Contact) opens or closes every 5s of the simulated clock for 5
+//            minutes.  The transport's link comes up joinMs after power-on, drops at 120s and
+//            comes back joinMs after the access point returns at 180s.  Join times are inputs
+//            of the scenarios (a full scan versus a join from the cached BSSID/channel), not
+//            measured - what is measured is what st::Everything does meanwhile.
+//
+//            "blocking init" is the old SmartThingsESP8266WiFi: nothing runs until the first
+//            join, and afterwards messages are sent (and lost) whether the link is up or not.
+//            "state machine" is the new one: devices start at power-on and isReady() holds
+//            the messages in the SendQueue while the link is down.
+//
+//            Reported: ms from power-on to the first event delivered, door changes, door
+//            events delivered and lost, SendQueue drops, and loop() passes while the link
+//            was down.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Everything.h>
+#include <IS_Contact.h>
+
+namespace
+{
+	const byte PIN = 4;
+	const unsigned long SIMULATED_MS = 300000UL;
+	const unsigned long TOGGLE_EVERY_MS = 5000;
+	const unsigned long OUTAGE_START = 120000UL;
+	const unsigned long OUTAGE_END = 180000UL;
+
+	struct Scenario
+	{
+		const char *name;
+		bool blockingInit;
+		unsigned long joinMs;
+	};
+
+	//transport whose link is switched by the bench
+	class LinkTransport: public st::SmartThings
+	{
+		public:
+			LinkTransport(bool gated) :
+				SmartThings(st::receiveSmartString, "", false, 0),
+				up(false),
+				gated(gated),
+				delivered(0),
+				lost(0),
+				firstMillis(0)
+			{
+			}
+
+			virtual void init(void) {}
+			virtual void run(void) {}
+			virtual bool isReady() const { return up || !gated; }
+
+			virtual void send(String message)
+			{
+				if (strncmp(message.c_str(), "contact1", 8) != 0)
+				{
+					return;
+				}
+				if (!up)
+				{
+					lost++;
+					return;
+				}
+				if (delivered++ == 0)
+				{
+					firstMillis = millis();
+				}
+			}
+
+			bool up;
+			bool gated;				//isReady() follows the link
+			unsigned long delivered;
+			unsigned long lost;
+			unsigned long firstMillis;
+	};
+
+	void runLinkScenario(void *arg)
+	{
+		const Scenario *scenario = static_cast<const Scenario *>(arg);
+
+		LinkTransport transport(!scenario->blockingInit);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+		st::IS_Contact door(F("contact1"), PIN, LOW, false);
+		st::Everything::addSensor(&door);
+
+		byte level = HIGH;
+		native::setDigitalPin(PIN, level);
+		unsigned long start = millis();
+		if (scenario->blockingInit)
+		{
+			native::advanceMillis(scenario->joinMs);	//init() waits for the join
+			transport.up = true;
+		}
+		st::Everything::initDevices();
+
+		unsigned long changes = 0;
+		unsigned long downPasses = 0;
+		unsigned long nextToggle = TOGGLE_EVERY_MS;
+		while (millis() - start < SIMULATED_MS)
+		{
+			unsigned long t = millis() - start;
+			transport.up = (t >= scenario->joinMs && t < OUTAGE_START) || t >= OUTAGE_END + scenario->joinMs;
+			if (t >= nextToggle)
+			{
+				level = level == HIGH ? LOW : HIGH;
+				native::setDigitalPin(PIN, level);
+				nextToggle += TOGGLE_EVERY_MS;
+				changes++;
+			}
+			st::Everything::run();
+			downPasses += transport.up ? 0 : 1;
+			native::advanceMillis(1);
+		}
+		//let the SendQueue drain
+		for (int i = 0; i < 10000 && !st::Everything::SendQueue.empty(); i++)
+		{
+			st::Everything::run();
+			native::advanceMillis(1);
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%s, join %lums", scenario->name, scenario->joinMs);
+		bench::report("link", name, transport.firstMillis - start, "ms from power-on to the first event");
+		bench::report("link", name, changes, "door changes");
+		bench::report("link", name, transport.delivered, "door events delivered (incl. initial state)");
+		bench::report("link", name, transport.lost, "door events lost");
+		bench::report("link", name, st::Everything::SendQueue.drops(), "SendQueue drops");
+		bench::report("link", name, downPasses, "loop() passes while the link was down");
+	}
+}
+
+void benchLink()
+{
+	static const Scenario scenarios[] =
+	{
+		{ "blocking init", true, 6000 },
+		{ "state machine, full scan", false, 6000 },
+		{ "state machine, cached BSSID", false, 1000 },
+	};
+
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runLinkScenario, const_cast<Scenario *>(&scenarios[i]));
+	}
+}
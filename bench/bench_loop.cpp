@@ -0,0 +1,336 @@
+//******************************************************************************************
+//  File: bench_loop.cpp
+//
+//  Summary:  Main loop throughput benchmark.
+//
+//            "loop" scenarios add 1, 10 or 30 sensors (a mix of every PS_, IS_ and S_ type
+//            in lib/ST_Anything) with 0 or 20 executors, then call st::Everything::run()
+//            a fixed number of times.  Each iteration stands for 1ms of board time, so the
+//            polling sensors fire at their configured interval, interrupt sensor inputs
+//            toggle every 500ms and an executor command arrives every second.
+//
+//            Reported per scenario:
+//              - run() iterations per second of host time
+//              - events handed to the transport
+//              - simulated time spent inside delay() (time a real board would be frozen)
+//              - SendQueue high-water mark and drops
+//
+//            "update" scenarios time a single device in isolation: update() while idle
+//            (nothing due) and update() when a poll is due / an input edge is pending.
+//            Executors have no update(), so beSmart() is timed for them instead.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Report SendQueue high-water mark and drops
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <Constants.h>
+#include <Everything.h>
+#include <PS_Illuminance.h>
+#include <PS_Water.h>
+#include <PS_Voltage.h>
+#include <PS_MQ2_Smoke.h>
+#include <PS_Generic.h>
+#include <PS_PulseCounter.h>
+#include <IS_Contact.h>
+#include <IS_Motion.h>
+#include <IS_Smoke.h>
+#include <IS_Button.h>
+#include <IS_CarbonMonoxide.h>
+#include <IS_DoorControl.h>
+#include <S_TimedRelay.h>
+#include <EX_Switch.h>
+#include <EX_Alarm.h>
+#include <EX_Switch_Dim.h>
+#include <EX_RGB_Dim.h>
+#include <EX_RGBW_Dim.h>
+
+namespace
+{
+	const unsigned long LOOP_ITERATIONS = 310000;	//310 simulated seconds - includes one DEV_REFRESH_INTERVAL
+	const unsigned long UPDATE_ITERATIONS = 20000;
+	const byte FIRST_EXECUTOR_PIN = 32;
+
+	const unsigned int SENSOR_TYPES = 11;
+	const unsigned int EXECUTOR_TYPES = 5;
+
+	st::Sensor *makeSensor(unsigned int n, byte pin)
+	{
+		int offset = n % 5;
+		switch (n % SENSOR_TYPES)
+		{
+			case 0:  return new st::PS_Illuminance(bench::deviceName("illuminance", n), 5, offset, pin);
+			case 1:  return new st::IS_Contact(bench::deviceName("contact", n), pin, LOW, true);
+			case 2:  return new st::PS_Water(bench::deviceName("water", n), 5, offset, pin, 200);
+			case 3:  return new st::IS_Motion(bench::deviceName("motion", n), pin, HIGH, false);
+			case 4:  return new st::PS_Voltage(bench::deviceName("voltage", n), 5, offset, pin, 0, 1023, 0, 5000, 4, 50);
+			case 5:  return new st::IS_Smoke(bench::deviceName("smoke", n), pin, HIGH, true, 50);
+			case 6:  return new st::PS_MQ2_Smoke(bench::deviceName("smoke", n), 5, offset, pin, 300);
+			case 7:  return new st::IS_Button(bench::deviceName("button", n), pin, 1000, LOW, true, 50);
+			case 8:  return new st::IS_CarbonMonoxide(bench::deviceName("carbonMonoxide", n), pin, HIGH, false);
+			case 9:  return new st::S_TimedRelay(bench::deviceName("relaySwitch", n), pin, LOW, false, 3000, 0, 1);
+			default: return new st::IS_DoorControl(bench::deviceName("doorControl", n), pin, LOW, true, pin + 1, LOW, false, 1000);
+		}
+	}
+
+	st::Executor *makeExecutor(unsigned int n, byte pin)
+	{
+		switch (n % EXECUTOR_TYPES)
+		{
+			case 0:  return new st::EX_Switch(bench::deviceName("switch", n), pin, LOW, true);
+			case 1:  return new st::EX_Alarm(bench::deviceName("alarm", n), pin, LOW, true);
+			case 2:  return new st::EX_Switch_Dim(bench::deviceName("dimmerSwitch", n), pin, pin + 1, LOW, false);
+			case 3:  return new st::EX_RGB_Dim(bench::deviceName("rgbSwitch", n), pin, pin + 1, pin + 2, false);
+			default: return new st::EX_RGBW_Dim(bench::deviceName("rgbwSwitch", n), pin, pin + 1, pin + 2, pin + 3, false);
+		}
+	}
+
+	const char *executorCommand(unsigned int n)
+	{
+		switch (n % EXECUTOR_TYPES)
+		{
+			case 0:  return (n / EXECUTOR_TYPES) % 2 ? " on" : " off";
+			case 1:  return (n / EXECUTOR_TYPES) % 2 ? " siren" : " off";
+			case 2:  return " 75";
+			default: return " #FF8040C0";
+		}
+	}
+
+	byte sensorPin(unsigned int n)
+	{
+		return n % FIRST_EXECUTOR_PIN;
+	}
+
+	byte executorPin(unsigned int n)
+	{
+		return FIRST_EXECUTOR_PIN + (n * 4) % (NUM_DIGITAL_PINS - FIRST_EXECUTOR_PIN - 4);
+	}
+
+	void initEverything(bench::NullTransport *transport)
+	{
+		st::Everything::SmartThing = transport;
+		st::Everything::init();
+	}
+
+	//******************************************************************************************
+	// st::Everything::run() throughput
+	//******************************************************************************************
+	struct LoopScenario
+	{
+		unsigned int sensors;
+		unsigned int executors;
+	};
+
+	void runLoopScenario(void *arg)
+	{
+		const LoopScenario &sc = *static_cast<LoopScenario *>(arg);
+
+		bench::NullTransport transport(st::receiveSmartString);
+		initEverything(&transport);
+
+		st::Executor **executors = new st::Executor*[sc.executors + 1];
+		for (unsigned int i = 0; i < sc.sensors; i++)
+		{
+			native::setAnalogPin(sensorPin(i), 100 + 25 * i);
+			st::Everything::addSensor(makeSensor(i, sensorPin(i)));
+		}
+		for (unsigned int i = 0; i < sc.executors; i++)
+		{
+			executors[i] = makeExecutor(i, executorPin(i));
+			st::Everything::addExecutor(executors[i]);
+		}
+		st::Everything::initDevices();
+
+		transport.sent = 0;
+		native::resetBlockedMicros();
+		unsigned long simStart = millis();
+		unsigned long long start = bench::nowNanos();
+
+		for (unsigned long it = 1; it <= LOOP_ITERATIONS; it++)
+		{
+			native::advanceMillis(1);
+
+			if (it % 500 == 0)
+			{
+				for (unsigned int i = 0; i < sc.sensors; i++)
+				{
+					byte pin = sensorPin(i);
+					native::setDigitalPin(pin, !native::getDigitalPin(pin));
+					native::setAnalogPin(pin, (it / 500 * 37 + i * 101) % 1024);
+				}
+			}
+
+			if (sc.executors && it % 1000 == 0)
+			{
+				unsigned int n = (it / 1000) % sc.executors;
+				st::receiveSmartString(executors[n]->getName() + executorCommand(n + it / 1000));
+			}
+
+			st::Everything::run();
+		}
+
+		unsigned long long elapsed = bench::nowNanos() - start;
+		unsigned long simElapsed = millis() - simStart;
+
+		char scenario[64];
+		snprintf(scenario, sizeof(scenario), "run() %u sensors %u executors", sc.sensors, sc.executors);
+		bench::report("loop", scenario, LOOP_ITERATIONS * 1e9 / elapsed, "iterations/s");
+		bench::report("loop", scenario, (double)elapsed / LOOP_ITERATIONS, "ns/iteration");
+		bench::report("loop", scenario, transport.sent, "events sent");
+		bench::report("loop", scenario, native::blockedMicros() / 1000.0, "ms blocked in delay()");
+		bench::report("loop", scenario, simElapsed / 1000.0, "s simulated");
+		bench::report("loop", scenario, st::Everything::SendQueue.highWater(), "queue high-water mark");
+		bench::report("loop", scenario, st::Everything::SendQueue.drops(), "queue drops");
+	}
+
+	//******************************************************************************************
+	// per-device update() cost
+	//******************************************************************************************
+	enum DeviceKind { POLLING, INTERRUPT, TIMED, EXECUTOR };
+
+	struct UpdateScenario
+	{
+		const char *label;
+		DeviceKind kind;
+		st::Device *(*make)(byte pin);
+		const char *command;	//executors and timed sensors only
+	};
+
+	st::Device *makeIlluminance(byte pin) { return new st::PS_Illuminance(F("illuminance1"), 1, 0, pin); }
+	st::Device *makeWater(byte pin) { return new st::PS_Water(F("water1"), 1, 0, pin, 200); }
+	st::Device *makeVoltage(byte pin) { return new st::PS_Voltage(F("voltage1"), 1, 0, pin, 0, 1023, 0, 5000, 10, 50); }
+	st::Device *makeVoltageComp(byte pin) { return new st::PS_Voltage(F("voltage1"), 1, 0, pin, 0, 1023, 0, 5000, 10, 50, -0.000000002, 0.000009, 0.9, 22); }
+	st::Device *makeMQ2(byte pin) { return new st::PS_MQ2_Smoke(F("smoke1"), 1, 0, pin, 300); }
+	st::Device *makeGeneric(byte pin) { (void)pin; return new st::PS_Generic(F("generic1"), 1, 0); }
+	st::Device *makePulseCounter(byte pin) { (void)pin; return new st::PS_PulseCounter(F("power1"), 1, 0, 21, FALLING, INPUT_PULLUP, 1.0, 0); }
+	st::Device *makeContact(byte pin) { return new st::IS_Contact(F("contact1"), pin, LOW, true); }
+	st::Device *makeSmoke(byte pin) { return new st::IS_Smoke(F("smoke1"), pin, HIGH, true); }
+	st::Device *makeCO(byte pin) { return new st::IS_CarbonMonoxide(F("carbonMonoxide1"), pin, HIGH, false); }
+	st::Device *makeButton(byte pin) { return new st::IS_Button(F("button1"), pin, 1000, LOW, true, 0); }
+	st::Device *makeDoor(byte pin) { return new st::IS_DoorControl(F("doorControl1"), pin, LOW, true, pin + 1, LOW, false, 1000); }
+	st::Device *makeTimedRelay(byte pin) { return new st::S_TimedRelay(F("relaySwitch1"), pin, LOW, false, 3000, 0, 1); }
+	st::Device *makeSwitch(byte pin) { return new st::EX_Switch(F("switch1"), pin, LOW, true); }
+	st::Device *makeAlarm(byte pin) { return new st::EX_Alarm(F("alarm1"), pin, LOW, true); }
+	st::Device *makeSwitchDim(byte pin) { return new st::EX_Switch_Dim(F("dimmerSwitch1"), pin, pin + 1, LOW, false); }
+	st::Device *makeRGB(byte pin) { return new st::EX_RGB_Dim(F("rgbSwitch1"), pin, pin + 1, pin + 2, false); }
+	st::Device *makeRGBW(byte pin) { return new st::EX_RGBW_Dim(F("rgbwSwitch1"), pin, pin + 1, pin + 2, pin + 3, false); }
+
+	UpdateScenario updateScenarios[] =
+	{
+		{ "PS_Illuminance", POLLING, makeIlluminance, 0 },
+		{ "PS_Water", POLLING, makeWater, 0 },
+		{ "PS_Voltage (10 samples)", POLLING, makeVoltage, 0 },
+		{ "PS_Voltage (10 samples, compensated)", POLLING, makeVoltageComp, 0 },
+		{ "PS_MQ2_Smoke", POLLING, makeMQ2, 0 },
+		{ "PS_Generic", POLLING, makeGeneric, 0 },
+		{ "PS_PulseCounter", POLLING, makePulseCounter, 0 },
+		{ "IS_Contact", INTERRUPT, makeContact, 0 },
+		{ "IS_Smoke", INTERRUPT, makeSmoke, 0 },
+		{ "IS_CarbonMonoxide", INTERRUPT, makeCO, 0 },
+		{ "IS_Button", INTERRUPT, makeButton, 0 },
+		{ "IS_DoorControl", INTERRUPT, makeDoor, 0 },
+		{ "S_TimedRelay", TIMED, makeTimedRelay, "relaySwitch1 on" },
+		{ "EX_Switch", EXECUTOR, makeSwitch, "switch1 on" },
+		{ "EX_Alarm", EXECUTOR, makeAlarm, "alarm1 siren" },
+		{ "EX_Switch_Dim", EXECUTOR, makeSwitchDim, "dimmerSwitch1 75" },
+		{ "EX_RGB_Dim", EXECUTOR, makeRGB, "rgbSwitch1 #FF8040" },
+		{ "EX_RGBW_Dim", EXECUTOR, makeRGBW, "rgbwSwitch1 #FF8040C0" },
+	};
+
+	void runUpdateScenario(void *arg)
+	{
+		const UpdateScenario &sc = *static_cast<UpdateScenario *>(arg);
+		const byte pin = 4;
+
+		bench::NullTransport transport(st::receiveSmartString);
+		initEverything(&transport);
+
+		native::setAnalogPin(pin, 512);
+		st::Device *device = sc.make(pin);
+		device->init();
+		st::Everything::run();	//drain the init() report
+
+		char scenario[64];
+		if (sc.kind == EXECUTOR)
+		{
+			String command(sc.command);
+			unsigned long long total = 0;
+			for (unsigned long i = 0; i < UPDATE_ITERATIONS; i++)
+			{
+				unsigned long long t0 = bench::nowNanos();
+				device->beSmart(command);
+				total += bench::nowNanos() - t0;
+				st::Everything::run();	//untimed - sends the queued report
+			}
+			snprintf(scenario, sizeof(scenario), "%s beSmart()", sc.label);
+			bench::report("update", scenario, (double)total / UPDATE_ITERATIONS, "ns/call");
+			return;
+		}
+
+		st::Sensor *sensor = static_cast<st::Sensor *>(device);
+
+		//idle - nothing is due, the pin is steady
+		unsigned long long t0 = bench::nowNanos();
+		for (unsigned long i = 0; i < UPDATE_ITERATIONS; i++)
+		{
+			sensor->update();
+		}
+		unsigned long long idle = bench::nowNanos() - t0;
+		st::Everything::run();
+
+		//due - a poll interval has elapsed or the input has changed state
+		unsigned long long due = 0;
+		for (unsigned long i = 0; i < UPDATE_ITERATIONS; i++)
+		{
+			if (sc.kind == POLLING)
+			{
+				native::advanceMillis(1000);
+			}
+			else if (sc.kind == TIMED)
+			{
+				sensor->beSmart(sc.command);	//untimed - starts the relay timer, which update() then expires
+				native::advanceMillis(3000);
+			}
+			else
+			{
+				native::setDigitalPin(pin, !native::getDigitalPin(pin));
+			}
+			t0 = bench::nowNanos();
+			sensor->update();
+			due += bench::nowNanos() - t0;
+			st::Everything::run();	//untimed - sends the queued report
+		}
+
+		snprintf(scenario, sizeof(scenario), "%s update() idle", sc.label);
+		bench::report("update", scenario, (double)idle / UPDATE_ITERATIONS, "ns/call");
+		snprintf(scenario, sizeof(scenario), "%s update() due", sc.label);
+		bench::report("update", scenario, (double)due / UPDATE_ITERATIONS, "ns/call");
+	}
+}
+
+void benchLoop()
+{
+	LoopScenario loopScenarios[] =
+	{
+		{ 1, 0 }, { 10, 0 }, { 30, 0 },
+		{ 1, 20 }, { 10, 20 }, { 30, 20 },
+	};
+
+	for (unsigned int i = 0; i < sizeof(loopScenarios) / sizeof(loopScenarios[0]); i++)
+	{
+		bench::runIsolated(runLoopScenario, &loopScenarios[i]);
+	}
+
+	for (unsigned int i = 0; i < sizeof(updateScenarios) / sizeof(updateScenarios[0]); i++)
+	{
+		bench::runIsolated(runUpdateScenario, &updateScenarios[i]);
+	}
+}
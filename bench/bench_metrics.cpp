@@ -0,0 +1,132 @@
+//******************************************************************************************
+//  File: bench_metrics.cpp
+//
+//  Summary:  The /metrics page.
+//
+//            10 PS_Voltage sensors (5s interval), 19 IS_Contact sensors and one sensor whose
+//            poll blocks for 30ms run for 60 simulated seconds at one loop pass per ms.  The
+//            page is then rendered by SmartThings::writeMetrics() into a counting Print, as
+//            SmartThingsESP8266WiFi does for GET /metrics.
+//
+//            Reported: size and render time of the page, loop passes counted by the histogram
+//            versus passes made, and the worst update() time of the slow sensor versus the
+//            worst of all the others - what an operator would look at to find the culprit.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <Everything.h>
+#include <Metrics.h>
+#include <PS_Voltage.h>
+#include <IS_Contact.h>
+
+namespace
+{
+	const unsigned long SIMULATED_MS = 60000UL;
+	const unsigned int RENDERS = 200;
+
+	class SlowSensor: public st::PollingSensor
+	{
+		public:
+			SlowSensor() : PollingSensor(F("slow1"), 2) {}
+
+			virtual void getData()
+			{
+				//stands for a sensor library that busy-waits on the bus
+				unsigned long start = micros();
+				while (micros() - start < 30000UL)
+				{
+				}
+			}
+	};
+
+	class CountingPrint: public Print
+	{
+		public:
+			unsigned long bytes;
+
+			CountingPrint() : bytes(0) {}
+			virtual size_t write(uint8_t c) {bytes++; return 1;}
+			virtual size_t write(const uint8_t *buffer, size_t size) {bytes += size; return size;}
+	};
+
+	void runMetricsScenario(void *)
+	{
+		bench::NullTransport transport(st::receiveSmartString);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::Sensor *slow = new SlowSensor();
+		st::Everything::addSensor(slow);
+		st::Sensor *others[29];
+		for (unsigned int i = 0; i < 29; i++)
+		{
+			if (i < 10)
+			{
+				others[i] = new st::PS_Voltage(bench::deviceName("voltage", i), 5, i % 5, i);
+			}
+			else
+			{
+				others[i] = new st::IS_Contact(bench::deviceName("contact", i), 20 + i, LOW, true, 0);
+			}
+			st::Everything::addSensor(others[i]);
+		}
+		st::Everything::initDevices();
+		st::Metrics::reset();
+
+		unsigned long passes = 0;
+		unsigned long start = millis();
+		while (millis() - start < SIMULATED_MS)
+		{
+			st::Everything::run();
+			passes++;
+			native::advanceMillis(1);
+		}
+		passes--;	//the first pass only starts the loop clock
+
+		CountingPrint page;
+		unsigned long long begin = bench::nowNanos();
+		for (unsigned int i = 0; i < RENDERS; i++)
+		{
+			transport.writeMetrics(page);
+		}
+		double renderMicros = (bench::nowNanos() - begin) / 1000.0 / RENDERS;
+
+		unsigned long counted = 0;
+		for (byte bucket = 0; bucket < st::Metrics::LOOP_BUCKETS; bucket++)
+		{
+			counted += st::Metrics::getLoopCount(bucket);
+		}
+
+		unsigned long othersMax = 0;
+		for (unsigned int i = 0; i < 29; i++)
+		{
+			if (others[i]->getUpdateMicrosMax() > othersMax)
+			{
+				othersMax = others[i]->getUpdateMicrosMax();
+			}
+		}
+
+		bench::report("metrics", "page size", page.bytes / RENDERS, "bytes");
+		bench::report("metrics", "page render", renderMicros, "us");
+		bench::report("metrics", "loop passes made", passes, "passes");
+		bench::report("metrics", "loop passes in histogram", counted, "passes");
+		bench::report("metrics", "slow1 worst update", slow->getUpdateMicrosMax(), "us");
+		bench::report("metrics", "other 29 sensors worst update", othersMax, "us");
+		bench::report("metrics", "loop period max", st::Metrics::getLoopMicrosMax(), "us");
+	}
+}
+
+void benchMetrics()
+{
+	bench::runIsolated(runMetricsScenario, 0);
+}
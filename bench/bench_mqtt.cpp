@@ -0,0 +1,244 @@
+//******************************************************************************************
+//  File: bench_mqtt.cpp
+//
+//  Summary:  SmartThingsMQTT against a bench::StandInBroker, compared with HTTP POSTs to a
+//            bench::StandInHub.
+//
+//            "storm" scenarios queue a refresh storm (one event from every device) with a
+//            transmit interval of 0 and call st::Everything::run() until the queue is empty,
+//            as the batch suite does.  Reported: events per second of host time, TCP
+//            connections opened and events received.
+//
+//            "flaky" scenarios send storms at the usual 100ms transmit interval on the
+//            simulated clock to a broker that drops the connection on every 50th publish,
+//            losing it.  Reported: distinct events the broker received out of
+//            those queued, repeats, connections, and the transport's dropped, downgraded and
+//            still unacknowledged events.
+//
+//            "startup" scenarios queue a storm right after st::Everything::init(), before the
+//            broker has answered CONNECT, as initDevices() does at power-on, and run until the
+//            events are sent and acknowledged.  Reported: events received out of those queued,
+//            and the transport's dropped and downgraded events.
+//
+//            Every MQTT scenario also checks that the "switch1 on" the broker sends on the
+//            command topic reaches the callout.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Events queued before CONNACK
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "StandInHub.h"
+#include "StandInBroker.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <Constants.h>
+#include <Everything.h>
+#include <SmartThingsMQTT.h>
+
+namespace
+{
+	const unsigned int STORM_ROUNDS = 200;
+	const unsigned int FLAKY_ROUNDS = 20;
+	const unsigned int STORM_EVENTS = st::Constants::RETURN_QUEUE_SIZE;
+	const unsigned int FLAKY_DROP_EVERY = 50;
+
+	struct MqttScenario
+	{
+		const char *name;
+		bool mqtt;
+		bool batch;
+		byte qos;
+		bool flaky;
+		bool startup;		//the storm is queued before CONNACK
+	};
+
+	unsigned long commands;
+
+	void countCommand(String message)
+	{
+		if (message == "switch1 on")
+		{
+			commands++;
+		}
+	}
+
+	//events carry their number as the value, so the broker can tell repeats
+	void queueStorm(unsigned int round)
+	{
+		char msg[st::Constants::RETURN_MESSAGE_LENGTH];
+		for (unsigned int i = 0; i < STORM_EVENTS; i++)
+		{
+			int len = snprintf(msg, sizeof(msg), "temperature%u %u", i + 1, round * STORM_EVENTS + i);
+			st::Everything::SendQueue.push(msg, len, st::PRIORITY_LOW);
+		}
+	}
+
+	void runMqttScenario(void *arg)
+	{
+		const MqttScenario &sc = *static_cast<MqttScenario *>(arg);
+		char scenario[64];
+		commands = 0;
+
+		if (!sc.mqtt)
+		{
+			bench::StandInHub hub;
+			if (!hub.start())
+			{
+				fprintf(stderr, "mqtt: stand-in hub did not start\n");
+				_exit(1);
+			}
+			bench::HttpTransport transport(hub.port(), countCommand, 0);
+			transport.setBatchMode(sc.batch);
+			st::Everything::SmartThing = &transport;
+			st::Everything::init();
+
+			unsigned long long start = bench::nowNanos();
+			for (unsigned int round = 0; round < STORM_ROUNDS; round++)
+			{
+				queueStorm(round);
+				while (!st::Everything::SendQueue.empty())
+				{
+					st::Everything::run();
+				}
+			}
+			unsigned long long elapsed = bench::nowNanos() - start;
+
+			snprintf(scenario, sizeof(scenario), "storm %s", sc.name);
+			bench::report("mqtt", scenario, (unsigned long)STORM_ROUNDS * STORM_EVENTS * 1e9 / elapsed, "events/s");
+			bench::report("mqtt", scenario, transport.connections, "connections opened");
+			bench::report("mqtt", scenario, hub.events(), "events received");
+			bench::report("mqtt", scenario, (unsigned long)STORM_ROUNDS * STORM_EVENTS, "events queued");
+			hub.stop();
+			return;
+		}
+
+		bench::StandInBroker broker;
+		if (!broker.start(sc.flaky ? FLAKY_DROP_EVERY : 0))
+		{
+			fprintf(stderr, "mqtt: stand-in broker did not start\n");
+			_exit(1);
+		}
+		bench::SocketClient client;
+		st::SmartThingsMQTT transport(client, IPAddress(127, 0, 0, 1), broker.port(), "bench", "bench/st", countCommand, sc.qos, "MQTT", false, sc.flaky ? 100 : 0);
+		transport.setBatchMode(sc.batch);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();		//calls transport.init()
+
+		unsigned long queued = 0;
+		if (sc.startup)
+		{
+			queueStorm(0);
+			queued = STORM_EVENTS;
+			for (int i = 0; i < 5000 && (!st::Everything::SendQueue.empty() || transport.getInFlight() > 0 || commands == 0); i++)
+			{
+				st::Everything::run();
+				usleep(100);
+			}
+			//the broker reads what is still on the way
+			for (int i = 0; i < 2000 && broker.distinct() < queued; i++)
+			{
+				usleep(500);
+			}
+			snprintf(scenario, sizeof(scenario), "startup %s", sc.name);
+			bench::report("mqtt", scenario, transport.getDropped(), "events dropped");
+			bench::report("mqtt", scenario, transport.getDowngraded(), "events downgraded to QoS 0");
+			bench::report("mqtt", scenario, broker.distinct(), "events received");
+			bench::report("mqtt", scenario, queued, "events queued");
+			bench::report("mqtt", scenario, commands, "commands received");
+			broker.stop();
+			return;
+		}
+
+		//CONNACK, SUBACK and the command
+		for (int i = 0; i < 1000 && commands == 0; i++)
+		{
+			st::Everything::run();
+			usleep(100);
+		}
+
+		if (!sc.flaky)
+		{
+			unsigned long long start = bench::nowNanos();
+			for (unsigned int round = 0; round < STORM_ROUNDS; round++)
+			{
+				queueStorm(round);
+				queued += STORM_EVENTS;
+				while (!st::Everything::SendQueue.empty())
+				{
+					st::Everything::run();
+				}
+			}
+			unsigned long long elapsed = bench::nowNanos() - start;
+
+			snprintf(scenario, sizeof(scenario), "storm %s", sc.name);
+			bench::report("mqtt", scenario, queued * 1e9 / elapsed, "events/s");
+			bench::report("mqtt", scenario, client.connects, "connections opened");
+
+			//the broker reads what is still on the way
+			for (int i = 0; i < 2000 && broker.distinct() < queued; i++)
+			{
+				usleep(500);
+			}
+		}
+		else
+		{
+			for (unsigned int round = 0; round < FLAKY_ROUNDS; round++)
+			{
+				queueStorm(round);
+				queued += STORM_EVENTS;
+				while (!st::Everything::SendQueue.empty())
+				{
+					native::advanceMillis(1);
+					st::Everything::run();
+					usleep(10);		//lets the broker process keep up, as the network would
+				}
+			}
+			//acknowledgements and repeats still on the way
+			for (int i = 0; i < 2000 && transport.getInFlight() > 0; i++)
+			{
+				native::advanceMillis(1);
+				st::Everything::run();
+				usleep(100);
+			}
+			usleep(20000);
+			snprintf(scenario, sizeof(scenario), "flaky %s", sc.name);
+			bench::report("mqtt", scenario, client.connects, "connections opened");
+			bench::report("mqtt", scenario, transport.getDropped(), "events dropped");
+			bench::report("mqtt", scenario, transport.getDowngraded(), "events downgraded to QoS 0");
+			bench::report("mqtt", scenario, transport.getInFlight(), "events unacknowledged");
+			bench::report("mqtt", scenario, broker.duplicates(), "repeats received");
+		}
+
+		bench::report("mqtt", scenario, broker.distinct(), "events received");
+		bench::report("mqtt", scenario, queued, "events queued");
+		bench::report("mqtt", scenario, commands, "commands received");
+		broker.stop();
+	}
+}
+
+void benchMqtt()
+{
+	MqttScenario scenarios[] =
+	{
+		{ "HTTP POST", false, false, 0, false, false },
+		{ "HTTP POST batched", false, true, 0, false, false },
+		{ "MQTT QoS 0", true, false, 0, false, false },
+		{ "MQTT QoS 0 batched", true, true, 0, false, false },
+		{ "MQTT QoS 0", true, false, 0, true, false },
+		{ "MQTT QoS 1", true, false, 1, true, false },
+		{ "MQTT QoS 0", true, false, 0, false, true },
+		{ "MQTT QoS 1", true, false, 1, false, true },
+	};
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runMqttScenario, &scenarios[i]);
+	}
+}
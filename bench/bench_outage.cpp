@@ -0,0 +1,274 @@
+//******************************************************************************************
+//  File: bench_outage.cpp
+//
+//  Summary:  Events sent while the hub cannot be reached, with and without the
+//            store-and-forward st::EventLog.
+//
+//            A meter's events ("energy1 <n>", numbered in order) are sent every 250ms of the
+//            simulated clock by a bench::HttpTransport to a bench::StandInHub that goes down
+//            twice (for 30s and for 10s).  The event log is kept on a bench::SimulatedFlash,
+//            with the default replay and retry intervals.  Without the log, the transport's
+//            retry queue (RetryQueue.h) holds what it can.
+//
+//            Reported: events received out of those sent, events received out of order or
+//            twice, events replayed, the most events waiting in the log, time from the hub's
+//            return to an empty log, and what was written to flash (bytes, and the fewest and
+//            most erases of a segment - the spread shows the wear levelling).
+//
+//            "power cut" stores an outage's events, replays half of them, then tears the
+//            record being written and starts over with a new st::EventLog on the same flash,
+//            as a reset board would.  "long outage" stores more events than the log holds.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Without the log, undelivered events go to the retry queue
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "SimulatedFlash.h"
+#include "StandInHub.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <EventLog.h>
+#include <Everything.h>
+
+namespace
+{
+	const unsigned long EVENT_EVERY_MS = 250;
+
+	enum OutageScenario
+	{
+		FLAPPING_NO_LOG,
+		FLAPPING_LOG,
+		POWER_CUT,
+		LONG_OUTAGE
+	};
+
+	unsigned long sent;
+
+	void sendEvent(st::SmartThings &transport)
+	{
+		char msg[32];
+		snprintf(msg, sizeof(msg), "energy1 %lu", ++sent);
+		transport.send(msg);
+	}
+
+	void reportFlash(const char *scenario, st::EventLog &log, bench::SimulatedFlash &flash)
+	{
+		unsigned long fewest = flash.erases(0);
+		unsigned long most = flash.erases(0);
+		for (byte s = 1; s < EVENTLOG_SEGMENTS; s++)
+		{
+			fewest = flash.erases(s) < fewest ? flash.erases(s) : fewest;
+			most = flash.erases(s) > most ? flash.erases(s) : most;
+		}
+		bench::report("outage", scenario, log.getStored(), "events stored");
+		bench::report("outage", scenario, log.getDropped(), "events dropped by the log");
+		bench::report("outage", scenario, flash.bytesWritten(), "bytes written to flash");
+		bench::report("outage", scenario, fewest, "fewest erases of a segment");
+		bench::report("outage", scenario, most, "most erases of a segment");
+	}
+
+	//runs the transport until the log is empty - returns the simulated milliseconds it took
+	unsigned long drain(st::SmartThings &transport, st::EventLog &log)
+	{
+		unsigned long start = millis();
+		while (log.getPending() > 0 && millis() - start < 3600000UL)
+		{
+			native::advanceMillis(1);
+			transport.run();
+		}
+		return millis() - start;
+	}
+
+	void runFlapping(bool withLog)
+	{
+		const char *scenario = withLog ? "flapping hub, event log" : "flapping hub, no log";
+		const unsigned long events = 400;		//100s
+
+		bench::StandInHub hub;
+		if (!hub.start())
+		{
+			fprintf(stderr, "outage: stand-in hub did not start\n");
+			_exit(1);
+		}
+		bench::SimulatedFlash flash;
+		st::EventLog log(flash);
+		log.begin();
+		bench::HttpTransport transport(hub.port(), st::receiveSmartString, 0);
+		if (withLog)
+		{
+			transport.setEventLog(&log);
+		}
+
+		unsigned long start = millis();
+		unsigned long hubBack = 0;
+		unsigned long drained = 0;
+		unsigned long mostPending = 0;
+		bool down = false;
+		while (sent < events || (withLog && log.getPending() > 0))
+		{
+			unsigned long t = millis() - start;
+			bool outage = (t >= 20000 && t < 50000) || (t >= 60000 && t < 70000);
+			if (outage != down)
+			{
+				down = outage;
+				hub.setDown(down);
+				hubBack = down ? hubBack : t;
+			}
+			if (sent < events && t >= sent * EVENT_EVERY_MS)
+			{
+				sendEvent(transport);
+			}
+			transport.run();
+			mostPending = log.getPending() > mostPending ? log.getPending() : mostPending;
+			if (log.getPending() > 0)
+			{
+				drained = 0;
+			}
+			else if (drained == 0 && mostPending > 0)
+			{
+				drained = t;
+			}
+			native::advanceMillis(1);
+		}
+
+		bench::report("outage", scenario, hub.events(), "events received");
+		bench::report("outage", scenario, events, "events sent");
+		bench::report("outage", scenario, hub.outOfOrder(), "events out of order or twice");
+		if (withLog)
+		{
+			bench::report("outage", scenario, hub.replays(), "events replayed");
+			bench::report("outage", scenario, mostPending, "most events waiting");
+			bench::report("outage", scenario, drained > hubBack ? drained - hubBack : 0, "ms from the hub's return to an empty log");
+			reportFlash(scenario, log, flash);
+		}
+		hub.stop();
+	}
+
+	void runPowerCut()
+	{
+		const char *scenario = "power cut";
+		const unsigned long events = 200;
+
+		bench::StandInHub hub;
+		if (!hub.start())
+		{
+			fprintf(stderr, "outage: stand-in hub did not start\n");
+			_exit(1);
+		}
+		hub.setDown(true);
+		bench::SimulatedFlash flash;
+
+		{
+			st::EventLog log(flash);
+			log.begin();
+			bench::HttpTransport transport(hub.port(), st::receiveSmartString, 0);
+			transport.setEventLog(&log);
+			while (sent < events)
+			{
+				native::advanceMillis(EVENT_EVERY_MS);
+				sendEvent(transport);
+			}
+
+			hub.setDown(false);
+			while (log.getReplayed() < events / 2)
+			{
+				native::advanceMillis(1);
+				transport.run();
+			}
+
+			//the board resets while it stores one more event
+			flash.cutPower();
+			sendEvent(transport);
+		}
+
+		unsigned long long recoverStart = bench::nowNanos();
+		st::EventLog log(flash);
+		log.begin();
+		double recoverMicros = (bench::nowNanos() - recoverStart) / 1e3;
+		bench::HttpTransport transport(hub.port(), st::receiveSmartString, 0);
+		transport.setEventLog(&log);
+		bench::report("outage", scenario, log.getPending(), "events waiting after the reset");
+		drain(transport, log);
+
+		bench::report("outage", scenario, hub.events(), "events received");
+		bench::report("outage", scenario, sent, "events sent");
+		bench::report("outage", scenario, hub.outOfOrder(), "events received twice (after the last cursor)");
+		bench::report("outage", scenario, log.getCorrupt(), "torn records skipped");
+		bench::report("outage", scenario, recoverMicros, "us in begin() after the reset (flash in memory)");
+		hub.stop();
+	}
+
+	void runLongOutage()
+	{
+		const char *scenario = "long outage";
+		const unsigned long events = 3000;		//12.5 minutes
+
+		bench::StandInHub hub;
+		if (!hub.start())
+		{
+			fprintf(stderr, "outage: stand-in hub did not start\n");
+			_exit(1);
+		}
+		hub.setDown(true);
+		bench::SimulatedFlash flash;
+		st::EventLog log(flash);
+		log.begin();
+		bench::HttpTransport transport(hub.port(), st::receiveSmartString, 0);
+		transport.setEventLog(&log);
+		while (sent < events)
+		{
+			native::advanceMillis(EVENT_EVERY_MS);
+			sendEvent(transport);
+			transport.run();
+		}
+		unsigned long kept = log.getPending();
+
+		hub.setDown(false);
+		unsigned long took = drain(transport, log);
+
+		bench::report("outage", scenario, events, "events sent");
+		bench::report("outage", scenario, kept, "events kept (the newest)");
+		bench::report("outage", scenario, hub.events(), "events received");
+		bench::report("outage", scenario, hub.outOfOrder(), "events out of order or twice");
+		bench::report("outage", scenario, took, "ms from the hub's return to an empty log");
+		reportFlash(scenario, log, flash);
+		hub.stop();
+	}
+
+	void runOutageScenario(void *arg)
+	{
+		sent = 0;
+		switch (*static_cast<OutageScenario *>(arg))
+		{
+			case FLAPPING_NO_LOG:
+				runFlapping(false);
+				break;
+			case FLAPPING_LOG:
+				runFlapping(true);
+				break;
+			case POWER_CUT:
+				runPowerCut();
+				break;
+			case LONG_OUTAGE:
+				runLongOutage();
+				break;
+		}
+	}
+}
+
+void benchOutage()
+{
+	static OutageScenario scenarios[] = { FLAPPING_NO_LOG, FLAPPING_LOG, POWER_CUT, LONG_OUTAGE };
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runOutageScenario, &scenarios[i]);
+	}
+}
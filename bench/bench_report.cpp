@@ -0,0 +1,120 @@
+//******************************************************************************************
+//  File: bench_report.cpp
+//
+//  Summary:  PollingSensor reporting policy.
+//
+//            10 PS_Voltage sensors are polled every 5s for one simulated hour.  Each analog
+//            input follows a slow sine (period 30 min, +-200 counts) with +-2 counts of noise,
+//            and 20 minutes of every hour it holds steady.
+//
+//            Scenarios: no policy (every poll is sent, as before), an absolute deadband of
+//            20mV with a 5 minute heartbeat, and a 1% deadband with 30s minimum spacing and a
+//            5 minute heartbeat.
+//
+//            Reported: messages that reached the transport, and reports sent versus
+//            suppressed as counted by PollingSensor.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <Everything.h>
+#include <PS_Voltage.h>
+
+namespace
+{
+	const unsigned int SENSORS = 10;
+	const unsigned long SIMULATED_MS = 3600000UL;
+
+	struct Scenario
+	{
+		const char *name;
+		bool policy;
+		float deadband;
+		bool percent;
+		long minSpacing;
+		long heartbeat;
+	};
+
+	int analogInput(unsigned int sensor, unsigned long ms, unsigned long &random)
+	{
+		random = random * 1103515245UL + 12345UL;
+		int noise = (int)((random >> 16) % 5) - 2;
+		if (ms % 3600000UL >= 2400000UL)
+		{
+			return 512 + noise;		//steady
+		}
+		double phase = 2 * 3.14159265 * (ms + sensor * 60000UL) / 1800000.0;
+		return 512 + (int)(200 * sin(phase)) + noise;
+	}
+
+	void runReportScenario(void *arg)
+	{
+		const Scenario *scenario = static_cast<const Scenario *>(arg);
+
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::PS_Voltage *sensors[SENSORS];
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			sensors[i] = new st::PS_Voltage(bench::deviceName("voltage", i), 5, i % 5, i);
+			if (scenario->policy)
+			{
+				sensors[i]->setReportPolicy(scenario->deadband, scenario->percent, scenario->minSpacing, scenario->heartbeat);
+			}
+			st::Everything::addSensor(sensors[i]);
+		}
+
+		unsigned long random = 777;
+		unsigned long start = millis();
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			native::setAnalogPin(i, analogInput(i, 0, random));
+		}
+		st::Everything::initDevices();
+
+		while (millis() - start < SIMULATED_MS)
+		{
+			unsigned long elapsed = millis() - start;
+			for (unsigned int i = 0; i < SENSORS; i++)
+			{
+				native::setAnalogPin(i, analogInput(i, elapsed, random));
+			}
+			st::Everything::run();
+			native::advanceMillis(10);
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%s messages sent", scenario->name);
+		bench::report("report", name, transport.sent, "messages");
+		snprintf(name, sizeof(name), "%s reports sent", scenario->name);
+		bench::report("report", name, st::PollingSensor::totalReportsSent, "reports");
+		snprintf(name, sizeof(name), "%s reports suppressed", scenario->name);
+		bench::report("report", name, st::PollingSensor::totalReportsSuppressed, "reports");
+	}
+}
+
+void benchReport()
+{
+	static const Scenario scenarios[] =
+	{
+		{ "no policy", false, 0, false, 0, 0 },
+		{ "20mV heartbeat 300s", true, 20, false, 0, 300 },
+		{ "1% spacing 30s heartbeat 300s", true, 1, true, 30, 300 },
+	};
+
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runReportScenario, const_cast<Scenario *>(&scenarios[i]));
+	}
+}
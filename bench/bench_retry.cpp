@@ -0,0 +1,177 @@
+//******************************************************************************************
+//  File: bench_retry.cpp
+//
+//  Summary:  Messages sent while connects to the hub fail, with the old immediate second
+//            connect and with the retry queue of the SmartThings base class (RetryQueue.h).
+//
+//            A meter's events ("energy1 <n>", numbered in order) are sent every 2s of the
+//            simulated clock for 3 minutes through a transport whose deliver() follows
+//            SmartThingsEthernetW5100 (connect, POST, read until the hub closes, stop) on a
+//            bench::FakeClient.  A failed connect takes 1s, as a connect timeout does.
+//
+//            "hub reboot": every connect fails from 30s to 90s.  "flaky link": every 4th
+//            connect fails.  "immediate retry" connects a second time at once and then gives
+//            the message up, as the transports did before; "retry queue" uses the default
+//            policy (RETRY_MAX_ATTEMPTS, RETRY_BASE_DELAY, RETRY_MAX_DELAY).
+//
+//            Reported: events received out of those sent, events out of order or twice,
+//            connects and failed connects, messages given up (dead letters, and the ones the
+//            old transport dropped), and the simulated time spent in failed connects, in total
+//            and in the longest loop() pass.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "FakeClient.h"
+
+#include <stdio.h>
+
+#include <Everything.h>
+
+namespace
+{
+	const unsigned long EVENT_EVERY_MS = 2000;
+	const unsigned long EVENTS = 90;
+	const unsigned long DRAIN_MS = 300000UL;
+
+	struct Scenario
+	{
+		const char *name;
+		bool reboot;
+		bool immediateRetry;
+	};
+
+	//deliver() as in SmartThingsEthernetW5100, on a FakeClient
+	class ClientTransport: public st::SmartThings
+	{
+		private:
+			Client &m_client;
+			bool m_bImmediateRetry;
+
+			bool post(const String &message)
+			{
+				if (!m_client.connect(IPAddress(127, 0, 0, 1), 39500))
+				{
+					m_nConnectFailures++;
+					return false;
+				}
+				m_client.println(F("POST / HTTP/1.1"));
+				m_client.println(F("HOST: 127.0.0.1:39500"));
+				m_client.println(F("CONTENT-TYPE: text"));
+				m_client.print(F("CONTENT-LENGTH: "));
+				m_client.println(message.length());
+				m_client.println();
+				m_client.println(message);
+				while (m_client.connected())
+				{
+					m_client.read();
+				}
+				m_client.stop();
+				return true;
+			}
+
+		protected:
+			virtual bool deliver(const String &message, long ageMillis)
+			{
+				if (post(message))
+				{
+					return true;
+				}
+				if (m_bImmediateRetry && post(message))
+				{
+					return true;
+				}
+				dropped += m_bImmediateRetry ? 1 : 0;
+				return false;
+			}
+
+		public:
+			ClientTransport(Client &client, bool immediateRetry) :
+				SmartThings(st::receiveSmartString, "Bench", false, 0),
+				m_client(client),
+				m_bImmediateRetry(immediateRetry),
+				dropped(0)
+			{
+				if (immediateRetry)
+				{
+					setRetryPolicy(1);		//the transport gives up after its second connect
+				}
+			}
+
+			virtual void init(void) {}
+			virtual void run(void) { retryKept(); }
+			virtual void send(String message) { deliverOrKeep(message); }
+
+			unsigned long dropped;			//messages the old transport gave up
+	};
+
+	void runRetryScenario(void *arg)
+	{
+		const Scenario *scenario = static_cast<const Scenario *>(arg);
+
+		bench::FakeClient client;
+		client.failMillis = 1000;
+		ClientTransport transport(client, scenario->immediateRetry);
+
+		unsigned long start = millis();
+		if (scenario->reboot)
+		{
+			client.downFrom = start + 30000;
+			client.downUntil = start + 90000;
+		}
+		else
+		{
+			client.failEvery = 4;
+		}
+
+		unsigned long sent = 0;
+		unsigned long longestPass = 0;
+		while (sent < EVENTS || (!transport.getRetryQueue().empty() && millis() - start < EVENTS * EVENT_EVERY_MS + DRAIN_MS))
+		{
+			unsigned long passStart = millis();
+			if (sent < EVENTS && millis() - start >= sent * EVENT_EVERY_MS)
+			{
+				char msg[32];
+				snprintf(msg, sizeof(msg), "energy1 %lu", ++sent);
+				transport.send(msg);
+			}
+			transport.run();
+			unsigned long pass = millis() - passStart;
+			longestPass = pass > longestPass ? pass : longestPass;
+			native::advanceMillis(1);
+		}
+
+		const st::RetryQueue &retries = transport.getRetryQueue();
+		bench::report("retry", scenario->name, client.events, "events received");
+		bench::report("retry", scenario->name, sent, "events sent");
+		bench::report("retry", scenario->name, client.outOfOrder, "events out of order or twice");
+		bench::report("retry", scenario->name, client.connects, "connects");
+		bench::report("retry", scenario->name, client.failures, "failed connects");
+		bench::report("retry", scenario->name, retries.getDeadLetters() + transport.dropped, "messages given up");
+		bench::report("retry", scenario->name, retries.getRecovered(), "messages delivered on a later attempt");
+		bench::report("retry", scenario->name, client.failures * client.failMillis, "ms in failed connects");
+		bench::report("retry", scenario->name, longestPass, "ms in the longest loop() pass");
+	}
+}
+
+void benchRetry()
+{
+	static const Scenario scenarios[] =
+	{
+		{ "hub reboot, immediate retry", true, true },
+		{ "hub reboot, retry queue", true, false },
+		{ "flaky link, immediate retry", false, true },
+		{ "flaky link, retry queue", false, false },
+	};
+
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runRetryScenario, const_cast<Scenario *>(&scenarios[i]));
+	}
+}
@@ -0,0 +1,182 @@
+//******************************************************************************************
+//  File: bench_rssi.cpp
+//
+//  Summary:  RSSI telemetry of the LAN transports, before and after it became change-driven
+//            (RssiReporter.h), as st::SmartThingsNative posting to a bench::StandInHub.
+//
+//            Two hours of simulated time, run() every 100ms, on a made-up signal trace:
+//            -62 dBm for 40 minutes, -74 dBm for 40 minutes (say, a door closed), then
+//            a slow climb back to -66 dBm - each reading with up to 3 dB of noise.
+//
+//            "ramp schedule" is the old run(): a POST of the raw reading every 5s, then
+//            every second longer, up to every RSSI_OLD_INTERVAL (60s).  "change-driven"
+//            is the transport as it is now.  Both are run without other traffic, and with
+//            an event every 20s in batch mode, where a report can ride along.
+//
+//            Reported: POSTs (connections to the hub), RSSI reports sent on their own and
+//            along with an event, and how far the hub's last RSSI is from the noise-free
+//            level on average, in dB.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "StandInHub.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <SmartThingsNative.h>
+
+namespace
+{
+	const unsigned long DURATION = 2UL * 60 * 60 * 1000;
+	const unsigned long STEP = 100;
+	const unsigned long RSSI_OLD_INTERVAL = 60000;	//RSSI_TX_INTERVAL before the change
+
+	void ignoreCallout(String message)
+	{
+	}
+
+	//noise-free level of the trace, t milliseconds into it, in 1/16 dB
+	long level16(unsigned long t)
+	{
+		const unsigned long minute = 60000;
+		if (t < 40 * minute)
+		{
+			return -62 * 16;
+		}
+		if (t < 80 * minute)
+		{
+			return -74 * 16;
+		}
+		return -74 * 16 + (long)((t - 80 * minute) * (8 * 16) / (40 * minute));
+	}
+
+	//a reading t milliseconds into the trace - the same noise for the same second in every scenario
+	long reading(unsigned long t)
+	{
+		unsigned long second = t / 1000;
+		unsigned long hash = second * 2654435761UL;
+		long noise = (long)((hash >> 16) % 7) - 3;
+		return level16(t) / 16 + noise;
+	}
+
+	struct Scenario
+	{
+		const char *name;
+		bool changeDriven;
+		unsigned long eventInterval;	//an event this often, in batch mode - 0 for none
+	};
+
+	//SmartThingsNative reading the trace as its RSSI
+	class Device: public st::SmartThingsNative
+	{
+		private:
+			const Scenario &m_Scenario;
+			unsigned long m_nStart;
+			long m_nInterval;			//ramp schedule
+			unsigned long m_nLastMillis;
+
+		protected:
+			virtual long readRSSI() { return m_Scenario.changeDriven ? reading(millis() - m_nStart) : 0; }
+
+		public:
+			unsigned long oldReports;
+			long oldReported;
+
+			Device(uint16_t hubPort, const Scenario &scenario) :
+				SmartThingsNative(0, IPAddress(127, 0, 0, 1), hubPort, ignoreCallout, "Native", false, 0),
+				m_Scenario(scenario), m_nStart(millis()), m_nInterval(5000), m_nLastMillis(millis() - 5000), oldReports(0), oldReported(0)
+			{
+			}
+
+			virtual void run(void)
+			{
+				//the old schedule, as SmartThingsHttpCore::run() had it - readRSSI() is 0 then, so the reporter stays out
+				if (!m_Scenario.changeDriven && millis() - m_nLastMillis > (unsigned long)m_nInterval)
+				{
+					m_nLastMillis = millis();
+					if (m_nInterval < (long)RSSI_OLD_INTERVAL)
+					{
+						m_nInterval += 1000;
+					}
+					oldReported = reading(millis() - m_nStart);
+					oldReports++;
+					send(String("rssi ") + String(oldReported));
+				}
+				SmartThingsNative::run();
+			}
+
+			long hubRSSI() const { return m_Scenario.changeDriven ? m_Rssi.getReported() : oldReported; }
+	};
+
+	void runScenario(void *arg)
+	{
+		const Scenario *scenario = static_cast<const Scenario *>(arg);
+
+		bench::StandInHub hub;
+		if (!hub.start())
+		{
+			fprintf(stderr, "rssi: stand-in hub did not start\n");
+			_exit(1);
+		}
+
+		Device device(hub.port(), *scenario);
+		device.init();
+		device.setBatchMode(scenario->eventInterval > 0);
+
+		unsigned long events = 0;
+		double errorSum = 0;
+		unsigned long errorSamples = 0;
+		for (unsigned long t = 0; t < DURATION; t += STEP)
+		{
+			if (scenario->eventInterval > 0 && t % scenario->eventInterval == 0)
+			{
+				char msg[32];
+				snprintf(msg, sizeof(msg), "temperature1 %lu", ++events);
+				device.send(msg);
+			}
+			device.run();
+
+			if (t % 1000 == 0 && device.hubRSSI() != 0)
+			{
+				errorSum += labs(device.hubRSSI() * 16 - level16(t)) / 16.0;
+				errorSamples++;
+			}
+			native::advanceMillis(STEP);
+		}
+
+		const st::RssiReporter &reporter = device.getRssiReporter();
+		unsigned long reports = scenario->changeDriven ? reporter.getReports() : device.oldReports;
+		unsigned long piggybacked = scenario->changeDriven ? reporter.getPiggybacked() : 0;
+
+		bench::report("rssi", scenario->name, hub.requests(), "POSTs");
+		bench::report("rssi", scenario->name, reports - piggybacked, "RSSI reports on their own");
+		bench::report("rssi", scenario->name, piggybacked, "RSSI reports along with an event");
+		bench::report("rssi", scenario->name, events, "events");
+		bench::report("rssi", scenario->name, errorSamples ? errorSum / errorSamples : 0, "dB hub RSSI off the level, mean");
+		hub.stop();
+	}
+}
+
+void benchRssi()
+{
+	static const Scenario scenarios[] =
+	{
+		{ "ramp schedule", false, 0 },
+		{ "change-driven", true, 0 },
+		{ "ramp schedule, batch, event every 20s", false, 20000 },
+		{ "change-driven, batch, event every 20s", true, 20000 },
+	};
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		bench::runIsolated(runScenario, const_cast<Scenario *>(&scenarios[i]));
+	}
+}
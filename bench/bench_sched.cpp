@@ -0,0 +1,218 @@
+//******************************************************************************************
+//  File: bench_sched.cpp
+//
+//  Summary:  Polling schedule accuracy.
+//
+//            30 polling sensors (intervals of 5 to 20s, offsets of 0 to 4s) run for one
+//            simulated hour.  Each pass of st::Everything::run() takes a random 1 to 9ms,
+//            and every 10 minutes one pass stalls for 2.5s, as a blocking network call would.
+//
+//            "scheduler" uses st::PollingSensor as polled by st::PollScheduler.  "legacy"
+//            is a copy of the old PollingSensor::checkInterval(), which accumulated the
+//            elapsed time from one update() call to the next and restarted the interval at
+//            the time of the late poll, kept for comparison.
+//
+//            Reported: polls made versus polls due on the ideal schedule (start + offset +
+//            k * interval), how far the last poll was behind its ideal time (cumulative
+//            drift), and for the scheduler the share of passes on which
+//            st::Everything::nextDeadline() was in the future, i.e. the loop could idle.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+
+#include <Constants.h>
+#include <Everything.h>
+#include <PollingSensor.h>
+
+namespace
+{
+	const unsigned int SENSORS = 30;
+	const unsigned long SIMULATED_MS = 3600000UL;
+	const unsigned long STALL_EVERY_MS = 600000UL;
+	const unsigned long STALL_MS = 2500;
+
+	long sensorInterval(unsigned int n) { return 5 + (n % 4) * 5; }
+	long sensorOffset(unsigned int n) { return n % 5; }
+
+	struct PollStats
+	{
+		unsigned long polls;
+		unsigned long lastPoll;
+	};
+
+	class CountingSensor: public st::PollingSensor
+	{
+		public:
+			PollStats stats;
+
+			CountingSensor(const __FlashStringHelper *name, long interval, long offset) :
+				PollingSensor(name, interval, offset)
+			{
+				stats.polls = 0;
+				stats.lastPoll = 0;
+			}
+
+			virtual void getData()
+			{
+				stats.polls++;
+				stats.lastPoll = millis();
+			}
+
+			virtual void refresh() {}	//only scheduled polls are counted
+	};
+
+	//the PollingSensor::checkInterval() logic this scheduler replaced
+	class LegacyCountingSensor: public st::Sensor
+	{
+		private:
+			unsigned long m_nPreviousTime;
+			long m_nDeltaTime;
+			long m_nInterval;
+			long m_nOffset;
+
+			bool checkInterval()
+			{
+				if(millis()<m_nPreviousTime)
+				{
+					m_nPreviousTime = 0;
+				}
+				if(m_nPreviousTime==0)
+				{
+					m_nPreviousTime=millis();
+				}
+				m_nDeltaTime+=(millis()-m_nPreviousTime)-m_nOffset;
+				m_nOffset=0;
+				m_nPreviousTime=millis();
+				if(m_nDeltaTime>=m_nInterval)
+				{
+					m_nDeltaTime=0;
+					return true;
+				}
+				return false;
+			}
+
+		public:
+			PollStats stats;
+
+			LegacyCountingSensor(const __FlashStringHelper *name, long interval, long offset) :
+				Sensor(name),
+				m_nPreviousTime(0),
+				m_nDeltaTime(0),
+				m_nInterval(interval * 1000),
+				m_nOffset(offset * 1000)
+			{
+				stats.polls = 0;
+				stats.lastPoll = 0;
+			}
+
+			virtual void init() {}
+			virtual void update()
+			{
+				if (checkInterval())
+				{
+					stats.polls++;
+					stats.lastPoll = millis();
+				}
+			}
+	};
+
+	void runSchedScenario(void *arg)
+	{
+		const bool legacy = (arg != 0);
+		const char *scenario = legacy ? "legacy checkInterval() 30 sensors" : "scheduler 30 sensors";
+
+		bench::NullTransport transport(st::receiveSmartString);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		PollStats *stats[SENSORS];
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			if (legacy)
+			{
+				LegacyCountingSensor *s = new LegacyCountingSensor(bench::deviceName("legacy", i), sensorInterval(i), sensorOffset(i));
+				stats[i] = &s->stats;
+				st::Everything::addSensor(s);
+			}
+			else
+			{
+				CountingSensor *s = new CountingSensor(bench::deviceName("counting", i), sensorInterval(i), sensorOffset(i));
+				stats[i] = &s->stats;
+				st::Everything::addSensor(s);
+			}
+		}
+		st::Everything::initDevices();
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			stats[i]->polls = 0;	//not counting the poll made by init()
+		}
+
+		unsigned long start = millis();
+		unsigned long random = 12345;
+		unsigned long passes = 0;
+		unsigned long idlePasses = 0;
+		unsigned long nextStall = STALL_EVERY_MS;
+		unsigned long lastPass = start;
+		while (millis() - start < SIMULATED_MS)
+		{
+			lastPass = millis();
+			st::Everything::run();
+			passes++;
+			if (!legacy && (long)(st::Everything::nextDeadline() - millis()) > 0)
+			{
+				idlePasses++;
+			}
+
+			random = random * 1103515245UL + 12345UL;
+			native::advanceMillis(1 + (random >> 16) % 9);
+			if (millis() - start >= nextStall)
+			{
+				native::advanceMillis(STALL_MS);
+				nextStall += STALL_EVERY_MS;
+			}
+		}
+		unsigned long end = lastPass - start;	//polls due after the last pass could not have been made
+
+		unsigned long due = 0;
+		unsigned long made = 0;
+		long worstDrift = 0;
+		for (unsigned int i = 0; i < SENSORS; i++)
+		{
+			long interval = sensorInterval(i) * 1000;
+			long first = sensorOffset(i) * 1000 + interval;
+			due += (end - first) / interval + 1;
+			made += stats[i]->polls;
+
+			//ideal time of the last poll that was made
+			long ideal = first + (long)(stats[i]->polls - 1) * interval;
+			long drift = (long)(stats[i]->lastPoll - start) - ideal;
+			if (drift > worstDrift)
+			{
+				worstDrift = drift;
+			}
+		}
+
+		bench::report("sched", scenario, due, "polls due");
+		bench::report("sched", scenario, made, "polls made");
+		bench::report("sched", scenario, worstDrift, "ms last poll behind schedule (worst)");
+		if (!legacy)
+		{
+			bench::report("sched", scenario, 100.0 * idlePasses / passes, "% passes that could idle (nextDeadline() ahead)");
+		}
+	}
+}
+
+void benchSched()
+{
+	bench::runIsolated(runSchedScenario, 0);
+	bench::runIsolated(runSchedScenario, (void *)1);
+}
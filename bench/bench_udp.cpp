@@ -0,0 +1,198 @@
+//******************************************************************************************
+//  File: bench_udp.cpp
+//
+//  Summary:  Event delivery of SmartThingsUDP over a lossy link.
+//
+//            A contact sensor's events are queued every 5ms (600 of them, transmit interval
+//            0) and sent by SmartThingsUDP to a bench::StandInReceiver on a loopback port
+//            that loses 0%, 5% or 20% of the datagrams in each direction.  The receiver also
+//            sends one command, then the same command id in a new session (a restarted
+//            receiver); each must reach the callout exactly once, 2 in all.
+//
+//            Reported: events received out of those queued, time from queueing an event to
+//            its first arrival (mean, median, 99th percentile, worst), datagrams and repeats
+//            sent, datagrams given up, and repeats the receiver dropped.  Loopback has no LAN
+//            latency - what is measured is the cost of the transport and of the repeats.
+//
+//            "receiver outage": an event every 250ms (60 of them) while the receiver is off
+//            the air from 1s to 11s - longer than the repeats of a datagram used to last, and
+//            more events than the window holds.  Reported as above, plus the SendQueue's drops
+//            and the longest time an event waited.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  The command again from a restarted receiver
+//    2026-10-17  Per Ivar Nerseth  Receiver outage
+//
+//******************************************************************************************
+
+#include "Bench.h"
+#include "StandInReceiver.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+#include <Constants.h>
+#include <Everything.h>
+#include <SmartThingsUDP.h>
+
+namespace
+{
+	const unsigned long EVENTS = 600;
+	const unsigned long long EVENT_EVERY_NANOS = 5000000ULL;
+
+	unsigned long commands;
+
+	void countCommand(String message)
+	{
+		if (message == "switch1 on")
+		{
+			commands++;
+		}
+	}
+
+	void runUdpScenario(void *arg)
+	{
+		const unsigned int loss = *static_cast<unsigned int *>(arg);
+		char scenario[64];
+		snprintf(scenario, sizeof(scenario), "%u%% loss", loss);
+		commands = 0;
+
+		bench::StandInReceiver receiver;
+		if (!receiver.start(loss))
+		{
+			fprintf(stderr, "udp: stand-in receiver did not start\n");
+			_exit(1);
+		}
+		bench::SocketUDP udp;
+		st::SmartThingsUDP transport(udp, IPAddress(127, 0, 0, 1), receiver.port(), 0, countCommand, "UDP", false, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();		//calls transport.init()
+
+		std::vector<unsigned long long> queuedAt(EVENTS);
+		unsigned long long start = bench::nowNanos();
+		unsigned long next = 0;
+		while (next < EVENTS || (transport.getPending() > 0 && bench::nowNanos() - start < 20000000000ULL))
+		{
+			if (next < EVENTS && bench::nowNanos() - start >= next * EVENT_EVERY_NANOS)
+			{
+				char msg[st::Constants::RETURN_MESSAGE_LENGTH];
+				int len = snprintf(msg, sizeof(msg), "contact1 %lu", next);
+				queuedAt[next++] = bench::nowNanos();
+				st::Everything::SendQueue.push(msg, len, st::PRIORITY_HIGH);
+			}
+			st::Everything::run();
+			usleep(50);
+		}
+		for (int i = 0; i < 200 && receiver.commandsAcked() < 2; i++)
+		{
+			st::Everything::run();
+			usleep(1000);
+		}
+
+		std::vector<double> latencies;
+		for (unsigned long i = 0; i < EVENTS; i++)
+		{
+			if (receiver.arrival(i))
+			{
+				latencies.push_back((receiver.arrival(i) - queuedAt[i]) / 1e6);
+			}
+		}
+		std::sort(latencies.begin(), latencies.end());
+		double total = 0;
+		for (size_t i = 0; i < latencies.size(); i++)
+		{
+			total += latencies[i];
+		}
+
+		bench::report("udp", scenario, receiver.distinct(), "events received");
+		bench::report("udp", scenario, EVENTS, "events queued");
+		if (!latencies.empty())
+		{
+			bench::report("udp", scenario, total / latencies.size(), "ms mean queue-to-receiver");
+			bench::report("udp", scenario, latencies[latencies.size() / 2], "ms median queue-to-receiver");
+			bench::report("udp", scenario, latencies[latencies.size() * 99 / 100], "ms p99 queue-to-receiver");
+			bench::report("udp", scenario, latencies.back(), "ms worst queue-to-receiver");
+		}
+		bench::report("udp", scenario, transport.getDatagrams(), "datagrams sent");
+		bench::report("udp", scenario, transport.getRetransmits(), "repeats sent");
+		bench::report("udp", scenario, transport.getLost(), "datagrams given up");
+		bench::report("udp", scenario, receiver.repeats(), "repeats dropped by receiver");
+		bench::report("udp", scenario, commands, "commands received");
+		receiver.stop();
+	}
+
+	void runUdpOutage(void *arg)
+	{
+		const char *scenario = "receiver outage";
+		const unsigned long OUTAGE_EVENTS = 60;
+		const unsigned long long EVERY_NANOS = 250000000ULL;
+
+		bench::StandInReceiver receiver;
+		if (!receiver.start(0))
+		{
+			fprintf(stderr, "udp: stand-in receiver did not start\n");
+			_exit(1);
+		}
+		bench::SocketUDP udp;
+		st::SmartThingsUDP transport(udp, IPAddress(127, 0, 0, 1), receiver.port(), 0, countCommand, "UDP", false, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		std::vector<unsigned long long> queuedAt(OUTAGE_EVENTS);
+		unsigned long long start = bench::nowNanos();
+		unsigned long next = 0;
+		bool down = false;
+		while (next < OUTAGE_EVENTS || ((transport.getPending() > 0 || !st::Everything::SendQueue.empty()) && bench::nowNanos() - start < 40000000000ULL))
+		{
+			unsigned long long t = bench::nowNanos() - start;
+			bool outage = t >= 1000000000ULL && t < 11000000000ULL;
+			if (outage != down)
+			{
+				down = outage;
+				receiver.setDown(down);
+			}
+			if (next < OUTAGE_EVENTS && t >= next * EVERY_NANOS)
+			{
+				char msg[st::Constants::RETURN_MESSAGE_LENGTH];
+				int len = snprintf(msg, sizeof(msg), "contact1 %lu", next);
+				queuedAt[next++] = bench::nowNanos();
+				st::Everything::SendQueue.push(msg, len, st::PRIORITY_HIGH);
+			}
+			st::Everything::run();
+			usleep(50);
+		}
+
+		double worst = 0;
+		for (unsigned long i = 0; i < OUTAGE_EVENTS; i++)
+		{
+			if (receiver.arrival(i))
+			{
+				worst = std::max(worst, (receiver.arrival(i) - queuedAt[i]) / 1e6);
+			}
+		}
+
+		bench::report("udp", scenario, receiver.distinct(), "events received");
+		bench::report("udp", scenario, OUTAGE_EVENTS, "events queued");
+		bench::report("udp", scenario, worst, "ms worst queue-to-receiver");
+		bench::report("udp", scenario, transport.getRetransmits(), "repeats sent");
+		bench::report("udp", scenario, transport.getLost(), "datagrams given up");
+		bench::report("udp", scenario, st::Everything::SendQueue.drops(), "SendQueue drops");
+		receiver.stop();
+	}
+}
+
+void benchUdp()
+{
+	static unsigned int losses[] = { 0, 5, 20 };
+	for (unsigned int i = 0; i < sizeof(losses) / sizeof(losses[0]); i++)
+	{
+		bench::runIsolated(runUdpScenario, &losses[i]);
+	}
+	bench::runIsolated(runUdpOutage, NULL);
+}
@@ -0,0 +1,235 @@
+//******************************************************************************************
+//  File: bench_voltage.cpp
+//
+//  Summary:  PS_Voltage with its compensation table and fixed-point averaging and filtering,
+//            against the old getData() arithmetic (pow() twice and map_double() per sample in
+//            double, the filter in float), which the bench keeps as OldVoltage.
+//
+//            "samples per second": getData() with 64 samples a poll, the analog input a random
+//            walk from sample to sample, measured in host time - with and without the
+//            compensation polynomial.  The host has an FPU; the ESP8266 has none, so there the
+//            old arithmetic is all soft-float and the difference larger.
+//
+//            "same values": 1000 polls of 8 samples, filter constant 75%, each value against
+//            the old arithmetic on the same samples - values that print the same (two
+//            decimals, as sent), and the largest difference in 1/1000 engineering unit.  "inputs":
+//            every analog input 0..4095 read alone (the table covers 0..PS_VOLTAGE_ADC_MAX, the
+//            rest is worked out per sample), against the old value.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <Everything.h>
+#include <PS_Voltage.h>
+
+namespace
+{
+	const byte PIN = 3;
+	const unsigned long POLLS = 20000;
+	const int SAMPLES = 64;
+
+	//the compensation of the example in PS_Voltage.h
+	const double S_L = -40, S_H = 140, M_L = 0, M_H = 4095;
+	const double C1 = -0.000000025934, C2 = 0.0001049656215, C3 = 0.9032840665333, C4 = 204.642825355678;
+
+	//the analog input: a random walk over 0..1023, one step per analogRead()
+	unsigned long random = 1;
+	int input = 512;
+
+	void analogReadHook(uint8_t pin)
+	{
+		random = random * 1103515245UL + 12345UL;
+		input += (int)((random >> 16) % 9) - 4;
+		input = input < 0 ? 0 : input > 1023 ? 1023 : input;
+		native::setAnalogPin(pin, input);
+	}
+
+	float map_double(double x, double in_min, double in_max, double out_min, double out_max)
+	{
+		return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+	}
+
+	//PS_Voltage as it was: the old getData() as it stood, on the example's mapping and compensation
+	class OldVoltage: public st::PollingSensor
+	{
+		public:
+			byte m_nAnalogInputPin;
+			float m_fSensorValue;
+			double SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH;
+			int m_nNumSamples;
+			float m_fFilterConstant;
+			double m_dCoeff1, m_dCoeff2, m_dCoeff3, m_dCoeff4;
+			bool m_bUseCompensation;
+
+			OldVoltage(bool compensation, int NumSamples, byte filterConstant) :
+				PollingSensor(F("voltage1"), 60, 0),
+				m_nAnalogInputPin(PIN),
+				m_fSensorValue(-1.0),
+				SENSOR_LOW(S_L),
+				SENSOR_HIGH(S_H),
+				MAPPED_LOW(M_L),
+				MAPPED_HIGH(M_H),
+				m_nNumSamples(NumSamples),
+				m_fFilterConstant(float(filterConstant) / 100),
+				m_dCoeff1(C1),
+				m_dCoeff2(C2),
+				m_dCoeff3(C3),
+				m_dCoeff4(C4),
+				m_bUseCompensation(compensation)
+			{
+			}
+
+			virtual void getData()
+			{
+				int i;
+				double tempValue = 0;
+				long tempAnalogInput = 0;
+
+				for (i = 0; i < m_nNumSamples; i++) {
+					tempAnalogInput = analogRead(m_nAnalogInputPin);
+					if (m_bUseCompensation) {
+						tempAnalogInput = (m_dCoeff1 * pow(tempAnalogInput, 3)) + (m_dCoeff2 * pow(tempAnalogInput, 2)) + (m_dCoeff3 * tempAnalogInput) + m_dCoeff4;
+					}
+					tempValue += map_double(tempAnalogInput, SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH);
+				}
+
+				tempValue = tempValue / m_nNumSamples;
+
+				if (m_fSensorValue == -1.0)
+				{
+					m_fSensorValue = tempValue;
+				}
+				else
+				{
+					m_fSensorValue = (m_fFilterConstant * tempValue) + (1 - m_fFilterConstant) * m_fSensorValue;
+				}
+
+				if (reportDue(m_fSensorValue))
+				{
+					st::Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+				}
+			}
+	};
+
+	st::PS_Voltage *newSensor(bool compensation, int samples, byte filterConstant)
+	{
+		if (compensation)
+		{
+			return new st::PS_Voltage(F("voltage1"), 60, 0, PIN, S_L, S_H, M_L, M_H, samples, filterConstant, C1, C2, C3, C4);
+		}
+		return new st::PS_Voltage(F("voltage1"), 60, 0, PIN, S_L, S_H, M_L, M_H, samples, filterConstant);
+	}
+
+	void runThroughput(void *arg)
+	{
+		bool compensation = arg != NULL;
+		const char *name = compensation ? "samples per second, compensation" : "samples per second, no compensation";
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+		native::setAnalogReadHook(analogReadHook);
+
+		st::PollingSensor *old = new OldVoltage(compensation, SAMPLES, 75);
+		old->setReportPolicy(1e9);		//the first value is sent, then none - the samples are measured, not the transport
+		unsigned long long start = bench::nowNanos();
+		for (unsigned long i = 0; i < POLLS; i++)
+		{
+			old->getData();
+		}
+		delete old;
+		double oldSeconds = (bench::nowNanos() - start) / 1e9;
+
+		st::PS_Voltage *sensor = newSensor(compensation, SAMPLES, 75);
+		sensor->setReportPolicy(1e9);
+		start = bench::nowNanos();
+		for (unsigned long i = 0; i < POLLS; i++)
+		{
+			sensor->getData();
+		}
+		double newSeconds = (bench::nowNanos() - start) / 1e9;
+		delete sensor;
+
+		bench::report("voltage", name, POLLS * SAMPLES / oldSeconds / 1e6, "million samples/s, old");
+		bench::report("voltage", name, POLLS * SAMPLES / newSeconds / 1e6, "million samples/s, now");
+		bench::report("voltage", name, oldSeconds / newSeconds, "times as many");
+	}
+
+	void runSame(void *arg)
+	{
+		bool compensation = arg != NULL;
+		const char *name = compensation ? "same values, compensation" : "same values, no compensation";
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		//both read the same samples - the hook is replayed for the old arithmetic
+		const int samples = 8;
+		OldVoltage old(compensation, samples, 75);
+		st::PS_Voltage *sensor = newSensor(compensation, samples, 75);
+		unsigned long same = 0;
+		double worst = 0;
+		for (int poll = 0; poll < 1000; poll++)
+		{
+			unsigned long savedRandom = random;
+			int savedInput = input;
+			native::setAnalogReadHook(analogReadHook);
+			sensor->getData();
+			random = savedRandom;
+			input = savedInput;
+			old.getData();
+			native::setAnalogReadHook(NULL);
+
+			same += String(sensor->getSensorValue()) == String(old.m_fSensorValue);
+			double difference = fabs(sensor->getSensorValue() - old.m_fSensorValue);
+			if (difference > worst)
+			{
+				worst = difference;
+			}
+		}
+		delete sensor;
+
+		bench::report("voltage", name, same, "of 1000 values print the same");
+		bench::report("voltage", name, worst * 1000, "largest difference, in 1/1000");
+	}
+
+	void runInputs(void *arg)
+	{
+		bench::NullTransport transport(st::receiveSmartString, 0);
+		st::Everything::SmartThing = &transport;
+		st::Everything::init();
+
+		st::PS_Voltage *sensor = newSensor(true, 1, 100);
+		OldVoltage old(true, 1, 100);
+		unsigned long same = 0;
+		for (int analogInput = 0; analogInput <= 4095; analogInput++)
+		{
+			native::setAnalogPin(PIN, analogInput);
+			sensor->getData();
+			old.getData();
+			same += String(sensor->getSensorValue()) == String(old.m_fSensorValue);
+		}
+		delete sensor;
+
+		bench::report("voltage", "inputs 0..4095, compensation", same, "of 4096 print the same");
+	}
+}
+
+void benchVoltage()
+{
+	static int compensation = 1;
+	bench::runIsolated(runThroughput, NULL);
+	bench::runIsolated(runThroughput, &compensation);
+	bench::runIsolated(runSame, NULL);
+	bench::runIsolated(runSame, &compensation);
+	bench::runIsolated(runInputs, NULL);
+}
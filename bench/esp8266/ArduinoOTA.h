@@ -0,0 +1,59 @@
+//******************************************************************************************
+//  File: ArduinoOTA.h
+//
+//  Summary:  Host stand-in for the ArduinoOTA library of the ESP8266 core - the callbacks are
+//            kept and never called, begin() and handle() are counted.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_ARDUINOOTA_H
+#define ST_BENCH_ARDUINOOTA_H
+
+#include <Arduino.h>
+
+#include <functional>
+
+typedef enum
+{
+	OTA_AUTH_ERROR,
+	OTA_BEGIN_ERROR,
+	OTA_CONNECT_ERROR,
+	OTA_RECEIVE_ERROR,
+	OTA_END_ERROR
+} ota_error_t;
+
+class ArduinoOTAClass
+{
+	private:
+		String m_Hostname;
+		unsigned long m_nBegins;
+		unsigned long m_nHandles;
+
+	public:
+		ArduinoOTAClass() : m_nBegins(0), m_nHandles(0) {}
+
+		void setHostname(const char *hostname) { m_Hostname = hostname; }
+		String getHostname() { return m_Hostname; }
+
+		void onStart(std::function<void(void)> fn) {}
+		void onEnd(std::function<void(void)> fn) {}
+		void onProgress(std::function<void(unsigned int, unsigned int)> fn) {}
+		void onError(std::function<void(ota_error_t)> fn) {}
+
+		void begin() { m_nBegins++; }
+		void handle() { m_nHandles++; }
+
+		//the host side
+		unsigned long getBegins() const { return m_nBegins; }
+		unsigned long getHandles() const { return m_nHandles; }
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif
@@ -0,0 +1,107 @@
+//******************************************************************************************
+//  File: ESP8266WiFi.h
+//
+//  Summary:  Host stand-in for the WiFi object of the ESP8266 core, enough to build and run
+//            SmartThingsESP8266WiFi and SmartThingsESP8266WiFiAsync on the host (see
+//            ESPAsyncTCP.h in this directory).
+//
+//            WiFiServer and WiFiClient are NativeServer and NativeClient (NativeSocket.h):
+//            real loopback sockets, and a server that hands out each connection once, as the
+//            ESP8266's does.  ESP keeps its RTC user memory in RAM.
+//
+//            begin() starts a join that completes setJoinMillis() after it, while the access
+//            point is up.  setAccessPoint(false) drops the station; it joins again
+//            setJoinMillis() after the next begin() once the access point is back.  Nothing
+//            here waits: status() works the state out from the simulated clock.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  WiFiServer/WiFiClient, ESP, and the BSSID/channel of the join
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_ESP8266WIFI_H
+#define ST_BENCH_ESP8266WIFI_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <NativeSocket.h>
+
+typedef NativeServer WiFiServer;
+typedef NativeClient WiFiClient;
+
+typedef enum
+{
+	WL_IDLE_STATUS = 0,
+	WL_NO_SSID_AVAIL = 1,
+	WL_CONNECTED = 3,
+	WL_CONNECT_FAILED = 4,
+	WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+	WIFI_OFF = 0,
+	WIFI_STA = 1,
+	WIFI_AP = 2,
+	WIFI_AP_STA = 3
+} WiFiMode_t;
+
+class ESP8266WiFiClass
+{
+	private:
+		bool m_bJoining;				//begin() called, not joined yet
+		bool m_bJoined;
+		bool m_bAccessPoint;
+		unsigned long m_nBeginMillis;
+		unsigned long m_nJoinMillis;
+		unsigned long m_nBegins;
+		String m_Hostname;
+
+	public:
+		ESP8266WiFiClass();
+
+		wl_status_t begin(const char *ssid, const char *passphrase = NULL, int32_t channel = 0, const uint8_t *bssid = NULL, bool connect = true);
+		bool config(IPAddress localIP, IPAddress gateway, IPAddress subnet, IPAddress dns = IPAddress()) { return true; }
+		bool disconnect(bool wifiOff = false);
+		wl_status_t status();
+		bool isConnected() { return status() == WL_CONNECTED; }
+
+		void persistent(bool persistent) {}
+		bool mode(WiFiMode_t mode) { return true; }
+		bool setAutoReconnect(bool autoReconnect) { return true; }
+		bool hostname(const char *name) { m_Hostname = name; return true; }
+		String hostname() { return m_Hostname; }
+
+		IPAddress localIP() { return m_bJoined ? IPAddress(192, 168, 1, 226) : IPAddress(); }
+		String macAddress() { return "5C:CF:7F:00:00:01"; }
+		int32_t RSSI() { return m_bJoined ? -62 : 31; }
+		uint8_t *BSSID();
+		int32_t channel() { return 6; }
+
+		//the host side
+		void setJoinMillis(unsigned long ms) { m_nJoinMillis = ms; }
+		void setAccessPoint(bool up);
+		unsigned long getBegins() const { return m_nBegins; }
+};
+
+extern ESP8266WiFiClass WiFi;
+
+class EspClass
+{
+	private:
+		uint32_t m_RtcUserMemory[128];
+
+	public:
+		EspClass();
+
+		bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+		bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+};
+
+extern EspClass ESP;
+
+#endif
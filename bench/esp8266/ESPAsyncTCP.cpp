@@ -0,0 +1,374 @@
+//******************************************************************************************
+//  File: ESPAsyncTCP.cpp
+//
+//  Summary:  Host stand-ins for the WiFi and ESP objects, ESPAsyncTCP and ArduinoOTA of the
+//            ESP8266 core (see ESP8266WiFi.h, ESPAsyncTCP.h and ArduinoOTA.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  ESP, connections to an AsyncServer
+//
+//******************************************************************************************
+
+#include "ESP8266WiFi.h"
+#include "ESPAsyncTCP.h"
+#include "ArduinoOTA.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+ESP8266WiFiClass WiFi;
+EspClass ESP;
+ArduinoOTAClass ArduinoOTA;
+
+//*******************************************************************************
+// WiFi
+//*******************************************************************************
+ESP8266WiFiClass::ESP8266WiFiClass() :
+	m_bJoining(false),
+	m_bJoined(false),
+	m_bAccessPoint(true),
+	m_nBeginMillis(0),
+	m_nJoinMillis(0),
+	m_nBegins(0)
+{
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel, const uint8_t *bssid, bool connect)
+{
+	m_bJoining = true;
+	m_bJoined = false;
+	m_nBeginMillis = millis();
+	m_nBegins++;
+	return WL_DISCONNECTED;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff)
+{
+	m_bJoining = false;
+	m_bJoined = false;
+	return true;
+}
+
+wl_status_t ESP8266WiFiClass::status()
+{
+	if (m_bJoining && m_bAccessPoint && millis() - m_nBeginMillis >= m_nJoinMillis)
+	{
+		m_bJoining = false;
+		m_bJoined = true;
+	}
+	return m_bJoined ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+uint8_t *ESP8266WiFiClass::BSSID()
+{
+	static uint8_t bssid[6] = { 0x5C, 0xCF, 0x7F, 0x00, 0x00, 0xAA };
+	return bssid;
+}
+
+void ESP8266WiFiClass::setAccessPoint(bool up)
+{
+	m_bAccessPoint = up;
+	if (!up)
+	{
+		m_bJoining = false;		//the station has to begin() again
+		m_bJoined = false;
+	}
+}
+
+//*******************************************************************************
+// ESP - offset and size in the units of the core: 4-byte blocks, bytes
+//*******************************************************************************
+EspClass::EspClass()
+{
+	memset(m_RtcUserMemory, 0, sizeof(m_RtcUserMemory));
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+{
+	if (offset * 4 + size > sizeof(m_RtcUserMemory))
+	{
+		return false;
+	}
+	memcpy(data, (uint8_t *)m_RtcUserMemory + offset * 4, size);
+	return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+	if (offset * 4 + size > sizeof(m_RtcUserMemory))
+	{
+		return false;
+	}
+	memcpy((uint8_t *)m_RtcUserMemory + offset * 4, data, size);
+	return true;
+}
+
+//*******************************************************************************
+// The hub
+//*******************************************************************************
+namespace
+{
+	std::vector<AsyncClient *> clients;		//every AsyncClient in existence
+	std::vector<AsyncServer *> servers;		//every AsyncServer in existence
+	bool hubUp = true;
+	unsigned long requests, events, replays, outOfOrder;
+	long highest = -1;
+
+	//one complete request at the front of sent - counted and removed, false if not complete yet
+	bool takeRequest(std::string &sent)
+	{
+		size_t end = sent.find("\r\n\r\n");
+		if (end == std::string::npos)
+		{
+			return false;
+		}
+		std::string headers = sent.substr(0, end);
+		size_t length = 0;
+		size_t at = headers.find("CONTENT-LENGTH: ");
+		if (at != std::string::npos)
+		{
+			length = strtoul(headers.c_str() + at + 16, NULL, 10);
+		}
+		if (sent.size() < end + 4 + length)
+		{
+			return false;
+		}
+
+		requests++;
+		if (headers.find("EVENT-AGE: ") != std::string::npos)
+		{
+			replays++;
+		}
+		std::string body = sent.substr(end + 4, length);
+		size_t start = 0;
+		while (start < body.size())
+		{
+			size_t stop = body.find('\n', start);
+			std::string line = body.substr(start, stop == std::string::npos ? std::string::npos : stop - start);
+			start = stop == std::string::npos ? body.size() : stop + 1;
+			if (line.empty())
+			{
+				continue;
+			}
+			events++;
+			size_t digits = line.find_last_not_of("0123456789");
+			if (line.compare(0, 5, "rssi ") != 0 && digits != std::string::npos && digits + 1 < line.size())
+			{
+				long number = atol(line.c_str() + digits + 1);
+				if (number <= highest)
+				{
+					outOfOrder++;
+				}
+				highest = std::max(highest, number);
+			}
+		}
+
+		//anything after the body up to the next request (the "\r\n" of a request that closes) is dropped
+		size_t next = sent.find("POST ", end + 4 + length);
+		sent.erase(0, next == std::string::npos ? sent.size() : next);
+		return true;
+	}
+}
+
+//*******************************************************************************
+// AsyncClient
+//*******************************************************************************
+AsyncClient::AsyncClient() :
+	m_nState(CLOSED),
+	m_pServer(NULL)
+{
+	clients.push_back(this);
+}
+
+AsyncClient::~AsyncClient()
+{
+	clients.erase(std::remove(clients.begin(), clients.end(), this), clients.end());
+}
+
+bool AsyncClient::connect(IPAddress ip, uint16_t port)
+{
+	if (m_nState != CLOSED || !WiFi.isConnected())
+	{
+		return false;
+	}
+	m_nState = CONNECTING;
+	m_Sent = String();
+	return true;
+}
+
+void AsyncClient::close(bool now)
+{
+	if (m_nState != CLOSED)
+	{
+		m_nState = CLOSING;
+	}
+}
+
+size_t AsyncClient::add(const char *data, size_t size, uint8_t apiflags)
+{
+	if (m_nState != CONNECTED)
+	{
+		return 0;
+	}
+	m_Sent.concat(data, size);
+	return size;
+}
+
+size_t AsyncClient::write(const char *data, size_t size, uint8_t apiflags)
+{
+	size_t written = add(data, size, apiflags);
+	send();
+	return written;
+}
+
+void runClient(AsyncClient &client)
+{
+	switch (client.m_nState)
+	{
+	case AsyncClient::CONNECTING:
+		if (hubUp && WiFi.isConnected())
+		{
+			client.m_nState = AsyncClient::CONNECTED;
+			if (client.m_onConnect)
+			{
+				client.m_onConnect(NULL, &client);
+			}
+		}
+		else
+		{
+			client.m_nState = AsyncClient::CLOSED;		//refused
+			if (client.m_onDisconnect)
+			{
+				client.m_onDisconnect(NULL, &client);
+			}
+		}
+		break;
+
+	case AsyncClient::ACCEPTING:
+		client.m_nState = AsyncClient::CONNECTED;
+		if (client.m_pServer->m_onClient)
+		{
+			client.m_pServer->m_onClient(NULL, &client);
+		}
+		if (client.m_onData && client.m_nState == AsyncClient::CONNECTED)
+		{
+			String received = client.m_Received;
+			client.m_Received = String();
+			client.m_onData(NULL, &client, (void *)received.c_str(), received.length());
+		}
+		break;
+
+	case AsyncClient::CONNECTED:
+		if (!WiFi.isConnected() || (client.m_pServer == NULL && !hubUp))
+		{
+			client.close(true);		//reset - onDisconnect on the next pass
+			break;
+		}
+		if (client.m_pServer == NULL)
+		{
+			std::string sent(client.m_Sent.c_str(), client.m_Sent.length());
+			bool answered = false;
+			while (takeRequest(sent))
+			{
+				answered = true;
+			}
+			if (answered)
+			{
+				client.m_Sent = String(sent.c_str());
+				static char reply[] = "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n";
+				if (client.m_onData)
+				{
+					client.m_onData(NULL, &client, reply, strlen(reply));
+				}
+			}
+		}
+		break;
+
+	case AsyncClient::CLOSING:
+		client.m_nState = AsyncClient::CLOSED;
+		if (client.m_onDisconnect)
+		{
+			client.m_onDisconnect(NULL, &client);
+		}
+		break;
+
+	case AsyncClient::CLOSED:
+		break;
+	}
+}
+
+//*******************************************************************************
+// AsyncServer
+//*******************************************************************************
+AsyncServer::AsyncServer(uint16_t port) :
+	m_nPort(port),
+	m_bListening(false)
+{
+	servers.push_back(this);
+}
+
+AsyncServer::~AsyncServer()
+{
+	servers.erase(std::remove(servers.begin(), servers.end(), this), servers.end());
+}
+
+bool asynctcpAccept(uint16_t port, const char *data, size_t len)
+{
+	for (size_t i = 0; i < servers.size(); i++)
+	{
+		if (servers[i]->m_nPort == port && servers[i]->m_bListening)
+		{
+			AsyncClient *client = new AsyncClient();	//the server's onDisconnect deletes it, as the library's does
+			client->m_nState = AsyncClient::ACCEPTING;
+			client->m_pServer = servers[i];
+			client->m_Received.concat(data, len);
+			return true;
+		}
+	}
+	return false;
+}
+
+namespace asynctcp
+{
+	bool connect(uint16_t port, const char *data, size_t len)
+	{
+		return asynctcpAccept(port, data, len);
+	}
+
+	void runStack()
+	{
+		//a callback may close, create or delete clients - each one alive at the start is run once
+		std::vector<AsyncClient *> now(clients);
+		for (size_t i = 0; i < now.size(); i++)
+		{
+			if (std::find(clients.begin(), clients.end(), now[i]) != clients.end())
+			{
+				runClient(*now[i]);
+			}
+		}
+	}
+
+	void setHubUp(bool up)
+	{
+		hubUp = up;
+	}
+
+	void resetHub()
+	{
+		hubUp = true;
+		requests = events = replays = outOfOrder = 0;
+		highest = -1;
+	}
+
+	unsigned long hubRequests() { return requests; }
+	unsigned long hubEvents() { return events; }
+	unsigned long hubReplays() { return replays; }
+	unsigned long hubOutOfOrder() { return outOfOrder; }
+}
@@ -0,0 +1,128 @@
+//******************************************************************************************
+//  File: ESPAsyncTCP.h
+//
+//  Summary:  Host stand-in for the ESPAsyncTCP library: AsyncClient and AsyncServer with the
+//            library's callback interface, and a hub for the connections to go to, so that
+//            SmartThingsESP8266WiFiAsync builds and runs on the host unchanged.
+//
+//            Nothing happens inside a call: connect(), write() and close() are carried out by
+//            asynctcp::runStack(), which plays the TCP stack the ESP8266 core runs between
+//            passes of loop() - the callbacks are called from there.
+//
+//            The hub takes a connection while it is up (asynctcp::setHubUp()), and answers each
+//            complete POST with "202 Accepted".  It counts the requests, the events (body lines)
+//            and the requests with an EVENT-AGE header.  A connect while the station has not
+//            joined (WiFi.status()) fails at once; one to a hub that is down fails in
+//            runStack(), with onDisconnect, as a refused connection does.
+//
+//            asynctcp::connect() opens a connection to an AsyncServer that has begun, with the
+//            bytes of a request; runStack() hands it to the server's onClient, then the bytes to
+//            the onData the server set.  What is written back on it is not taken for the hub.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Connections to an AsyncServer
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_ESPASYNCTCP_H
+#define ST_BENCH_ESPASYNCTCP_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#include <functional>
+
+#define ASYNC_WRITE_FLAG_COPY 0x01
+
+class AsyncClient;
+class AsyncServer;
+
+typedef std::function<void(void *, AsyncClient *)> AcConnectHandler;
+typedef std::function<void(void *, AsyncClient *, size_t len, uint32_t time)> AcAckHandler;
+typedef std::function<void(void *, AsyncClient *, void *data, size_t len)> AcDataHandler;
+
+class AsyncClient
+{
+	private:
+		enum State
+		{
+			CLOSED,
+			CONNECTING,		//runStack() connects, or fails
+			CONNECTED,
+			CLOSING,		//runStack() calls onDisconnect
+			ACCEPTING		//runStack() hands it to the server, then m_Received
+		};
+		State m_nState;
+		String m_Sent;				//bytes written since the last request the hub answered
+		AsyncServer *m_pServer;		//the server it was opened to, NULL for one to the hub
+		String m_Received;			//bytes for the server's onData
+
+		AcConnectHandler m_onConnect;
+		AcConnectHandler m_onDisconnect;
+		AcConnectHandler m_onPoll;
+		AcDataHandler m_onData;
+		AcAckHandler m_onAck;
+
+		friend void runClient(AsyncClient &client);
+		friend bool asynctcpAccept(uint16_t port, const char *data, size_t len);
+
+	public:
+		AsyncClient();
+		~AsyncClient();
+
+		bool connect(IPAddress ip, uint16_t port);
+		void close(bool now = false);
+		bool connected() const { return m_nState == CONNECTED; }
+
+		size_t space() const { return 5744; }
+		size_t add(const char *data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY);
+		bool send() { return m_nState == CONNECTED; }
+		size_t write(const char *data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY);
+		void setNoDelay(bool nodelay) {}
+
+		void onConnect(AcConnectHandler cb, void *arg = 0) { m_onConnect = cb; }
+		void onDisconnect(AcConnectHandler cb, void *arg = 0) { m_onDisconnect = cb; }
+		void onPoll(AcConnectHandler cb, void *arg = 0) { m_onPoll = cb; }
+		void onData(AcDataHandler cb, void *arg = 0) { m_onData = cb; }
+		void onAck(AcAckHandler cb, void *arg = 0) { m_onAck = cb; }
+};
+
+class AsyncServer
+{
+	private:
+		uint16_t m_nPort;
+		AcConnectHandler m_onClient;
+		bool m_bListening;
+
+		friend void runClient(AsyncClient &client);
+		friend bool asynctcpAccept(uint16_t port, const char *data, size_t len);
+
+	public:
+		AsyncServer(uint16_t port);
+		~AsyncServer();
+
+		void begin() { m_bListening = true; }
+		void setNoDelay(bool nodelay) {}
+		void onClient(AcConnectHandler cb, void *arg) { m_onClient = cb; }
+
+		bool listening() const { return m_bListening; }
+};
+
+namespace asynctcp
+{
+	void runStack();				//connects, answers and closes what the clients asked for since the last call
+	bool connect(uint16_t port, const char *data, size_t len);	//false if no AsyncServer has begun on port
+
+	void setHubUp(bool up);
+	void resetHub();
+	unsigned long hubRequests();
+	unsigned long hubEvents();
+	unsigned long hubReplays();		//requests with an EVENT-AGE header
+	unsigned long hubOutOfOrder();	//events whose trailing number is not above every earlier event's
+}
+
+#endif
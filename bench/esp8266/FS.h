@@ -0,0 +1,41 @@
+//******************************************************************************************
+//  File: FS.h
+//
+//  Summary:  Host stand-in for the file system of the ESP8266 core - no file can be opened,
+//            as on a board whose sketch did not mount SPIFFS.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_FS_H
+#define ST_BENCH_FS_H
+
+#include <Arduino.h>
+
+namespace fs
+{
+	class File
+	{
+		public:
+			operator bool() const { return false; }
+			size_t read(uint8_t *buf, size_t size) { return 0; }
+			size_t write(const uint8_t *buf, size_t size) { return 0; }
+			void close() {}
+	};
+
+	class FS
+	{
+		public:
+			File open(const char *path, const char *mode) { return File(); }
+	};
+}
+
+using fs::File;
+using fs::FS;
+
+#endif
@@ -0,0 +1,35 @@
+//******************************************************************************************
+//  File: StreamString.h
+//
+//  Summary:  Host stand-in for the StreamString of the ESP8266 core - a String that can be
+//            printed to.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_STREAMSTRING_H
+#define ST_BENCH_STREAMSTRING_H
+
+#include <Arduino.h>
+
+class StreamString: public Print, public String
+{
+	public:
+		virtual size_t write(uint8_t c) { return concat((char)c) ? 1 : 0; }
+		virtual size_t write(const uint8_t *buffer, size_t size)
+		{
+			size_t n = 0;
+			while (n < size && write(buffer[n]))
+			{
+				n++;
+			}
+			return n;
+		}
+};
+
+#endif
@@ -0,0 +1,98 @@
+//******************************************************************************************
+//  File: main.cpp
+//
+//  Summary:  Entry point of the host benchmark program built by [env:native].
+//            With no arguments every suite is run, otherwise only the suites named on
+//            the command line (e.g. "program loop").
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Added the batch suite
+//    2026-10-16  Per Ivar Nerseth  Added the sched suite
+//    2026-10-16  Per Ivar Nerseth  Added the dispatch suite
+//    2026-10-16  Per Ivar Nerseth  Added the edge suite
+//    2026-10-16  Per Ivar Nerseth  Added the report suite
+//    2026-10-16  Per Ivar Nerseth  Added the metrics suite
+//    2026-10-16  Per Ivar Nerseth  Added the http suite
+//    2026-10-16  Per Ivar Nerseth  Added the conn suite
+//    2026-10-16  Per Ivar Nerseth  Added the async suite
+//    2026-10-16  Per Ivar Nerseth  Added the mqtt suite
+//    2026-10-16  Per Ivar Nerseth  Added the udp suite
+//    2026-10-16  Per Ivar Nerseth  Added the outage suite
+//    2026-10-16  Per Ivar Nerseth  Added the link suite
+//    2026-10-16  Per Ivar Nerseth  Added the retry suite
+//    2026-10-17  Per Ivar Nerseth  Added the core suite
+//    2026-10-17  Per Ivar Nerseth  Added the rssi suite
+//    2026-10-17  Per Ivar Nerseth  Added the dht suite
+//    2026-10-17  Per Ivar Nerseth  Added the am2320 suite
+//    2026-10-17  Per Ivar Nerseth  Added the ds18b20 suite
+//    2026-10-17  Per Ivar Nerseth  Added the voltage suite
+//
+//******************************************************************************************
+
+#include "Bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+	struct Suite
+	{
+		const char *name;
+		void (*run)();
+	};
+
+	const Suite suites[] =
+	{
+		{ "loop", benchLoop },
+		{ "batch", benchBatch },
+		{ "sched", benchSched },
+		{ "dispatch", benchDispatch },
+		{ "edge", benchEdge },
+		{ "report", benchReport },
+		{ "metrics", benchMetrics },
+		{ "http", benchHttp },
+		{ "conn", benchConn },
+		{ "async", benchAsync },
+		{ "mqtt", benchMqtt },
+		{ "udp", benchUdp },
+		{ "outage", benchOutage },
+		{ "link", benchLink },
+		{ "retry", benchRetry },
+		{ "core", benchCore },
+		{ "rssi", benchRssi },
+		{ "dht", benchDht },
+		{ "am2320", benchAm2320 },
+		{ "ds18b20", benchDs18b20 },
+		{ "voltage", benchVoltage },
+	};
+}
+
+int main(int argc, char *argv[])
+{
+	int ran = 0;
+	for (unsigned int i = 0; i < sizeof(suites) / sizeof(suites[0]); i++)
+	{
+		bool selected = (argc < 2);
+		for (int a = 1; a < argc; a++)
+		{
+			if (strcmp(argv[a], suites[i].name) == 0) selected = true;
+		}
+		if (selected)
+		{
+			suites[i].run();
+			ran++;
+		}
+	}
+
+	if (ran == 0)
+	{
+		fprintf(stderr, "usage: %s [suite...]\n", argv[0]);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,412 @@
+//******************************************************************************************
+//  File: DallasTemperature.cpp
+//
+//  Summary:  Host stand-ins for the OneWire and DallasTemperature libraries (see OneWire.h
+//            and DallasTemperature.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Added readPowerSupply()
+//
+//******************************************************************************************
+
+#include "DallasTemperature.h"
+
+#include <string.h>
+
+//*******************************************************************************
+// OneWire
+//*******************************************************************************
+OneWire::Probe OneWire::s_Probes[ONEWIRE_MAX_PROBES];
+uint8_t OneWire::s_nProbes = 0;
+
+OneWire::OneWire(uint8_t pin) :
+	m_nPin(pin),
+	m_nSearch(0)
+{
+}
+
+void OneWire::reset_search()
+{
+	m_nSearch = 0;
+}
+
+bool OneWire::search(uint8_t *newAddr, bool search_mode)
+{
+	busSearch();
+	Probe *p = probe(m_nSearch);
+	if (p == NULL)
+	{
+		m_nSearch = 0;
+		return false;
+	}
+	memcpy(newAddr, p->rom, 8);
+	m_nSearch++;
+	return true;
+}
+
+uint8_t OneWire::crc8(const uint8_t *addr, uint8_t len)
+{
+	uint8_t crc = 0;
+	while (len--)
+	{
+		uint8_t inbyte = *addr++;
+		for (uint8_t i = 8; i; i--)
+		{
+			uint8_t mix = (crc ^ inbyte) & 0x01;
+			crc >>= 1;
+			if (mix)
+			{
+				crc ^= 0x8C;
+			}
+			inbyte >>= 1;
+		}
+	}
+	return crc;
+}
+
+void OneWire::busReset()
+{
+	delayMicroseconds(ONEWIRE_RESET_US);
+}
+
+void OneWire::busBytes(uint8_t count)
+{
+	busSlots(count * 8);
+}
+
+void OneWire::busSlots(uint16_t count)
+{
+	delayMicroseconds(count * ONEWIRE_SLOT_US);
+}
+
+void OneWire::busSearch()
+{
+	busReset();
+	busBytes(1);
+	busSlots(64 * 3);
+}
+
+uint8_t OneWire::count() const
+{
+	uint8_t n = 0;
+	for (uint8_t i = 0; i < s_nProbes; i++)
+	{
+		n += s_Probes[i].pin == m_nPin;
+	}
+	return n;
+}
+
+OneWire::Probe *OneWire::probe(uint8_t index) const
+{
+	for (uint8_t i = 0; i < s_nProbes; i++)
+	{
+		if (s_Probes[i].pin == m_nPin && index-- == 0)
+		{
+			return &s_Probes[i];
+		}
+	}
+	return NULL;
+}
+
+OneWire::Probe *OneWire::find(const uint8_t *rom) const
+{
+	for (uint8_t i = 0; i < s_nProbes; i++)
+	{
+		if (s_Probes[i].pin == m_nPin && memcmp(s_Probes[i].rom, rom, 8) == 0)
+		{
+			return &s_Probes[i];
+		}
+	}
+	return NULL;
+}
+
+void OneWire::addProbe(uint8_t pin, const uint8_t *rom, float celsius)
+{
+	if (s_nProbes >= ONEWIRE_MAX_PROBES)
+	{
+		return;
+	}
+
+	//kept in ascending ROM order, the order a search finds them in
+	uint8_t at = s_nProbes;
+	while (at > 0 && memcmp(s_Probes[at - 1].rom, rom, 8) > 0)
+	{
+		s_Probes[at] = s_Probes[at - 1];
+		at--;
+	}
+	Probe &p = s_Probes[at];
+	p.pin = pin;
+	memcpy(p.rom, rom, 8);
+	p.celsius = celsius;
+	p.scratchpad = 85.0;
+	p.resolution = 12;
+	p.converting = false;
+	p.convertStart = 0;
+	s_nProbes++;
+}
+
+void OneWire::setCelsius(const uint8_t *rom, float celsius)
+{
+	for (uint8_t i = 0; i < s_nProbes; i++)
+	{
+		if (memcmp(s_Probes[i].rom, rom, 8) == 0)
+		{
+			s_Probes[i].celsius = celsius;
+		}
+	}
+}
+
+void OneWire::removeProbe(const uint8_t *rom)
+{
+	for (uint8_t i = 0; i < s_nProbes; i++)
+	{
+		if (memcmp(s_Probes[i].rom, rom, 8) == 0)
+		{
+			memmove(&s_Probes[i], &s_Probes[i + 1], (s_nProbes - i - 1) * sizeof(Probe));
+			s_nProbes--;
+			return;
+		}
+	}
+}
+
+void OneWire::clearProbes()
+{
+	s_nProbes = 0;
+}
+
+//*******************************************************************************
+// DallasTemperature
+//*******************************************************************************
+DallasTemperature::DallasTemperature(OneWire *wire) :
+	m_pWire(wire),
+	m_nDevices(0),
+	m_nResolution(9),
+	m_bWaitForConversion(true)
+{
+}
+
+void DallasTemperature::begin(void)
+{
+	//one search per probe, and the one that finds none - each probe's scratchpad and power supply are read
+	m_nDevices = m_pWire->count();
+	for (uint8_t i = 0; i <= m_nDevices; i++)
+	{
+		m_pWire->busSearch();
+		if (i < m_nDevices)
+		{
+			m_pWire->busReset();
+			m_pWire->busBytes(1 + 8 + 1 + 9);
+			m_pWire->busReset();
+			m_pWire->busBytes(1 + 8 + 1);
+			m_pWire->busSlots(1);
+		}
+	}
+	m_nResolution = 9;
+	for (uint8_t i = 0; i < m_nDevices; i++)
+	{
+		if (m_pWire->probe(i)->resolution > m_nResolution)
+		{
+			m_nResolution = m_pWire->probe(i)->resolution;
+		}
+	}
+}
+
+uint8_t DallasTemperature::getDeviceCount(void)
+{
+	return m_nDevices;
+}
+
+bool DallasTemperature::getAddress(uint8_t *deviceAddress, uint8_t index)
+{
+	//reset_search(), then search() until the index-th device
+	OneWire::Probe *p = NULL;
+	for (uint8_t i = 0; i <= index; i++)
+	{
+		m_pWire->busSearch();
+		p = m_pWire->probe(i);
+		if (p == NULL)
+		{
+			return false;
+		}
+	}
+	memcpy(deviceAddress, p->rom, 8);
+	return true;
+}
+
+bool DallasTemperature::isConnected(const uint8_t *deviceAddress)
+{
+	m_pWire->busReset();
+	m_pWire->busBytes(1 + 8 + 1 + 9);
+	return m_pWire->find(deviceAddress) != NULL;
+}
+
+bool DallasTemperature::readPowerSupply(const uint8_t *deviceAddress)
+{
+	//reset, match ROM (or skip ROM), read power supply, one read slot
+	m_pWire->busReset();
+	m_pWire->busBytes(deviceAddress ? 1 + 8 + 1 : 2);
+	m_pWire->busSlots(1);
+	return false;
+}
+
+void DallasTemperature::setResolution(uint8_t newResolution)
+{
+	m_nResolution = constrain(newResolution, 9, 12);
+	DeviceAddress deviceAddress;
+	for (uint8_t i = 0; i < m_nDevices; i++)
+	{
+		if (getAddress(deviceAddress, i))
+		{
+			setResolution(deviceAddress, m_nResolution, true);
+		}
+	}
+}
+
+bool DallasTemperature::setResolution(const uint8_t *deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation)
+{
+	//read the scratchpad - if the resolution differs, write it back and copy it to the probe's EEPROM (20ms)
+	if (!isConnected(deviceAddress))
+	{
+		return false;
+	}
+	OneWire::Probe *p = m_pWire->find(deviceAddress);
+	newResolution = constrain(newResolution, 9, 12);
+	if (p->resolution == newResolution)
+	{
+		return true;
+	}
+	m_pWire->busReset();
+	m_pWire->busBytes(1 + 8 + 1 + 3);
+	m_pWire->busReset();
+	m_pWire->busBytes(1 + 8 + 1);
+	delay(20);
+	p->resolution = newResolution;
+	if (!skipGlobalBitResolutionCalculation && newResolution > m_nResolution)
+	{
+		m_nResolution = newResolution;
+	}
+	return true;
+}
+
+void DallasTemperature::startConversion(OneWire::Probe *probe)
+{
+	conversionDone(probe);
+	probe->converting = true;
+	probe->convertStart = millis();
+}
+
+bool DallasTemperature::conversionDone(OneWire::Probe *probe)
+{
+	if (probe->converting && millis() - probe->convertStart >= millisToWaitForConversion(probe->resolution))
+	{
+		float step = 0.5 / (1 << (probe->resolution - 9));	//0.5C at 9 bits .. 0.0625C at 12 bits
+		probe->scratchpad = floorf(probe->celsius / step) * step;
+		probe->converting = false;
+	}
+	return !probe->converting;
+}
+
+void DallasTemperature::requestTemperatures(void)
+{
+	//reset, skip ROM, convert T
+	m_pWire->busReset();
+	m_pWire->busBytes(2);
+	for (uint8_t i = 0; i < m_pWire->count(); i++)
+	{
+		startConversion(m_pWire->probe(i));
+	}
+	if (m_bWaitForConversion)
+	{
+		delay(millisToWaitForConversion(m_nResolution));
+	}
+}
+
+bool DallasTemperature::requestTemperaturesByAddress(const uint8_t *deviceAddress)
+{
+	//reset, match ROM, convert T
+	m_pWire->busReset();
+	m_pWire->busBytes(1 + 8 + 1);
+	OneWire::Probe *p = m_pWire->find(deviceAddress);
+	if (p == NULL)
+	{
+		return false;
+	}
+	startConversion(p);
+	if (m_bWaitForConversion)
+	{
+		delay(millisToWaitForConversion(p->resolution));
+	}
+	return true;
+}
+
+bool DallasTemperature::isConversionComplete(void)
+{
+	m_pWire->busSlots(1);
+	for (uint8_t i = 0; i < m_pWire->count(); i++)
+	{
+		if (!conversionDone(m_pWire->probe(i)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+uint16_t DallasTemperature::millisToWaitForConversion(uint8_t bitResolution)
+{
+	switch (bitResolution)
+	{
+		case 9:
+			return 94;
+		case 10:
+			return 188;
+		case 11:
+			return 375;
+		default:
+			return 750;
+	}
+}
+
+float DallasTemperature::getTempC(const uint8_t *deviceAddress)
+{
+	//reset, match ROM, read scratchpad
+	m_pWire->busReset();
+	m_pWire->busBytes(1 + 8 + 1 + 9);
+	OneWire::Probe *p = m_pWire->find(deviceAddress);
+	if (p == NULL)
+	{
+		return DEVICE_DISCONNECTED_C;
+	}
+	conversionDone(p);
+	return p->scratchpad;
+}
+
+float DallasTemperature::getTempF(const uint8_t *deviceAddress)
+{
+	float c = getTempC(deviceAddress);
+	return c == DEVICE_DISCONNECTED_C ? DEVICE_DISCONNECTED_F : toFahrenheit(c);
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index)
+{
+	DeviceAddress deviceAddress;
+	if (!getAddress(deviceAddress, index))
+	{
+		return DEVICE_DISCONNECTED_C;
+	}
+	return getTempC(deviceAddress);
+}
+
+float DallasTemperature::getTempFByIndex(uint8_t index)
+{
+	DeviceAddress deviceAddress;
+	if (!getAddress(deviceAddress, index))
+	{
+		return DEVICE_DISCONNECTED_F;
+	}
+	return getTempF(deviceAddress);
+}
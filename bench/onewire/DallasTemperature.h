@@ -0,0 +1,73 @@
+//******************************************************************************************
+//  File: DallasTemperature.h
+//
+//  Summary:  Host stand-in for the DallasTemperature library, on the simulated 1-Wire bus of
+//            OneWire.h in this directory.  The functions ST_Anything uses have the library's
+//            signatures and its bus traffic: getAddress() and the ...ByIndex() functions
+//            search the bus from the start up to the index, as the library does; getTempC()
+//            reads the probe's scratchpad by its ROM code (reset, match ROM, read
+//            scratchpad - 19 bytes); requestTemperatures() waits for the conversion in
+//            delay() unless setWaitForConversion(false).  The probes are externally powered:
+//            readPowerSupply() reads false.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  Added readPowerSupply()
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_DALLASTEMPERATURE_H
+#define ST_BENCH_DALLASTEMPERATURE_H
+
+#include <Arduino.h>
+#include "OneWire.h"
+
+typedef uint8_t DeviceAddress[8];
+
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_F -196.6
+
+class DallasTemperature
+{
+	public:
+		DallasTemperature(OneWire *wire);
+
+		void begin(void);
+		uint8_t getDeviceCount(void);
+		bool getAddress(uint8_t *deviceAddress, uint8_t index);
+		bool isConnected(const uint8_t *deviceAddress);
+		bool readPowerSupply(const uint8_t *deviceAddress = NULL);
+
+		void setResolution(uint8_t newResolution);
+		bool setResolution(const uint8_t *deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation = false);
+		uint8_t getResolution(void) { return m_nResolution; }
+
+		void setWaitForConversion(bool flag) { m_bWaitForConversion = flag; }
+		bool getWaitForConversion(void) { return m_bWaitForConversion; }
+
+		void requestTemperatures(void);
+		bool requestTemperaturesByAddress(const uint8_t *deviceAddress);
+		bool isConversionComplete(void);
+		uint16_t millisToWaitForConversion(uint8_t bitResolution);
+
+		float getTempC(const uint8_t *deviceAddress);
+		float getTempF(const uint8_t *deviceAddress);
+		float getTempCByIndex(uint8_t index);
+		float getTempFByIndex(uint8_t index);
+
+		static float toFahrenheit(float celsius) { return celsius * 1.8 + 32; }
+
+	private:
+		OneWire *m_pWire;
+		uint8_t m_nDevices;
+		uint8_t m_nResolution;
+		bool m_bWaitForConversion;
+
+		void startConversion(OneWire::Probe *probe);
+		bool conversionDone(OneWire::Probe *probe);
+};
+
+#endif
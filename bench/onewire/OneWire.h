@@ -0,0 +1,84 @@
+//******************************************************************************************
+//  File: OneWire.h
+//
+//  Summary:  Host stand-in for the OneWire library: a simulated 1-Wire bus of DS18B20
+//            probes per pin, used by the ds18b20 benchmark suite through the stand-in
+//            DallasTemperature (DallasTemperature.h in this directory).
+//
+//            Each bus transaction costs its standard-speed 1-Wire time in delayMicroseconds(),
+//            so it is counted as blocked time by native::blockedMicros(): a reset 960us, a
+//            time slot (one bit written or read) 70us.  A ROM search takes a reset, the
+//            command byte and three slots per ROM bit, about 14.5ms per probe found.
+//
+//            crc8() is the library's Dallas/Maxim CRC, so ROM codes must carry a valid one.
+//
+//            Probes are added and changed from the host with the static functions below.  A
+//            probe's scratchpad holds 85.0C after power-on, and the temperature of its last
+//            conversion once that has had its conversion time.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_ONEWIRE_H
+#define ST_BENCH_ONEWIRE_H
+
+#include <Arduino.h>
+
+#define ONEWIRE_RESET_US 960
+#define ONEWIRE_SLOT_US 70
+#define ONEWIRE_MAX_PROBES 32
+
+class OneWire
+{
+	public:
+		struct Probe
+		{
+			uint8_t pin;
+			uint8_t rom[8];
+			float celsius;					//temperature the next conversion will measure
+			float scratchpad;				//temperature in the scratchpad
+			uint8_t resolution;
+			bool converting;
+			unsigned long convertStart;		//millis() when the running conversion started
+		};
+
+		OneWire(uint8_t pin);
+
+		uint8_t getPin() const { return m_nPin; }
+
+		//the OneWire functions ST_Anything uses - search() costs a ROM search
+		void reset_search();
+		bool search(uint8_t *newAddr, bool search_mode = true);
+		static uint8_t crc8(const uint8_t *addr, uint8_t len);
+
+		//bus time - each call costs its 1-Wire time in delayMicroseconds()
+		void busReset();
+		void busBytes(uint8_t count);
+		void busSlots(uint16_t count);
+		void busSearch();
+
+		//probes on this bus, in ROM search order (ascending ROM code)
+		uint8_t count() const;
+		Probe *probe(uint8_t index) const;
+		Probe *find(const uint8_t *rom) const;
+
+		//host side - probes on the simulated buses
+		static void addProbe(uint8_t pin, const uint8_t *rom, float celsius);
+		static void setCelsius(const uint8_t *rom, float celsius);
+		static void removeProbe(const uint8_t *rom);
+		static void clearProbes();
+
+	private:
+		uint8_t m_nPin;
+		uint8_t m_nSearch;			//index of the probe the next search() finds
+
+		static Probe s_Probes[ONEWIRE_MAX_PROBES];
+		static uint8_t s_nProbes;
+};
+
+#endif
@@ -0,0 +1,18 @@
+//******************************************************************************************
+//  File: Wire.h
+//
+//  Summary:  Empty stand-in for the Arduino Wire (I2C) library, which some sensor headers
+//            include without using it, for the host build of the bench.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_BENCH_WIRE_H
+#define ST_BENCH_WIRE_H
+
+#endif
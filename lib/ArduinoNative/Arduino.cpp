@@ -0,0 +1,349 @@
+//*******************************************************************************
+//	ArduinoNative - Host (Linux) implementation of the Arduino core API
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-16  Per Ivar Nerseth  Added native::setYieldHook()
+//	2026-10-17  Per Ivar Nerseth  Added native::advanceMicros() and native::getPinMode()
+//	2026-10-17  Per Ivar Nerseth  Added native::setReadHook(), native::setInterruptsHook() and native::interruptsOn()
+//	2026-10-17  Per Ivar Nerseth  Added native::setAnalogReadHook()
+//	2026-10-17  Per Ivar Nerseth  Added digitalPinToInterrupt() and native::setInterruptPin()
+//*******************************************************************************
+#include "Arduino.h"
+
+#include <stdio.h>
+#include <time.h>
+
+namespace
+{
+	uint8_t pinLevel[NUM_DIGITAL_PINS];
+	uint8_t pinModes[NUM_DIGITAL_PINS];
+	int analogValue[NUM_DIGITAL_PINS];
+	int analogOut[NUM_DIGITAL_PINS];
+
+	void (*isrFunc[NUM_DIGITAL_PINS])(void);
+	int isrMode[NUM_DIGITAL_PINS];
+	bool isrPending[NUM_DIGITAL_PINS];
+	bool noInterruptPin[NUM_DIGITAL_PINS];	//see native::setInterruptPin()
+	bool interruptsEnabled = true;
+
+	unsigned long long simOffsetMicros = 0;	//simulated time added by delay() and advanceMillis()
+	unsigned long long blockedMicrosTotal = 0;	//simulated time added by delay() only
+
+	void (*yieldHook)() = NULL;		//see native::setYieldHook()
+	void (*readHook)(uint8_t pin) = NULL;	//see native::setReadHook()
+	void (*analogReadHook)(uint8_t pin) = NULL;	//see native::setAnalogReadHook()
+	void (*interruptsHook)() = NULL;		//see native::setInterruptsHook()
+
+	bool serialEcho = false;
+	const char *serialInput = NULL;
+
+	unsigned long long hostMicros()
+	{
+		static bool started = false;
+		static struct timespec start;
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if (!started)
+		{
+			start = now;
+			started = true;
+		}
+		return (unsigned long long)(now.tv_sec - start.tv_sec) * 1000000ULL + (now.tv_nsec - start.tv_nsec) / 1000;
+	}
+
+	bool validPin(uint8_t pin)
+	{
+		return pin < NUM_DIGITAL_PINS;
+	}
+}
+
+//*******************************************************************************
+// Time
+//*******************************************************************************
+unsigned long micros()
+{
+	return (unsigned long)(hostMicros() + simOffsetMicros);
+}
+
+unsigned long millis()
+{
+	return (unsigned long)((hostMicros() + simOffsetMicros) / 1000);
+}
+
+void delay(unsigned long ms)
+{
+	if (yieldHook == NULL)
+	{
+		simOffsetMicros += (unsigned long long)ms * 1000;
+		blockedMicrosTotal += (unsigned long long)ms * 1000;
+		return;
+	}
+
+	//the core runs its system tasks while the sketch waits
+	for (unsigned long i = 0; i < ms; i++)
+	{
+		simOffsetMicros += 1000;
+		blockedMicrosTotal += 1000;
+		yieldHook();
+	}
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	simOffsetMicros += us;
+	blockedMicrosTotal += us;
+}
+
+void yield()
+{
+	if (yieldHook)
+	{
+		yieldHook();
+	}
+}
+
+//*******************************************************************************
+// Digital and Analog I/O
+//*******************************************************************************
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	if (!validPin(pin)) return;
+	pinModes[pin] = mode;
+	if (mode == INPUT_PULLUP) pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	if (!validPin(pin)) return;
+	pinLevel[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+	if (!validPin(pin)) return LOW;
+	if (readHook) readHook(pin);
+	return pinLevel[pin];
+}
+
+int analogRead(uint8_t pin)
+{
+	if (!validPin(pin)) return 0;
+	if (analogReadHook) analogReadHook(pin);
+	return analogValue[pin];
+}
+
+void analogWrite(uint8_t pin, int val)
+{
+	if (!validPin(pin)) return;
+	analogOut[pin] = val;
+}
+
+//*******************************************************************************
+// Interrupts
+//*******************************************************************************
+int digitalPinToInterrupt(uint8_t pin)
+{
+	return validPin(pin) && !noInterruptPin[pin] ? pin : NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode)
+{
+	if (!validPin(interruptNum)) return;
+	isrFunc[interruptNum] = userFunc;
+	isrMode[interruptNum] = mode;
+	isrPending[interruptNum] = false;
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+	if (!validPin(interruptNum)) return;
+	isrFunc[interruptNum] = NULL;
+	isrPending[interruptNum] = false;
+}
+
+void noInterrupts()
+{
+	interruptsEnabled = false;
+}
+
+void interrupts()
+{
+	interruptsEnabled = true;
+	for (uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++)
+	{
+		if (isrPending[pin] && isrFunc[pin])
+		{
+			isrPending[pin] = false;
+			isrFunc[pin]();
+		}
+	}
+	if (interruptsHook)
+	{
+		interruptsHook();
+	}
+}
+
+//*******************************************************************************
+// Math
+//*******************************************************************************
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+long random(long howbig)
+{
+	if (howbig == 0) return 0;
+	return rand() % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+	if (howsmall >= howbig) return howsmall;
+	return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+	srand((unsigned int)seed);
+}
+
+//*******************************************************************************
+// Serial
+//*******************************************************************************
+NativeSerial Serial;
+
+int NativeSerial::available()
+{
+	return serialInput ? (int)strlen(serialInput) : 0;
+}
+
+int NativeSerial::read()
+{
+	if (!serialInput || !*serialInput) return -1;
+	return (unsigned char)*serialInput++;
+}
+
+int NativeSerial::peek()
+{
+	if (!serialInput || !*serialInput) return -1;
+	return (unsigned char)*serialInput;
+}
+
+size_t NativeSerial::write(uint8_t c)
+{
+	if (serialEcho) fputc(c, stdout);
+	return 1;
+}
+
+size_t NativeSerial::write(const uint8_t *buffer, size_t size)
+{
+	if (serialEcho) fwrite(buffer, 1, size, stdout);
+	return size;
+}
+
+//*******************************************************************************
+// Host-side controls for the simulated board
+//*******************************************************************************
+namespace native
+{
+	void setDigitalPin(uint8_t pin, uint8_t val)
+	{
+		if (!validPin(pin)) return;
+		uint8_t old = pinLevel[pin];
+		pinLevel[pin] = val ? HIGH : LOW;
+
+		if (isrFunc[pin] && old != pinLevel[pin])
+		{
+			bool fire = (isrMode[pin] == CHANGE) ||
+						(isrMode[pin] == RISING && pinLevel[pin] == HIGH) ||
+						(isrMode[pin] == FALLING && pinLevel[pin] == LOW);
+			if (fire)
+			{
+				if (interruptsEnabled) isrFunc[pin]();
+				else isrPending[pin] = true;
+			}
+		}
+	}
+
+	uint8_t getDigitalPin(uint8_t pin)
+	{
+		return validPin(pin) ? pinLevel[pin] : LOW;
+	}
+
+	uint8_t getPinMode(uint8_t pin)
+	{
+		return validPin(pin) ? pinModes[pin] : INPUT;
+	}
+
+	void setAnalogPin(uint8_t pin, int val)
+	{
+		if (validPin(pin)) analogValue[pin] = val;
+	}
+
+	int getAnalogWrite(uint8_t pin)
+	{
+		return validPin(pin) ? analogOut[pin] : 0;
+	}
+
+	void advanceMillis(unsigned long ms)
+	{
+		simOffsetMicros += (unsigned long long)ms * 1000;
+	}
+
+	void advanceMicros(unsigned long us)
+	{
+		simOffsetMicros += us;
+	}
+
+	void setYieldHook(void (*hook)())
+	{
+		yieldHook = hook;
+	}
+
+	void setReadHook(void (*hook)(uint8_t pin))
+	{
+		readHook = hook;
+	}
+
+	void setAnalogReadHook(void (*hook)(uint8_t pin))
+	{
+		analogReadHook = hook;
+	}
+
+	void setInterruptPin(uint8_t pin, bool hasInterrupt)
+	{
+		if (validPin(pin)) noInterruptPin[pin] = !hasInterrupt;
+	}
+
+	void setInterruptsHook(void (*hook)())
+	{
+		interruptsHook = hook;
+	}
+
+	bool interruptsOn()
+	{
+		return interruptsEnabled;
+	}
+
+	unsigned long long blockedMicros()
+	{
+		return blockedMicrosTotal;
+	}
+
+	void resetBlockedMicros()
+	{
+		blockedMicrosTotal = 0;
+	}
+
+	void setSerialEcho(bool echo)
+	{
+		serialEcho = echo;
+	}
+
+	void setSerialInput(const char *data)
+	{
+		serialInput = data;
+	}
+}
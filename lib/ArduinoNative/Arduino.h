@@ -0,0 +1,156 @@
+//*******************************************************************************
+//	ArduinoNative - Host (Linux) implementation of the Arduino core API
+//
+//	Summary:  Just enough of the Arduino core to build the ST_Anything library on a
+//			  PC for benchmarking (see [env:native] in platformio.ini).
+//			  -millis()/micros() follow the host's monotonic clock plus a simulated
+//			   offset.  delay() and delayMicroseconds() do NOT sleep, they advance the
+//			   simulated offset and are accounted in native::blockedMicros(), so code
+//			   that blocks on a real board shows up as "blocked time" in a benchmark.
+//			  -Digital and analog inputs are simulated pin arrays which the host
+//			   program drives through the native:: functions below.
+//			  -Serial output is discarded unless native::setSerialEcho(true) is called.
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-16  Per Ivar Nerseth  Added native::setYieldHook()
+//	2026-10-17  Per Ivar Nerseth  Added F_CPU, word(), native::advanceMicros() and native::getPinMode() - to play sensor waveforms into a pin
+//	2026-10-17  Per Ivar Nerseth  Added microsecondsToClockCycles(), native::setReadHook() and native::setInterruptsHook() - for busy-wait readers
+//	2026-10-17  Per Ivar Nerseth  Added native::setAnalogReadHook()
+//	2026-10-17  Per Ivar Nerseth  Added NOT_AN_INTERRUPT and native::setInterruptPin() - pins without an external interrupt
+//*******************************************************************************
+#ifndef __ARDUINO_NATIVE_H__
+#define __ARDUINO_NATIVE_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef ARDUINO_ARCH_NATIVE
+#define ARDUINO_ARCH_NATIVE
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT			0x0
+#define OUTPUT			0x1
+#define INPUT_PULLUP	0x2
+
+#define CHANGE	1
+#define FALLING	2
+#define RISING	3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+//clock of the simulated board (an ESP8266) - some libraries size their busy-wait loops by it
+#ifndef F_CPU
+#define F_CPU 80000000L
+#endif
+
+#define clockCyclesPerMicrosecond() (F_CPU / 1000000L)
+#define clockCyclesToMicroseconds(a) ((a) / clockCyclesPerMicrosecond())
+#define microsecondsToClockCycles(a) ((a) * clockCyclesPerMicrosecond())
+
+#define NUM_DIGITAL_PINS 64
+#define NUM_ANALOG_INPUTS 8
+#define A0 (NUM_DIGITAL_PINS - NUM_ANALOG_INPUTS)
+#define A1 (A0 + 1)
+#define A2 (A0 + 2)
+#define A3 (A0 + 3)
+#define A4 (A0 + 4)
+#define A5 (A0 + 5)
+
+//NodeMCU board markings, so the example sketches' pin definitions resolve
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define D9 3
+#define D10 1
+#define LED_BUILTIN 16
+
+//There is no separate program memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#define pgm_read_word(addr) (*(const unsigned short *)(addr))
+#define strcpy_P(dest, src) strcpy((dest), (src))
+#define strcmp_P(a, b) strcmp((a), (b))
+#define strlen_P(s) strlen((s))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+
+inline word makeWord(uint8_t h, uint8_t l) { return (h << 8) | l; }
+#define word(...) makeWord(__VA_ARGS__)
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define NOT_AN_INTERRUPT -1
+
+#include "WString.h"
+#include "Print.h"
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+int digitalPinToInterrupt(uint8_t pin);		//the pin itself, or NOT_AN_INTERRUPT (see native::setInterruptPin())
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void noInterrupts();
+void interrupts();
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+//*******************************************************************************
+// Host-side controls for the simulated board
+//*******************************************************************************
+namespace native
+{
+	void setDigitalPin(uint8_t pin, uint8_t val);	//drives an input pin; fires an attached interrupt on a matching edge
+	uint8_t getDigitalPin(uint8_t pin);				//last level written by digitalWrite() or setDigitalPin()
+	uint8_t getPinMode(uint8_t pin);				//last mode set by pinMode()
+	void setReadHook(void (*hook)(uint8_t pin));	//hook is called by digitalRead() before it reads pin, so the host can drive a
+													//waveform that a busy-wait loop samples - NULL to remove
+	void setAnalogPin(uint8_t pin, int val);		//value returned by analogRead(pin)
+	void setAnalogReadHook(void (*hook)(uint8_t pin));	//hook is called by analogRead() before it reads pin - NULL to remove
+	int getAnalogWrite(uint8_t pin);				//last value written by analogWrite(pin)
+
+	void advanceMillis(unsigned long ms);			//moves the simulated clock forward without counting it as blocked time
+	void advanceMicros(unsigned long us);
+	void setYieldHook(void (*hook)());				//hook is called by yield() and after each simulated ms of delay(), where an ESP8266
+													//core runs its system tasks (WiFi, TCP stack) - NULL to remove
+	void setInterruptPin(uint8_t pin, bool hasInterrupt);	//false == the pin has no external interrupt, as pins 22-53 of a MEGA
+	void setInterruptsHook(void (*hook)());			//hook is called by interrupts(), where interrupts held back by noInterrupts() run
+	bool interruptsOn();							//false between noInterrupts() and interrupts()
+	unsigned long long blockedMicros();				//total time "spent" in delay()/delayMicroseconds() since the last reset
+	void resetBlockedMicros();
+
+	void setSerialEcho(bool echo);					//true == Serial output is written to stdout
+	void setSerialInput(const char *data);			//bytes returned by Serial.read()
+}
+
+#endif
@@ -0,0 +1,36 @@
+//*******************************************************************************
+//	ArduinoNative - Host declaration of the Client interface
+//
+//	Same members as the Client class of the Arduino cores, which WiFiClient and
+//	EthernetClient implement - lets network-agnostic code (SmartThingsMQTT) build
+//	on the host.  The bench provides a POSIX socket implementation.
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __ARDUINO_NATIVE_CLIENT_H__
+#define __ARDUINO_NATIVE_CLIENT_H__
+
+#include "Print.h"
+#include "IPAddress.h"
+
+class Client : public Stream
+{
+	public:
+		virtual int connect(IPAddress ip, uint16_t port) = 0;
+		virtual int connect(const char *host, uint16_t port) = 0;
+		virtual size_t write(uint8_t) = 0;
+		virtual size_t write(const uint8_t *buf, size_t size) = 0;
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int read(uint8_t *buf, size_t size) = 0;
+		virtual int peek() = 0;
+		virtual void flush() = 0;
+		virtual void stop() = 0;
+		virtual uint8_t connected() = 0;
+		virtual operator bool() = 0;
+
+		using Print::write;
+};
+
+#endif
@@ -0,0 +1,37 @@
+//*******************************************************************************
+//	ArduinoNative - Host implementation of IPAddress
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __ARDUINO_NATIVE_IPADDRESS_H__
+#define __ARDUINO_NATIVE_IPADDRESS_H__
+
+#include <stdint.h>
+#include <string.h>
+#include "Print.h"
+
+class IPAddress : public Printable
+{
+	private:
+		uint8_t _address[4];
+
+	public:
+		IPAddress() { _address[0] = _address[1] = _address[2] = _address[3] = 0; }
+		IPAddress(uint8_t o1, uint8_t o2, uint8_t o3, uint8_t o4) { _address[0] = o1; _address[1] = o2; _address[2] = o3; _address[3] = o4; }
+		IPAddress(uint32_t address) { memcpy(_address, &address, sizeof(_address)); }
+
+		operator uint32_t() const { uint32_t a; memcpy(&a, _address, sizeof(a)); return a; }
+		bool operator == (const IPAddress &addr) const { return memcmp(_address, addr._address, sizeof(_address)) == 0; }
+		uint8_t operator [] (int index) const { return _address[index]; }
+		uint8_t & operator [] (int index) { return _address[index]; }
+
+		String toString() const
+		{
+			return String(_address[0]) + "." + String(_address[1]) + "." + String(_address[2]) + "." + String(_address[3]);
+		}
+
+		virtual size_t printTo(Print &p) const { return p.print(toString()); }
+};
+
+#endif
@@ -0,0 +1,287 @@
+//*******************************************************************************
+//	ArduinoNative - POSIX socket Client and Server
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  NativeServer offers connections again after setOffersAgain(true)
+//*******************************************************************************
+#include "NativeSocket.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+//*******************************************************************************
+// NativeClient
+//*******************************************************************************
+NativeClient::NativeClient() :
+	m_pSocket(0)
+{
+}
+
+NativeClient::NativeClient(int fd) :
+	m_pSocket(new Socket)
+{
+	m_pSocket->fd = fd;
+	m_pSocket->refs = 1;
+}
+
+NativeClient::NativeClient(const NativeClient &other) :
+	m_pSocket(other.m_pSocket)
+{
+	if (m_pSocket)
+	{
+		m_pSocket->refs++;
+	}
+}
+
+NativeClient &NativeClient::operator=(const NativeClient &other)
+{
+	if (other.m_pSocket)
+	{
+		other.m_pSocket->refs++;
+	}
+	release();
+	m_pSocket = other.m_pSocket;
+	return *this;
+}
+
+NativeClient::~NativeClient()
+{
+	release();
+}
+
+void NativeClient::release()
+{
+	if (m_pSocket && --m_pSocket->refs == 0)
+	{
+		if (m_pSocket->fd >= 0)
+		{
+			close(m_pSocket->fd);
+		}
+		delete m_pSocket;
+	}
+	m_pSocket = 0;
+}
+
+int NativeClient::connect(IPAddress ip, uint16_t port)
+{
+	release();		//other copies keep the old connection, as with WiFiClient
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		return 0;
+	}
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = (uint32_t)ip;
+	addr.sin_port = htons(port);
+	if (::connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+	{
+		close(fd);
+		return 0;
+	}
+	m_pSocket = new Socket;
+	m_pSocket->fd = fd;
+	m_pSocket->refs = 1;
+	return 1;
+}
+
+int NativeClient::connect(const char *host, uint16_t port)
+{
+	return connect(IPAddress(127, 0, 0, 1), port);
+}
+
+size_t NativeClient::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t NativeClient::write(const uint8_t *buf, size_t size)
+{
+	if (!*this)
+	{
+		return 0;
+	}
+	size_t left = size;
+	while (left > 0)
+	{
+		ssize_t n = ::send(m_pSocket->fd, buf, left, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (n <= 0)
+		{
+			return size - left;
+		}
+		buf += n;
+		left -= n;
+	}
+	return size;
+}
+
+int NativeClient::available()
+{
+	int count = 0;
+	if (!*this || ioctl(m_pSocket->fd, FIONREAD, &count) < 0)
+	{
+		return 0;
+	}
+	return count;
+}
+
+int NativeClient::read()
+{
+	uint8_t c;
+	return read(&c, 1) == 1 ? c : -1;
+}
+
+int NativeClient::read(uint8_t *buf, size_t size)
+{
+	if (!*this)
+	{
+		return -1;
+	}
+	ssize_t n = recv(m_pSocket->fd, buf, size, MSG_DONTWAIT);
+	return n > 0 ? (int)n : -1;
+}
+
+int NativeClient::peek()
+{
+	uint8_t c;
+	if (!*this || recv(m_pSocket->fd, &c, 1, MSG_DONTWAIT | MSG_PEEK) != 1)
+	{
+		return -1;
+	}
+	return c;
+}
+
+void NativeClient::stop()
+{
+	if (*this)
+	{
+		close(m_pSocket->fd);
+		m_pSocket->fd = -1;		//closed for every copy
+	}
+}
+
+uint8_t NativeClient::connected()
+{
+	if (!*this)
+	{
+		return 0;
+	}
+	//open while there is data to read, or a read would wait - 0 from recv is the peer's FIN
+	uint8_t c;
+	ssize_t n = recv(m_pSocket->fd, &c, 1, MSG_DONTWAIT | MSG_PEEK);
+	return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? 1 : 0;
+}
+
+void NativeClient::setNoDelay(bool noDelay)
+{
+	if (*this)
+	{
+		int flag = noDelay ? 1 : 0;
+		setsockopt(m_pSocket->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+	}
+}
+
+//*******************************************************************************
+// NativeServer
+//*******************************************************************************
+NativeServer::NativeServer(uint16_t port) :
+	m_nSocket(-1),
+	m_nPort(port),
+	m_bOffersAgain(false)
+{
+}
+
+NativeServer::~NativeServer()
+{
+	stop();
+}
+
+void NativeServer::begin()
+{
+	stop();
+	m_nSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if (m_nSocket < 0)
+	{
+		return;
+	}
+	int reuse = 1;
+	setsockopt(m_nSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(m_nPort);
+	socklen_t length = sizeof(addr);
+	if (bind(m_nSocket, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(m_nSocket, 64) < 0
+		|| getsockname(m_nSocket, (struct sockaddr *)&addr, &length) < 0)
+	{
+		stop();
+		return;
+	}
+	m_nPort = ntohs(addr.sin_port);
+	fcntl(m_nSocket, F_SETFL, fcntl(m_nSocket, F_GETFL) | O_NONBLOCK);
+}
+
+void NativeServer::stop()
+{
+	if (m_nSocket >= 0)
+	{
+		close(m_nSocket);
+		m_nSocket = -1;
+	}
+	for (int i = 0; i < NATIVE_SERVER_SOCKETS; i++)
+	{
+		m_Offered[i] = NativeClient();
+	}
+}
+
+NativeClient NativeServer::available()
+{
+	if (m_nSocket < 0)
+	{
+		return NativeClient();
+	}
+	if (!m_bOffersAgain)
+	{
+		int fd = accept(m_nSocket, NULL, NULL);
+		return fd < 0 ? NativeClient() : NativeClient(fd);
+	}
+
+	//as EthernetServer: take what is waiting into the free sockets, then offer the first connection
+	//with data to read or closed by the peer - the same one again until it is read or stopped
+	for (int i = 0; i < NATIVE_SERVER_SOCKETS; i++)
+	{
+		if (!m_Offered[i])
+		{
+			int fd = accept(m_nSocket, NULL, NULL);
+			if (fd < 0)
+			{
+				break;
+			}
+			m_Offered[i] = NativeClient(fd);
+		}
+	}
+	for (int i = 0; i < NATIVE_SERVER_SOCKETS; i++)
+	{
+		if (m_Offered[i] && (m_Offered[i].available() > 0 || !m_Offered[i].connected()))
+		{
+			return m_Offered[i];
+		}
+	}
+	return NativeClient();
+}
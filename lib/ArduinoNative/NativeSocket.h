@@ -0,0 +1,85 @@
+//*******************************************************************************
+//	ArduinoNative - POSIX socket Client and Server
+//
+//	NativeClient and NativeServer behave as WiFiClient and WiFiServer of the
+//	ESP8266 core, on TCP sockets of the host, so the transport engine
+//	(SmartThingsHttpCore.h) runs and can be load-tested on Linux:
+//	  - a NativeClient is a handle - copies share one socket, which is closed
+//	    by stop() or when the last copy goes away;
+//	  - reads never wait (available() == 0 until data has arrived), writes do;
+//	  - NativeServer::available() hands out each new connection once, and never
+//	    waits for one - or, after setOffersAgain(true), behaves as EthernetServer
+//	    (W5100/W5500) and the WiFi101/WiFiEsp servers: every connection with data
+//	    to read, or closed by the peer, is offered again on each call until it is
+//	    stopped (at most NATIVE_SERVER_SOCKETS at a time, as the W5100's sockets).
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  NativeClient::operator==, NativeServer::setOffersAgain()
+//*******************************************************************************
+#ifndef __ARDUINO_NATIVE_SOCKET_H__
+#define __ARDUINO_NATIVE_SOCKET_H__
+
+#include "Client.h"
+
+#define NATIVE_SERVER_SOCKETS 4
+
+class NativeClient : public Client
+{
+	private:
+		struct Socket
+		{
+			int fd;
+			unsigned int refs;
+		};
+		Socket *m_pSocket;
+
+		void release();
+
+	public:
+		NativeClient();
+		explicit NativeClient(int fd);		//takes over a connected socket
+		NativeClient(const NativeClient &other);
+		NativeClient &operator=(const NativeClient &other);
+		virtual ~NativeClient();
+
+		virtual int connect(IPAddress ip, uint16_t port);
+		virtual int connect(const char *host, uint16_t port);	//host is ignored - always 127.0.0.1
+		virtual size_t write(uint8_t c);
+		virtual size_t write(const uint8_t *buf, size_t size);
+		virtual int available();
+		virtual int read();
+		virtual int read(uint8_t *buf, size_t size);
+		virtual int peek();
+		virtual void flush() {}
+		virtual void stop();
+		virtual uint8_t connected();
+		virtual operator bool() { return m_pSocket != 0 && m_pSocket->fd >= 0; }
+		bool operator==(const NativeClient &other) const { return m_pSocket == other.m_pSocket; }	//the same connection
+
+		void setNoDelay(bool noDelay);		//TCP_NODELAY, as WiFiClient::setNoDelay()
+
+		using Print::write;
+};
+
+class NativeServer
+{
+	private:
+		int m_nSocket;
+		uint16_t m_nPort;
+		bool m_bOffersAgain;
+		NativeClient m_Offered[NATIVE_SERVER_SOCKETS];		//setOffersAgain(true): the open connections
+
+	public:
+		explicit NativeServer(uint16_t port);	//port 0 == any free port, see port() after begin()
+		~NativeServer();
+
+		void begin();
+		void stop();
+		NativeClient available();
+		void setOffersAgain(bool offersAgain) { m_bOffersAgain = offersAgain; }
+
+		uint16_t port() const { return m_nPort; }
+};
+
+#endif
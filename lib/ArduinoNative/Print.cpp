@@ -0,0 +1,125 @@
+//*******************************************************************************
+//	ArduinoNative - Host implementation of Print, Stream and the Serial port
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#include "Print.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+size_t Print::strlenSafe(const char *str)
+{
+	return strlen(str);
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+	size_t n = 0;
+	while (size--)
+	{
+		if (write(*buffer++)) n++;
+		else break;
+	}
+	return n;
+}
+
+size_t Print::print(const __FlashStringHelper *ifsh)
+{
+	return write(reinterpret_cast<const char *>(ifsh));
+}
+
+size_t Print::print(const String &s)
+{
+	return write((const uint8_t *)s.c_str(), s.length());
+}
+
+size_t Print::print(const char str[])
+{
+	return write(str);
+}
+
+size_t Print::print(char c)
+{
+	return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base)
+{
+	return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base)
+{
+	return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+	return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+	return print(String(n, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+	return print(String(n, (unsigned char)base));
+}
+
+size_t Print::print(double n, int digits)
+{
+	return print(String(n, (unsigned char)digits));
+}
+
+size_t Print::print(const Printable &x)
+{
+	return x.printTo(*this);
+}
+
+size_t Print::println(void)
+{
+	return write("\r\n");
+}
+
+#define ST_NATIVE_PRINTLN(type) \
+	size_t Print::println(type x) \
+	{ \
+		size_t n = print(x); \
+		return n + println(); \
+	}
+
+#define ST_NATIVE_PRINTLN_BASE(type) \
+	size_t Print::println(type x, int base) \
+	{ \
+		size_t n = print(x, base); \
+		return n + println(); \
+	}
+
+ST_NATIVE_PRINTLN(const __FlashStringHelper *)
+ST_NATIVE_PRINTLN(const String &)
+ST_NATIVE_PRINTLN(const char *)
+ST_NATIVE_PRINTLN(char)
+ST_NATIVE_PRINTLN(const Printable &)
+ST_NATIVE_PRINTLN_BASE(unsigned char)
+ST_NATIVE_PRINTLN_BASE(int)
+ST_NATIVE_PRINTLN_BASE(unsigned int)
+ST_NATIVE_PRINTLN_BASE(long)
+ST_NATIVE_PRINTLN_BASE(unsigned long)
+ST_NATIVE_PRINTLN_BASE(double)
+
+size_t Print::printf(const char *format, ...)
+{
+	char buf[256];
+	va_list arg;
+	va_start(arg, format);
+	int len = vsnprintf(buf, sizeof(buf), format, arg);
+	va_end(arg);
+	if (len < 0) return 0;
+	if ((size_t)len >= sizeof(buf)) len = sizeof(buf) - 1;
+	return write((const uint8_t *)buf, len);
+}
@@ -0,0 +1,95 @@
+//*******************************************************************************
+//	ArduinoNative - Host implementation of Print, Stream and the Serial port
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __ARDUINO_NATIVE_PRINT_H__
+#define __ARDUINO_NATIVE_PRINT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+class Print;
+
+class Printable
+{
+	public:
+		virtual ~Printable() {}
+		virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+	public:
+		virtual ~Print() {}
+
+		virtual size_t write(uint8_t c) = 0;
+		virtual size_t write(const uint8_t *buffer, size_t size);
+		size_t write(const char *str) { return str ? write((const uint8_t *)str, strlenSafe(str)) : 0; }
+		size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+		size_t print(const __FlashStringHelper *ifsh);
+		size_t print(const String &s);
+		size_t print(const char str[]);
+		size_t print(char c);
+		size_t print(unsigned char n, int base = 10);
+		size_t print(int n, int base = 10);
+		size_t print(unsigned int n, int base = 10);
+		size_t print(long n, int base = 10);
+		size_t print(unsigned long n, int base = 10);
+		size_t print(double n, int digits = 2);
+		size_t print(const Printable &x);
+
+		size_t println(const __FlashStringHelper *ifsh);
+		size_t println(const String &s);
+		size_t println(const char str[]);
+		size_t println(char c);
+		size_t println(unsigned char n, int base = 10);
+		size_t println(int n, int base = 10);
+		size_t println(unsigned int n, int base = 10);
+		size_t println(long n, int base = 10);
+		size_t println(unsigned long n, int base = 10);
+		size_t println(double n, int digits = 2);
+		size_t println(const Printable &x);
+		size_t println(void);
+
+		size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+	private:
+		static size_t strlenSafe(const char *str);
+};
+
+class Stream : public Print
+{
+	public:
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int peek() = 0;
+		virtual void flush() {}
+};
+
+//*******************************************************************************
+// Serial - output goes to stdout only when native::setSerialEcho(true)
+//*******************************************************************************
+class NativeSerial : public Stream
+{
+	public:
+		void begin(unsigned long baud) { (void)baud; }
+		void end() {}
+
+		virtual int available();
+		virtual int read();
+		virtual int peek();
+
+		virtual size_t write(uint8_t c);
+		virtual size_t write(const uint8_t *buffer, size_t size);
+		using Print::write;
+
+		operator bool() const { return true; }
+};
+
+extern NativeSerial Serial;
+
+#endif
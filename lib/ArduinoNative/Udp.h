@@ -0,0 +1,43 @@
+//*******************************************************************************
+//	ArduinoNative - Host declaration of the UDP interface
+//
+//	Same members as the UDP class of the Arduino cores, which WiFiUDP and
+//	EthernetUDP implement - lets network-agnostic code (SmartThingsUDP) build on
+//	the host.  The bench provides a POSIX socket implementation.
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __ARDUINO_NATIVE_UDP_H__
+#define __ARDUINO_NATIVE_UDP_H__
+
+#include "Print.h"
+#include "IPAddress.h"
+
+class UDP : public Stream
+{
+	public:
+		virtual uint8_t begin(uint16_t port) = 0;
+		virtual void stop() = 0;
+
+		virtual int beginPacket(IPAddress ip, uint16_t port) = 0;
+		virtual int beginPacket(const char *host, uint16_t port) = 0;
+		virtual int endPacket() = 0;
+		virtual size_t write(uint8_t) = 0;
+		virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+
+		virtual int parsePacket() = 0;
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int read(unsigned char *buffer, size_t len) = 0;
+		virtual int read(char *buffer, size_t len) = 0;
+		virtual int peek() = 0;
+		virtual void flush() = 0;
+
+		virtual IPAddress remoteIP() = 0;
+		virtual uint16_t remotePort() = 0;
+
+		using Print::write;
+};
+
+#endif
@@ -0,0 +1,505 @@
+//*******************************************************************************
+//	ArduinoNative - Host implementation of the Arduino String class
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#include "WString.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+//*******************************************************************************
+// Constructors / Destructor
+//*******************************************************************************
+String::String(const char *cstr) : buffer(NULL), capacity(0), len(0)
+{
+	if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const String &value) : buffer(NULL), capacity(0), len(0)
+{
+	*this = value;
+}
+
+String::String(const __FlashStringHelper *pstr) : buffer(NULL), capacity(0), len(0)
+{
+	*this = pstr;
+}
+
+String::String(char c) : buffer(NULL), capacity(0), len(0)
+{
+	char buf[2] = { c, 0 };
+	*this = buf;
+}
+
+String::String(unsigned char value, unsigned char base) : buffer(NULL), capacity(0), len(0)
+{
+	*this = String((unsigned long)value, base);
+}
+
+String::String(int value, unsigned char base) : buffer(NULL), capacity(0), len(0)
+{
+	*this = String((long)value, base);
+}
+
+String::String(unsigned int value, unsigned char base) : buffer(NULL), capacity(0), len(0)
+{
+	*this = String((unsigned long)value, base);
+}
+
+String::String(long value, unsigned char base) : buffer(NULL), capacity(0), len(0)
+{
+	if (base == 10)
+	{
+		char buf[2 + 8 * sizeof(long)];
+		snprintf(buf, sizeof(buf), "%ld", value);
+		*this = buf;
+	}
+	else
+	{
+		*this = String((unsigned long)value, base);
+	}
+}
+
+String::String(unsigned long value, unsigned char base) : buffer(NULL), capacity(0), len(0)
+{
+	char buf[1 + 8 * sizeof(unsigned long)];
+	char *p = buf + sizeof(buf) - 1;
+	*p = 0;
+	if (base < 2) base = 10;
+	do
+	{
+		unsigned long digit = value % base;
+		*--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+		value /= base;
+	} while (value);
+	*this = p;
+}
+
+String::String(float value, unsigned char decimalPlaces) : buffer(NULL), capacity(0), len(0)
+{
+	*this = String((double)value, decimalPlaces);
+}
+
+String::String(double value, unsigned char decimalPlaces) : buffer(NULL), capacity(0), len(0)
+{
+	char buf[33];
+	snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+	*this = buf;
+}
+
+String::~String()
+{
+	free(buffer);
+}
+
+//*******************************************************************************
+// Memory Management
+//*******************************************************************************
+void String::invalidate()
+{
+	free(buffer);
+	buffer = NULL;
+	capacity = len = 0;
+}
+
+unsigned char String::reserve(unsigned int size)
+{
+	if (buffer && capacity >= size) return 1;
+	if (changeBuffer(size))
+	{
+		if (len == 0) buffer[0] = 0;
+		return 1;
+	}
+	return 0;
+}
+
+unsigned char String::changeBuffer(unsigned int maxStrLen)
+{
+	char *newbuffer = (char *)realloc(buffer, maxStrLen + 1);
+	if (newbuffer)
+	{
+		buffer = newbuffer;
+		capacity = maxStrLen;
+		return 1;
+	}
+	return 0;
+}
+
+String & String::copy(const char *cstr, unsigned int length)
+{
+	if (!reserve(length))
+	{
+		invalidate();
+		return *this;
+	}
+	len = length;
+	memmove(buffer, cstr, length);
+	buffer[len] = 0;
+	return *this;
+}
+
+String & String::operator = (const String &rhs)
+{
+	if (this == &rhs) return *this;
+	if (rhs.buffer) copy(rhs.buffer, rhs.len);
+	else invalidate();
+	return *this;
+}
+
+String & String::operator = (const char *cstr)
+{
+	if (cstr) copy(cstr, strlen(cstr));
+	else invalidate();
+	return *this;
+}
+
+String & String::operator = (const __FlashStringHelper *pstr)
+{
+	return *this = reinterpret_cast<const char *>(pstr);
+}
+
+//*******************************************************************************
+// concat
+//*******************************************************************************
+unsigned char String::concat(const String &s)
+{
+	return concat(s.buffer ? s.buffer : "", s.len);
+}
+
+unsigned char String::concat(const char *cstr, unsigned int length)
+{
+	unsigned int newlen = len + length;
+	if (!cstr) return 0;
+	if (length == 0) return 1;
+	if (!reserve(newlen)) return 0;
+	memmove(buffer + len, cstr, length);
+	len = newlen;
+	buffer[len] = 0;
+	return 1;
+}
+
+unsigned char String::concat(const char *cstr)
+{
+	if (!cstr) return 0;
+	return concat(cstr, strlen(cstr));
+}
+
+unsigned char String::concat(const __FlashStringHelper *str)
+{
+	return concat(reinterpret_cast<const char *>(str));
+}
+
+unsigned char String::concat(char c)
+{
+	char buf[2] = { c, 0 };
+	return concat(buf, 1);
+}
+
+unsigned char String::concat(unsigned char num) { return concat(String(num)); }
+unsigned char String::concat(int num) { return concat(String(num)); }
+unsigned char String::concat(unsigned int num) { return concat(String(num)); }
+unsigned char String::concat(long num) { return concat(String(num)); }
+unsigned char String::concat(unsigned long num) { return concat(String(num)); }
+unsigned char String::concat(float num) { return concat(String(num)); }
+unsigned char String::concat(double num) { return concat(String(num)); }
+
+//*******************************************************************************
+// Concatenate (StringSumHelper)
+//*******************************************************************************
+StringSumHelper & operator + (const StringSumHelper &lhs, const String &rhs)
+{
+	StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+	if (!a.concat(rhs)) a.invalidate();
+	return a;
+}
+
+StringSumHelper & operator + (const StringSumHelper &lhs, const char *cstr)
+{
+	StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+	if (!cstr || !a.concat(cstr)) a.invalidate();
+	return a;
+}
+
+StringSumHelper & operator + (const StringSumHelper &lhs, const __FlashStringHelper *rhs)
+{
+	return lhs + reinterpret_cast<const char *>(rhs);
+}
+
+StringSumHelper & operator + (const StringSumHelper &lhs, char c)
+{
+	StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+	if (!a.concat(c)) a.invalidate();
+	return a;
+}
+
+#define ST_NATIVE_SUM_NUMBER(type) \
+	StringSumHelper & operator + (const StringSumHelper &lhs, type num) \
+	{ \
+		StringSumHelper &a = const_cast<StringSumHelper &>(lhs); \
+		if (!a.concat(num)) a.invalidate(); \
+		return a; \
+	}
+
+ST_NATIVE_SUM_NUMBER(unsigned char)
+ST_NATIVE_SUM_NUMBER(int)
+ST_NATIVE_SUM_NUMBER(unsigned int)
+ST_NATIVE_SUM_NUMBER(long)
+ST_NATIVE_SUM_NUMBER(unsigned long)
+ST_NATIVE_SUM_NUMBER(float)
+ST_NATIVE_SUM_NUMBER(double)
+
+//*******************************************************************************
+// Comparison
+//*******************************************************************************
+int String::compareTo(const String &s) const
+{
+	if (!buffer || !s.buffer)
+	{
+		if (s.buffer && s.len > 0) return 0 - *(unsigned char *)s.buffer;
+		if (buffer && len > 0) return *(unsigned char *)buffer;
+		return 0;
+	}
+	return strcmp(buffer, s.buffer);
+}
+
+unsigned char String::equals(const String &s2) const
+{
+	return (len == s2.len && compareTo(s2) == 0);
+}
+
+unsigned char String::equals(const char *cstr) const
+{
+	if (len == 0) return (cstr == NULL || *cstr == 0);
+	if (cstr == NULL) return buffer[0] == 0;
+	return strcmp(buffer, cstr) == 0;
+}
+
+unsigned char String::equalsIgnoreCase(const String &s2) const
+{
+	if (this == &s2) return 1;
+	if (len != s2.len) return 0;
+	if (len == 0) return 1;
+	for (unsigned int i = 0; i < len; i++)
+	{
+		if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)s2.buffer[i])) return 0;
+	}
+	return 1;
+}
+
+unsigned char String::startsWith(const String &s2) const
+{
+	if (len < s2.len) return 0;
+	return startsWith(s2, 0);
+}
+
+unsigned char String::startsWith(const String &s2, unsigned int offset) const
+{
+	if (offset > len - s2.len || !buffer || !s2.buffer) return 0;
+	return strncmp(&buffer[offset], s2.buffer, s2.len) == 0;
+}
+
+unsigned char String::endsWith(const String &s2) const
+{
+	if (len < s2.len || !buffer || !s2.buffer) return 0;
+	return strcmp(&buffer[len - s2.len], s2.buffer) == 0;
+}
+
+//*******************************************************************************
+// Character Access
+//*******************************************************************************
+char String::charAt(unsigned int loc) const
+{
+	return operator[](loc);
+}
+
+void String::setCharAt(unsigned int loc, char c)
+{
+	if (loc < len) buffer[loc] = c;
+}
+
+char & String::operator[](unsigned int index)
+{
+	static char dummy_writable_char;
+	if (index >= len || !buffer)
+	{
+		dummy_writable_char = 0;
+		return dummy_writable_char;
+	}
+	return buffer[index];
+}
+
+char String::operator[](unsigned int index) const
+{
+	if (index >= len || !buffer) return 0;
+	return buffer[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+	if (!bufsize || !buf) return;
+	if (index >= len)
+	{
+		buf[0] = 0;
+		return;
+	}
+	unsigned int n = bufsize - 1;
+	if (n > len - index) n = len - index;
+	strncpy((char *)buf, buffer + index, n);
+	buf[n] = 0;
+}
+
+//*******************************************************************************
+// Search
+//*******************************************************************************
+int String::indexOf(char c) const
+{
+	return indexOf(c, 0);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+	if (fromIndex >= len) return -1;
+	const char *temp = strchr(buffer + fromIndex, ch);
+	if (temp == NULL) return -1;
+	return temp - buffer;
+}
+
+int String::indexOf(const String &s2) const
+{
+	return indexOf(s2, 0);
+}
+
+int String::indexOf(const String &s2, unsigned int fromIndex) const
+{
+	if (fromIndex >= len) return -1;
+	const char *found = strstr(buffer + fromIndex, s2.buffer);
+	if (found == NULL) return -1;
+	return found - buffer;
+}
+
+int String::lastIndexOf(char ch) const
+{
+	if (len == 0) return -1;
+	const char *temp = strrchr(buffer, ch);
+	if (temp == NULL) return -1;
+	return temp - buffer;
+}
+
+int String::lastIndexOf(const String &s2) const
+{
+	if (s2.len == 0 || s2.len > len) return -1;
+	int found = -1;
+	for (char *p = buffer; p <= buffer + len - s2.len; p++)
+	{
+		p = strstr(p, s2.buffer);
+		if (!p) break;
+		found = p - buffer;
+	}
+	return found;
+}
+
+String String::substring(unsigned int left, unsigned int right) const
+{
+	if (left > right)
+	{
+		unsigned int temp = right;
+		right = left;
+		left = temp;
+	}
+	String out;
+	if (left >= len) return out;
+	if (right > len) right = len;
+	out.copy(buffer + left, right - left);
+	return out;
+}
+
+//*******************************************************************************
+// Modification
+//*******************************************************************************
+void String::replace(char find, char replace)
+{
+	if (!buffer) return;
+	for (char *p = buffer; *p; p++)
+	{
+		if (*p == find) *p = replace;
+	}
+}
+
+void String::replace(const String &find, const String &replace)
+{
+	if (len == 0 || find.len == 0) return;
+	String result;
+	result.reserve(len);
+	unsigned int i = 0;
+	while (i < len)
+	{
+		const char *found = strstr(buffer + i, find.buffer);
+		if (!found)
+		{
+			result.concat(buffer + i, len - i);
+			break;
+		}
+		result.concat(buffer + i, found - (buffer + i));
+		result.concat(replace);
+		i = (found - buffer) + find.len;
+	}
+	*this = result;
+}
+
+void String::remove(unsigned int index)
+{
+	remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+	if (index >= len) return;
+	if (count > len - index) count = len - index;
+	char *writeTo = buffer + index;
+	len = len - count;
+	memmove(writeTo, buffer + index + count, len - index);
+	buffer[len] = 0;
+}
+
+void String::toLowerCase()
+{
+	if (!buffer) return;
+	for (char *p = buffer; *p; p++) *p = tolower((unsigned char)*p);
+}
+
+void String::toUpperCase()
+{
+	if (!buffer) return;
+	for (char *p = buffer; *p; p++) *p = toupper((unsigned char)*p);
+}
+
+void String::trim()
+{
+	if (!buffer || len == 0) return;
+	char *begin = buffer;
+	while (isspace((unsigned char)*begin)) begin++;
+	char *end = buffer + len - 1;
+	while (isspace((unsigned char)*end) && end >= begin) end--;
+	len = end + 1 - begin;
+	if (begin > buffer) memmove(buffer, begin, len);
+	buffer[len] = 0;
+}
+
+//*******************************************************************************
+// Parsing / Conversion
+//*******************************************************************************
+long String::toInt() const
+{
+	if (buffer) return atol(buffer);
+	return 0;
+}
+
+float String::toFloat() const
+{
+	if (buffer) return (float)atof(buffer);
+	return 0;
+}
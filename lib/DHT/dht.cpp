@@ -1,11 +1,13 @@
 //
 //    FILE: dht.cpp
 //  AUTHOR: Rob Tillaart
-// VERSION: 0.2.0
+// VERSION: 0.2.2
 // PURPOSE: DHT Temperature & Humidity Sensor library for Arduino
 //     URL: https://github.com/RobTillaart/Arduino/tree/master/libraries/DHTstable
 //
 // HISTORY:
+// 0.2.2  2026-10-17 split-phase read start()/poll() from interrupt time stamps (Per Ivar Nerseth)
+//        2026-10-17 start() falls back to the blocking read on a pin without an interrupt (Per Ivar Nerseth)
 // 0.2.1  2017-09-20 fix https://github.com/RobTillaart/Arduino/issues/80
 // 0.2.0  2017-07-24 fix https://github.com/RobTillaart/Arduino/issues/31 + 33
 // 0.1.13 fix negative temperature
@@ -35,6 +37,19 @@
 // PUBLIC
 //
 
+dht *dht::_active = NULL;
+volatile uint32_t dht::_edges[DHTLIB_EDGE_BUFFER];
+volatile uint8_t dht::_edgeCount = 0;
+
+dht::dht() :
+    _pin(0),
+    _dht11(false),
+    _state(STATE_IDLE),
+    _stateMillis(0),
+    _result(DHTLIB_OK)
+{
+}
+
 // return values:
 // DHTLIB_OK
 // DHTLIB_ERROR_CHECKSUM
@@ -42,36 +57,158 @@
 int dht::read11(uint8_t pin)
 {
     // READ VALUES
-    int rv = _readSensor(pin, DHTLIB_DHT11_WAKEUP);
-    if (rv != DHTLIB_OK)
+    return _convert(_readSensor(pin, DHTLIB_DHT11_WAKEUP), true);
+}
+
+
+// return values:
+// DHTLIB_OK
+// DHTLIB_ERROR_CHECKSUM
+// DHTLIB_ERROR_TIMEOUT
+int dht::read(uint8_t pin)
+{
+    // READ VALUES
+    return _convert(_readSensor(pin, DHTLIB_DHT_WAKEUP), false);
+}
+
+// return values:
+// true  - the wake pulse has started, call poll() until it returns something else than DHTLIB_BUSY
+// false - a split-phase read is running already
+bool dht::start(uint8_t pin, bool dht11)
+{
+    if (_active != NULL)
     {
-        humidity    = DHTLIB_INVALID_VALUE; // invalid value, or is NaN prefered?
-        temperature = DHTLIB_INVALID_VALUE; // invalid value
-        return rv;
+        return false;
     }
+    _active = this;
+    _pin = pin;
+    _dht11 = dht11;
 
-    // CONVERT AND STORE
-    humidity    = bits[0];  // bits[1] == 0;
-    temperature = bits[2];  // bits[3] == 0;
+    // NO INTERRUPT ON THIS PIN - nothing could time-stamp the reply, read it the blocking way
+    if ((int)digitalPinToInterrupt(pin) == (int)NOT_AN_INTERRUPT)
+    {
+        _result = dht11 ? read11(pin) : read(pin);
+        _state = STATE_DONE;
+        return true;
+    }
 
-    // TEST CHECKSUM
-    uint8_t sum = bits[0] + bits[1] + bits[2] + bits[3];
-    if (bits[4] != sum)
+    // REQUEST SAMPLE
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+    uint8_t wakeupDelay = dht11 ? DHTLIB_DHT11_WAKEUP : DHTLIB_DHT_WAKEUP;
+    if (wakeupDelay <= DHTLIB_INLINE_WAKEUP)
     {
-      return DHTLIB_ERROR_CHECKSUM;
+        // too short to leave to loop(), which may come back much later
+        delayMicroseconds(wakeupDelay * 1000U);
+        _release();
     }
-    return DHTLIB_OK;
+    else
+    {
+        _state = STATE_WAKEUP;
+        _stateMillis = millis();
+    }
+    return true;
 }
 
-
 // return values:
+// DHTLIB_BUSY
 // DHTLIB_OK
 // DHTLIB_ERROR_CHECKSUM
+// DHTLIB_ERROR_TIMEOUT (also when no read was started)
+// DHTLIB_ERROR_SIGNAL
+int dht::poll()
+{
+    if (_state == STATE_IDLE)
+    {
+        return DHTLIB_ERROR_TIMEOUT;
+    }
+
+    if (_state == STATE_DONE)
+    {
+        _state = STATE_IDLE;
+        _active = NULL;
+        return _result;
+    }
+
+    if (_state == STATE_WAKEUP)
+    {
+        if (millis() - _stateMillis >= (_dht11 ? DHTLIB_DHT11_WAKEUP : DHTLIB_DHT_WAKEUP))
+        {
+            _release();
+        }
+        return DHTLIB_BUSY;
+    }
+
+    // done when every edge is in and the line has been quiet for longer than a bit
+    // (a stray edge may have come first), or on timeout
+    uint8_t count = _edgeCount;
+    bool timedOut = millis() - _stateMillis > DHTLIB_CAPTURE_TIMEOUT;
+    if (!timedOut && (count < DHTLIB_EDGES || (count < DHTLIB_EDGE_BUFFER && micros() - _edges[count - 1] <= DHTLIB_BIT_MAX)))
+    {
+        return DHTLIB_BUSY;
+    }
+
+    detachInterrupt(digitalPinToInterrupt(_pin));
+    _state = STATE_IDLE;
+    _active = NULL;
+
+    uint32_t edges[DHTLIB_EDGE_BUFFER];
+    count = _edgeCount;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        edges[i] = _edges[i];
+    }
+    return _convert(decode(edges, count, bits), _dht11);
+}
+
+// return values:
+// DHTLIB_OK
 // DHTLIB_ERROR_TIMEOUT
-int dht::read(uint8_t pin)
+// DHTLIB_ERROR_SIGNAL
+int dht::decode(const uint32_t *edges, uint8_t count, uint8_t *bits)
+{
+    // EMPTY BUFFER
+    for (uint8_t i = 0; i < 5; i++) bits[i] = 0;
+
+    if (count < DHTLIB_EDGES)
+    {
+        return DHTLIB_ERROR_TIMEOUT;
+    }
+
+    // stray edges come before the response (e.g. a flag the host's own wake pulse set) -
+    // the transfer is the last DHTLIB_EDGES
+    edges += count - DHTLIB_EDGES;
+
+    uint32_t t = edges[1] - edges[0];
+    if (t < DHTLIB_RESPONSE_MIN || t > DHTLIB_RESPONSE_MAX)
+    {
+        return DHTLIB_ERROR_SIGNAL;
+    }
+
+    // READ THE OUTPUT - 40 BITS => 5 BYTES
+    for (uint8_t i = 0; i < 40; i++)
+    {
+        t = edges[i + 2] - edges[i + 1];
+        if (t < DHTLIB_BIT_MIN || t > DHTLIB_BIT_MAX)
+        {
+            return DHTLIB_ERROR_SIGNAL;
+        }
+        if (t > DHTLIB_BIT_THRESHOLD)
+        {
+            bits[i >> 3] |= 128 >> (i & 7);
+        }
+    }
+    return DHTLIB_OK;
+}
+
+/////////////////////////////////////////////////////
+//
+// PRIVATE
+//
+
+// return values: see read() and read11()
+int dht::_convert(int rv, bool dht11)
 {
-    // READ VALUES
-    int rv = _readSensor(pin, DHTLIB_DHT_WAKEUP);
     if (rv != DHTLIB_OK)
     {
         humidity    = DHTLIB_INVALID_VALUE;  // invalid value, or is NaN prefered?
@@ -80,11 +217,19 @@ int dht::read(uint8_t pin)
     }
 
     // CONVERT AND STORE
-    humidity = word(bits[0], bits[1]) * 0.1;
-    temperature = word(bits[2] & 0x7F, bits[3]) * 0.1;
-    if (bits[2] & 0x80)  // negative temperature
+    if (dht11)
     {
-        temperature = -temperature;
+        humidity    = bits[0];  // bits[1] == 0;
+        temperature = bits[2];  // bits[3] == 0;
+    }
+    else
+    {
+        humidity = word(bits[0], bits[1]) * 0.1;
+        temperature = word(bits[2] & 0x7F, bits[3]) * 0.1;
+        if (bits[2] & 0x80)  // negative temperature
+        {
+            temperature = -temperature;
+        }
     }
 
     // TEST CHECKSUM
@@ -96,10 +241,25 @@ int dht::read(uint8_t pin)
     return DHTLIB_OK;
 }
 
-/////////////////////////////////////////////////////
-//
-// PRIVATE
-//
+void dht::_release()
+{
+    // the sensor answers 20-40 usec after the line is released - listen first
+    _edgeCount = 0;
+    attachInterrupt(digitalPinToInterrupt(_pin), _captureEdge, FALLING);
+    pinMode(_pin, INPUT);
+    _state = STATE_CAPTURE;
+    _stateMillis = millis();
+}
+
+void DHTLIB_ISR_ATTR dht::_captureEdge()
+{
+    uint8_t n = _edgeCount;
+    if (n < DHTLIB_EDGE_BUFFER)
+    {
+        _edges[n] = micros();
+        _edgeCount = n + 1;
+    }
+}
 
 // return values:
 // DHTLIB_OK
@@ -1,7 +1,7 @@
 //
 //    FILE: dht.h
 //  AUTHOR: Rob Tillaart
-// VERSION: 0.2.1
+// VERSION: 0.2.2
 // PURPOSE: DHT Temperature & Humidity Sensor library for Arduino
 //     URL: https://github.com/RobTillaart/Arduino/tree/master/libraries/DHTstable
 //
@@ -18,11 +18,13 @@
 #include <Arduino.h>
 #endif
 
-#define DHT_LIB_VERSION "0.2.1 - dhtstable"
+#define DHT_LIB_VERSION "0.2.2 - dhtstable"
 
 #define DHTLIB_OK                0
 #define DHTLIB_ERROR_CHECKSUM   -1
 #define DHTLIB_ERROR_TIMEOUT    -2
+#define DHTLIB_ERROR_SIGNAL     -3
+#define DHTLIB_BUSY              1
 #define DHTLIB_INVALID_VALUE    -999
 
 #define DHTLIB_DHT11_WAKEUP     18
@@ -35,6 +37,34 @@
 // so by dividing F_CPU by 40000 we "fail" as fast as possible
 #define DHTLIB_TIMEOUT (F_CPU/40000)
 
+// SPLIT-PHASE READ (start() / poll())
+// a transfer has 42 falling edges: the sensor's response, the start of each of
+// the 40 bits, and the end of the last bit.  A bit is the time from its falling
+// edge to the next one: ~50 usec low, then ~27 usec (0) or ~70 usec (1) high.
+#define DHTLIB_EDGES            42
+#define DHTLIB_EDGE_BUFFER      44      // room for stray edges before the response
+#define DHTLIB_BIT_THRESHOLD    100     // usec - a longer bit is a 1
+#define DHTLIB_BIT_MIN          50      // usec - shorter or longer bits are a broken signal
+#define DHTLIB_BIT_MAX          200
+#define DHTLIB_RESPONSE_MIN     120     // usec - response: ~80 usec low, ~80 usec high
+#define DHTLIB_RESPONSE_MAX     240
+#define DHTLIB_INLINE_WAKEUP    2       // msec - shorter wake pulses are timed in start() itself
+#define DHTLIB_CAPTURE_TIMEOUT  10      // msec from releasing the line - a transfer takes ~5
+
+// digitalPinToInterrupt() of a pin without an external interrupt (SAMD has it as an enum value)
+#if !defined(NOT_AN_INTERRUPT) && !defined(ARDUINO_ARCH_SAMD)
+#define NOT_AN_INTERRUPT -1
+#endif
+
+// interrupt routines must be placed in RAM on the ESP boards
+#if defined(ARDUINO_ARCH_ESP8266)
+#define DHTLIB_ISR_ATTR ICACHE_RAM_ATTR
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DHTLIB_ISR_ATTR IRAM_ATTR
+#else
+#define DHTLIB_ISR_ATTR
+#endif
+
 class dht
 {
 public:
@@ -50,12 +80,47 @@ public:
     inline int read33(uint8_t pin) { return read(pin); };
     inline int read44(uint8_t pin) { return read(pin); };
 
+    // SPLIT-PHASE READ - nothing waits for the sensor
+    // start() pulls the line low for the wake pulse and returns.  poll(), called
+    // from loop(), releases the line once the wake pulse is long enough; the
+    // falling edges of the reply are time-stamped by a pin interrupt, and once
+    // they are all in poll() decodes them.  poll() returns DHTLIB_BUSY until
+    // then, and afterwards what read11() or read() would have, with humidity
+    // and temperature set.  On a pin without an external interrupt (e.g. pins
+    // 22-53 of the MEGA) start() falls back to read11() or read(), which block
+    // for the whole transfer, and the next poll() returns their result.
+    // One split-phase read runs at a time over all dht objects - start()
+    // returns false while another one is busy.
+    dht();
+    bool start(uint8_t pin, bool dht11);
+    int poll();
+    inline bool busy() const { return _state == STATE_WAKEUP || _state == STATE_CAPTURE; };  // poll() returns DHTLIB_BUSY
+
+    // time stamps (usec) of the falling edges of one transfer => bits[5]
+    // return values: DHTLIB_OK, DHTLIB_ERROR_TIMEOUT (edges missing), DHTLIB_ERROR_SIGNAL
+    static int decode(const uint32_t *edges, uint8_t count, uint8_t *bits);
+
     float humidity;
     float temperature;
 
 private:
+    enum { STATE_IDLE, STATE_WAKEUP, STATE_CAPTURE, STATE_DONE };
+
     uint8_t bits[5];  // buffer to receive data
     int _readSensor(uint8_t pin, uint8_t wakeupDelay);
+    int _convert(int rv, bool dht11);
+    void _release();
+
+    uint8_t _pin;
+    bool _dht11;
+    uint8_t _state;
+    uint32_t _stateMillis;  // start of the wake pulse, or release of the line
+    int _result;            // STATE_DONE: what the blocking read returned
+
+    static dht *_active;    // the split-phase read in progress
+    static volatile uint32_t _edges[DHTLIB_EDGE_BUFFER];
+    static volatile uint8_t _edgeCount;
+    static void DHTLIB_ISR_ATTR _captureEdge();
 };
 #endif
 //
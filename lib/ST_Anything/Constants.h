@@ -40,6 +40,11 @@
 //    2016-06-04  Dan Ogorchock  Added improved support for Arduino Leonardo
 //    2017-02-07  Dan Ogorchock  Added support for new SmartThings v2.0 library (ThingShield, W5100, ESP8266)
 //    2017-08-14  Dan Ogorchock  Added support for ESP32
+//    2026-10-16  Per Ivar Nerseth  Added BOARD_NATIVE for the host benchmark build
+//    2026-10-16  Per Ivar Nerseth  Replaced RETURN_STRING_RESERVE with RETURN_QUEUE_SIZE and RETURN_MESSAGE_LENGTH (see MessageQueue.h)
+//    2026-10-16  Per Ivar Nerseth  Added BATCH_MESSAGE_LENGTH for transports in batch mode
+//    2026-10-16  Per Ivar Nerseth  Added MAX_EDGE_CAPTURE_PINS for InterruptSensors in edge capture mode
+//    2026-10-16  Per Ivar Nerseth  Added DISABLE_METRICS
 //
 //******************************************************************************************
 
@@ -52,6 +57,7 @@
 //#define ENABLE_SERIAL			//If uncommented, will allow you to type in commands via the Arduino Serial Console Window (useful for debugging)
 //#define DISABLE_SMARTTHINGS	//If uncommented, will disable all ST Shield Library calls (e.g. you want to use this library without SmartThings for a different application)
 //#define DISABLE_REFRESH		//If uncommented, will disable periodic refresh of the sensors and executors states to the ST Cloud - improves performance, but may reduce data integrity
+//#define DISABLE_METRICS		//If uncommented, will disable the runtime statistics (loop period, update() times...) served on the /metrics page - saves 12 bytes of SRAM per sensor
 
 #if defined(__AVR_ATmega168__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega328P__) || defined(ARDUINO_AVR_UNO)
 #define BOARD_UNO
@@ -65,6 +71,8 @@
 #define BOARD_ESP8266
 #elif defined(ARDUINO_ARCH_ESP32)
 #define BOARD_ESP32
+#elif defined(ARDUINO_ARCH_NATIVE)
+#define BOARD_NATIVE	//host build used for benchmarking (see lib/ArduinoNative)
 #else	
 #define BOARD_UNO	//assume user is using an UNO for the unknown case
 #endif
@@ -80,19 +88,33 @@ namespace st
 			//Serial debug console baud rate
 			static const unsigned long SERIAL_BAUDRATE=115200;			//Uncomment If NOT using pins 0,1 for ST Shield communications (default)
 			//static const unsigned int SERIAL_BAUDRATE=2400;			//Uncomment if using Pins 0,1 for ST Shield Communications
-			#if defined(BOARD_MEGA) || defined(BOARD_MKR1000) || defined(BOARD_ESP8266) || defined(BOARD_ESP32)
+			#if defined(BOARD_MEGA) || defined(BOARD_MKR1000) || defined(BOARD_ESP8266) || defined(BOARD_ESP32) || defined(BOARD_NATIVE)
 				//Maximum number of SENSOR objects
 				static const byte MAX_SENSOR_COUNT=30;					//Used to limit the number of sensor devices allowed.  Be careful on Arduino UNO due to 2K SRAM limitation 
 				//Maximum number of EXECUTOR objects
 				static const byte MAX_EXECUTOR_COUNT=20;				//Used to limit the number of executor devices allowed.  Be careful on Arduino UNO due to 2K SRAM limitation 
+				//Number of messages that can be queued for transfer to ST Cloud
+				static const byte RETURN_QUEUE_SIZE = MAX_SENSOR_COUNT + MAX_EXECUTOR_COUNT;	//one refresh of every device fits in the queue
+				//Maximum length of one queued message (including null terminator!)
+				static const byte RETURN_MESSAGE_LENGTH = 64;
+				//Maximum length of one batch of messages, if the SmartThings transport is in batch mode (see SmartThings::setBatchMode())
+				static const unsigned int BATCH_MESSAGE_LENGTH = 1024;
+				//Maximum number of InterruptSensors in edge capture mode (see InterruptSensor::enableEdgeCapture())
+				static const byte MAX_EDGE_CAPTURE_PINS = 8;
 			#else
 				//Maximum number of SENSOR objects
 				static const byte MAX_SENSOR_COUNT = 10;				//Used to limit the number of sensor devices allowed.  Be careful on Arduino UNO due to 2K SRAM limitation 
 				//Maximum number of EXECUTOR objects
 				static const byte MAX_EXECUTOR_COUNT = 10;				//Used to limit the number of executor devices allowed.  Be careful on Arduino UNO due to 2K SRAM limitation 
+				//Number of messages that can be queued for transfer to ST Cloud
+				static const byte RETURN_QUEUE_SIZE = 4;				//Do not make too large due to UNO's 2K SRAM limitation (RETURN_QUEUE_SIZE * RETURN_MESSAGE_LENGTH bytes)
+				//Maximum length of one queued message (including null terminator!)
+				static const byte RETURN_MESSAGE_LENGTH = 40;
+				//Maximum length of one batch of messages, if the SmartThings transport is in batch mode (see SmartThings::setBatchMode())
+				static const unsigned int BATCH_MESSAGE_LENGTH = RETURN_QUEUE_SIZE * RETURN_MESSAGE_LENGTH;
+				//Maximum number of InterruptSensors in edge capture mode (see InterruptSensor::enableEdgeCapture())
+				static const byte MAX_EDGE_CAPTURE_PINS = 2;			//UNO has only two external interrupt pins (2 and 3)
 			#endif
-			//Size of reserved return string
-			static const byte RETURN_STRING_RESERVE = (MAX_SENSOR_COUNT + MAX_EXECUTOR_COUNT) * 5;	//Do not make too large due to UNO's 2K SRAM limitation
 			//Interval on which Device's refresh methods are called (in seconds) - most useful for Executors and InterruptSensors - only works if DISABLE_REFRESH is not defined above
 			static const int DEV_REFRESH_INTERVAL=300;				//seconds - Used to make sure the ST Cloud is kept current with device status (in case of missed updates to the ST Cloud) - primarily for Executors and InterruptSensors - only works if DISABLE_REFRESH is not defined above
 
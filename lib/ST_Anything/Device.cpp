@@ -12,6 +12,7 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2018-08-15  Dan Ogorchock  Workaround for strcpy_P() ESP32 crash bug
+//    2026-10-16  Per Ivar Nerseth  Added compareName()
 //
 //******************************************************************************************
 
@@ -62,6 +63,34 @@ namespace st
 
 	}
 	
+	int Device::compareName(const char *str, unsigned int len) const
+	{
+		const char *name=(const char*)m_pName;
+		for(unsigned int i=0; i<len; ++i)
+		{
+			unsigned char c=pgm_read_byte(name+i);
+			if(c!=(unsigned char)str[i])
+			{
+				return (int)c-(unsigned char)str[i];	//also covers a name shorter than len (c==0)
+			}
+		}
+		return pgm_read_byte(name+len);	//>0 if the name is longer than len
+	}
+
+	int Device::compareName(const Device &other) const
+	{
+		const char *a=(const char*)m_pName;
+		const char *b=(const char*)other.m_pName;
+		for(unsigned int i=0; ; ++i)
+		{
+			unsigned char ca=pgm_read_byte(a+i);
+			unsigned char cb=pgm_read_byte(b+i);
+			if(ca!=cb || ca==0)
+			{
+				return (int)ca-cb;
+			}
+		}
+	}
 
 	//debug flag to determine if debug print statements are executed (set value in your sketch)
 	bool Device::debug=false;
@@ -11,6 +11,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  Per Ivar Nerseth  Added compareName() - compares the name in flash without building a String
 //
 //
 //******************************************************************************************
@@ -46,6 +47,10 @@ namespace st
 
 			//gets
 			const String getName() const;
+
+			//compares the name with the first len characters of str, like strcmp() (<0, 0, >0) - reads the name straight from flash
+			int compareName(const char *str, unsigned int len) const;
+			int compareName(const Device &other) const;
 				
 			//debug flag to determine if debug print statements are executed (set value in your sketch)
 			static bool debug;
@@ -0,0 +1,133 @@
+//******************************************************************************************
+//  File: EdgeCapture.cpp
+//
+//  Summary:  st::EdgeCapture records the edges of digital input pins from a pin-change
+//			  interrupt.  See EdgeCapture.h for details.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  A full ring coalesces bounces into the newest edge and keeps the first and last discarded edge
+//
+//******************************************************************************************
+
+#include "EdgeCapture.h"
+
+namespace st
+{
+	namespace
+	{
+		typedef void (*IsrFunction)();
+	}
+
+//private
+	void ST_ISR_ATTR EdgeCapture::capture(byte channel)
+	{
+		Channel &c = m_Channels[channel];
+		unsigned long now = micros();
+		byte level = digitalRead(c.pin);
+		byte head = c.head;
+		byte next = (head + 1) & (RING_SIZE - 1);
+		if (c.overflow || next == c.tail)
+		{
+			byte newest = (head - 1) & (RING_SIZE - 1);		//not the slot being read - that is c.tail == next
+			if (!c.overflow && now - c.time[newest] < c.coalesce)
+			{
+				c.time[newest] = now;		//the newest level did not last - a bounce
+				c.level[newest] = level;
+				return;
+			}
+			if (!c.overflow)
+			{
+				c.lostFirst = now;
+				c.overflow = true;
+			}
+			c.lostLast = now;
+			c.lostLevel = level;
+			return;
+		}
+		c.time[head] = now;
+		c.level[head] = level;
+		c.head = next;		//publish the edge only after it is complete
+	}
+
+//public
+	byte EdgeCapture::attach(byte pin, unsigned long coalesceMicros)
+	{
+		static const IsrFunction isrs[] = {isr<0>, isr<1>, isr<2>, isr<3>, isr<4>, isr<5>, isr<6>, isr<7>};
+
+		for (byte ch = 0; ch < Constants::MAX_EDGE_CAPTURE_PINS && ch < sizeof(isrs) / sizeof(isrs[0]); ++ch)
+		{
+			if (!m_Channels[ch].used)
+			{
+				m_Channels[ch].used = true;
+				m_Channels[ch].pin = pin;
+				m_Channels[ch].coalesce = coalesceMicros;
+				clear(ch);
+				attachInterrupt(digitalPinToInterrupt(pin), isrs[ch], CHANGE);
+				return ch;
+			}
+		}
+		return NO_CHANNEL;
+	}
+
+	void EdgeCapture::detach(byte channel)
+	{
+		if (channel < Constants::MAX_EDGE_CAPTURE_PINS && m_Channels[channel].used)
+		{
+			detachInterrupt(digitalPinToInterrupt(m_Channels[channel].pin));
+			m_Channels[channel].used = false;
+		}
+	}
+
+	void EdgeCapture::setCoalesce(byte channel, unsigned long coalesceMicros)
+	{
+		if (channel < Constants::MAX_EDGE_CAPTURE_PINS)
+		{
+			m_Channels[channel].coalesce = coalesceMicros;
+		}
+	}
+
+	bool EdgeCapture::read(byte channel, unsigned long &micros, bool &level)
+	{
+		Channel &c = m_Channels[channel];
+		byte tail = c.tail;
+		if (tail == c.head)
+		{
+			return false;
+		}
+		micros = c.time[tail];
+		level = c.level[tail];
+		c.tail = (tail + 1) & (RING_SIZE - 1);		//hand the slot back only after it was read
+		return true;
+	}
+
+	void EdgeCapture::clear(byte channel)
+	{
+		Channel &c = m_Channels[channel];
+		c.tail = c.head;
+		c.overflow = false;
+	}
+
+	bool EdgeCapture::overflowed(byte channel, unsigned long &firstMicros, unsigned long &lastMicros, bool &level)
+	{
+		Channel &c = m_Channels[channel];
+		if (!c.overflow)
+		{
+			return false;
+		}
+		noInterrupts();		//the interrupt routine updates the last edge until the flag is cleared
+		firstMicros = c.lostFirst;
+		lastMicros = c.lostLast;
+		level = c.lostLevel;
+		c.overflow = false;
+		interrupts();
+		return true;
+	}
+
+	EdgeCapture::Channel EdgeCapture::m_Channels[Constants::MAX_EDGE_CAPTURE_PINS];
+}
@@ -0,0 +1,97 @@
+//******************************************************************************************
+//  File: EdgeCapture.h
+//
+//  Summary:  st::EdgeCapture records the edges of digital input pins from a pin-change
+//			  interrupt, so st::InterruptSensor can debounce on real time stamps instead of
+//			  counting passes of the main loop.
+//			  -Each attached pin gets a channel with a ring of RING_SIZE edges.  The
+//			   interrupt routine is the only writer and the main loop the only reader, so the
+//			   ring needs no locking (single producer, single consumer).
+//			  -An edge is the micros() time stamp and the pin level just after the change.
+//			  -If the main loop falls behind and the ring is full, an edge that comes less than
+//			   the channel's coalesce time after the newest one replaces it (the newest level
+//			   was a bounce).  Otherwise the edge is discarded and the channel is flagged as
+//			   overflowed; from then on every edge is discarded, keeping the time of the first
+//			   and the time and level of the last, until the reader takes them with
+//			   overflowed().  The buffered edges are all older than the discarded ones.
+//			  -The number of channels is set by MAX_EDGE_CAPTURE_PINS in Constants.h.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-17  Per Ivar Nerseth  A full ring coalesces bounces into the newest edge and keeps the first and last discarded edge
+//
+//******************************************************************************************
+
+#ifndef ST_EDGECAPTURE_H
+#define ST_EDGECAPTURE_H
+
+#include "Constants.h"
+
+//interrupt routines must be placed in RAM on the ESP boards
+#if defined(BOARD_ESP8266)
+#define ST_ISR_ATTR ICACHE_RAM_ATTR
+#elif defined(BOARD_ESP32)
+#define ST_ISR_ATTR IRAM_ATTR
+#else
+#define ST_ISR_ATTR
+#endif
+
+namespace st
+{
+	class EdgeCapture
+	{
+		public:
+			static const byte NO_CHANNEL = 255;
+			static const byte RING_SIZE = 8;		//edges buffered per pin - must be a power of 2
+
+			//attaches a CHANGE interrupt to pin - returns the channel, or NO_CHANNEL if all channels are in use
+			//coalesceMicros: when the ring is full, an edge this soon after the newest replaces it
+			static byte attach(byte pin, unsigned long coalesceMicros = 0);
+
+			//changes the coalesce time of the channel
+			static void setCoalesce(byte channel, unsigned long coalesceMicros);
+
+			//detaches the interrupt and frees the channel
+			static void detach(byte channel);
+
+			//removes the oldest edge of the channel - returns false if there is none
+			static bool read(byte channel, unsigned long &micros, bool &level);
+
+			//discards all buffered edges and the overflow flag of the channel
+			static void clear(byte channel);
+
+			//whether edges were discarded because the ring was full - if so, firstMicros is the time of the
+			//first one, lastMicros and level the time and level of the last; the flag is cleared by the call
+			static bool overflowed(byte channel, unsigned long &firstMicros, unsigned long &lastMicros, bool &level);
+
+		private:
+			struct Channel
+			{
+				volatile unsigned long time[RING_SIZE];	//micros() of each edge
+				volatile byte level[RING_SIZE];			//pin level after each edge
+				volatile byte head;						//next slot to write (interrupt routine only)
+				volatile byte tail;						//next slot to read (main loop only)
+				volatile bool overflow;
+				unsigned long lostFirst;				//micros() of the first discarded edge
+				volatile unsigned long lostLast;		//micros() of the last discarded edge
+				volatile byte lostLevel;				//pin level after the last discarded edge
+				unsigned long coalesce;
+				byte pin;
+				bool used;
+			};
+
+			static Channel m_Channels[Constants::MAX_EDGE_CAPTURE_PINS];
+
+			static void capture(byte channel);
+
+			//one interrupt routine per channel, since attachInterrupt() passes no argument
+			template<byte C> static void ST_ISR_ATTR isr() {capture(C);}
+	};
+}
+
+#endif
@@ -23,12 +23,21 @@
 //    2017-02-07  Dan Ogorchock  Added support for new SmartThings v2.0 library (ThingShield, W5100, ESP8266)
 //    2017-02-19  Dan Ogorchock  Fixed bug in throttling capability
 //    2017-04-26  Dan Ogorchock  Allow each communication method to specify unique ST transmission throttling delay
+//    2026-10-16  Per Ivar Nerseth  Replaced the "|" delimited Return_String with the fixed-size st::MessageQueue
+//    2026-10-16  Per Ivar Nerseth  sendStrings() no longer delay()s for the transmit interval - sends one message per due slot; refresh runs one device at a time
+//    2026-10-16  Per Ivar Nerseth  In batch mode sendStrings() packs the queued messages into one send(), one message per line
+//    2026-10-16  Per Ivar Nerseth  updateSensors() only polls the st::PollingSensors that are due (st::PollScheduler); added nextDeadline()
+//    2026-10-16  Per Ivar Nerseth  getDeviceByName() binary searches m_DeviceIndex; receiveSmartString() matches the name token in place
+//    2026-10-16  Per Ivar Nerseth  Loop period and update() times recorded for the /metrics page (st::Metrics)
+//    2026-10-16  Per Ivar Nerseth  Messages stay in the SendQueue while the transport is not ready (e.g. WiFi still joining)
 //
 //******************************************************************************************
 
 //#include <Arduino.h>
 //#include <avr/pgmspace.h>
 #include "Everything.h"
+#include "PollingSensor.h"
+#include "Metrics.h"
 
 long freeRam();	//freeRam() function prototype - useful in determining how much SRAM is available on Arduino
 #if defined(ARDUINO_ARCH_SAMD)
@@ -40,11 +49,20 @@ namespace st
 //private
 	void Everything::updateSensors()
 	{
-		for(unsigned int index=0; index<m_nSensorCount; ++index)
+		#ifndef DISABLE_METRICS
+			unsigned long start=micros();	//each sensor's end time is the next one's start - one micros() call per sensor
+		#endif
+		for(unsigned int index=0; index<m_nPassSensorCount; ++index)
 		{
-			m_Sensors[index]->update();
-			sendStrings();
+			m_PassSensors[index]->update();
+			#ifndef DISABLE_METRICS
+				unsigned long end=micros();
+				m_PassSensors[index]->recordUpdate(end-start);
+				start=end;
+			#endif
 		}
+
+		Scheduler.runDue(millis());
 	}
 	
 #if defined(ENABLE_SERIAL)
@@ -66,62 +84,124 @@ namespace st
 	
 	void Everything::sendStrings()
 	{
-		unsigned int index;
-		//Loop through the Return_String buffer and send each "|" delimited string to ST Shield
-		while(Return_String.length()>=1 && Return_String[0]!='|')
+		//Send the oldest message in the SendQueue to ST Shield once its transmit slot is due.  Never waits for the slot - 
+		//returns to run() instead, so sensors keep being polled while a backlog drains.
+		while(!SendQueue.empty())
 		{
-			index=Return_String.indexOf("|");
+			#ifndef DISABLE_SMARTTHINGS
+			if (!SmartThing->isReady())
+			{
+				return;		//no link to the hub yet - the messages wait in the SendQueue, sensors keep running
+			}
+			if (millis() - sendstringsLastMillis < (unsigned long)SmartThing->getTransmitInterval())	//each method of communicating to ST cloud has its own interval.  DGO 2017-04-26
+			{
+				return;		//slot not due yet - try again on a later pass through run()
+			}
+			#endif
+
+			Send_String=SendQueue.front();
+			SendQueue.pop();
+			bool batch=false;
+			#ifndef DISABLE_SMARTTHINGS
+			if (SmartThing->getBatchMode())
+			{
+				appendBatch();		//calls callOnMsgSend for each message it packs
+				batch=true;
+			}
+			#endif
 			if(debug)
 			{
 				Serial.print(F("Everything: Sending: "));
-				Serial.println(Return_String.substring(0, index));
+				Serial.println(Send_String);
 				//Serial.print(F("Everything: getTransmitInterval() = "));
 				//Serial.println(SmartThing->getTransmitInterval());
 			}
 			#ifndef DISABLE_SMARTTHINGS
-//			if (millis() - sendstringsLastMillis < Constants::SENDSTRINGS_INTERVAL)
-			if (millis() - sendstringsLastMillis < SmartThing->getTransmitInterval())
-				{
-//					delay(Constants::SENDSTRINGS_INTERVAL - (millis() - sendstringsLastMillis)); //Added due to slow ST Hub/Cloud Processing.  Events were being missed.  DGO 2015-03-28
-					delay(SmartThing->getTransmitInterval() - (millis() - sendstringsLastMillis)); //modified to allow different values for each method of communicating to ST cloud.  DGO 2017-04-26
-			}
-				SmartThing->send(Return_String.substring(0, index));
+				SmartThing->send(Send_String);
 				sendstringsLastMillis = millis();
 			#endif
 			#if defined(ENABLE_SERIAL) && defined(DISABLE_SMARTTHINGS)
-				Serial.println(Return_String.substring(0, index));
+				Serial.println(Send_String);
 			#endif
 			
+			if(callOnMsgSend!=0 && !batch)
+			{
+				callOnMsgSend(Send_String);
+			}
+		}
+	}
+
+	void Everything::appendBatch()
+	{
+		Send_String.reserve(Constants::BATCH_MESSAGE_LENGTH);	//grows once, on the first batch
+
+		if(callOnMsgSend!=0)
+		{
+			callOnMsgSend(Send_String);
+		}
+
+		//append queued messages, one per line, while they fit in the batch
+		while(!SendQueue.empty() && Send_String.length() + 1 + strlen(SendQueue.front()) <= Constants::BATCH_MESSAGE_LENGTH)
+		{
+			Send_String += '\n';
+			unsigned int start = Send_String.length();
+			Send_String += SendQueue.front();
+			SendQueue.pop();
+
 			if(callOnMsgSend!=0)
 			{
-				callOnMsgSend(Return_String.substring(0, index));
+				callOnMsgSend(Send_String.substring(start));
 			}
+		}
+	}
 
-			Return_String=Return_String.substring(index+1);
+	void Everything::flushStrings()
+	{
+		while(!SendQueue.empty())
+		{
+			#ifndef DISABLE_SMARTTHINGS
+			if (!SmartThing->isReady())
+			{
+				return;		//sent from run() once the transport is ready
+			}
+			#endif
+			sendStrings();
+			yield();
 		}
-		Return_String.remove(0);	//clear the Return_String buffer
 	}
 	
 	void Everything::refreshDevices()
 	{
-		for(unsigned int i=0; i<m_nExecutorCount; ++i)
+		m_nRefreshIndex=0;	//refreshNextDevice() takes it from here, one device at a time
+	}
+
+	void Everything::refreshNextDevice()
+	{
+		//refresh the next device only once the previous one's messages have been sent, so a refresh never floods the SendQueue
+		if(m_nRefreshIndex>=m_nExecutorCount+m_nSensorCount || !SendQueue.empty())
 		{
-			m_Executors[i]->refresh();
-			sendStrings();
+			return;
 		}
 
-		for (unsigned int i = 0; i<m_nSensorCount; ++i)
+		bRefreshing=true;	//refresh only repeats the current state - first to go if the queue overflows
+		if(m_nRefreshIndex<m_nExecutorCount)
 		{
-			m_Sensors[i]->refresh();
-			sendStrings();
+			m_Executors[m_nRefreshIndex]->refresh();
 		}
+		else
+		{
+			m_Sensors[m_nRefreshIndex-m_nExecutorCount]->refresh();
+		}
+		bRefreshing=false;
+
+		++m_nRefreshIndex;
 	}
 	
 //public
 	void Everything::init()
 	{
 		Serial.begin(Constants::SERIAL_BAUDRATE);
-		Return_String.reserve(st::Constants::RETURN_STRING_RESERVE);	//allocate Return_String buffer one time to prevent Heap Fragmentation.  RETURN_STRING_RESERVE is set in Constants.h
+		Send_String.reserve(st::Constants::RETURN_MESSAGE_LENGTH);	//allocate Send_String buffer one time to prevent Heap Fragmentation.  RETURN_MESSAGE_LENGTH is set in Constants.h
 		
 		if(debug)
 		{
@@ -131,6 +211,9 @@ namespace st
 		}
 		
 		#ifndef DISABLE_SMARTTHINGS
+			#ifndef DISABLE_METRICS
+				SmartThing->setMetricsCallout(Metrics::write);	//added to the transport's own figures on the /metrics page
+			#endif
 			SmartThing->init();
 		#endif
 		
@@ -155,13 +238,13 @@ namespace st
 		for(unsigned int index=0; index<m_nSensorCount; ++index)
 		{
 			m_Sensors[index]->init();
-			sendStrings();
+			flushStrings();
 		}
 		
 		for(unsigned int index=0; index<m_nExecutorCount; ++index)
 		{
 			m_Executors[index]->init();
-			sendStrings();
+			flushStrings();
 		}
 		
 		if(debug)
@@ -172,10 +255,15 @@ namespace st
 		}
 		
 		refLastMillis = millis(); //avoid immediately refreshing after initialization
+		Scheduler.start(refLastMillis); //polling starts now, as it did on the first update() call
 	}
 	
 	void Everything::run()
 	{
+		#ifndef DISABLE_METRICS
+			Metrics::loopPass();	//loop period histogram
+		#endif
+
 		updateSensors();			//call each st::Sensor object to refresh data
 
 		#ifndef DISABLE_SMARTTHINGS
@@ -186,13 +274,15 @@ namespace st
 			readSerial();			//read data from the Arduino IDE Serial Monitor window (useful for debugging sometimes)
 		#endif
 		
-		sendStrings();				//send any pending updates to ST Cloud
+		refreshNextDevice();		//continue a refresh of all devices, if one is in progress
+
+		sendStrings();				//send the next pending update to ST Cloud, if its transmit slot is due
 		
 		#ifndef DISABLE_REFRESH		//Added new check to allow user to disable REFRESH feature - setting is in Constants.h)
 		if ((bTimersPending == 0) && ((millis() - refLastMillis) >= long(Constants::DEV_REFRESH_INTERVAL) * 1000))  //DEV_REFRESH_INTERVAL is set in Constants.h
 		{
 			refLastMillis = millis();
-			refreshDevices();	//call each st::Device object to refresh data (this is just a safeguard to ensure the state of the Arduino and the ST Cloud stay in synch should an event be missed)
+			refreshDevices();	//start refreshing each st::Device object's data (this is just a safeguard to ensure the state of the Arduino and the ST Cloud stay in synch should an event be missed)
 		}
 		#endif
 		
@@ -201,58 +291,88 @@ namespace st
 			lastmillis = millis();
 			Serial.print(F("Everything: Free Ram = "));  
 			Serial.println(freeRam());
+			Serial.print(F("Everything: SendQueue high-water mark = "));
+			Serial.print(SendQueue.highWater());
+			Serial.print(F(" of "));
+			Serial.print(SendQueue.capacity());
+			Serial.print(F(", dropped = "));
+			Serial.println(SendQueue.drops());
 		}
 	}
 	
-	bool Everything::sendSmartString(String &str)
+	bool Everything::sendSmartString(String &str, byte priority)
 	{
-		while(str.length()>1 && str[0]=='|') //get rid of leading pipes (messes up sendStrings()'s parsing technique)
-		{
-			str=str.substring(1);
-		}
-		if((str.length()==1 && str[0]=='|') || str.length()==0)
+		if(str.length()==0)
 		{
 			return false;
 		}
-		
-		if(Return_String.length()+str.length()>=Constants::RETURN_STRING_RESERVE)
+
+		if(bRefreshing)
 		{
-			if (debug)
-			{
-				Serial.print(F("Everything: ERROR: \""));
-				Serial.print(str);
-				Serial.println(F("\" would overflow the Return_String 'buffer'"));
-			}
-			return false;
+			priority=PRIORITY_LOW;
 		}
-		else
+
+		unsigned long dropsBefore=SendQueue.drops();
+		bool queued=SendQueue.push(str.c_str(), str.length(), priority);	//copy the new message into a free slot of the queue to be sent to ST Shield
+		
+		if(debug && SendQueue.drops()!=dropsBefore)
 		{
-			Return_String+=str+"|";		//add the new message to the queue to be sent to ST Shield with a "|" delimiter
-			return true;
+			Serial.print(F("Everything: ERROR: SendQueue overflow while queueing \""));
+			Serial.print(str);
+			Serial.println(queued ? F("\" - dropped an older message") : F("\" - message dropped"));
 		}
+		return queued;
 	}
 
-	bool Everything::sendSmartStringNow(String &str)
+	bool Everything::sendSmartStringNow(String &str, byte priority)
 	{
-		if (sendSmartString(str)) sendStrings(); //send any pending updates to ST Cloud immediately
+		bool result = sendSmartString(str, priority);
+		if (result) sendStrings(); //send the next pending update to ST Cloud right away if its transmit slot is due
+		return result;
 	}
 
 	Device* Everything::getDeviceByName(const String &str)
 	{
-		for(unsigned int index=0; index<m_nSensorCount; ++index)
+		return getDeviceByName(str.c_str(), str.length());
+	}
+
+	Device* Everything::getDeviceByName(const char *name, unsigned int len)
+	{
+		//binary search for the first device whose name is not less than name
+		byte low=0;
+		byte high=m_nDeviceIndexCount;
+		while(low<high)
 		{
-			if(m_Sensors[index]->getName()==str)
-				return (Device*)m_Sensors[index];
+			byte mid=(low+high)/2;
+			if(m_DeviceIndex[mid]->compareName(name, len)<0)
+			{
+				low=mid+1;
+			}
+			else
+			{
+				high=mid;
+			}
 		}
-		
-		for(unsigned int index=0; index<m_nExecutorCount; ++index)
+
+		if(low<m_nDeviceIndexCount && m_DeviceIndex[low]->compareName(name, len)==0)
 		{
-			if(m_Executors[index]->getName()==str)
-				return (Device*)m_Executors[index];
+			return m_DeviceIndex[low];
 		}
-		
 		return 0; //null if no such device present
 	}
+
+	void Everything::indexDevice(Device *device)
+	{
+		//insertion sort - devices are only added during setup()
+		byte pos=m_nDeviceIndexCount;
+		while(pos>0 && m_DeviceIndex[pos-1]->compareName(*device)>0)
+		{
+			m_DeviceIndex[pos]=m_DeviceIndex[pos-1];
+			--pos;
+		}
+		m_DeviceIndex[pos]=device;
+		++m_nDeviceIndexCount;
+	}
 	
 	bool Everything::addSensor(Sensor *sensor)
 	{
@@ -270,6 +390,18 @@ namespace st
 		{
 			m_Sensors[m_nSensorCount]=sensor;
 			++m_nSensorCount;
+			indexDevice(sensor);
+
+			PollingSensor *polled=sensor->getPollingSensor();
+			if(polled!=0)
+			{
+				Scheduler.add(polled);
+			}
+			else
+			{
+				m_PassSensors[m_nPassSensorCount]=sensor;
+				++m_nPassSensorCount;
+			}
 		}
 		
 		if(debug)
@@ -298,6 +430,7 @@ namespace st
 		{
 			m_Executors[m_nExecutorCount]=executor;
 			++m_nExecutorCount;
+			indexDevice(executor);
 		}
 		
 		if(debug)
@@ -309,6 +442,46 @@ namespace st
 		}
 		return true;
 	}
+
+	unsigned long Everything::nextDeadline()
+	{
+		unsigned long now=millis();
+
+		//these need run() on every pass
+		if(m_nPassSensorCount>0 || bTimersPending>0 || m_nRefreshIndex<m_nExecutorCount+m_nSensorCount)
+		{
+			return now;
+		}
+
+		unsigned long deadline=now+0x7FFFFFFFUL;	//as far ahead as millis() comparisons reach
+		#ifndef DISABLE_REFRESH
+			deadline=refLastMillis+long(Constants::DEV_REFRESH_INTERVAL)*1000;
+		#endif
+
+		PollingSensor *next=Scheduler.next();
+		if(next!=0 && (long)(next->nextPoll()-deadline)<0)
+		{
+			deadline=next->nextPoll();
+		}
+
+		#ifndef DISABLE_SMARTTHINGS
+		if(!SendQueue.empty())
+		{
+			unsigned long slot=sendstringsLastMillis+SmartThing->getTransmitInterval();
+			if((long)(slot-deadline)<0)
+			{
+				deadline=slot;
+			}
+		}
+		#else
+		if(!SendQueue.empty())
+		{
+			return now;
+		}
+		#endif
+
+		return ((long)(deadline-now)<0) ? now : deadline;
+	}
 	
 	//friends!
 	void receiveSmartString(String message)
@@ -326,7 +499,8 @@ namespace st
 		}
 		else if (message.length() > 1)		//ignore empty string messages from the ST Hub
 		{
-			Device *p = Everything::getDeviceByName(message.substring(0, message.indexOf(' ')));
+			int space = message.indexOf(' ');
+			Device *p = Everything::getDeviceByName(message.c_str(), space < 0 ? message.length() : space);	//match the name token in place
 			if (p != 0)
 			{
 				p->beSmart(message);	//pass the incoming SmartThings Shield message to the correct Device's beSmart() routine
@@ -342,14 +516,22 @@ namespace st
 	
 	//initialize static members
 	st::SmartThings* Everything::SmartThing=0; //initialize pointer to null
-	String Everything::Return_String;
+	String Everything::Send_String;
+	MessageQueue Everything::SendQueue;
+	PollScheduler Everything::Scheduler;
 	Sensor* Everything::m_Sensors[Constants::MAX_SENSOR_COUNT];
+	Sensor* Everything::m_PassSensors[Constants::MAX_SENSOR_COUNT];
+	byte Everything::m_nPassSensorCount=0;
 	Executor* Everything::m_Executors[Constants::MAX_EXECUTOR_COUNT];
 	byte Everything::m_nSensorCount=0;
 	byte Everything::m_nExecutorCount=0;
+	Device* Everything::m_DeviceIndex[Constants::MAX_SENSOR_COUNT + Constants::MAX_EXECUTOR_COUNT];
+	byte Everything::m_nDeviceIndexCount=0;
 	unsigned long Everything::lastmillis=0;
 	unsigned long Everything::refLastMillis=0;
 	unsigned long Everything::sendstringsLastMillis=0;
+	bool Everything::bRefreshing=false;
+	byte Everything::m_nRefreshIndex=255;	//no refresh in progress
 	bool Everything::debug=false;
 	byte Everything::bTimersPending=0;	//initialize variable
 	void (*Everything::callOnMsgSend)(const String &msg)=0; //initialize this callback function to null
@@ -23,6 +23,13 @@
 //	  2015-03-14  Dan Ogorchock	 Added public setLED() function to control ThingShield LED
 //    2015-03-28  Dan Ogorchock  Added throttling capability to sendStrings to improve success rate of ST Cloud getting the data ("SENDSTRINGS_INTERVAL" is in CONSTANTS.H)
 //    2017-02-07  Dan Ogorchock  Added support for new SmartThings v2.0 library (ThingShield, W5100, ESP8266)
+//    2026-10-16  Per Ivar Nerseth  Replaced the "|" delimited Return_String with the fixed-size st::MessageQueue
+//    2026-10-16  Per Ivar Nerseth  Non-blocking transmit pacing in sendStrings() and incremental refreshDevices()
+//    2026-10-16  Per Ivar Nerseth  Batch mode support in sendStrings()
+//    2026-10-16  Per Ivar Nerseth  Polling sensors are run by st::PollScheduler; added nextDeadline()
+//    2026-10-16  Per Ivar Nerseth  getDeviceByName() binary searches a name-sorted index instead of comparing Strings
+//    2026-10-16  Per Ivar Nerseth  st::Metrics reads the sensor list for the /metrics page
+//    2026-10-16  Per Ivar Nerseth  sendStrings() waits for SmartThing->isReady()
 //
 //******************************************************************************************
 
@@ -33,6 +40,8 @@
 #include "Constants.h"
 #include "Sensor.h"
 #include "Executor.h"
+#include "MessageQueue.h"
+#include "PollScheduler.h"
 
 #include "SmartThings.h"
 
@@ -45,45 +54,62 @@ namespace st
 		private:
 			static Sensor* m_Sensors[Constants::MAX_SENSOR_COUNT];		//array of Sensor objects that st::Everything will keep track of
 			static byte m_nSensorCount;	//number of st::Sensor objects added to st::Everything in your sketch Setup() routine
+			static Sensor* m_PassSensors[Constants::MAX_SENSOR_COUNT];	//the Sensor objects that are not st::PollingSensors - update() is called on every pass
+			static byte m_nPassSensorCount;
 			
 			static Executor* m_Executors[Constants::MAX_EXECUTOR_COUNT]; //array of Executor objects that st::Everything will keep track of
 			static byte m_nExecutorCount;//number of st::Executor objects added to st::Everything in your sketch Setup() routine
+
+			static Device* m_DeviceIndex[Constants::MAX_SENSOR_COUNT + Constants::MAX_EXECUTOR_COUNT];	//every Device, sorted by name, for getDeviceByName()
+			static byte m_nDeviceIndexCount;
+			static void indexDevice(Device *device);	//inserts device into m_DeviceIndex, after any device of the same name
 			
 			
 			//static SmartThingsNetworkState_t stNetworkState;
 		
 			//static void updateNetworkState();	//keeps track of the current ST Shield to Hub network status
-			static void updateSensors();		//simply calls update on all the sensors
-			static void sendStrings();			//sends all updates from the devices in Return_String
+			static void updateSensors();		//calls update on the sensors that need it every pass, and polls the st::PollingSensors that are due
+			static void sendStrings();			//sends the oldest update in SendQueue if its transmit slot is due and SmartThing is ready - never waits
+			static void appendBatch();			//moves further updates from SendQueue into Send_String, one per line, up to BATCH_MESSAGE_LENGTH
+			static void flushStrings();			//sends every update in SendQueue, waiting for each transmit slot, while SmartThing is ready - only used during initDevices()
 			static unsigned long sendstringsLastMillis;	//keep track of how long since last time we sent data to ST Cloud, to enable throttling
 
 			static unsigned long lastmillis;	//used to keep track of last time run() has output freeRam() info
 			
 			//stuff for refreshing Devices
 			static unsigned long refLastMillis;	//used to keep track of last time run() has called refreshDevices()
-			static void refreshDevices();		//simply calls refresh on all the Devices
+			static void refreshDevices();		//starts a refresh of all the Devices
+			static void refreshNextDevice();	//calls refresh on the next Device of a refresh in progress, once the SendQueue is empty
+			static byte m_nRefreshIndex;		//next Device to refresh (executors first, then sensors) - >= device count when no refresh is in progress
+			static bool bRefreshing;			//true while a Device's refresh() runs - messages are then queued as PRIORITY_LOW
 
 			#ifdef ENABLE_SERIAL
 				static void readSerial();		//reads data from Arduino IDE Serial Monitor, if enabled in Constants.h
 			#endif
 		
-			static String Return_String;		//static buffer for string data queued for transfer to SmartThings Shield - prevents dynamic memory allocation heap fragmentation
+			static String Send_String;			//reusable buffer for the message being sent - reserved once in init() to prevent heap fragmentation
 		
 		public:
 			static void init();					//st::Everything initialization routine called in your sketch setup() routine 
 			static void initDevices();			//calls the init() routine of every object added to st::Everything in your sketch setup() routine 
 			static void run();					//st::Everything initialization routine called in your sketch loop() routine 
 			
-			static bool sendSmartString(String &str); //sendSmartString() may edit the string reference passed to it - queues messages - preferable
-			static bool sendSmartStringNow(String &str); //sendSmartStringNow() may edit the string reference passed to it - sends messages immediate - only for special circumstances
+			static bool sendSmartString(String &str, byte priority = PRIORITY_NORMAL); //queues messages - preferable - returns false if the message was dropped
+			static bool sendSmartStringNow(String &str, byte priority = PRIORITY_NORMAL); //queues messages and sends right away if the transmit slot is due - only for special circumstances
 
 			static Device* getDeviceByName(const String &str);	//returns pointer to Device object by name
+			static Device* getDeviceByName(const char *name, unsigned int len);	//same, for the first len characters of name - does not allocate
 			
 			static bool addSensor(Sensor *sensor);		//adds a Sensor object to st::Everything's m_Sensors[] array - called in your sketch setup() routine
 			static bool addExecutor(Executor *executor);//adds a Executor object to st::Everything's m_Executors[] array - called in your sketch setup() routine
+
+			static unsigned long nextDeadline();	//millis() value by which run() must be called again - millis() itself if something needs every pass (interrupt sensors, queued messages...)
 		
 			static byte bTimersPending;	//number of time critical events in progress - if > 0, do NOT perform refreshDevices() routine 
 
+			static MessageQueue SendQueue;	//messages queued for transfer to ST Cloud - exposes drop counters, high-water mark and overflow policy
+			static PollScheduler Scheduler;	//st::PollingSensor objects ordered by the time their next poll is due
+
 			static bool debug;	//debug flag to determine if debug print statements are executed - set value in your sketch's setup() routine
 			
 			static void (*callOnMsgSend)(const String &msg); //If this function pointer is assigned, the function it points to will be called upon every time a string is sent to the cloud.		
@@ -95,6 +121,7 @@ namespace st
 			#endif
 
 			friend SmartThingsCallout_t receiveSmartString; //callback function to act on data received from SmartThings Shield - called from SmartThings Shield Library
+			friend class Metrics;	//reports the statistics of every sensor
 			
 			//SmartThings Object
 			//#ifndef DISABLE_SMARTTHINGS
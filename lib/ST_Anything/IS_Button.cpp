@@ -21,6 +21,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2017-03-25  Dan            Original Creation
+//    2026-10-16  Per Ivar Nerseth  State change events are queued as PRIORITY_HIGH
+//    2026-10-16  Per Ivar Nerseth  Pushed/held is decided on the edge times (getEventMillis), not the time update() ran
 //
 //
 //******************************************************************************************
@@ -63,7 +65,7 @@ namespace st
 	void IS_Button::runInterrupt()
 	{
 		//Capture time of button down event so we can figure it whether to send "pushed" or "held" on button release
-		m_lTimeBtnPressed = millis();
+		m_lTimeBtnPressed = getEventMillis();
 
 		//Serial.println("IS_Button: in runInterrupt()");
 	}
@@ -77,15 +79,15 @@ namespace st
 
 		if (!m_bFirstRun)  //Prevent sending data to SmartThings during initial startup
 		{
-			if (millis() < (m_lTimeBtnPressed + m_lreqNumMillisHeld))
+			if (getEventMillis() < (m_lTimeBtnPressed + m_lreqNumMillisHeld))
 			{
 				//add the "pushed" event to the buffer to be queued for transfer to SmartThings
-				Everything::sendSmartString(getName() + F(" pushed"));
+				Everything::sendSmartString(getName() + F(" pushed"), PRIORITY_HIGH);
 			}
-			else if (millis() >= (m_lTimeBtnPressed + m_lreqNumMillisHeld))
+			else if (getEventMillis() >= (m_lTimeBtnPressed + m_lreqNumMillisHeld))
 			{
 				//add the "held" event to the buffer to be queued for transfer to SmartThings
-				Everything::sendSmartString(getName() + F(" held"));
+				Everything::sendSmartString(getName() + F(" held"), PRIORITY_HIGH);
 			}
 		}
 		else
@@ -21,6 +21,7 @@
 //    ----        ---            ----
 //    2015-04-19  Dan & Daniel   Original Creation
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  State change events are queued as PRIORITY_HIGH
 //
 //
 //******************************************************************************************
@@ -61,13 +62,13 @@ namespace st
 	void IS_CarbonMonoxide::runInterrupt()
 	{
 		//add the "closed" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" clear"));
+		Everything::sendSmartString(getName() + F(" clear"), PRIORITY_HIGH);
 	}
 	
 	void IS_CarbonMonoxide::runInterruptEnded()
 	{
 		//add the "open" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" detected"));
+		Everything::sendSmartString(getName() + F(" detected"), PRIORITY_HIGH);
 	}
 
 }
\ No newline at end of file
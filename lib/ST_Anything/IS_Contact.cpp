@@ -22,6 +22,7 @@
 //    2015-01-03  Dan & Daniel   Original Creation
 //	  2015-03-17  Dan Ogorchock  Added optional "numReqCounts" constructor argument/capability
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  State change events are queued as PRIORITY_HIGH
 //
 //
 //******************************************************************************************
@@ -62,13 +63,13 @@ namespace st
 	void IS_Contact::runInterrupt()
 	{
 		//add the "closed" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" closed"));
+		Everything::sendSmartString(getName() + F(" closed"), PRIORITY_HIGH);
 	}
 	
 	void IS_Contact::runInterruptEnded()
 	{
 		//add the "open" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" open"));
+		Everything::sendSmartString(getName() + F(" open"), PRIORITY_HIGH);
 	}
 
 }
\ No newline at end of file
@@ -28,6 +28,7 @@
 //    ----        ---            ----
 //    2015-01-07  Dan Ogorchock  Original Creation
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  State change events are queued as PRIORITY_HIGH
 //
 //
 //******************************************************************************************
@@ -132,13 +133,13 @@ namespace st
 	void IS_DoorControl::runInterrupt()
 	{
 		//add the "closed" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" closed"));
+		Everything::sendSmartString(getName() + F(" closed"), PRIORITY_HIGH);
 	}
 	
 	void IS_DoorControl::runInterruptEnded()
 	{
 		//add the "open" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" open"));
+		Everything::sendSmartString(getName() + F(" open"), PRIORITY_HIGH);
 	}
 
 	void IS_DoorControl::setOutputPin(byte pin)
@@ -23,6 +23,7 @@
 //	  2016-09-03  Dan Ogorchock  Added optional "numReqCounts" constructor argument/capability
 //    2017-01-25  Dan Ogorchock  Corrected issue with INPUT_PULLUP per request of Jiri Culik
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  State change events are queued as PRIORITY_HIGH
 //
 //
 //******************************************************************************************
@@ -69,13 +70,13 @@ namespace st
 	void IS_Motion::runInterrupt()
 	{
 		//add the "active" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" active"));
+		Everything::sendSmartString(getName() + F(" active"), PRIORITY_HIGH);
 	}
 	
 	void IS_Motion::runInterruptEnded()
 	{
 		//add the "inactive" event to the buffer to be queued for transfer to the ST Shield
-		Everything::sendSmartString(getName() + F(" inactive"));
+		Everything::sendSmartString(getName() + F(" inactive"), PRIORITY_HIGH);
 	}
 	
 	void IS_Motion::update()
@@ -12,6 +12,8 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //	  2015-03-17  Dan			 Added optional "numReqCounts" constructor argument/capability
+//    2026-10-16  Per Ivar Nerseth  Added edge capture mode (enableEdgeCapture) with debounce in microseconds
+//    2026-10-17  Per Ivar Nerseth  Edge capture: bounces coalesced in a full ring, the level before discarded edges evaluated
 //
 //
 //******************************************************************************************
@@ -36,6 +38,7 @@ namespace st
 				{
 					m_bStatus = true;
 					m_bInitRequired = false;
+					m_nEventMillis = millis();
 					runInterrupt();
 				}
 			}
@@ -47,11 +50,72 @@ namespace st
 				{
 					m_bStatus = false;
 					m_bInitRequired = false;
+					m_nEventMillis = millis();
 					runInterruptEnded();
 				}
 			}
 	}
 
+	//Edge capture mode: takes the edges recorded by the interrupt routine.  A level that held for
+	//m_nDebounceMicros before the next edge (or until now) is believed, anything shorter is bounce.
+	void InterruptSensor::checkEdges()
+	{
+		unsigned long now = micros();	//read first, so every edge drained below is at or before now
+		unsigned long edgeMicros;
+		bool level;
+
+		while (EdgeCapture::read(m_nEdgeChannel, edgeMicros, level))
+		{
+			if (level == m_bEdgeLevel)
+			{
+				continue;	//the opposite edge in between was too short to read the pin
+			}
+			if (edgeMicros - m_nEdgeMicros >= m_nDebounceMicros)
+			{
+				setState(m_bEdgeLevel, m_nEdgeMicros);
+			}
+			m_bEdgeLevel = level;
+			m_nEdgeMicros = edgeMicros;
+		}
+
+		unsigned long lostMicros;
+		if (EdgeCapture::overflowed(m_nEdgeChannel, lostMicros, edgeMicros, level))
+		{
+			//edges were discarded after the buffered ones: the pending level held until the first of them,
+			//and the last of them is where the pin is now
+			if (lostMicros - m_nEdgeMicros >= m_nDebounceMicros)
+			{
+				setState(m_bEdgeLevel, m_nEdgeMicros);
+			}
+			m_bEdgeLevel = level;
+			m_nEdgeMicros = edgeMicros;
+		}
+
+		if ((long)(now - m_nEdgeMicros) >= (long)m_nDebounceMicros)
+		{
+			setState(m_bEdgeLevel, m_nEdgeMicros);
+		}
+	}
+
+	//Edge capture mode: the pin has settled at level since edgeMicros
+	void InterruptSensor::setState(bool level, unsigned long edgeMicros)
+	{
+		if (level == m_bInterruptState && !m_bStatus) //new interrupt
+		{
+			m_bStatus = true;
+			m_bInitRequired = false;
+			m_nEventMillis = millis() - (micros() - edgeMicros) / 1000;
+			runInterrupt();
+		}
+		else if (level != m_bInterruptState && (m_bStatus || m_bInitRequired)) //interrupt has ended OR Init called us
+		{
+			m_bStatus = false;
+			m_bInitRequired = false;
+			m_nEventMillis = millis() - (micros() - edgeMicros) / 1000;
+			runInterruptEnded();
+		}
+	}
+
 //public
 	//constructor
 	InterruptSensor::InterruptSensor(const __FlashStringHelper *name, byte pin, bool iState, bool pullup, long numReqCounts) :
@@ -62,7 +126,12 @@ namespace st
 		m_bInitRequired(true),
 		m_nRequiredCounts(numReqCounts),
 		m_nCurrentUpCount(0),
-		m_nCurrentDownCount(numReqCounts)
+		m_nCurrentDownCount(numReqCounts),
+		m_nEdgeChannel(EdgeCapture::NO_CHANNEL),
+		m_bEdgeLevel(false),
+		m_nEdgeMicros(0),
+		m_nDebounceMicros(0),
+		m_nEventMillis(0)
 		{
 			setInterruptPin(pin);
 		}
@@ -76,13 +145,45 @@ namespace st
 	//initialization function
 	void InterruptSensor::init()
 	{
-		checkIfTriggered();
+		if (getEdgeCapture())
+		{
+			//start from the current level of the pin and report it right away
+			EdgeCapture::clear(m_nEdgeChannel);
+			m_bEdgeLevel = digitalRead(m_nInterruptPin);
+			m_nEdgeMicros = micros() - m_nDebounceMicros;
+			checkEdges();
+		}
+		else
+		{
+			checkIfTriggered();
+		}
 	}
 	
 	//update function 
 	void InterruptSensor::update()
 	{
-		checkIfTriggered();
+		if (getEdgeCapture())
+		{
+			checkEdges();
+		}
+		else
+		{
+			checkIfTriggered();
+		}
+	}
+
+	bool InterruptSensor::enableEdgeCapture(unsigned long debounceMicros)
+	{
+		m_nDebounceMicros = debounceMicros;
+		if (!getEdgeCapture())
+		{
+			m_nEdgeChannel = EdgeCapture::attach(m_nInterruptPin, debounceMicros);
+		}
+		else
+		{
+			EdgeCapture::setCoalesce(m_nEdgeChannel, debounceMicros);
+		}
+		return getEdgeCapture();
 	}
 
 	//handles start of an interrupt - all derived classes should implement this virtual function
@@ -106,6 +207,12 @@ namespace st
 	//sets the pin to be monitored, and set the Arduino pinMode based on constructor data
 	void InterruptSensor::setInterruptPin(byte pin)
 	{
+		if (getEdgeCapture() && pin != m_nInterruptPin)
+		{
+			//move the interrupt to the new pin
+			EdgeCapture::detach(m_nEdgeChannel);
+			m_nEdgeChannel = EdgeCapture::attach(pin, m_nDebounceMicros);
+		}
 		m_nInterruptPin=pin;
 		if(!m_bPullup)
 		{
@@ -12,6 +12,7 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //	  2015-03-17  Dan			 Added optional "numReqCounts" constructor argument/capability
+//    2026-10-16  Per Ivar Nerseth  Added edge capture mode (enableEdgeCapture) with debounce in microseconds
 //
 //
 //******************************************************************************************
@@ -20,6 +21,7 @@
 #define ST_INTERRUPTSENSOR_H
 
 #include "Sensor.h"
+#include "EdgeCapture.h"
 
 namespace st
 {
@@ -34,8 +36,15 @@ namespace st
 			long m_nRequiredCounts;	//Number of required counts (checks of the pin) before believing the pin is high/low
 			long m_nCurrentUpCount;
 			long m_nCurrentDownCount;
+			byte m_nEdgeChannel;				//st::EdgeCapture channel, EdgeCapture::NO_CHANNEL == polled mode (numReqCounts)
+			bool m_bEdgeLevel;					//edge capture mode: pin level after the last edge
+			unsigned long m_nEdgeMicros;		//edge capture mode: micros() of the last edge
+			unsigned long m_nDebounceMicros;	//edge capture mode: time the pin must hold a level before it is believed
+			unsigned long m_nEventMillis;		//millis() at which the current state (triggered or ended) began
 
 			void checkIfTriggered(); 
+			void checkEdges();
+			void setState(bool level, unsigned long edgeMicros);
 			
 		public:
 			//constructor
@@ -56,7 +65,16 @@ namespace st
 			//handles what to do when interrupt is ended - all derived classes should implement this virtual function
 			virtual void runInterruptEnded();
 			
+			//switches from counting checks of the pin (numReqCounts) to a pin-change interrupt that
+			//time stamps every edge.  A level is believed once it has held for debounceMicros, however
+			//slow the loop is, and pulses longer than debounceMicros are never missed.  Call in setup()
+			//before st::Everything::initDevices().  Returns false (the sensor stays in polled mode) if
+			//Constants::MAX_EDGE_CAPTURE_PINS sensors already use edge capture.
+			bool enableEdgeCapture(unsigned long debounceMicros = 5000);
+
 			//gets
+			inline bool getEdgeCapture() const {return m_nEdgeChannel != EdgeCapture::NO_CHANNEL;}
+			inline unsigned long getEventMillis() const {return m_nEventMillis;}	//time the current state began (edge time in edge capture mode)
 			inline byte getInterruptPin() const {return m_nInterruptPin;}
 			inline bool getInterruptState() const {return m_bInterruptState;}
 			inline bool getStatus() const {return m_bStatus;}	//whether or not the device is currently interrupted
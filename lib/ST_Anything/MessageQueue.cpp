@@ -0,0 +1,157 @@
+//******************************************************************************************
+//  File: MessageQueue.cpp
+//
+//  Summary:  st::MessageQueue is the fixed-capacity queue of messages waiting to be sent
+//			  to the hub by st::Everything.  See MessageQueue.h for the overflow rules.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "MessageQueue.h"
+
+namespace st
+{
+//private
+	void MessageQueue::removeAt(byte pos)
+	{
+		m_nFree[m_nFreeCount++] = slotAt(pos);
+
+		//close the gap by moving the newer entries one position towards the head
+		for (byte i = pos; i + 1 < m_nCount; ++i)
+		{
+			m_nOrder[(m_nHead + i) % Constants::RETURN_QUEUE_SIZE] = slotAt(i + 1);
+		}
+		--m_nCount;
+	}
+
+	int MessageQueue::findOldest(byte priority, bool lower) const
+	{
+		for (byte pos = 0; pos < m_nCount; ++pos)
+		{
+			byte p = m_nPriority[slotAt(pos)];
+			if (lower ? (p < priority) : (p == priority))
+			{
+				return pos;
+			}
+		}
+		return -1;
+	}
+
+//public
+	//constructor
+	MessageQueue::MessageQueue()
+	{
+		//a newer refresh always follows, so a full queue drops new refresh messages
+		m_nPolicy[PRIORITY_LOW] = DROP_NEWEST;
+		//for values and state changes the latest message is the one worth keeping
+		m_nPolicy[PRIORITY_NORMAL] = DROP_OLDEST;
+		m_nPolicy[PRIORITY_HIGH] = DROP_OLDEST;
+
+		clear();
+		resetStatistics();
+	}
+
+	bool MessageQueue::push(const char *msg, unsigned int len, byte priority)
+	{
+		if (priority >= PRIORITY_COUNT)
+		{
+			priority = PRIORITY_HIGH;
+		}
+
+		if (len >= Constants::RETURN_MESSAGE_LENGTH)
+		{
+			++m_nDrops[priority];
+			return false;
+		}
+
+		if (m_nFreeCount == 0)
+		{
+			int victim = findOldest(priority, true);
+			if (victim < 0 && m_nPolicy[priority] == DROP_OLDEST)
+			{
+				victim = findOldest(priority, false);
+			}
+			if (victim < 0)
+			{
+				++m_nDrops[priority];
+				return false;
+			}
+			++m_nDrops[m_nPriority[slotAt(victim)]];
+			removeAt(victim);
+		}
+
+		byte slot = m_nFree[--m_nFreeCount];
+		memcpy(m_Slots[slot], msg, len);
+		m_Slots[slot][len] = 0;
+		m_nPriority[slot] = priority;
+		m_nOrder[(m_nHead + m_nCount) % Constants::RETURN_QUEUE_SIZE] = slot;
+		++m_nCount;
+
+		if (m_nCount > m_nHighWater)
+		{
+			m_nHighWater = m_nCount;
+		}
+		return true;
+	}
+
+	const char* MessageQueue::front() const
+	{
+		return m_nCount ? m_Slots[m_nOrder[m_nHead]] : 0;
+	}
+
+	void MessageQueue::pop()
+	{
+		if (m_nCount == 0)
+		{
+			return;
+		}
+		m_nFree[m_nFreeCount++] = m_nOrder[m_nHead];
+		m_nHead = (m_nHead + 1) % Constants::RETURN_QUEUE_SIZE;
+		--m_nCount;
+	}
+
+	void MessageQueue::clear()
+	{
+		m_nHead = 0;
+		m_nCount = 0;
+		m_nFreeCount = Constants::RETURN_QUEUE_SIZE;
+		for (byte i = 0; i < Constants::RETURN_QUEUE_SIZE; ++i)
+		{
+			m_nFree[i] = Constants::RETURN_QUEUE_SIZE - 1 - i;
+		}
+	}
+
+	unsigned long MessageQueue::drops() const
+	{
+		unsigned long total = 0;
+		for (byte p = 0; p < PRIORITY_COUNT; ++p)
+		{
+			total += m_nDrops[p];
+		}
+		return total;
+	}
+
+	void MessageQueue::setOverflowPolicy(byte priority, byte policy)
+	{
+		if (priority < PRIORITY_COUNT)
+		{
+			m_nPolicy[priority] = policy;
+		}
+	}
+
+	void MessageQueue::resetStatistics()
+	{
+		m_nHighWater = m_nCount;
+		for (byte p = 0; p < PRIORITY_COUNT; ++p)
+		{
+			m_nDrops[p] = 0;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+//******************************************************************************************
+//  File: MessageQueue.h
+//
+//  Summary:  st::MessageQueue is the fixed-capacity queue of messages waiting to be sent
+//			  to the hub by st::Everything.  It replaces the old "|" delimited Return_String.
+//			  -All storage is allocated statically (RETURN_QUEUE_SIZE slots of
+//			   RETURN_MESSAGE_LENGTH characters, set in Constants.h) - no heap is used.
+//			  -Messages leave the queue in the order they were queued.
+//			  -Every message carries a priority.  When the queue is full, the oldest queued
+//			   message of a LOWER priority is discarded to make room.  If there is none, the
+//			   overflow policy of the new message's priority decides:
+//				 DROP_OLDEST - discard the oldest queued message of the same priority
+//				 DROP_NEWEST - discard the new message
+//			  -Drops (per priority) and the high-water mark are counted so overload can
+//			   be detected in the field.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_MESSAGEQUEUE_H
+#define ST_MESSAGEQUEUE_H
+
+#include "Constants.h"
+
+namespace st
+{
+	//message priorities, lowest first
+	enum MessagePriority
+	{
+		PRIORITY_LOW = 0,		//periodic refresh of current state - a newer refresh will follow
+		PRIORITY_NORMAL,		//polled values and command acknowledgements (default)
+		PRIORITY_HIGH,			//state changes detected on an input (contact, motion, smoke, button...)
+		PRIORITY_COUNT
+	};
+
+	enum OverflowPolicy
+	{
+		DROP_OLDEST = 0,
+		DROP_NEWEST
+	};
+
+	class MessageQueue
+	{
+		private:
+			char m_Slots[Constants::RETURN_QUEUE_SIZE][Constants::RETURN_MESSAGE_LENGTH];	//message text, null terminated
+			byte m_nPriority[Constants::RETURN_QUEUE_SIZE];		//priority of the message in each slot
+			byte m_nOrder[Constants::RETURN_QUEUE_SIZE];		//ring of slot numbers, oldest message first
+			byte m_nFree[Constants::RETURN_QUEUE_SIZE];			//stack of unused slot numbers
+			byte m_nHead;				//position of the oldest message in m_nOrder
+			byte m_nCount;				//number of queued messages
+			byte m_nFreeCount;			//number of unused slots
+			byte m_nHighWater;			//largest m_nCount seen
+			byte m_nPolicy[PRIORITY_COUNT];			//OverflowPolicy for each priority
+			unsigned long m_nDrops[PRIORITY_COUNT];	//messages discarded, by priority of the discarded message
+
+			byte slotAt(byte pos) const {return m_nOrder[(m_nHead + pos) % Constants::RETURN_QUEUE_SIZE];}
+			void removeAt(byte pos);	//removes the message at ring position pos, keeping the order of the others
+			int findOldest(byte priority, bool lower) const;	//ring position of the oldest message with priority == (or <) priority, -1 if none
+
+		public:
+			//constructor
+			MessageQueue();
+
+			//queues len characters of msg - returns false if the new message was dropped (too long, or queue full)
+			bool push(const char *msg, unsigned int len, byte priority = PRIORITY_NORMAL);
+
+			//oldest queued message (null terminated), or 0 if the queue is empty
+			const char* front() const;
+
+			//removes the oldest queued message
+			void pop();
+
+			//discards all queued messages (counters are kept)
+			void clear();
+
+			//gets
+			inline byte depth() const {return m_nCount;}
+			inline bool empty() const {return m_nCount == 0;}
+			inline byte capacity() const {return Constants::RETURN_QUEUE_SIZE;}
+			inline byte highWater() const {return m_nHighWater;}
+			inline unsigned long drops(byte priority) const {return priority < PRIORITY_COUNT ? m_nDrops[priority] : 0;}
+			unsigned long drops() const;	//total over all priorities
+
+			//sets
+			void setOverflowPolicy(byte priority, byte policy);
+			void resetStatistics();
+	};
+}
+
+#endif
@@ -0,0 +1,165 @@
+//******************************************************************************************
+//  File: Metrics.cpp
+//
+//  Summary:  st::Metrics collects runtime statistics of st::Everything.  See Metrics.h.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#include "Metrics.h"
+
+#ifndef DISABLE_METRICS
+
+#include "Everything.h"
+#include "PollingSensor.h"
+
+long freeRam();	//see Everything.cpp
+
+namespace st
+{
+//private
+	void Metrics::writeHeap(Print &out)
+	{
+		long freeHeap;
+		long largestBlock;
+		#if defined(ARDUINO_ARCH_ESP8266)
+			freeHeap = ESP.getFreeHeap();
+			largestBlock = ESP.getMaxFreeBlockSize();
+		#elif defined(ARDUINO_ARCH_ESP32)
+			freeHeap = ESP.getFreeHeap();
+			largestBlock = ESP.getMaxAllocHeap();
+		#else
+			freeHeap = freeRam();		//the gap between heap and stack, which is also the largest block
+			largestBlock = freeHeap;
+		#endif
+		if (freeHeap < 0)
+		{
+			return;	//unknown on this board
+		}
+		out.print(F("st_heap_free_bytes "));
+		out.println(freeHeap);
+		out.print(F("st_heap_largest_free_block_bytes "));
+		out.println(largestBlock);
+	}
+
+//public
+	void Metrics::loopPass()
+	{
+		unsigned long now = micros();
+		if (m_bFirstPass)
+		{
+			m_bFirstPass = false;
+			m_nLastPassMicros = now;
+			return;
+		}
+
+		unsigned long period = now - m_nLastPassMicros;
+		m_nLastPassMicros = now;
+
+		byte bucket = 0;
+		while (bucket < LOOP_BUCKETS - 1 && period > LOOP_LIMITS[bucket])
+		{
+			++bucket;
+		}
+		m_nLoopBuckets[bucket]++;
+		if (period > m_nLoopMicrosMax)
+		{
+			m_nLoopMicrosMax = period;
+		}
+	}
+
+	void Metrics::write(Print &out)
+	{
+		out.print(F("st_uptime_ms "));
+		out.println(millis());
+
+		//loop period histogram - the buckets are cumulative, as Prometheus expects
+		unsigned long cumulative = 0;
+		for (byte bucket = 0; bucket < LOOP_BUCKETS; ++bucket)
+		{
+			cumulative += m_nLoopBuckets[bucket];
+			out.print(F("st_loop_period_us_bucket{le=\""));
+			if (bucket < LOOP_BUCKETS - 1)
+			{
+				out.print(LOOP_LIMITS[bucket]);
+			}
+			else
+			{
+				out.print(F("+Inf"));
+			}
+			out.print(F("\"} "));
+			out.println(cumulative);
+		}
+		out.print(F("st_loop_period_us_count "));
+		out.println(cumulative);
+		out.print(F("st_loop_period_us_max "));
+		out.println(m_nLoopMicrosMax);
+
+		//time spent in each sensor
+		for (byte index = 0; index < Everything::m_nSensorCount; ++index)
+		{
+			const Sensor *sensor = Everything::m_Sensors[index];
+			const String name = sensor->getName();
+			out.print(F("st_update_count{device=\""));
+			out.print(name);
+			out.print(F("\"} "));
+			out.println(sensor->getUpdateCount());
+			out.print(F("st_update_us_sum{device=\""));
+			out.print(name);
+			out.print(F("\"} "));
+			out.println(sensor->getUpdateMicros());
+			out.print(F("st_update_us_max{device=\""));
+			out.print(name);
+			out.print(F("\"} "));
+			out.println(sensor->getUpdateMicrosMax());
+		}
+
+		//messages waiting for the hub
+		out.print(F("st_queue_depth "));
+		out.println((unsigned int)Everything::SendQueue.depth());
+		out.print(F("st_queue_capacity "));
+		out.println((unsigned int)Everything::SendQueue.capacity());
+		out.print(F("st_queue_high_water "));
+		out.println((unsigned int)Everything::SendQueue.highWater());
+		out.print(F("st_queue_drops{priority=\"low\"} "));
+		out.println(Everything::SendQueue.drops(PRIORITY_LOW));
+		out.print(F("st_queue_drops{priority=\"normal\"} "));
+		out.println(Everything::SendQueue.drops(PRIORITY_NORMAL));
+		out.print(F("st_queue_drops{priority=\"high\"} "));
+		out.println(Everything::SendQueue.drops(PRIORITY_HIGH));
+
+		//PollingSensor reporting policy
+		out.print(F("st_reports_sent "));
+		out.println(PollingSensor::totalReportsSent);
+		out.print(F("st_reports_suppressed "));
+		out.println(PollingSensor::totalReportsSuppressed);
+
+		writeHeap(out);
+	}
+
+	void Metrics::reset()
+	{
+		for (byte bucket = 0; bucket < LOOP_BUCKETS; ++bucket)
+		{
+			m_nLoopBuckets[bucket] = 0;
+		}
+		m_nLoopMicrosMax = 0;
+		m_bFirstPass = true;
+	}
+
+	//1ms and below is a healthy loop - beyond 100ms events and hub commands wait noticeably
+	const unsigned long Metrics::LOOP_LIMITS[LOOP_BUCKETS - 1] = {100, 1000, 5000, 10000, 50000, 100000, 500000, 1000000};
+	unsigned long Metrics::m_nLoopBuckets[LOOP_BUCKETS];
+	unsigned long Metrics::m_nLoopMicrosMax = 0;
+	unsigned long Metrics::m_nLastPassMicros = 0;
+	bool Metrics::m_bFirstPass = true;
+}
+
+#endif
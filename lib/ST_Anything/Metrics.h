@@ -0,0 +1,65 @@
+//******************************************************************************************
+//  File: Metrics.h
+//
+//  Summary:  st::Metrics collects runtime statistics of st::Everything and writes them as plain
+//			  text, one "name value" line per metric (Prometheus text format), so an overloaded
+//			  node can be found without a serial cable.  st::Everything::init() registers write()
+//			  with the SmartThings transport (SmartThings::setMetricsCallout()), and transports
+//			  with an HTTP server (e.g. SmartThingsESP8266WiFi) serve it on GET /metrics, after
+//			  their own send latency, connect failure and RSSI figures.
+//			  -st_loop_period_us: histogram of the time between two calls of Everything::run()
+//			  -st_update_us_sum/_max/st_update_count: time spent in each sensor's update() (or poll)
+//			  -st_queue_*: SendQueue depth, high-water mark and drops per priority
+//			  -st_reports_*: reports sent and suppressed by the PollingSensor reporting policy
+//			  -st_heap_*: free heap and largest free block (where the board can tell)
+//
+//			  Define DISABLE_METRICS in Constants.h to leave the statistics out.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_METRICS_H
+#define ST_METRICS_H
+
+#include "Constants.h"
+
+namespace st
+{
+	class Metrics
+	{
+		public:
+			static const byte LOOP_BUCKETS = 9;		//the last bucket counts everything above the last limit
+
+			//records one pass of the loop - called at the start of Everything::run()
+			static void loopPass();
+
+			//writes every metric to out - SmartThingsMetrics_t callout
+			static void write(Print &out);
+
+			//clears the loop period histogram
+			static void reset();
+
+			//gets
+			static unsigned long getLoopCount(byte bucket) {return bucket < LOOP_BUCKETS ? m_nLoopBuckets[bucket] : 0;}
+			static unsigned long getLoopLimit(byte bucket) {return bucket < LOOP_BUCKETS - 1 ? LOOP_LIMITS[bucket] : 0;}	//upper bound of a bucket in microseconds, 0 == none
+			static unsigned long getLoopMicrosMax() {return m_nLoopMicrosMax;}
+
+		private:
+			static const unsigned long LOOP_LIMITS[LOOP_BUCKETS - 1];	//in microseconds
+			static unsigned long m_nLoopBuckets[LOOP_BUCKETS];
+			static unsigned long m_nLoopMicrosMax;
+			static unsigned long m_nLastPassMicros;
+			static bool m_bFirstPass;
+
+			static void writeHeap(Print &out);
+	};
+}
+
+#endif
@@ -35,6 +35,7 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2017-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
 //
 //
 //******************************************************************************************
@@ -95,7 +96,10 @@ namespace st
 	{
 		int m_nSensorValue=map(analogRead(m_nAnalogInputPin), SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH);
 		
-		Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		if (reportDue(m_nSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		}
 	}
 	
 	void PS_Illuminance::setPin(byte pin)
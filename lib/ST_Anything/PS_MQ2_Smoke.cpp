@@ -27,6 +27,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2017-07-04  Dan Ogorchock  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
 //
 //
 //******************************************************************************************
@@ -85,7 +86,11 @@ namespace st
 	{
 		int m_nSensorValue=analogRead(m_nAnalogInputPin);
 		
-		Everything::sendSmartString(getName() + (m_nSensorValue < m_nSensorLimit ? F(" clear") : F(" detected")));
+		bool detected = !(m_nSensorValue < m_nSensorLimit);
+		if (reportDue(detected))	//with a policy, only changes of state (and heartbeats) are sent
+		{
+			Everything::sendSmartString(getName() + (detected ? F(" detected") : F(" clear")));
+		}
 
 		if (st::PollingSensor::debug)
 		{
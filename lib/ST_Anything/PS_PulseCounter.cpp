@@ -35,6 +35,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-03-31  Dan Ogorchock   Original Creation
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
 //
 //
 //******************************************************************************************
@@ -161,7 +162,10 @@ namespace st
 			}
 		}
 
-		Everything::sendSmartString(getName() + " " + m_nSensorValue);
+		if (reportDue(m_nSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + m_nSensorValue);
+		}
 	}
 
 	void PS_PulseCounter::setPin(byte pin)
@@ -57,6 +57,15 @@
 //
 // 				CompensatedValue = Coeff1 * rawAnalogInput^3 + Coeff2 * rawAnalogInput^2 + Coeff3 * rawAnalogInput + Coeff4
 //
+//			  On the ESP8266 and ESP32 the compensation is worked out once, in the constructor, into
+//			  a table indexed by the raw analog input (PS_VOLTAGE_ADC_MAX + 1 entries: 1024 on the
+//			  ESP8266, 4096 on the ESP32 - 4 bytes each), so a sample costs a table lookup instead of
+//			  the polynomial in soft-float.  The AVR and other small boards have no heap to spare for
+//			  it and work the polynomial out per sample (without pow()).
+//			  The samples are averaged and filtered as fixed-point analog input counts (1/65536
+//			  count in 64 bits; 1/256 count in 32 bits on the AVR), and mapped to engineering units
+//			  once per poll - map() is linear, so this gives the value that mapping every sample did.
+//
 //			  This class supports receiving configuration data from the SmartThings cloud via the ST App.  A user preference
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
@@ -72,6 +81,9 @@
 //    2017-08-31  Dan Ogorchock  Added oversampling optional argument to help reduce noisy signals
 //    2017-08-31  Dan Ogorchock  Added filtering optional argument to help reduce noisy signals
 //    2017-09-01  Dan Ogorchock  Added 3rd order polynomial nonlinear correction compensation
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Compensation table built in the constructor; fixed-point averaging and filtering
+//    2026-10-17  Per Ivar Nerseth  Compensation table on the ESP8266/ESP32 only; 32-bit fixed point on the AVR
 //
 //
 //******************************************************************************************
@@ -79,14 +91,63 @@
 
 #include "Constants.h"
 #include "Everything.h"
-#include <math.h>
 
 namespace st
 {
+	//fractional bits of the fixed-point averaged and filtered analog input (PS_Voltage::Fixed)
+#if defined(ARDUINO_ARCH_AVR)
+	const byte FIXED_BITS = 8;
+#else
+	const byte FIXED_BITS = 16;
+#endif
+
 //private
-	float map_double(double x, double in_min, double in_max, double out_min, double out_max)
+	void PS_Voltage::setFilterConstant(byte filterConstant)
+	{
+		//check for upper and lower limit and adjust accordingly
+		if ((filterConstant <= 0) || (filterConstant >= 100))
+		{
+			m_nFilterConstant = 100;
+		}
+		else if (filterConstant <= 5)
+		{
+			m_nFilterConstant = 5;
+		}
+		else
+		{
+			m_nFilterConstant = filterConstant;
+		}
+	}
+
+	void PS_Voltage::setMapping()
 	{
-		return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+		//map(x, s_l, s_h, m_l, m_h) of a fixed-point value, as one multiply and add
+		double scale = (MAPPED_HIGH - MAPPED_LOW) / (SENSOR_HIGH - SENSOR_LOW);
+		m_dScale = scale / ((Fixed)1 << FIXED_BITS);
+		m_dOffset = MAPPED_LOW - SENSOR_LOW * scale;
+	}
+
+	//the compensation of every raw analog input, worked out once
+	void PS_Voltage::buildTable()
+	{
+#if defined(PS_VOLTAGE_ADC_MAX)
+		m_pCompensated = new long[PS_VOLTAGE_ADC_MAX + 1];
+		if (m_pCompensated == NULL)
+		{
+			return;		//no room - compensate() works it out per sample
+		}
+		for (long i = 0; i <= PS_VOLTAGE_ADC_MAX; i++)
+		{
+			m_pCompensated[i] = compensate(i);
+		}
+#endif
+	}
+
+	long PS_Voltage::compensate(long analogInput) const
+	{
+		//x^2 and x^3 are exact for an analog input, as pow() gave them
+		double x = analogInput;
+		return (m_dCoeff1 * (x * x * x)) + (m_dCoeff2 * (x * x)) + (m_dCoeff3 * x) + m_dCoeff4;
 	}
 
 //public
@@ -98,25 +159,15 @@ namespace st
 		SENSOR_HIGH(s_h),
 		MAPPED_LOW(m_l),
 		MAPPED_HIGH(m_h),
-		m_nNumSamples(NumSamples),
-		m_bUseCompensation(false)
+		m_nNumSamples(NumSamples > 0 ? NumSamples : 1),
+		m_bUseCompensation(false),
+		m_pCompensated(NULL),
+		m_nFiltered(0),
+		m_bFiltered(false)
 	{
 		setPin(analogInputPin);
-
-		//check for upper and lower limit and adjust accordingly
-		if ((filterConstant <= 0) || (filterConstant >= 100))
-		{
-			m_fFilterConstant = 1.0;
-		}
-		else if (filterConstant <= 5)
-		{
-			m_fFilterConstant = 0.05;
-		}
-		else
-		{
-			m_fFilterConstant = float(filterConstant) / 100;
-		}
-
+		setFilterConstant(filterConstant);
+		setMapping();
 	}
 	
 	//constructor - called in your sketch's global variable declaration section
@@ -127,36 +178,27 @@ namespace st
 		SENSOR_HIGH(s_h),
 		MAPPED_LOW(m_l),
 		MAPPED_HIGH(m_h),
-		m_nNumSamples(NumSamples),
+		m_nNumSamples(NumSamples > 0 ? NumSamples : 1),
 		m_dCoeff1(Coeff1),
 		m_dCoeff2(Coeff2),
 		m_dCoeff3(Coeff3),
 		m_dCoeff4(Coeff4),
-		m_bUseCompensation(true)
+		m_bUseCompensation(true),
+		m_pCompensated(NULL),
+		m_nFiltered(0),
+		m_bFiltered(false)
 	{
 		setPin(analogInputPin);
-
-		//check for upper and lower limit and adjust accordingly
-		if ((filterConstant <= 0) || (filterConstant >= 100))
-		{
-			m_fFilterConstant = 1.0;
-		}
-		else if (filterConstant <= 5)
-		{
-			m_fFilterConstant = 0.05;
-		}
-		else
-		{
-			m_fFilterConstant = float(filterConstant) / 100;
-		}
-
+		setFilterConstant(filterConstant);
+		setMapping();
+		buildTable();
 	}
 
 
 	//destructor
 	PS_Voltage::~PS_Voltage()
 	{
-		
+		delete[] m_pCompensated;
 	}
 
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
@@ -185,7 +227,7 @@ namespace st
 	void PS_Voltage::getData()
 	{
 		int i;
-		double tempValue = 0;
+		long sum = 0;
 		long tempAnalogInput = 0;
 
 		//implement oversampling / averaging
@@ -194,42 +236,42 @@ namespace st
 			tempAnalogInput = analogRead(m_nAnalogInputPin);
 
 			if (m_bUseCompensation) {
-
-				//Serial.print(F("PS_Voltage::tempAnalogInput = "));
-				//Serial.print(tempAnalogInput);
-
-				tempAnalogInput = (m_dCoeff1 * pow(tempAnalogInput, 3)) + (m_dCoeff2 * pow(tempAnalogInput, 2)) + (m_dCoeff3 * tempAnalogInput) + m_dCoeff4;
-
-				//Serial.print(F(", PS_Voltage::tempAnalogInput (Compensated) = "));
-				//Serial.print(tempAnalogInput);
-				//Serial.println();
-
+#if defined(PS_VOLTAGE_ADC_MAX)
+				if (m_pCompensated != NULL && tempAnalogInput >= 0 && tempAnalogInput <= PS_VOLTAGE_ADC_MAX)
+				{
+					tempAnalogInput = m_pCompensated[tempAnalogInput];
+				}
+				else
+#endif
+				{
+					tempAnalogInput = compensate(tempAnalogInput);
+				}
 			}
 
-			tempValue += map_double(tempAnalogInput, SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH);
-
-			//if (st::PollingSensor::debug)
-			//{
-			//	Serial.print(F("PS_Voltage::tempValue = "));
-			//	Serial.print(tempValue);
-			//	Serial.println();
-			//}
+			sum += tempAnalogInput;
 		}
 		
-		tempValue = tempValue / m_nNumSamples; //calculate the average value over the number of samples
+		//calculate the average value over the number of samples, in fixed point
+		Fixed average = ((Fixed)sum << FIXED_BITS) / m_nNumSamples;
 
 		//implement filtering
-		if (m_fSensorValue == -1.0)
+		if (!m_bFiltered)
 		{
 			//first time through, no filtering
-			m_fSensorValue = tempValue;  
+			m_nFiltered = average;
+			m_bFiltered = true;
 		}
 		else
 		{
-			m_fSensorValue = (m_fFilterConstant * tempValue) + (1 - m_fFilterConstant) * m_fSensorValue;
+			m_nFiltered += (average - m_nFiltered) * m_nFilterConstant / 100;
 		}
+
+		m_fSensorValue = m_nFiltered * m_dScale + m_dOffset;
 		
-		Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+		if (reportDue(m_fSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+		}
 	}
 	
 	void PS_Voltage::setPin(byte pin)
@@ -57,6 +57,15 @@
 //
 // 				CompensatedValue = Coeff1 * rawAnalogInput^3 + Coeff2 * rawAnalogInput^2 + Coeff3 * rawAnalogInput + Coeff4
 //
+//			  On the ESP8266 and ESP32 the compensation is worked out once, in the constructor, into
+//			  a table indexed by the raw analog input (PS_VOLTAGE_ADC_MAX + 1 entries: 1024 on the
+//			  ESP8266, 4096 on the ESP32 - 4 bytes each), so a sample costs a table lookup instead of
+//			  the polynomial in soft-float.  The AVR and other small boards have no heap to spare for
+//			  it and work the polynomial out per sample (without pow()).
+//			  The samples are averaged and filtered as fixed-point analog input counts (1/65536
+//			  count in 64 bits; 1/256 count in 32 bits on the AVR), and mapped to engineering units
+//			  once per poll - map() is linear, so this gives the value that mapping every sample did.
+//
 //			  This class supports receiving configuration data from the SmartThings cloud via the ST App.  A user preference
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
@@ -72,6 +81,8 @@
 //    2017-08-31  Dan Ogorchock  Added oversampling optional argument to help reduce noisy signals
 //    2017-08-31  Dan Ogorchock  Added filtering optional argument to help reduce noisy signals
 //    2017-09-01  Dan Ogorchock  Added 3rd order polynomial nonlinear correction compensation
+//    2026-10-17  Per Ivar Nerseth  Compensation table built in the constructor; fixed-point averaging and filtering
+//    2026-10-17  Per Ivar Nerseth  Compensation table on the ESP8266/ESP32 only; 32-bit fixed point on the AVR
 //
 //
 //******************************************************************************************
@@ -79,6 +90,16 @@
 #define ST_PS_VOLTAGE_H
 
 #include "PollingSensor.h"
+#include "Constants.h"
+
+//largest raw analog input - the compensation table has one entry per value (no table where it is not defined)
+#ifndef PS_VOLTAGE_ADC_MAX
+#if defined(BOARD_ESP32)
+#define PS_VOLTAGE_ADC_MAX 4095
+#elif defined(BOARD_ESP8266) || defined(BOARD_NATIVE)
+#define PS_VOLTAGE_ADC_MAX 1023
+#endif
+#endif
 
 namespace st
 {
@@ -89,9 +110,23 @@ namespace st
 			float m_fSensorValue;
 			double SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH;
 			int m_nNumSamples;
-			float m_fFilterConstant;        //Filter constant % as floating point from 0.00 to 1.00
+			byte m_nFilterConstant;         //Filter constant % from 5 to 100
 			double m_dCoeff1, m_dCoeff2, m_dCoeff3, m_dCoeff4;  //3rd order polynomial nonlinear correction compensation coefficients
 			bool m_bUseCompensation;
+			long *m_pCompensated;           //compensated value of each raw analog input, NULL == worked out per sample
+#if defined(ARDUINO_ARCH_AVR)
+			typedef long Fixed;             //analog input counts in fixed point - 1/256 count, 32-bit math on the AVR
+#else
+			typedef int64_t Fixed;          //analog input counts in fixed point - 1/65536 count
+#endif
+			double m_dScale, m_dOffset;     //map() from fixed-point analog input counts to engineering units
+			Fixed m_nFiltered;              //filtered value in fixed-point analog input counts
+			bool m_bFiltered;               //false until the first poll
+
+			void setFilterConstant(byte filterConstant);
+			void setMapping();
+			void buildTable();
+			long compensate(long analogInput) const;
 
 		public:
 			//constructor - called in your sketch's global variable declaration section
@@ -28,6 +28,7 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2015-08-23  Dan			 Added optional alarm limit to constructor
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
 //
 //
 //******************************************************************************************
@@ -94,7 +95,11 @@ namespace st
 		}
 
 		//check to see if the sensor's value is < 100.  If so send "dry", otherwise send "wet".  Adjust the 100 as needed for your sensor.
-		Everything::sendSmartString(getName() + (m_nSensorValue<m_nSensorLimit?F(" dry"):F(" wet")));
+		bool wet = !(m_nSensorValue<m_nSensorLimit);
+		if (reportDue(wet))	//with a policy, only changes of state (and heartbeats) are sent
+		{
+			Everything::sendSmartString(getName() + (wet?F(" wet"):F(" dry")));
+		}
 	}
 	
 	void PS_Water::setPin(byte pin)
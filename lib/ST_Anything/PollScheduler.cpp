@@ -0,0 +1,138 @@
+//******************************************************************************************
+//  File: PollScheduler.cpp
+//
+//  Summary:  st::PollScheduler keeps the st::PollingSensor objects ordered by their next
+//			  due time.  See PollScheduler.h.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//    2026-10-16  Per Ivar Nerseth  Polls are timed for the /metrics page (Sensor::recordUpdate)
+//    2026-10-17  Per Ivar Nerseth  A poll that reschedules its sensor (PollingSensor::pollAgainIn) is timed for that sensor
+//
+//******************************************************************************************
+
+#include "PollScheduler.h"
+
+#include "PollingSensor.h"
+
+namespace st
+{
+//private
+	bool PollScheduler::earlier(const PollingSensor *a, const PollingSensor *b)
+	{
+		return (long)(a->nextPoll() - b->nextPoll()) < 0;	//signed difference handles millis() rollover
+	}
+
+	void PollScheduler::siftUp(byte pos)
+	{
+		while (pos > 0)
+		{
+			byte parent = (pos - 1) / 2;
+			if (!earlier(m_Heap[pos], m_Heap[parent]))
+			{
+				break;
+			}
+			PollingSensor *tmp = m_Heap[pos];
+			m_Heap[pos] = m_Heap[parent];
+			m_Heap[parent] = tmp;
+			pos = parent;
+		}
+	}
+
+	void PollScheduler::siftDown(byte pos)
+	{
+		while (true)
+		{
+			byte first = pos;
+			byte left = 2 * pos + 1;
+			byte right = left + 1;
+			if (left < m_nCount && earlier(m_Heap[left], m_Heap[first]))
+			{
+				first = left;
+			}
+			if (right < m_nCount && earlier(m_Heap[right], m_Heap[first]))
+			{
+				first = right;
+			}
+			if (first == pos)
+			{
+				break;
+			}
+			PollingSensor *tmp = m_Heap[pos];
+			m_Heap[pos] = m_Heap[first];
+			m_Heap[first] = tmp;
+			pos = first;
+		}
+	}
+
+//public
+	//constructor
+	PollScheduler::PollScheduler():
+		m_nCount(0)
+	{
+
+	}
+
+	bool PollScheduler::add(PollingSensor *sensor)
+	{
+		if (m_nCount >= Constants::MAX_SENSOR_COUNT)
+		{
+			return false;
+		}
+		sensor->start(millis());
+		m_Heap[m_nCount] = sensor;
+		siftUp(m_nCount);
+		++m_nCount;
+		return true;
+	}
+
+	void PollScheduler::start(unsigned long now)
+	{
+		for (byte i = 0; i < m_nCount; ++i)
+		{
+			m_Heap[i]->start(now);
+		}
+		//every sensor moved by the same amount except for pending offsets - rebuild the heap
+		for (byte i = m_nCount / 2; i > 0; --i)
+		{
+			siftDown(i - 1);
+		}
+	}
+
+	void PollScheduler::reschedule(PollingSensor *sensor)
+	{
+		for (byte i = 0; i < m_nCount; ++i)
+		{
+			if (m_Heap[i] == sensor)
+			{
+				siftUp(i);
+				siftDown(i);
+				return;
+			}
+		}
+	}
+
+	byte PollScheduler::runDue(unsigned long now)
+	{
+		byte polled = 0;
+		while (polled < m_nCount && m_Heap[0]->isDue(now))
+		{
+			#ifndef DISABLE_METRICS
+				PollingSensor *sensor = m_Heap[0];	//a split-phase read may reschedule it within poll()
+				unsigned long start = micros();
+				sensor->poll(now);
+				sensor->recordUpdate(micros() - start);
+			#else
+				m_Heap[0]->poll(now);
+			#endif
+			siftDown(0);
+			++polled;
+		}
+		return polled;
+	}
+}
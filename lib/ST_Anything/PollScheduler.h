@@ -0,0 +1,64 @@
+//******************************************************************************************
+//  File: PollScheduler.h
+//
+//  Summary:  st::PollScheduler keeps every st::PollingSensor added to st::Everything in a
+//			  binary min-heap ordered by the time its next poll is due.
+//			  -Each pass of st::Everything::run() only looks at the top of the heap, so
+//			   sensors that are not due cost nothing.
+//			  -Due times advance by exactly one interval per poll (see PollingSensor.h), so
+//			   a late pass does not push later polls back - there is no cumulative drift.
+//			  -next() tells st::Everything::nextDeadline() when the next poll is due.
+//			  -All storage is allocated statically (MAX_SENSOR_COUNT entries) - no heap is used.
+//
+//			  In general, this file should not need to be modified.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+
+#ifndef ST_POLLSCHEDULER_H
+#define ST_POLLSCHEDULER_H
+
+#include "Constants.h"
+
+namespace st
+{
+	class PollingSensor;
+
+	class PollScheduler
+	{
+		private:
+			PollingSensor* m_Heap[Constants::MAX_SENSOR_COUNT];	//min-heap ordered by PollingSensor::nextPoll()
+			byte m_nCount;				//number of scheduled sensors
+
+			static bool earlier(const PollingSensor *a, const PollingSensor *b);	//true if a's poll is due before b's
+			void siftUp(byte pos);
+			void siftDown(byte pos);
+
+		public:
+			//constructor
+			PollScheduler();
+
+			//schedules sensor, starting its polling clock now - returns false if the scheduler is full
+			bool add(PollingSensor *sensor);
+
+			//restarts the polling clock of every scheduled sensor at now (first poll after offset + interval)
+			void start(unsigned long now);
+
+			//restores the heap order after sensor's due time was changed from outside the scheduler
+			void reschedule(PollingSensor *sensor);
+
+			//polls every sensor that is due at now (each at most once) - returns the number polled
+			byte runDue(unsigned long now);
+
+			//gets
+			inline PollingSensor* next() const {return m_nCount ? m_Heap[0] : 0;}	//sensor due first, 0 if none
+			inline byte count() const {return m_nCount;}
+	};
+}
+
+#endif
@@ -17,6 +17,9 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  Per Ivar Nerseth  Drift-free due times (m_nNextPoll) instead of accumulated m_nDeltaTime; polled by st::PollScheduler
+//    2026-10-16  Per Ivar Nerseth  Added the deadband/heartbeat reporting policy (setReportPolicy, reportDue) and report counters
+//    2026-10-17  Per Ivar Nerseth  Added pollAgainIn() - follow-up polls for split-phase reads
 //
 //
 //******************************************************************************************
@@ -31,47 +34,150 @@ namespace st
 //private
 	bool PollingSensor::checkInterval()
 	{
-		//check for time overflow
-		if(millis()<m_nPreviousTime)
+		unsigned long now=millis();
+
+		if(!m_bStarted) //eliminates problem of there being a delay before first update() call
+		{
+			start(now);
+		}
+
+		//determine interval has passed
+		if(!isDue(now))
+		{
+			return false;
+		}
+
+		advance(now);
+		Everything::Scheduler.reschedule(this);	//in case update() is called directly on a scheduled sensor
+		return true;
+	}
+
+	void PollingSensor::start(unsigned long now)
+	{
+		if(m_bFollowUp)
+		{
+			m_nResumePoll=now+m_nOffset+m_nInterval;	//a read started in init() - finish it first
+			m_nOffset=0;
+			m_bStarted=true;
+			return;
+		}
+		m_nNextPoll=now+m_nOffset+m_nInterval;
+		m_nOffset=0;
+		m_bStarted=true;
+	}
+
+	void PollingSensor::advance(unsigned long now)
+	{
+		if(m_bFollowUp)
 		{
-			if (debug)
+			//a follow-up poll - back to the regular schedule, unless that is due as well
+			m_bFollowUp=false;
+			m_nNextPoll=m_nResumePoll;
+			if((long)(now-m_nNextPoll)<0)
 			{
-				Serial.println(F("PollingSensor: millis() Overflow handled"));
+				return;
 			}
-			
-			m_nPreviousTime = 0;
 		}
-		
-		if(m_nPreviousTime==0) //eliminates problem of there being a delay before first update() call
+
+		m_nNextPoll+=m_nInterval;
+
+		//fell a whole interval or more behind (e.g. a long blocking call) - skip the missed polls, keep to the schedule
+		if((long)(now-m_nNextPoll)>=0)
 		{
-			m_nPreviousTime=millis();
+			if(m_nInterval<=0)
+			{
+				m_nNextPoll=now+1;	//no interval - poll at most once per millisecond
+				return;
+			}
+
+			m_nNextPoll+=((now-m_nNextPoll)/m_nInterval+1)*m_nInterval;
+			if(debug)
+			{
+				Serial.print(getName());
+				Serial.println(F(": PollingSensor: missed polls skipped"));
+			}
 		}
-		
-		//calculate new delta time
-		m_nDeltaTime+=(millis()-m_nPreviousTime)-m_nOffset;
-		m_nOffset=0;
-		m_nPreviousTime=millis();
-		
-		//determine interval has passed
-		if(m_nDeltaTime>=m_nInterval)
+	}
+
+	void PollingSensor::poll(unsigned long now)
+	{
+		advance(now);
+		collect();
+	}
+
+	void PollingSensor::collect()
+	{
+		getData();
+		if(!m_bFollowUp)
 		{
-			m_nDeltaTime=0;
-			return true;
+			m_bForceReport=false;	//a refresh() ends with the read it started
+		}
+	}
+
+//protected
+	bool PollingSensor::reportDue(float value, ReportState &state)
+	{
+		unsigned long now=millis();
+		bool due;
+
+		if(!m_bReportPolicy || m_bForceReport || !state.valid)
+		{
+			due=true;
+		}
+		else if(m_nHeartbeat && now-state.millis>=m_nHeartbeat)
+		{
+			due=true;	//silent for too long
 		}
 		else
 		{
+			float band=m_bDeadbandPercent?fabs(state.value)*m_fDeadband/100:m_fDeadband;
+			due=fabs(value-state.value)>band && now-state.millis>=m_nMinSpacing;
+		}
+
+		if(!due)
+		{
+			m_nReportsSuppressed++;
+			totalReportsSuppressed++;
 			return false;
 		}
+
+		state.value=value;
+		state.millis=now;
+		state.valid=true;
+		m_nReportsSent++;
+		totalReportsSent++;
+		return true;
+	}
+
+	void PollingSensor::pollAgainIn(unsigned long ms)
+	{
+		if(!m_bFollowUp)
+		{
+			m_nResumePoll=m_nNextPoll;
+			m_bFollowUp=true;
+		}
+		m_nNextPoll=millis()+ms;
+		Everything::Scheduler.reschedule(this);
 	}
 
 //public
 	//constructor
 	PollingSensor::PollingSensor(const __FlashStringHelper *name, long interval, long offset):
 		Sensor(name),
-		m_nPreviousTime(0),
-		m_nDeltaTime(0),
+		m_nNextPoll(0),
+		m_nResumePoll(0),
+		m_bFollowUp(false),
+		m_bStarted(false),
 		m_nInterval(interval*1000),
-		m_nOffset(offset*1000)
+		m_nOffset(offset*1000),
+		m_bReportPolicy(false),
+		m_bDeadbandPercent(false),
+		m_bForceReport(false),
+		m_fDeadband(0),
+		m_nMinSpacing(0),
+		m_nHeartbeat(0),
+		m_nReportsSent(0),
+		m_nReportsSuppressed(0)
 	{
 	
 	}
@@ -89,17 +195,48 @@ namespace st
 
 	void PollingSensor::refresh()
 	{
-		getData();
+		m_bForceReport=true;	//the hub asked for the current state
+		collect();
 	}
 
 	void PollingSensor::update()
 	{
 		if(checkInterval())
 		{
-			getData();
+			collect();
 		}
 	}
 	
+	void PollingSensor::offset(long os)
+	{
+		if(!m_bStarted)
+		{
+			m_nOffset=os;
+			return;
+		}
+		(m_bFollowUp?m_nResumePoll:m_nNextPoll)+=os;
+		Everything::Scheduler.reschedule(this);
+	}
+
+	void PollingSensor::setInterval(long interval)
+	{
+		if(m_bStarted)
+		{
+			(m_bFollowUp?m_nResumePoll:m_nNextPoll)+=interval-m_nInterval;	//keep the time of the previous poll as the reference
+		}
+		m_nInterval=interval;
+		Everything::Scheduler.reschedule(this);
+	}
+
+	void PollingSensor::setReportPolicy(float deadband, bool percent, long minSpacing, long heartbeat)
+	{
+		m_bReportPolicy=true;
+		m_fDeadband=deadband;
+		m_bDeadbandPercent=percent;
+		m_nMinSpacing=minSpacing*1000;
+		m_nHeartbeat=heartbeat*1000;
+	}
+
 	void PollingSensor::getData()
 	{
 		if(debug)
@@ -110,4 +247,7 @@ namespace st
 	
 	//debug flag to determine if debug print statements are executed (set value in your sketch)
 	bool PollingSensor::debug=false;
+
+	unsigned long PollingSensor::totalReportsSent=0;
+	unsigned long PollingSensor::totalReportsSuppressed=0;
 }
\ No newline at end of file
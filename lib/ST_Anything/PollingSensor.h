@@ -12,11 +12,31 @@
 //				- long interval - REQUIRED - the polling interval in seconds
 //				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
 //
+//			  The first poll is due offset + interval after polling starts, and every later poll exactly
+//			  one interval after the previous due time (not after the time the poll actually ran), so
+//			  polls never drift.  If polls are missed altogether, they are skipped and the sensor stays
+//			  on its original schedule.  st::Everything polls these sensors through st::PollScheduler.
+//
+//			  Reporting policy (optional, see setReportPolicy()): subclasses pass each value through
+//			  reportDue() before sending it, so a sensor can poll fast without sending every poll.
+//			  A value is sent if it moved by more than the deadband (absolute, or percent of the last
+//			  reported value) and at least minSpacing seconds have passed since the last report, or if
+//			  nothing was sent for heartbeat seconds.  The first value and refresh() are always sent.
+//			  By default there is no policy and every poll is sent, as before.
+//
+//			  Split-phase reads (optional, see pollAgainIn()): a sensor whose reading takes time
+//			  starts it in getData() and asks to be polled again a few milliseconds later, instead
+//			  of waiting.  That follow-up poll does not move the regular schedule, and a refresh()
+//			  stays in force until the read is finished.
+//
 //  Change History:
 //
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  Per Ivar Nerseth  Drift-free due times (m_nNextPoll) instead of accumulated m_nDeltaTime; polled by st::PollScheduler
+//    2026-10-16  Per Ivar Nerseth  Added the deadband/heartbeat reporting policy (setReportPolicy, reportDue) and report counters
+//    2026-10-17  Per Ivar Nerseth  Added pollAgainIn() - follow-up polls for split-phase reads
 //
 //
 //******************************************************************************************
@@ -25,18 +45,56 @@
 #define ST_POLLINGSENSOR_H
 
 #include "Sensor.h"
+#include "PollScheduler.h"
 
 namespace st
 {
+	//last value sent for one reading of a PollingSensor (see PollingSensor::reportDue())
+	struct ReportState
+	{
+		float value;			//value last sent
+		unsigned long millis;	//millis() when it was sent
+		bool valid;				//false until the first value was sent
+
+		ReportState() : value(0), millis(0), valid(false) {}
+	};
+
 	class PollingSensor: public Sensor
 	{
 		private:
-			unsigned long m_nPreviousTime; //in milliseconds - time of last poll
-			long m_nDeltaTime;			   //in milliseconds - elapsed time since last poll
+			unsigned long m_nNextPoll;	   //in milliseconds - millis() value at which the next poll is due
+			unsigned long m_nResumePoll;   //in milliseconds - regular due time while a follow-up poll is pending
+			bool m_bFollowUp;			   //true while the next poll is a follow-up (see pollAgainIn())
+			bool m_bStarted;			   //false until the polling clock has been started
 			long m_nInterval;			   //in milliseconds - polling interval for the sensor
-			long m_nOffset;				   //in milliseconds - offset to prevent all Polling sensors from running at the same time
+			long m_nOffset;				   //in milliseconds - offset to prevent all Polling sensors from running at the same time (applied when polling starts)
+			bool m_bReportPolicy;		   //false == every value is reported (no setReportPolicy() call)
+			bool m_bDeadbandPercent;	   //true == m_fDeadband is a percentage of the last reported value
+			bool m_bForceReport;		   //true while refresh() runs - every value is reported
+			float m_fDeadband;			   //change required before a new value is reported
+			unsigned long m_nMinSpacing;   //in milliseconds - minimum time between two reports of a changed value
+			unsigned long m_nHeartbeat;	   //in milliseconds - a value is reported at least this often, 0 == never
+			ReportState m_Report;		   //last report of the sensor's (first) value
+			unsigned long m_nReportsSent;
+			unsigned long m_nReportsSuppressed;
 			
-			virtual bool checkInterval(); //returns true and resets m_nDeltaTime if m_nInterval has been reached
+			virtual bool checkInterval(); //returns true and advances m_nNextPoll if the next poll is due
+
+			void start(unsigned long now);	//first poll due at now + m_nOffset + m_nInterval
+			void advance(unsigned long now);	//moves m_nNextPoll one interval on - or past now, keeping to the schedule, if polls were missed
+			void poll(unsigned long now);	//advance() and collect() - called by st::PollScheduler
+			void collect();					//getData(), and the end of a refresh() once no follow-up poll is pending
+
+			friend class PollScheduler;
+
+		protected:
+			//applies the reporting policy to a new value - returns true if it should be sent now (and records it as sent)
+			bool reportDue(float value) {return reportDue(value, m_Report);}
+			bool reportDue(float value, ReportState &state);	//for sensors that report more than one value
+
+			//split-phase reads - getData() is called again in ms milliseconds, then the regular schedule resumes
+			void pollAgainIn(unsigned long ms);
+			inline bool followUpPending() const {return m_bFollowUp;}
 			
 		public:
 			//constructor
@@ -51,6 +109,9 @@ namespace st
 			//called periodically by Everything class to ensure ST Cloud is kept consistent with the state of each Device subclass object
 			virtual void refresh();
 
+			//lets st::Everything schedule this sensor instead of calling update() on every pass
+			virtual PollingSensor* getPollingSensor() {return this;}
+
 			//update function 
 			virtual void update();
 			
@@ -58,10 +119,20 @@ namespace st
 			virtual void getData();
 			
 			//gets
-			virtual void offset(long os) {m_nOffset=os;} //offset the delta time from its current value
+			inline unsigned long nextPoll() const {return m_nNextPoll;}
+			inline bool isDue(unsigned long now) const {return m_bStarted && (long)(now - m_nNextPoll) >= 0;}	//signed difference handles millis() rollover
+			virtual void offset(long os); //offset the next due time from its current value
+			inline unsigned long getReportsSent() const {return m_nReportsSent;}
+			inline unsigned long getReportsSuppressed() const {return m_nReportsSuppressed;}
 
 			//sets
-			virtual void setInterval(long interval) {m_nInterval=interval;}
+			virtual void setInterval(long interval);	//the next poll is due interval after the previous one
+			//reporting policy - deadband in the sensor's units (or percent), minSpacing and heartbeat in seconds (0 == none)
+			void setReportPolicy(float deadband, bool percent = false, long minSpacing = 0, long heartbeat = 0);
+
+			//reports sent and suppressed by all PollingSensors
+			static unsigned long totalReportsSent;
+			static unsigned long totalReportsSuppressed;
 	
 			//debug flag to determine if debug print statements are executed (set value in your sketch)
 			static bool debug;
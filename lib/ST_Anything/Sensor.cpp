@@ -11,6 +11,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  Per Ivar Nerseth  Added update() timing statistics for the /metrics page (see st::Metrics)
 //
 //
 //******************************************************************************************
@@ -28,6 +29,11 @@ namespace st
 	//constructor
 	Sensor::Sensor(const __FlashStringHelper *name):
 		Device(name)
+		#ifndef DISABLE_METRICS
+			,m_nUpdateCount(0),
+			m_nUpdateMicros(0),
+			m_nUpdateMicrosMax(0)
+		#endif
 	{
 	
 	}
@@ -37,6 +43,18 @@ namespace st
 	{
 	
 	}
+
+	#ifndef DISABLE_METRICS
+	void Sensor::recordUpdate(unsigned long elapsed)
+	{
+		m_nUpdateCount++;
+		m_nUpdateMicros+=elapsed;
+		if(elapsed>m_nUpdateMicrosMax)
+		{
+			m_nUpdateMicrosMax=elapsed;
+		}
+	}
+	#endif
 	
 	void Sensor::beSmart(const String &str)
 	{
@@ -11,6 +11,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  Per Ivar Nerseth  Added getPollingSensor() so st::Everything can schedule polling sensors
+//    2026-10-16  Per Ivar Nerseth  Added update() timing statistics for the /metrics page (see st::Metrics)
 //
 //
 //******************************************************************************************
@@ -19,13 +21,21 @@
 #define ST_SENSOR_H
 
 #include "Device.h"
+#include "Constants.h"
 
 namespace st
 {
+	class PollingSensor;
+
 	//abstract
 	class Sensor: public Device
 	{
 		private:
+			#ifndef DISABLE_METRICS
+				unsigned long m_nUpdateCount;		//timed update() (or poll) calls
+				unsigned long m_nUpdateMicros;		//total time spent in them, in microseconds
+				unsigned long m_nUpdateMicrosMax;	//longest one, in microseconds
+			#endif
 			
 		public:
 			//constructor
@@ -40,6 +50,18 @@ namespace st
 			//all derived classes must implement these pure virtual functions
 			virtual void init()=0;
 			virtual void update()=0;
+
+			//returns this for sensors polled on an interval (st::PollingSensor), 0 for sensors that need update() on every pass
+			virtual PollingSensor* getPollingSensor() {return 0;}
+
+			#ifndef DISABLE_METRICS
+				//counts one update() (or poll) that took elapsedMicros - called by st::Everything and st::PollScheduler
+				void recordUpdate(unsigned long elapsedMicros);
+
+				inline unsigned long getUpdateCount() const {return m_nUpdateCount;}
+				inline unsigned long getUpdateMicros() const {return m_nUpdateMicros;}
+				inline unsigned long getUpdateMicrosMax() const {return m_nUpdateMicrosMax;}
+			#endif
 	
 	};
 
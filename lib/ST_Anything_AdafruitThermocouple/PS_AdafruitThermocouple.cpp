@@ -30,6 +30,7 @@
 //    ----        ---            ----
 //    2015-03-24  Dan Ogorchock  Original Creation
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
 //
 //
 //******************************************************************************************
@@ -103,7 +104,10 @@ namespace st
 			m_dblTemperatureSensorValue = -99.0;
 		}
 		
-		Everything::sendSmartString(getName() + " " + String(int(m_dblTemperatureSensorValue)));
+		if (reportDue(int(m_dblTemperatureSensorValue)))
+		{
+			Everything::sendSmartString(getName() + " " + String(int(m_dblTemperatureSensorValue)));
+		}
 
 	}
 	
@@ -22,6 +22,14 @@
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
 //
+//			  getData() starts a conversion on every probe of every bus and returns; it is polled again
+//			  (PollingSensor::pollAgainIn()) once the conversion time of the resolution has passed
+//			  (94ms at 9 bits .. 750ms at 12 bits), then once per probe to read its scratchpad by the
+//			  ROM code init() found - about 11ms of bus time per loop pass.  A probe that does not
+//			  answer is reported as -99.0, and the buses are searched again before the next conversion
+//			  (at most once every PS_DS18B20_SEARCH_BACKOFF conversions), one ROM code per poll.
+//			  The number in a probe's name belongs to its ROM code (st::ProbeTable).
+//
 //			  TODO:  Determine a method to persist the ST Cloud's Polling Interval data
 //
 //  Change History:
@@ -33,6 +41,11 @@
 //    2016-02-27  Dan Ogorchock  Added support for multiple DS18B20 sensors
 //    2017-08-18  Dan Ogorchock  Modified to send floating point values to SmartThings
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Non-blocking conversions, probes read by ROM codes found once in init() - no delay()
+//    2026-10-17  Per Ivar Nerseth  Several OneWire buses per sensor; names keyed on ROM codes (st::ProbeTable), kept in flash
+//    2026-10-17  Per Ivar Nerseth  One search in init(); searches for a missing probe backed off; resolution set on new probes only
+//    2026-10-17  Per Ivar Nerseth  The search for a missing probe is polled, one ROM code per loop pass
 //
 //
 //******************************************************************************************
@@ -47,26 +60,97 @@
 namespace st
 {
 //private
-
+	void PS_DS18B20_Temperature::createBuses(const byte *pins, byte num_pins)
+	{
+		m_nBuses = num_pins;
+		m_pOneWireBus = new OneWire*[num_pins];
+		m_pDS18B20 = new DallasTemperature*[num_pins];
+		m_pParasite = new bool[num_pins];
+		for (byte bus = 0; bus < num_pins; bus++)
+		{
+			m_pOneWireBus[bus] = new OneWire(pins[bus]);
+			m_pDS18B20[bus] = new DallasTemperature(m_pOneWireBus[bus]);
+			m_pParasite[bus] = false;
+		}
+		memset(m_pProbeBus, NO_BUS, m_numSensors);
+		m_pFound = new DeviceAddress[m_numSensors];
+		m_pFoundBus = new byte[m_numSensors];
+		m_pFoundNew = new bool[m_numSensors];
+	}
 
 //public
 	//constructor - called in your sketch's global variable declaration section
 	PS_DS18B20_Temperature::PS_DS18B20_Temperature(const __FlashStringHelper *name, unsigned int interval, int offset, byte pin, bool In_C, byte resolution, byte num_sensors) :
 		PollingSensor(name, interval, offset),
 		m_dblTemperatureSensorValue(0.0),
-		m_OneWireBus(pin),
-		m_DS18B20(&m_OneWireBus),
+		m_nBuses(0),
+		m_pOneWireBus(NULL),
+		m_pDS18B20(NULL),
+		m_Resolution(resolution),
 		m_In_C(In_C),
+		m_numSensors(num_sensors),
+		m_Reports(new ReportState[num_sensors]),
+		m_Probes(num_sensors),
+		m_pProbeStorage(NULL),
+		m_pProbeBus(new byte[num_sensors]),
+		m_pParasite(NULL),
+		m_pFound(NULL),
+		m_pFoundBus(NULL),
+		m_pFoundNew(NULL),
+		m_nFoundCount(0),
+		m_nSearchBus(NO_BUS),
+		m_nSearchWait(0),
+		m_bConverting(false),
+		m_nNextRead(0),
+		m_bSearch(false)
+	{
+		createBuses(&pin, 1);
+	}
+
+	//constructor - several OneWire buses, num_sensors probes on all of them together
+	PS_DS18B20_Temperature::PS_DS18B20_Temperature(const __FlashStringHelper *name, unsigned int interval, int offset, const byte *pins, byte num_pins, bool In_C, byte resolution, byte num_sensors) :
+		PollingSensor(name, interval, offset),
+		m_dblTemperatureSensorValue(0.0),
+		m_nBuses(0),
+		m_pOneWireBus(NULL),
+		m_pDS18B20(NULL),
 		m_Resolution(resolution),
-		m_numSensors(num_sensors)
+		m_In_C(In_C),
+		m_numSensors(num_sensors),
+		m_Reports(new ReportState[num_sensors]),
+		m_Probes(num_sensors),
+		m_pProbeStorage(NULL),
+		m_pProbeBus(new byte[num_sensors]),
+		m_pParasite(NULL),
+		m_pFound(NULL),
+		m_pFoundBus(NULL),
+		m_pFoundNew(NULL),
+		m_nFoundCount(0),
+		m_nSearchBus(NO_BUS),
+		m_nSearchWait(0),
+		m_bConverting(false),
+		m_nNextRead(0),
+		m_bSearch(false)
 	{
-		
+		createBuses(pins, num_pins);
 	}
 
 	//destructor
 	PS_DS18B20_Temperature::~PS_DS18B20_Temperature()
 	{
-
+		for (byte bus = 0; bus < m_nBuses; bus++)
+		{
+			delete m_pDS18B20[bus];
+			delete m_pOneWireBus[bus];
+		}
+		delete[] m_pDS18B20;
+		delete[] m_pOneWireBus;
+		delete[] m_pParasite;
+		delete[] m_pFound;
+		delete[] m_pFoundBus;
+		delete[] m_pFoundNew;
+		delete[] m_Reports;
+		delete[] m_pProbeBus;
 	}
 
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
@@ -94,63 +178,192 @@ namespace st
 	//initialization routine - get first set of readings and send to ST cloud
 	void PS_DS18B20_Temperature::init()
 	{
-		m_DS18B20.begin();					   //Initialize the DallasTemperature library
-		m_DS18B20.setResolution(m_Resolution); //Set the temperature sensor resolution
-		m_DS18B20.requestTemperatures();	   //Send the command to get temperatures once, to ensure clean data before sending to ST
-		delay(500);						       //Wait 500ms to let sensors stabilize
-		getData();							   //Get temperature data and send to ST cloud
+		for (byte bus = 0; bus < m_nBuses; bus++)
+		{
+			m_pDS18B20[bus]->setWaitForConversion(false); //requestTemperatures() returns at once - getData() comes back for the values
+		}
+		m_Probes.begin(m_pProbeStorage);	   //Numbers given to the ROM codes before a reset
+		startSearch();						   //Find the ROM codes once, and set the temperature sensor resolution (begin() only where assignFound() needs it)
+		while (!searchStep())
+		{
+		}
+		getData();							   //Start the first conversion - its values are sent to ST cloud when it is done
 	}
 
 	//function to get data from sensor and queue results for transfer to ST Cloud
 	void PS_DS18B20_Temperature::getData()
 	{
-		if (st::PollingSensor::debug) {
-			Serial.print(F("PS_DS18B20_Temperature::Requesting temperatures..."));
+		if (!m_bConverting)
+		{
+			if (m_bSearch)
+			{
+				if (m_nSearchWait == 0)
+				{
+					//one ROM code per poll, as the scratchpad reads below - the conversion starts once the search is done
+					if (m_nSearchBus == NO_BUS)
+					{
+						startSearch();
+					}
+					if (!searchStep())
+					{
+						pollAgainIn(0);
+						return;
+					}
+				}
+				else
+				{
+					m_nSearchWait--;
+				}
+			}
+
+			if (st::PollingSensor::debug) {
+				Serial.println(F("PS_DS18B20_Temperature::Requesting temperatures..."));
+			}
+
+			//every bus converts at once - one conversion time for all the probes
+			for (byte bus = 0; bus < m_nBuses; bus++)
+			{
+				m_pDS18B20[bus]->requestTemperatures(); // Send the command to get temperatures
+			}
+			m_bConverting = true;
+			m_nNextRead = 0;
+			pollAgainIn(m_pDS18B20[0]->millisToWaitForConversion(m_Resolution));
+			return;
 		}
-		
-		m_DS18B20.requestTemperatures(); // Send the command to get temperatures
 
-		if (st::PollingSensor::debug) {
-			Serial.println(F("DONE"));
+		//one sensor per poll, so a loop pass spends one scratchpad read on the bus
+		readSensor(m_nNextRead++);
+		if (m_nNextRead < m_numSensors)
+		{
+			pollAgainIn(0);
+			return;
 		}
+		m_bConverting = false;
+	}
+
+	void PS_DS18B20_Temperature::startSearch()
+	{
+		m_nFoundCount = 0;
+		m_nSearchBus = 0;
+		m_pOneWireBus[0]->reset_search();
+	}
+
+	bool PS_DS18B20_Temperature::searchStep()
+	{
+		byte &count = m_nFoundCount;
+		byte bus = m_nSearchBus;
 
-		for (int index = 1; index <= m_numSensors; index++)
+		if (count < m_numSensors)
 		{
-			if (m_In_C)
+			if (m_pOneWireBus[bus]->search(m_pFound[count]))
 			{
-				m_dblTemperatureSensorValue = m_DS18B20.getTempCByIndex(index-1);
+				if (m_pFound[count][0] != 0 && OneWire::crc8(m_pFound[count], 7) == m_pFound[count][7])
+				{
+					//a probe already on this bus in the search before has its resolution set
+					int index = m_Probes.slotOf(m_pFound[count]);
+					m_pFoundNew[count] = index < 0 || m_pProbeBus[index] != bus;
+					m_pFoundBus[count++] = bus;
+				}
+				return false;
 			}
-			else
+			if (++m_nSearchBus < m_nBuses)
 			{
-				m_dblTemperatureSensorValue = m_DS18B20.getTempFByIndex(index-1);
+				m_pOneWireBus[m_nSearchBus]->reset_search();
+				return false;
 			}
+		}
 
-			if (st::PollingSensor::debug) {
-				Serial.print(F("PS_DS18B20_Temperature:: Temperature for the device # "));
-				Serial.print(index);
-				Serial.print(F(" is: "));
-				Serial.println(m_dblTemperatureSensorValue);
-			}
+		m_nSearchBus = NO_BUS;
+		assignFound();
+		return true;
+	}
 
+	void PS_DS18B20_Temperature::assignFound()
+	{
+		byte count = m_nFoundCount;
 
-			if (isnan(m_dblTemperatureSensorValue))
-			{
-				if (st::PollingSensor::debug) {
-					Serial.print(F("PS_DS18B20_Temperature:: Error Reading Sensor # "));
-					Serial.println(index);
-				}
-				m_dblTemperatureSensorValue = -99.0;
-			}
+		if (m_Probes.assign(m_pFound, count) && st::PollingSensor::debug) {
+			Serial.println(F("PS_DS18B20_Temperature:: Sensor numbers changed"));
+		}
 
-			if (m_numSensors == 1)
+		memset(m_pProbeBus, NO_BUS, m_numSensors);
+		for (byte i = 0; i < count; i++)
+		{
+			int index = m_Probes.slotOf(m_pFound[i]);
+			if (index < 0)
 			{
-				Everything::sendSmartString(getName() + " " + String(m_dblTemperatureSensorValue));
+				continue;
 			}
-			else
+			byte bus = m_pFoundBus[i];
+			m_pProbeBus[index] = bus;
+			if (m_pFoundNew[i])
 			{
-				Everything::sendSmartString(getName() + index + " " + String(m_dblTemperatureSensorValue));
+				//a parasite-powered probe needs the strong pull-up while it converts, which DallasTemperature sets up in begin()
+				if (!m_pParasite[bus] && m_pDS18B20[bus]->readPowerSupply(m_pFound[i]))
+				{
+					m_pDS18B20[bus]->begin();
+					m_pParasite[bus] = true;
+				}
+				m_pDS18B20[bus]->setResolution(m_pFound[i], m_Resolution, true);
 			}
 		}
+		if (count < m_numSensors && st::PollingSensor::debug) {
+			Serial.print(F("PS_DS18B20_Temperature:: Found "));
+			Serial.print(count);
+			Serial.print(F(" of "));
+			Serial.print(m_numSensors);
+			Serial.println(F(" sensors"));
+		}
+		m_nSearchWait = count < m_numSensors ? PS_DS18B20_SEARCH_BACKOFF : 0;
+		m_bSearch = false;
+	}
+
+	void PS_DS18B20_Temperature::readSensor(byte index)
+	{
+		float celsius = DEVICE_DISCONNECTED_C;
+		if (m_pProbeBus[index] != NO_BUS)
+		{
+			celsius = m_pDS18B20[m_pProbeBus[index]]->getTempC(m_Probes.getRom(index));
+		}
+
+		if (celsius == DEVICE_DISCONNECTED_C)
+		{
+			if (st::PollingSensor::debug) {
+				Serial.print(F("PS_DS18B20_Temperature:: Error Reading Sensor # "));
+				Serial.println(index + 1);
+			}
+			m_dblTemperatureSensorValue = -99.0;
+			m_bSearch = true;
+		}
+		else if (m_In_C)
+		{
+			m_dblTemperatureSensorValue = celsius;
+		}
+		else
+		{
+			m_dblTemperatureSensorValue = DallasTemperature::toFahrenheit(celsius);
+		}
+
+		if (st::PollingSensor::debug) {
+			Serial.print(F("PS_DS18B20_Temperature:: Temperature for the device # "));
+			Serial.print(index + 1);
+			Serial.print(F(" is: "));
+			Serial.println(m_dblTemperatureSensorValue);
+		}
+
+		if (!reportDue(m_dblTemperatureSensorValue, m_Reports[index]))
+		{
+			return;
+		}
+
+		if (m_numSensors == 1)
+		{
+			Everything::sendSmartString(getName() + " " + String(m_dblTemperatureSensorValue));
+		}
+		else
+		{
+			Everything::sendSmartString(getName() + (index + 1) + " " + String(m_dblTemperatureSensorValue));
+		}
 	}
 
 }
@@ -18,10 +18,31 @@
 //				- byte resolution - OPTIONAL - DS18B20 sensor resolution in bits.  9, 10, 11, or 12.  Defaults to 10 for decent accuracy and performance
 //				- byte num_sensors - OPTIONAL - number of OneWire DS18B20 sensors attached to OneWire bus - Defaults to 1
 //
+//			  Several buses:  st::PS_DS18B20_Temperature sensor1("temperature", 60, 0, pins, 3, false, 12, 20);
+//			  takes const byte *pins and byte num_pins instead of byte pin; num_sensors counts the probes on all of them.
+//
 //			  This class supports receiving configuration data from the SmartThings cloud via the ST App.  A user preference
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
 //
+//			  getData() starts a conversion on every probe of every bus and returns; it is polled again
+//			  (PollingSensor::pollAgainIn()) once the conversion time of the resolution has passed
+//			  (94ms at 9 bits .. 750ms at 12 bits), then once per probe to read its scratchpad by the
+//			  ROM code init() found - about 11ms of bus time per loop pass.  A probe that does not
+//			  answer is reported as -99.0, and the buses are searched again before the next conversion;
+//			  while it stays missing, only once every PS_DS18B20_SEARCH_BACKOFF conversions.  That
+//			  search is polled too, one OneWire::search() step (one ROM code) per loop pass.  Only a
+//			  probe a search newly finds gets its resolution set.
+//
+//			  init() searches each bus once and does not call DallasTemperature::begin(), which
+//			  searches it as well - except on a bus with a parasite-powered probe, whose conversions
+//			  need the strong pull-up begin() sets up.
+//
+//			  Names:  with more than one probe, each is sent as name1 .. nameN.  The number belongs to
+//			  the probe's ROM code (see st::ProbeTable), not to its place in the search order, so it
+//			  does not change when another probe is added or fails; a new probe takes a free number,
+//			  or the number of a probe that is gone.  setProbeStorage() keeps the numbers in flash.
+//
 //			  TODO:  Determine a method to persist the ST Cloud's Polling Interval data
 //
 //  Change History:
@@ -33,6 +54,11 @@
 //    2016-02-27  Dan Ogorchock  Added support for multiple DS18B20 sensors
 //    2017-08-18  Dan Ogorchock  Modified to send floating point values to SmartThings
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Non-blocking conversions, probes read by ROM codes found once in init() - no delay()
+//    2026-10-17  Per Ivar Nerseth  Several OneWire buses per sensor; names keyed on ROM codes (st::ProbeTable), kept in flash
+//    2026-10-17  Per Ivar Nerseth  One search in init(); searches for a missing probe backed off; resolution set on new probes only
+//    2026-10-17  Per Ivar Nerseth  The search for a missing probe is polled, one ROM code per loop pass
 //
 //
 //******************************************************************************************
@@ -41,26 +67,56 @@
 
 
 #include "PollingSensor.h"
+#include "ProbeTable.h"
 #include <Wire.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
 
+//conversions between two searches for a probe that stays missing
+#ifndef PS_DS18B20_SEARCH_BACKOFF
+#define PS_DS18B20_SEARCH_BACKOFF 10
+#endif
+
 namespace st
 {
 	class PS_DS18B20_Temperature : public PollingSensor
 	{
 		private:
 			float m_dblTemperatureSensorValue;		//current Temperature value
-			OneWire m_OneWireBus;					//OneWire Bus
-			DallasTemperature m_DS18B20;			//Dallas Temperature object
+			byte m_nBuses;							//number of OneWire buses
+			OneWire **m_pOneWireBus;				//OneWire Bus, one per pin
+			DallasTemperature **m_pDS18B20;			//Dallas Temperature object, one per bus
 			byte m_Resolution;						//DS18B20 Resolution in bits - 9, 10, 11, or 12
 			bool m_In_C;							//Return temp in C
 			byte m_numSensors;						//number of DS18B20 sensors to report values for
+			ReportState *m_Reports;					//last value sent for each of the m_numSensors sensors
+			ProbeTable m_Probes;					//ROM code of each of the m_numSensors sensors
+			ProbeTableStorage *m_pProbeStorage;		//flash behind m_Probes, NULL == none
+			byte *m_pProbeBus;						//bus each sensor was found on, NO_BUS if it was not
+			bool *m_pParasite;						//bus has a parasite-powered probe - begin() was called for it
+			DeviceAddress *m_pFound;				//ROM codes found by the last search
+			byte *m_pFoundBus;						//bus each of them was found on
+			bool *m_pFoundNew;						//not found, or not on the bus, in the search before
+			byte m_nFoundCount;						//ROM codes found so far by the search in progress
+			byte m_nSearchBus;						//bus the search in progress is on, NO_BUS if none is
+			byte m_nSearchWait;						//conversions until a missing probe is searched for again
+			bool m_bConverting;						//true from the start of a conversion until every sensor has been read
+			byte m_nNextRead;						//index of the next sensor to read once the conversion is done
+			bool m_bSearch;							//search the buses again before the next conversion
+
+			static const byte NO_BUS = 0xFF;
+
+			void createBuses(const byte *pins, byte num_pins);
+			void startSearch();						//starts a search of the buses for the ROM codes
+			bool searchStep();						//one OneWire::search() - true once every bus has been searched
+			void assignFound();						//gives each ROM code found its number, sets up new probes
+			void readSensor(byte index);			//reads the scratchpad of one sensor and sends its value
 
 		public:
 
 			//constructor - called in your sketch's global variable declaration section
 			PS_DS18B20_Temperature(const __FlashStringHelper *name, unsigned int interval, int offset, byte pin, bool In_C = false, byte resolution = 10, byte num_sensors = 1);
+			PS_DS18B20_Temperature(const __FlashStringHelper *name, unsigned int interval, int offset, const byte *pins, byte num_pins, bool In_C = false, byte resolution = 10, byte num_sensors = 1);
 
 			//destructor
 			virtual ~PS_DS18B20_Temperature();
@@ -76,8 +132,10 @@ namespace st
 
 			//gets
 			inline float getTemperatureSensorValue() const { return float(m_dblTemperatureSensorValue); }
+			inline const ProbeTable &getProbes() const { return m_Probes; }
 
 			//sets
+			void setProbeStorage(ProbeTableStorage *storage) { m_pProbeStorage = storage; }	//before init()
 
 	};
 }
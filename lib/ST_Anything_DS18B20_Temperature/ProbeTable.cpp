@@ -0,0 +1,212 @@
+//******************************************************************************************
+//  File: ProbeTable.cpp
+//
+//  Summary:  ROM code to slot table of the 1-Wire probes of a sensor (see ProbeTable.h).
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+#include "ProbeTable.h"
+
+#include <string.h>
+
+namespace st
+{
+	namespace
+	{
+		//stored record: magic, slot count and check byte, then 8 bytes per slot
+		const byte MAGIC0 = 'P';
+		const byte MAGIC1 = 'T';
+		const byte HEADER = 4;
+	}
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+	ProbeTableFS::ProbeTableFS(fs::FS &fs, const char *path) :
+		m_fs(fs),
+		m_pPath(path)
+	{
+
+	}
+
+	size_t ProbeTableFS::load(void *data, size_t length)
+	{
+		if (!m_fs.exists(m_pPath))
+		{
+			return 0;
+		}
+		File file = m_fs.open(m_pPath, "r");
+		if (!file)
+		{
+			return 0;
+		}
+		size_t bytes = file.read((uint8_t *)data, length);
+		file.close();
+		return bytes;
+	}
+
+	bool ProbeTableFS::save(const void *data, size_t length)
+	{
+		File file = m_fs.open(m_pPath, "w");
+		if (!file)
+		{
+			return false;
+		}
+		size_t bytes = file.write((const uint8_t *)data, length);
+		file.close();
+		return bytes == length;
+	}
+#endif
+
+//private
+	uint8_t ProbeTable::check() const
+	{
+		uint8_t check = 0xA5 ^ m_nSlots;
+		for (byte slot = 0; slot < m_nSlots; slot++)
+		{
+			for (byte i = 0; i < 8; i++)
+			{
+				check = (check << 1 | check >> 7) ^ m_Roms[slot][i];
+			}
+		}
+		return check;
+	}
+
+	void ProbeTable::save()
+	{
+		if (m_pStorage == NULL)
+		{
+			return;
+		}
+		size_t length = HEADER + m_nSlots * 8;
+		byte *record = new byte[length];
+		record[0] = MAGIC0;
+		record[1] = MAGIC1;
+		record[2] = m_nSlots;
+		record[3] = check();
+		memcpy(record + HEADER, m_Roms, m_nSlots * 8);
+		if (m_pStorage->save(record, length))
+		{
+			m_nSaves++;
+		}
+		delete[] record;
+	}
+
+//public
+	ProbeTable::ProbeTable(byte slots) :
+		m_nSlots(slots),
+		m_Roms(new uint8_t[slots][8]),
+		m_pStorage(NULL),
+		m_nSaves(0)
+	{
+		memset(m_Roms, 0, slots * 8);
+	}
+
+	ProbeTable::~ProbeTable()
+	{
+		delete[] m_Roms;
+	}
+
+	void ProbeTable::begin(ProbeTableStorage *storage)
+	{
+		m_pStorage = storage;
+		if (m_pStorage == NULL)
+		{
+			return;
+		}
+
+		//a record for another number of slots, or a torn one, is not used - the slots are found again
+		size_t length = HEADER + m_nSlots * 8;
+		byte *record = new byte[length];
+		if (m_pStorage->load(record, length) == length && record[0] == MAGIC0 && record[1] == MAGIC1 && record[2] == m_nSlots)
+		{
+			memcpy(m_Roms, record + HEADER, m_nSlots * 8);
+			if (check() != record[3])
+			{
+				memset(m_Roms, 0, m_nSlots * 8);
+			}
+		}
+		delete[] record;
+	}
+
+	bool ProbeTable::assign(const uint8_t (*found)[8], byte count)
+	{
+		bool *present = new bool[m_nSlots];
+		memset(present, 0, m_nSlots * sizeof(bool));
+		for (byte i = 0; i < count; i++)
+		{
+			int slot = slotOf(found[i]);
+			if (slot >= 0)
+			{
+				present[slot] = true;
+			}
+		}
+
+		bool changed = false;
+		for (byte i = 0; i < count; i++)
+		{
+			if (slotOf(found[i]) >= 0)
+			{
+				continue;
+			}
+
+			//the first empty slot, or else the first one whose probe was not found
+			int slot = -1;
+			for (byte s = 0; s < m_nSlots && slot < 0; s++)
+			{
+				if (isEmpty(s))
+				{
+					slot = s;
+				}
+			}
+			for (byte s = 0; s < m_nSlots && slot < 0; s++)
+			{
+				if (!present[s])
+				{
+					slot = s;
+				}
+			}
+			if (slot < 0)
+			{
+				break;		//more probes than slots
+			}
+			memcpy(m_Roms[slot], found[i], 8);
+			present[slot] = true;
+			changed = true;
+		}
+		delete[] present;
+
+		if (changed)
+		{
+			save();
+		}
+		return changed;
+	}
+
+	int ProbeTable::slotOf(const uint8_t *rom) const
+	{
+		for (byte slot = 0; slot < m_nSlots; slot++)
+		{
+			if (memcmp(m_Roms[slot], rom, 8) == 0)
+			{
+				return slot;
+			}
+		}
+		return -1;
+	}
+
+	bool ProbeTable::isEmpty(byte slot) const
+	{
+		for (byte i = 0; i < 8; i++)
+		{
+			if (m_Roms[slot][i] != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,93 @@
+//******************************************************************************************
+//  File: ProbeTable.h
+//
+//  Summary:  st::ProbeTable gives each 1-Wire probe of a sensor a fixed slot - and so a fixed
+//			  name, e.g. "temperature3" - keyed on its 64-bit ROM code, instead of its place in
+//			  the bus search order, which changes when a probe is added or fails.
+//
+//			  assign() takes the ROM codes found on the buses: a known code keeps its slot, a
+//			  new code takes the first empty slot, or else the slot of a code that was not
+//			  found (a probe that was replaced).  A probe that fails keeps its slot until then.
+//
+//			  With a ProbeTableStorage the table survives a reset; it is written only when a
+//			  slot changes.  On the ESP8266/ESP32 ProbeTableFS keeps it in a file of LittleFS
+//			  or SPIFFS - one file per sensor:
+//				LittleFS.begin();
+//				static st::ProbeTableFS probeStorage(LittleFS, "/stprobes1");
+//				sensor1.setProbeStorage(&probeStorage);
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-17  Per Ivar Nerseth  Original Creation
+//
+//******************************************************************************************
+#ifndef ST_PROBETABLE_H
+#define ST_PROBETABLE_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+#include <FS.h>
+#endif
+
+namespace st
+{
+	//flash behind a ProbeTable - one record, read and written whole
+	class ProbeTableStorage
+	{
+		public:
+			virtual ~ProbeTableStorage() {}
+
+			virtual size_t load(void *data, size_t length) = 0;		//returns the bytes read, 0 if there is no record
+			virtual bool save(const void *data, size_t length) = 0;
+	};
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+	//ProbeTableStorage in a file of a mounted LittleFS or SPIFFS
+	class ProbeTableFS : public ProbeTableStorage
+	{
+		private:
+			fs::FS &m_fs;
+			const char *m_pPath;
+
+		public:
+			ProbeTableFS(fs::FS &fs, const char *path = "/stprobes");
+
+			virtual size_t load(void *data, size_t length);
+			virtual bool save(const void *data, size_t length);
+	};
+#endif
+
+	class ProbeTable
+	{
+		private:
+			byte m_nSlots;
+			uint8_t (*m_Roms)[8];			//ROM code of each slot, all zero if empty
+			ProbeTableStorage *m_pStorage;
+			unsigned long m_nSaves;
+
+			uint8_t check() const;
+			void save();
+
+		public:
+			ProbeTable(byte slots);
+			~ProbeTable();
+
+			//reads the table from storage (NULL == kept in RAM only)
+			void begin(ProbeTableStorage *storage);
+
+			//gives each ROM code found a slot - returns true if a slot changed
+			bool assign(const uint8_t (*found)[8], byte count);
+
+			//gets
+			int slotOf(const uint8_t *rom) const;		//-1 if the code has no slot
+			const uint8_t *getRom(byte slot) const { return m_Roms[slot]; }
+			bool isEmpty(byte slot) const;
+			byte getSlots() const { return m_nSlots; }
+			unsigned long getSaves() const { return m_nSaves; }
+	};
+}
+
+#endif
@@ -2,6 +2,9 @@
 
 MIT license
 written by Adafruit Industries
+
+2026-10-17  Per Ivar Nerseth  Split-phase read (start/poll/complete) - no delay(), interrupts
+                              are off for one bit at a time, with statistics of those windows
 */
 
 #include "DHT_AM2320.h"
@@ -9,12 +12,14 @@ written by Adafruit Industries
 #define MIN_INTERVAL 2000
 
 DHT_AM2320::DHT_AM2320(uint8_t pin, uint8_t type, uint8_t count) {
-  _pin = pin;
+  setPin(pin);
   _type = type;
-  #ifdef __AVR
-    _bit = digitalPinToBitMask(pin);
-    _port = digitalPinToPort(pin);
-  #endif
+  _state = STATE_IDLE;
+  _lastresult = false;
+  _lockedTotal = _captureMicros = 0;
+  _lockedMax = _lockedWorst = 0;
+  _lockedWindows = 0;
+  data[0] = data[1] = data[2] = data[3] = data[4] = 0;
   _maxcycles = microsecondsToClockCycles(1000);  // 1 millisecond timeout for
                                                  // reading pulses from DHT sensor.
   // Note that count is now ignored as the DHT reading algorithm adjusts itself
@@ -31,33 +36,47 @@ void DHT_AM2320::begin(void) {
   DEBUG_PRINT("Max clock cycles: "); DEBUG_PRINTLN(_maxcycles, DEC);
 }
 
+void DHT_AM2320::setPin(uint8_t pin) {
+  _pin = pin;
+  #ifdef __AVR
+    _bit = digitalPinToBitMask(pin);
+    _port = digitalPinToPort(pin);
+  #endif
+}
+
 //boolean S == Scale.  True == Fahrenheit; False == Celcius
 float DHT_AM2320::readTemperature(bool S, bool force) {
+  if (read(force)) {
+    return getTemperature(S);
+  }
+  return NAN;
+}
+
+//boolean S == Scale.  True == Fahrenheit; False == Celcius
+float DHT_AM2320::getTemperature(bool S) {
   float f = NAN;
 
-  if (read(force)) {
-    switch (_type) {
-    case DHT11:
-      f = data[2];
-      if(S) {
-        f = convertCtoF(f);
-      }
-      break;
-    case DHT22:
-    
-    case DHT21:
-      f = data[2] & 0x7F;
-      f *= 256;
-      f += data[3];
-      f *= 0.1;
-      if (data[2] & 0x80) {
-        f *= -1;
-      }
-      if(S) {
-        f = convertCtoF(f);
-      }
-      break;
+  switch (_type) {
+  case DHT11:
+    f = data[2];
+    if(S) {
+      f = convertCtoF(f);
+    }
+    break;
+  case DHT22:
+
+  case DHT21:
+    f = data[2] & 0x7F;
+    f *= 256;
+    f += data[3];
+    f *= 0.1;
+    if (data[2] & 0x80) {
+      f *= -1;
+    }
+    if(S) {
+      f = convertCtoF(f);
     }
+    break;
   }
   return f;
 }
@@ -71,21 +90,26 @@ float DHT_AM2320::convertFtoC(float f) {
 }
 
 float DHT_AM2320::readHumidity(bool force) {
+  if (read(force)) {
+    return getHumidity();
+  }
+  return NAN;
+}
+
+float DHT_AM2320::getHumidity(void) {
   float f = NAN;
-  if (read()) {
-    switch (_type) {
-    case DHT11:
-      f = data[0];
-      break;
-    case DHT22:
-
-    case DHT21:
-      f = data[0];
-      f *= 256;
-      f += data[1];
-      f *= 0.1;
-      break;
-    }
+  switch (_type) {
+  case DHT11:
+    f = data[0];
+    break;
+  case DHT22:
+
+  case DHT21:
+    f = data[0];
+    f *= 256;
+    f += data[1];
+    f *= 0.1;
+    break;
   }
   return f;
 }
@@ -123,11 +147,24 @@ float DHT_AM2320::computeHeatIndex(float temperature, float percentHumidity, boo
 }
 
 boolean DHT_AM2320::read(bool force) {
+  if (!start(force)) {
+    return _lastresult; // return last correct measurement
+  }
+  while (!poll()) {
+    delay(pollDelay());
+  }
+  return complete();
+}
+
+boolean DHT_AM2320::start(bool force) {
+  if (_state != STATE_IDLE) {
+    return true;
+  }
   // Check if sensor was read less than two seconds ago and return early
   // to use last reading.
   uint32_t currenttime = millis();
-  if (!force && ((currenttime - _lastreadtime) < 2000)) {
-    return _lastresult; // return last correct measurement
+  if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
+    return false;
   }
   _lastreadtime = currenttime;
 
@@ -138,75 +175,136 @@ boolean DHT_AM2320::read(bool force) {
   //   http://www.adafruit.com/datasheets/Digital%20humidity%20and%20temperature%20sensor%20AM2302.pdf
 
   // Go into high impedence state to let pull-up raise data line level and
-  // start the reading process.
+  // start the reading process.  poll() takes it from here.
   digitalWrite(_pin, HIGH);
-  delay(250);
-
-  // First set data line low for 20 milliseconds.
-  pinMode(_pin, OUTPUT);
-  digitalWrite(_pin, LOW);
-  delay(20);
-
-  uint32_t cycles[80];
-  {
-    // Turn off interrupts temporarily because the next sections are timing critical
-    // and we don't want any interruptions.
-    InterruptLock lock;
-
-    // End the start signal by setting data line high for 40 microseconds.
-    digitalWrite(_pin, HIGH);
-    delayMicroseconds(40);
-
-    // Now start reading the data line to get the value from the DHT sensor.
-    pinMode(_pin, INPUT_PULLUP);
-    delayMicroseconds(10);  // Delay a bit to let sensor pull data line low.
-
-    // First expect a low signal for ~80 microseconds followed by a high signal
-    // for ~80 microseconds again.
-    if (expectPulse(LOW) == 0) {
-      DEBUG_PRINTLN(F("Timeout waiting for start signal low pulse."));
-      _lastresult = false;
-      return _lastresult;
+  _state = STATE_SETTLE;
+  _stateMillis = currenttime;
+  return true;
+}
+
+boolean DHT_AM2320::poll(void) {
+  switch (_state) {
+  case STATE_SETTLE:
+    if (millis() - _stateMillis < DHT_AM2320_SETTLE) {
+      return false;
     }
-    if (expectPulse(HIGH) == 0) {
-      DEBUG_PRINTLN(F("Timeout waiting for start signal high pulse."));
-      _lastresult = false;
-      return _lastresult;
+    // Then set data line low for 20 milliseconds.
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+    _state = STATE_WAKEUP;
+    _stateMillis = millis();
+    return false;
+
+  case STATE_WAKEUP:
+    if (millis() - _stateMillis < DHT_AM2320_WAKEUP) {
+      return false;
     }
+    _state = STATE_IDLE;
+    _lastresult = capture();
+    return true;
+
+  default:
+    return true;
+  }
+}
+
+uint32_t DHT_AM2320::pollDelay(void) const {
+  uint32_t phase = _state == STATE_SETTLE ? DHT_AM2320_SETTLE : _state == STATE_WAKEUP ? DHT_AM2320_WAKEUP : 0;
+  uint32_t elapsed = millis() - _stateMillis;
+  return elapsed < phase ? phase - elapsed : 0;
+}
+
+// Interrupts are off while a pulse is timed - unlock() and lock() again at the
+// start of each bit's 50us low pulse lets interrupts that came in meanwhile run,
+// so none waits longer than one bit (about 120us) instead of the whole transfer.
+void DHT_AM2320::lock(void) {
+  noInterrupts();
+  _lockedAt = micros();
+}
+
+void DHT_AM2320::unlock(void) {
+  uint32_t locked = micros() - _lockedAt;
+  interrupts();
+  _lockedTotal += locked;
+  _lockedWindows++;
+  if (locked > _lockedMax) {
+    _lockedMax = locked > 0xFFFF ? 0xFFFF : locked;
+  }
+}
 
-    // Now read the 40 bits sent by the sensor.  Each bit is sent as a 50
-    // microsecond low pulse followed by a variable length high pulse.  If the
-    // high pulse is ~28 microseconds then it's a 0 and if it's ~70 microseconds
-    // then it's a 1.  We measure the cycle count of the initial 50us low pulse
-    // and use that to compare to the cycle count of the high pulse to determine
-    // if the bit is a 0 (high state cycle count < low state cycle count), or a
-    // 1 (high state cycle count > low state cycle count). Note that for speed all
-    // the pulses are read into a array and then examined in a later step.
-    for (int i=0; i<80; i+=2) {
-      cycles[i]   = expectPulse(LOW);
-      cycles[i+1] = expectPulse(HIGH);
+boolean DHT_AM2320::capture(void) {
+  _lockedTotal = 0;
+  _lockedMax = 0;
+  _lockedWindows = 0;
+  uint32_t start = micros();
+
+  uint32_t cycles[80] = {0};
+  lock();
+
+  // End the start signal by setting data line high for 40 microseconds.
+  digitalWrite(_pin, HIGH);
+  delayMicroseconds(40);
+
+  // Now start reading the data line to get the value from the DHT sensor.
+  pinMode(_pin, INPUT_PULLUP);
+  delayMicroseconds(10);  // Delay a bit to let sensor pull data line low.
+
+  // First expect a low signal for ~80 microseconds followed by a high signal
+  // for ~80 microseconds again.  Only their presence matters, so interrupts
+  // may run at the start of the low one.
+  unlock();
+  lock();
+  if (expectPulse(LOW) == 0) {
+    unlock();
+    DEBUG_PRINTLN(F("Timeout waiting for start signal low pulse."));
+    return false;
+  }
+  if (expectPulse(HIGH) == 0) {
+    unlock();
+    DEBUG_PRINTLN(F("Timeout waiting for start signal high pulse."));
+    return false;
+  }
+
+  // Now read the 40 bits sent by the sensor.  Each bit is sent as a 50
+  // microsecond low pulse followed by a variable length high pulse.  If the
+  // high pulse is ~28 microseconds then it's a 0 and if it's ~70 microseconds
+  // then it's a 1.  Note that for speed all the pulses are read into a array
+  // and then examined in a later step.
+  for (int i=0; i<80; i+=2) {
+    unlock();
+    lock();
+    cycles[i]   = expectPulse(LOW);
+    cycles[i+1] = expectPulse(HIGH);
+    if (cycles[i+1] == 0) {
+      break;  // The line stays high - the transfer is lost, don't wait out the rest.
     }
-  } // Timing critical code is now complete.
+  }
+  unlock();
+  _captureMicros = micros() - start;
+  if (_lockedMax > _lockedWorst) {
+    _lockedWorst = _lockedMax;
+  }
 
-  // Inspect pulses and determine which ones are 0 (high state cycle count < low
-  // state cycle count), or 1 (high state cycle count > low state cycle count).
+  // Interrupts that ran at the start of a low pulse shortened its cycle count,
+  // so the high pulses are compared with the longest low pulse (~50us), which
+  // no interrupt cut short: a longer high pulse is a 1, a shorter one a 0.
+  uint32_t lowCycles = 0;
   for (int i=0; i<40; ++i) {
-    uint32_t lowCycles  = cycles[2*i];
-    uint32_t highCycles = cycles[2*i+1];
-    if ((lowCycles == 0) || (highCycles == 0)) {
+    if ((cycles[2*i] == 0) || (cycles[2*i+1] == 0)) {
       DEBUG_PRINTLN(F("Timeout waiting for pulse."));
-      _lastresult = false;
-      return _lastresult;
+      return false;
+    }
+    if (cycles[2*i] > lowCycles) {
+      lowCycles = cycles[2*i];
     }
+  }
+  for (int i=0; i<40; ++i) {
+    uint32_t highCycles = cycles[2*i+1];
     data[i/8] <<= 1;
-    // Now compare the low and high cycle times to see if the bit is a 0 or 1.
     if (highCycles > lowCycles) {
       // High cycles are greater than 50us low cycle count, must be a 1.
       data[i/8] |= 1;
     }
-    // Else high cycles are less than (or equal to, a weird case) the 50us low
-    // cycle count so this must be a zero.  Nothing needs to be changed in the
-    // stored data.
   }
 
   DEBUG_PRINTLN(F("Received:"));
@@ -219,14 +317,10 @@ boolean DHT_AM2320::read(bool force) {
 
   // Check we read 40 bits and that the checksum matches.
   if (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
-    _lastresult = true;
-    return _lastresult;
-  }
-  else {
-    DEBUG_PRINTLN(F("Checksum failure!"));
-    _lastresult = false;
-    return _lastresult;
+    return true;
   }
+  DEBUG_PRINTLN(F("Checksum failure!"));
+  return false;
 }
 
 // Expect the signal line to be at the specified level for a period of time and
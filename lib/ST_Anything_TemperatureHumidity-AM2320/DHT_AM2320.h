@@ -2,6 +2,9 @@
 
 MIT license
 written by Adafruit Industries
+
+2026-10-17  Per Ivar Nerseth  Split-phase read (start/poll/complete) - no delay(), interrupts
+                              are off for one bit at a time, with statistics of those windows
 */
 #ifndef DHT_AM2320_H
 #define DHT_AM2320_H
@@ -35,6 +38,11 @@ written by Adafruit Industries
 #define AM2301 21
 #define AM2320 22
 
+// Timing of a read, in milliseconds: the line is held high, then low to wake the
+// sensor up, before the transfer is captured.
+#define DHT_AM2320_SETTLE 250
+#define DHT_AM2320_WAKEUP 20
+
 class DHT_AM2320 {
   public:
    DHT_AM2320(uint8_t pin, uint8_t type, uint8_t count=6);
@@ -45,10 +53,43 @@ class DHT_AM2320 {
    float computeHeatIndex(float temperature, float percentHumidity, bool isFahrenheit=true);
    float readHumidity(bool force=false);
    boolean read(bool force=false);
+   void setPin(uint8_t pin);
+
+   // Split-phase read, for callers that must not block: start() begins a read
+   // (false if the last one is less than two seconds old - its result stands),
+   // poll() moves it along and returns true once it is over, and complete() tells
+   // whether it gave a valid reading.  pollDelay() is the time in milliseconds
+   // until poll() has work to do.  read() is start() and poll() until done.
+   boolean start(bool force=false);
+   boolean poll(void);
+   boolean complete(void) const { return _lastresult; }
+   uint32_t pollDelay(void) const;
+   boolean busy(void) const { return _state != STATE_IDLE; }
+
+   // Values of the last complete read - no new read is started.
+   float getTemperature(bool S=false);
+   float getHumidity(void);
+
+   // Interrupts-off windows of the last capture: the longest one and the sum, in
+   // microseconds, and how many there were; the longest of every capture so far;
+   // and the time from releasing the line to the last bit, which the whole
+   // capture used to be locked for.
+   uint16_t lockedMaxMicros(void) const { return _lockedMax; }
+   uint32_t lockedTotalMicros(void) const { return _lockedTotal; }
+   uint8_t lockedWindows(void) const { return _lockedWindows; }
+   uint16_t lockedWorstMicros(void) const { return _lockedWorst; }
+   uint32_t captureMicros(void) const { return _captureMicros; }
 
  private:
+  enum { STATE_IDLE, STATE_SETTLE, STATE_WAKEUP };
+
   uint8_t data[5];
   uint8_t _pin, _type;
+  uint8_t _state;
+  uint32_t _stateMillis;
+  uint32_t _lockedAt, _lockedTotal, _captureMicros;
+  uint16_t _lockedMax, _lockedWorst;
+  uint8_t _lockedWindows;
   #ifdef __AVR
     // Use direct GPIO access on an 8-bit AVR so keep track of the port and bitmask
     // for the digital pin connected to the DHT.  Other platforms will use digitalRead.
@@ -58,6 +99,9 @@ class DHT_AM2320 {
   bool _lastresult;
 
   uint32_t expectPulse(bool level);
+  boolean capture(void);
+  void lock(void);
+  void unlock(void);
 
 };
 
@@ -44,6 +44,9 @@
 //    2017-06-27  Dan Ogorchock  Added optional Celsius reading argument
 //    2017-08-17  Dan Ogorchock  Added optional filter constant argument and to transmit floating point values to SmartThings
 //    2018-01-09  Ajay Barve     Created new C++ class to handle the AM2320 sensors
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Split-phase reads (DHT_AM2320::start/poll/complete) - no delay() in getData() or init();
+//                                  In_C now reports Celsius (readTemperature(true) was Fahrenheit)
 //
 //******************************************************************************************
 
@@ -65,6 +68,8 @@ namespace st
 		PollingSensor(name, interval, offset),
 		m_fTemperatureSensorValue(-1.0),
 		m_fHumiditySensorValue(-1.0),
+		m_DHT(digitalInputPin, DHTSensorType),
+		m_bReading(false),
 		m_bDHTSensorType(DHTSensorType),
 		m_strTemperature(strTemp),
 		m_strHumidity(strHumid),
@@ -119,45 +124,49 @@ namespace st
 	//initialization routine - get first set of readings and send to ST cloud
 	void PS_TemperatureHumidity_AM2320::init()
 	{
-		
-		delay(1500);		//Needed to prevent "Unknown Error" on first read of DHT Sensor
-		getData();
-		
+		m_DHT.begin();
+		pollAgainIn(STARTUP_DELAY);		//Needed to prevent "Unknown Error" on first read of DHT Sensor - without holding up the loop
 	}
 	
 	//function to get data from sensor and queue results for transfer to ST Cloud 
 	void PS_TemperatureHumidity_AM2320::getData()
 	{
-	    DHT_AM2320 dht1(m_nDigitalInputPin, m_bDHTSensorType);
-		dht1.begin();
-		// READ DATA
-		int8_t chk = 0;
-		/*switch (m_bDHTSensorType) {
-			case DHT11:
-				//Serial.println(F("PS_TemperatureHumidity: DTH11 Read"));
-				chk = DHT.read11(m_nDigitalInputPin);
-				break;
-			case DHT21:
-				//Serial.println(F("PS_TemperatureHumidity: DTH21 Read"));
-				chk = DHT.read21(m_nDigitalInputPin);
-				break;
-			case DHT22:
-				//Serial.println(F("PS_TemperatureHumidity: DTH22 Read"));
-				chk = DHT.read22(m_nDigitalInputPin);
-				break;
-			case DHT33:
-				//Serial.println(F("PS_TemperatureHumidity: DTH33 Read"));
-				chk = DHT.read33(m_nDigitalInputPin);
-				break;
-			case DHT44:
-				//Serial.println(F("PS_TemperatureHumidity: DTH44 Read"));
-				chk = DHT.read44(m_nDigitalInputPin);
-				break;
-			default:
-				Serial.println(F("PS_TemperatureHumidity: Invalid DHT Sensor Type"));
+		// START A READ - the line is held high, then low, for about 270ms before the transfer
+		if (!m_bReading)
+		{
+			if (m_DHT.start())
+			{
+				m_bReading = true;
+				pollAgainIn(m_DHT.pollDelay());
+				return;
+			}
+			//the last read is less than two seconds old - its result stands
+		}
+		else if (!m_DHT.poll())
+		{
+			pollAgainIn(m_DHT.pollDelay());
+			return;
+		}
+		else
+		{
+			m_bReading = false;
+			if (st::PollingSensor::debug)
+			{
+				Serial.print(F("PS_TemperatureHumidity_AM2320: interrupts off "));
+				Serial.print(m_DHT.lockedTotalMicros());
+				Serial.print(F("us in "));
+				Serial.print(m_DHT.lockedWindows());
+				Serial.print(F(" windows, longest "));
+				Serial.print(m_DHT.lockedMaxMicros());
+				Serial.print(F("us, transfer "));
+				Serial.print(m_DHT.captureMicros());
+				Serial.println(F("us"));
 			}
+		}
 
-*/		switch (chk)
+		// READ DATA
+		int8_t chk = m_DHT.complete() ? 0 : -1;
+		switch (chk)
 		{
 		case 0:
 
@@ -165,11 +174,11 @@ namespace st
 			if (m_fHumiditySensorValue == -1.0)
 			{
 				Serial.println("First time through Humidity)");
-				m_fHumiditySensorValue = dht1.readHumidity();  //first time through, no filtering
+				m_fHumiditySensorValue = m_DHT.getHumidity();  //first time through, no filtering
 			}
 			else
 			{
-				m_fHumiditySensorValue = (m_fFilterConstant * dht1.readHumidity()) + (1 - m_fFilterConstant) * m_fHumiditySensorValue;
+				m_fHumiditySensorValue = (m_fFilterConstant * m_DHT.getHumidity()) + (1 - m_fFilterConstant) * m_fHumiditySensorValue;
 			}
 
 			//Temperature
@@ -179,22 +188,22 @@ namespace st
 				//first time through, no filtering
 				if (m_In_C == false)
 				{
-					m_fTemperatureSensorValue = (dht1.readTemperature() * 1.8) + 32.0;		//Scale from Celsius to Farenheit
+					m_fTemperatureSensorValue = (m_DHT.getTemperature() * 1.8) + 32.0;		//Scale from Celsius to Farenheit
 				}
 				else
 				{
-					m_fTemperatureSensorValue = dht1.readTemperature(true);
+					m_fTemperatureSensorValue = m_DHT.getTemperature();
 				}
 			}
 			else
 			{
 				if (m_In_C == false)
 				{
-					m_fTemperatureSensorValue = (m_fFilterConstant * ((dht1.readTemperature() * 1.8) + 32.0)) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
+					m_fTemperatureSensorValue = (m_fFilterConstant * ((m_DHT.getTemperature() * 1.8) + 32.0)) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
 				}
 				else
 				{
-					m_fTemperatureSensorValue = (m_fFilterConstant * dht1.readTemperature(true)) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
+					m_fTemperatureSensorValue = (m_fFilterConstant * m_DHT.getTemperature()) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
 				}
 				
 			}
@@ -219,7 +228,7 @@ namespace st
 		//	break;
 		default:
 			if (st::PollingSensor::debug) {
-				Serial.println(F("PS_TemperatureHumidity: DHT Unknown error"));
+				Serial.println(F("PS_TemperatureHumidity_AM2320: DHT read error (time out or checksum)"));
 			}
 			break;
 
@@ -233,13 +242,20 @@ namespace st
 
 		
 	
-		Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
-		Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		if (reportDue(m_fTemperatureSensorValue))
+		{
+			Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
+		}
+		if (reportDue(m_fHumiditySensorValue, m_HumidityReport))
+		{
+			Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		}
 	}
 	
 	void PS_TemperatureHumidity_AM2320::setPin(byte pin)
 	{
 		m_nDigitalInputPin=pin;
+		m_DHT.setPin(pin);
 	}
 
 
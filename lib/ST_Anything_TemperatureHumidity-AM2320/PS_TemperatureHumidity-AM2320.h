@@ -31,6 +31,11 @@
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
 //
+//			  A read takes about 270ms (the line is held high, then low to wake the sensor up), so
+//			  getData() starts it and asks for follow-up polls (PollingSensor::pollAgainIn()) until
+//			  it is done; only the transfer itself (about 5ms) is spent in one poll.  With debug on,
+//			  the interrupts-off windows of each transfer are printed (see DHT_AM2320::lockedMaxMicros()).
+//
 //			  TODO:  Determine a method to persist the ST Cloud's Polling Interval data
 //
 //  Change History:
@@ -44,11 +49,14 @@
 //    2017-06-27  Dan Ogorchock  Added optional Celsius reading argument
 //    2017-08-17  Dan Ogorchock  Added optional filter constant argument and to transmit floating point values to SmartThings
 //    2018-01-09  Ajay Barve     Created new C++ class to handle the AM2320 sensors
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Split-phase reads (DHT_AM2320::start/poll/complete) - no delay() in getData() or init();
+//                                  own header guard, so it can be built next to PS_TemperatureHumidity
 //
 //******************************************************************************************
 
-#ifndef ST_PS_TEMPERATUREHUMIDITY_H
-#define ST_PS_TEMPERATUREHUMIDITY_H
+#ifndef ST_PS_TEMPERATUREHUMIDITY_AM2320_H
+#define ST_PS_TEMPERATUREHUMIDITY_AM2320_H
 
 #include "PollingSensor.h"
 #include <DHT_AM2320.h>
@@ -60,13 +68,17 @@ namespace st
 			byte m_nDigitalInputPin;		//digital pin connected to the DHT sensor
 			float m_fTemperatureSensorValue;//current Temperature value
 			float m_fHumiditySensorValue;	//current Humidity Value
-			static DHT_AM2320 DHT(uint8_t pin, uint8_t type, uint8_t count=6);					//DHT library object
+			ReportState m_HumidityReport;	//last humidity value sent (the temperature uses the PollingSensor's own)
+			DHT_AM2320 m_DHT;				//DHT library object - keeps the state of a read between polls
+			bool m_bReading;				//true while a read started by getData() is running
 			byte m_bDHTSensorType;			//DHT Sensor Type
 			String m_strTemperature;		//name of temparature sensor to use when transferring data to ST Cloud
 			String m_strHumidity;			//name of temparature sensor to use when transferring data to ST Cloud		
 			bool m_In_C;					//Return temp in C
 			float m_fFilterConstant;        //Filter constant % as floating point from 0.00 to 1.00
 
+			static const unsigned int STARTUP_DELAY = 1500;	//ms from init() to the first read
+
 		public:
 			//types of DHT sensors supported by the dht library
 			//enum DHT_SENSOR { DHT11, DHT21, DHT22, DHT33, DHT44 };
@@ -90,6 +102,7 @@ namespace st
 			inline byte getPin() const { return m_nDigitalInputPin; }
 			inline float getTemperatureSensorValue() const { return m_fTemperatureSensorValue; }
 			inline float getHumiditySensorValue() const { return m_fHumiditySensorValue; }
+			inline const DHT_AM2320 &getDHT() const { return m_DHT; }
 				
 			//sets
 			void setPin(byte pin);
@@ -27,6 +27,13 @@
 //
 //            filteredValue = (filterConstant/100 * currentValue) + ((1 - filterConstant/100) * filteredValue) 
 //
+//			  Reads do not block the loop: a poll starts the DHT's wake pulse (dht::start()) and returns,
+//			  the reply is time-stamped by a pin interrupt, and follow-up polls a few milliseconds later
+//			  (PollingSensor::pollAgainIn()) decode it and send the values.  On a pin without an
+//			  external interrupt (e.g. pins 22-53 of the MEGA) the read falls back to the blocking
+//			  dht::read()/read11(), ~5ms for a DHT22 and ~23ms for a DHT11.  Sensors on several pins
+//			  take turns, one read at a time.
+//
 //			  This class supports receiving configuration data from the SmartThings cloud via the ST App.  A user preference
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
@@ -43,6 +50,9 @@
 //    2015-03-29  Dan Ogorchock	 Optimized use of the DHT library (made it static) to reduce SRAM memory usage at runtime.
 //    2017-06-27  Dan Ogorchock  Added optional Celsius reading argument
 //    2017-08-17  Dan Ogorchock  Added optional filter constant argument and to transmit floating point values to SmartThings
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Split-phase reads (dht::start/poll) - no delay() or busy wait in getData() or init()
+//    2026-10-17  Per Ivar Nerseth  Blocking read on a pin without an interrupt; DHTSensorType checked against the DHT_SENSOR types
 //
 //******************************************************************************************
 
@@ -55,7 +65,20 @@
 namespace st
 {
 //private
-	
+	bool PS_TemperatureHumidity::isSupported(byte DHTSensorType)
+	{
+		switch (DHTSensorType)
+		{
+		case DHT11:
+		case DHT21:
+		case DHT22:
+		case DHT33:
+		case DHT44:
+			return true;
+		default:
+			return false;
+		}
+	}
 
 //public
 	//constructor - called in your sketch's global variable declaration section
@@ -66,7 +89,8 @@ namespace st
 		m_bDHTSensorType(DHTSensorType),
 		m_strTemperature(strTemp),
 		m_strHumidity(strHumid),
-		m_In_C(In_C)
+		m_In_C(In_C),
+		m_bReading(false)
 	{
 		setPin(digitalInputPin);
 
@@ -114,42 +138,46 @@ namespace st
 		}
 	}
 
-	//initialization routine - get first set of readings and send to ST cloud
+	//initialization routine - the first set of readings is taken and sent to ST cloud once the DHT Sensor is ready
 	void PS_TemperatureHumidity::init()
 	{
-		delay(1500);		//Needed to prevent "Unknown Error" on first read of DHT Sensor
-		getData();
+		pollAgainIn(STARTUP_DELAY);		//Needed to prevent "Unknown Error" on first read of DHT Sensor - without holding up the loop
 	}
 	
 	//function to get data from sensor and queue results for transfer to ST Cloud 
 	void PS_TemperatureHumidity::getData()
 	{
-		// READ DATA
-		int8_t chk = 0;
-		switch (m_bDHTSensorType) {
-			case DHT11:
-				//Serial.println(F("PS_TemperatureHumidity: DTH11 Read"));
-				chk = DHT.read11(m_nDigitalInputPin);
-				break;
-			case DHT21:
-				//Serial.println(F("PS_TemperatureHumidity: DTH21 Read"));
-				chk = DHT.read21(m_nDigitalInputPin);
-				break;
-			case DHT22:
-				//Serial.println(F("PS_TemperatureHumidity: DTH22 Read"));
-				chk = DHT.read22(m_nDigitalInputPin);
-				break;
-			case DHT33:
-				//Serial.println(F("PS_TemperatureHumidity: DTH33 Read"));
-				chk = DHT.read33(m_nDigitalInputPin);
-				break;
-			case DHT44:
-				//Serial.println(F("PS_TemperatureHumidity: DTH44 Read"));
-				chk = DHT.read44(m_nDigitalInputPin);
-				break;
-			default:
-				Serial.println(F("PS_TemperatureHumidity: Invalid DHT Sensor Type"));
+		if (!isSupported(m_bDHTSensorType))
+		{
+			Serial.println(F("PS_TemperatureHumidity: Invalid DHT Sensor Type"));
+			return;
+		}
+
+		// START A READ - the DHT11 is woken up for 18ms, the others for 1ms (within start())
+		if (!m_bReading)
+		{
+			if (!DHT.start(m_nDigitalInputPin, m_bDHTSensorType == DHT11))
+			{
+				pollAgainIn(RETRY_TIME);	//another sensor's read is running
+				return;
 			}
+			m_bReading = true;
+			if (DHT.busy())
+			{
+				pollAgainIn(m_bDHTSensorType == DHT11 ? DHTLIB_DHT11_WAKEUP : TRANSFER_TIME);
+				return;
+			}
+			//no interrupt on the pin - start() has read the sensor already
+		}
+
+		// READ DATA
+		int8_t chk = DHT.poll();
+		if (chk == DHTLIB_BUSY)
+		{
+			pollAgainIn(RETRY_TIME);
+			return;
+		}
+		m_bReading = false;
 
 
 		switch (chk)
@@ -206,6 +234,11 @@ namespace st
 				Serial.println(F("PS_TemperatureHumidity: DHT Time out error"));
 			}
 			break;
+		case DHTLIB_ERROR_SIGNAL:
+			if (st::PollingSensor::debug) {
+				Serial.println(F("PS_TemperatureHumidity: DHT Signal error"));
+			}
+			break;
 		//case DHTLIB_ERROR_CONNECT:
 		//	if (st::PollingSensor::debug) {
 		//		Serial.println(F("PS_TemperatureHumidity: DHT Connect error"));
@@ -235,8 +268,14 @@ namespace st
 		//Serial.print(m_nTemperatureSensorValue, 1);
 		//Serial.println();
 
-		Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
-		Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		if (reportDue(m_fTemperatureSensorValue))
+		{
+			Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
+		}
+		if (reportDue(m_fHumiditySensorValue, m_HumidityReport))
+		{
+			Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		}
 	}
 	
 	void PS_TemperatureHumidity::setPin(byte pin)
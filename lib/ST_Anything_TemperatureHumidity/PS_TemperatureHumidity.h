@@ -27,6 +27,13 @@
 //
 //            filteredValue = (filterConstant/100 * currentValue) + ((1 - filterConstant/100) * filteredValue) 
 //
+//			  Reads do not block the loop: a poll starts the DHT's wake pulse (dht::start()) and returns,
+//			  the reply is time-stamped by a pin interrupt, and follow-up polls a few milliseconds later
+//			  (PollingSensor::pollAgainIn()) decode it and send the values.  On a pin without an
+//			  external interrupt (e.g. pins 22-53 of the MEGA) the read falls back to the blocking
+//			  dht::read()/read11(), ~5ms for a DHT22 and ~23ms for a DHT11.  Sensors on several pins
+//			  take turns, one read at a time.
+//
 //			  This class supports receiving configuration data from the SmartThings cloud via the ST App.  A user preference
 //			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to 
 //			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
@@ -43,6 +50,9 @@
 //    2015-03-29  Dan Ogorchock	 Optimized use of the DHT library (made it static) to reduce SRAM memory usage at runtime.
 //    2017-06-27  Dan Ogorchock  Added optional Celsius reading argument
 //    2017-08-17  Dan Ogorchock  Added optional filter constant argument and to transmit floating point values to SmartThings
+//    2026-10-16  Per Ivar Nerseth  Values are sent through the PollingSensor reporting policy (reportDue)
+//    2026-10-17  Per Ivar Nerseth  Split-phase reads (dht::start/poll) - no delay() or busy wait in getData() or init()
+//    2026-10-17  Per Ivar Nerseth  Blocking read on a pin without an interrupt; DHTSensorType checked against the DHT_SENSOR types
 //
 //******************************************************************************************
 
@@ -60,12 +70,20 @@ namespace st
 			byte m_nDigitalInputPin;		//digital pin connected to the DHT sensor
 			float m_fTemperatureSensorValue;//current Temperature value
 			float m_fHumiditySensorValue;	//current Humidity Value
+			ReportState m_HumidityReport;	//last humidity value sent (the temperature uses the PollingSensor's own)
 			static dht DHT;					//DHT library object
 			byte m_bDHTSensorType;			//DHT Sensor Type
 			String m_strTemperature;		//name of temparature sensor to use when transferring data to ST Cloud
 			String m_strHumidity;			//name of temparature sensor to use when transferring data to ST Cloud		
 			bool m_In_C;					//Return temp in C
 			float m_fFilterConstant;        //Filter constant % as floating point from 0.00 to 1.00
+			bool m_bReading;				//true while a split-phase read of DHT is running for this sensor
+
+			static const unsigned int STARTUP_DELAY = 1500;	//in milliseconds - from init() to the first read ("Unknown Error" if read sooner)
+			static const byte TRANSFER_TIME = 6;			//in milliseconds - from releasing the line until the reply is in
+			static const byte RETRY_TIME = 2;				//in milliseconds - between follow-up polls while a read is busy
+
+			static bool isSupported(byte DHTSensorType);	//one of the DHT_SENSOR types
 
 		public:
 			//types of DHT sensors supported by the dht library
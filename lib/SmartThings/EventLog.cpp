@@ -0,0 +1,476 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Store-and-Forward Event Log
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#include <EventLog.h>
+
+namespace st
+{
+	namespace
+	{
+		//Record: 16 byte header, then the text (no terminating 0).  Multi-byte fields are little endian.
+		//	[0] RECORD_MAGIC  [1] type  [2..3] text length  [4..7] seq  [8..11] millis()  [12..13] boot  [14..15] checksum
+		const byte RECORD_MAGIC = 0x5E;
+		const size_t RECORD_HEADER = 16;
+
+		const byte RECORD_SEGMENT = 1;	//first record of each segment - seq is the segment's generation
+		const byte RECORD_EVENT = 2;	//seq is the event's number
+		const byte RECORD_CURSOR = 3;	//seq is the last event delivered
+
+		void putLE(byte *data, unsigned long value, byte bytes)
+		{
+			for (byte i = 0; i < bytes; i++)
+			{
+				data[i] = (byte)(value >> (8 * i));
+			}
+		}
+
+		unsigned long getLE(const byte *data, byte bytes)
+		{
+			unsigned long value = 0;
+			for (byte i = 0; i < bytes; i++)
+			{
+				value |= (unsigned long)data[i] << (8 * i);
+			}
+			return value;
+		}
+
+		//Fletcher-16 over the header (without its checksum) and the text
+		unsigned int checksum(const byte *header, const char *text, unsigned int length)
+		{
+			unsigned int sum1 = 0;
+			unsigned int sum2 = 0;
+			for (byte i = 0; i < RECORD_HEADER - 2; i++)
+			{
+				sum1 = (sum1 + header[i]) % 255;
+				sum2 = (sum2 + sum1) % 255;
+			}
+			for (unsigned int i = 0; i < length; i++)
+			{
+				sum1 = (sum1 + (byte)text[i]) % 255;
+				sum2 = (sum2 + sum1) % 255;
+			}
+			return (sum2 << 8) | sum1;
+		}
+	}
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+	//*******************************************************************************
+	// EventLogFS - one file per segment
+	//*******************************************************************************
+	EventLogFS::EventLogFS(fs::FS &fs, const char *prefix) :
+		m_fs(fs),
+		m_pPrefix(prefix)
+	{
+
+	}
+
+	String EventLogFS::path(byte segment) const
+	{
+		return String(m_pPrefix) + segment;
+	}
+
+	size_t EventLogFS::size(byte segment)
+	{
+		String name = path(segment);
+		if (!m_fs.exists(name))
+		{
+			return 0;
+		}
+		File file = m_fs.open(name, "r");
+		size_t bytes = file ? file.size() : 0;
+		file.close();
+		return bytes;
+	}
+
+	size_t EventLogFS::read(byte segment, size_t offset, void *data, size_t length)
+	{
+		File file = m_fs.open(path(segment), "r");
+		if (!file)
+		{
+			return 0;
+		}
+		size_t bytes = file.seek(offset, SeekSet) ? file.read((uint8_t *)data, length) : 0;
+		file.close();
+		return bytes;
+	}
+
+	bool EventLogFS::append(byte segment, const void *data, size_t length)
+	{
+		File file = m_fs.open(path(segment), "a");
+		if (!file)
+		{
+			return false;
+		}
+		size_t bytes = file.write((const uint8_t *)data, length);
+		file.close();
+		return bytes == length;
+	}
+
+	void EventLogFS::erase(byte segment)
+	{
+		String name = path(segment);
+		if (m_fs.exists(name))
+		{
+			m_fs.remove(name);
+		}
+	}
+#endif
+
+	//*******************************************************************************
+	// EventLog Constructor
+	//*******************************************************************************
+	EventLog::EventLog(EventLogStorage &storage, unsigned long replayInterval, unsigned long retryInterval) :
+		m_storage(storage),
+		m_nHead(EVENTLOG_SEGMENTS - 1),
+		m_nHeadSize(0),
+		m_nReadSegment(0),
+		m_nReadOffset(0),
+		m_nNextSeq(1),
+		m_nDelivered(0),
+		m_nPeekSeq(0),
+		m_nPeekSize(0),
+		m_nBoot(0),
+		m_nSinceCursor(0),
+		m_nReplayInterval(replayInterval),
+		m_nRetryInterval(retryInterval),
+		m_nReplayMillis(0),
+		m_nStored(0),
+		m_nReplayed(0),
+		m_nDropped(0),
+		m_nCorrupt(0),
+		m_nBytesWritten(0),
+		m_nErases(0)
+	{
+		for (byte i = 0; i < EVENTLOG_SEGMENTS; i++)
+		{
+			m_nGeneration[i] = 0;
+			m_nLastSeq[i] = 0;
+		}
+	}
+
+	//*****************************************************************************
+	//EventLog::begin()
+	//*****************************************************************************
+	void EventLog::begin()
+	{
+		Record record;
+		char text[EVENTLOG_MAX_MESSAGE + 1];
+		bool found = false;
+
+		//the newest segment is the one with the highest generation - the ring runs on from there
+		for (byte s = 0; s < EVENTLOG_SEGMENTS; s++)
+		{
+			m_nGeneration[s] = 0;
+			m_nLastSeq[s] = 0;
+			if (readRecord(s, 0, record, text) && record.type == RECORD_SEGMENT && record.seq != 0)
+			{
+				m_nGeneration[s] = record.seq;
+				if (!found || record.seq > m_nGeneration[m_nHead])
+				{
+					m_nHead = s;
+					found = true;
+				}
+			}
+		}
+
+		m_nNextSeq = 1;
+		m_nDelivered = 0;
+		m_nHeadSize = 0;
+		m_nPeekSeq = 0;
+		unsigned int lastBoot = 0;
+		bool torn = false;
+		bool oldest = true;
+
+		//oldest segment first: the events stored, and the last cursor
+		for (byte i = 1; found && i <= EVENTLOG_SEGMENTS; i++)
+		{
+			byte s = (m_nHead + i) % EVENTLOG_SEGMENTS;
+			if (m_nGeneration[s] == 0)
+			{
+				continue;
+			}
+			if (oldest)
+			{
+				m_nReadSegment = s;
+				m_nReadOffset = 0;
+				oldest = false;
+			}
+
+			size_t size = m_storage.size(s);
+			size_t offset = 0;
+			while (offset < size)
+			{
+				if (!readRecord(s, offset, record, text))
+				{
+					m_nCorrupt++;
+					torn = torn || s == m_nHead;	//a power cut during an append - the next one would follow the broken record
+					break;
+				}
+				if (record.type == RECORD_EVENT)
+				{
+					m_nLastSeq[s] = record.seq;
+					if (record.seq >= m_nNextSeq)
+					{
+						m_nNextSeq = record.seq + 1;
+					}
+				}
+				else if (record.type == RECORD_CURSOR && record.seq > m_nDelivered)
+				{
+					m_nDelivered = record.seq;
+				}
+				if (record.boot > lastBoot)
+				{
+					lastBoot = record.boot;
+				}
+				offset += RECORD_HEADER + record.length;
+			}
+			if (s == m_nHead)
+			{
+				m_nHeadSize = offset;
+			}
+		}
+
+		if (m_nDelivered >= m_nNextSeq)
+		{
+			m_nNextSeq = m_nDelivered + 1;
+		}
+		m_nBoot = (lastBoot + 1) & 0xFFFF;
+
+		if (!found || torn || m_nHeadSize + RECORD_HEADER >= EVENTLOG_SEGMENT_SIZE)
+		{
+			startSegment();
+		}
+		if (!found)
+		{
+			m_nReadSegment = m_nHead;
+			m_nReadOffset = 0;
+		}
+		m_nReplayMillis = millis();
+	}
+
+	//*****************************************************************************
+	//EventLog::append()
+	//*****************************************************************************
+	bool EventLog::append(const String &message)
+	{
+		if (message.length() > EVENTLOG_MAX_MESSAGE)
+		{
+			m_nDropped++;
+			return false;
+		}
+
+		//an event is only stored because its delivery just failed - do not try again at once
+		if (getPending() == 0)
+		{
+			m_nReplayMillis = millis() + m_nRetryInterval;
+		}
+
+		if (!appendRecord(RECORD_EVENT, m_nNextSeq, message.c_str(), message.length()))
+		{
+			m_nDropped++;
+			return false;
+		}
+		m_nLastSeq[m_nHead] = m_nNextSeq;
+		m_nNextSeq++;
+		m_nStored++;
+		return true;
+	}
+
+	//*****************************************************************************
+	//EventLog::replayDue()
+	//*****************************************************************************
+	bool EventLog::replayDue() const
+	{
+		return getPending() > 0 && (long)(millis() - m_nReplayMillis) >= 0;
+	}
+
+	//*****************************************************************************
+	//EventLog::peek()
+	//*****************************************************************************
+	bool EventLog::peek(String &message, long &ageMillis)
+	{
+		Record record;
+		char text[EVENTLOG_MAX_MESSAGE + 1];
+		m_nPeekSeq = 0;
+
+		while (getPending() > 0)
+		{
+			size_t size = segmentSize(m_nReadSegment);
+			if (m_nReadOffset >= size)
+			{
+				if (m_nReadSegment == m_nHead)
+				{
+					//the rest was in records that failed their checksum
+					m_nDropped += getPending();
+					m_nDelivered = m_nNextSeq - 1;
+					break;
+				}
+				m_nReadSegment = (m_nReadSegment + 1) % EVENTLOG_SEGMENTS;
+				m_nReadOffset = 0;
+				continue;
+			}
+
+			if (!readRecord(m_nReadSegment, m_nReadOffset, record, text))
+			{
+				//nothing after a broken record can be found - skip the rest of its segment
+				m_nReadOffset = size;
+				continue;
+			}
+			if (record.type != RECORD_EVENT || record.seq <= m_nDelivered)
+			{
+				m_nReadOffset += RECORD_HEADER + record.length;
+				continue;
+			}
+			if (record.seq > m_nDelivered + 1)
+			{
+				//events before this one were overwritten or broken
+				m_nDropped += record.seq - m_nDelivered - 1;
+				m_nDelivered = record.seq - 1;
+			}
+
+			message = text;
+			ageMillis = record.boot == m_nBoot ? (long)(millis() - record.millis) : -1;
+			m_nPeekSeq = record.seq;
+			m_nPeekSize = RECORD_HEADER + record.length;
+			return true;
+		}
+		return false;
+	}
+
+	//*****************************************************************************
+	//EventLog::replayed()
+	//*****************************************************************************
+	void EventLog::replayed(bool delivered)
+	{
+		if (!delivered || m_nPeekSeq == 0)
+		{
+			m_nReplayMillis = millis() + m_nRetryInterval;
+			return;
+		}
+
+		m_nDelivered = m_nPeekSeq;
+		m_nReadOffset += m_nPeekSize;
+		m_nPeekSeq = 0;
+		m_nReplayed++;
+		if (++m_nSinceCursor >= EVENTLOG_CURSOR_EVERY || getPending() == 0)
+		{
+			writeCursor();
+		}
+		m_nReplayMillis = millis() + m_nReplayInterval;
+	}
+
+	//*****************************************************************************
+	//EventLog::appendRecord()
+	//*****************************************************************************
+	bool EventLog::appendRecord(byte type, unsigned long seq, const char *text, unsigned int length)
+	{
+		size_t size = RECORD_HEADER + length;
+		if (m_nHeadSize + size > EVENTLOG_SEGMENT_SIZE)
+		{
+			startSegment();
+		}
+
+		byte record[RECORD_HEADER + EVENTLOG_MAX_MESSAGE];
+		record[0] = RECORD_MAGIC;
+		record[1] = type;
+		putLE(record + 2, length, 2);
+		putLE(record + 4, seq, 4);
+		putLE(record + 8, millis(), 4);
+		putLE(record + 12, m_nBoot, 2);
+		putLE(record + 14, checksum(record, text, length), 2);
+		memcpy(record + RECORD_HEADER, text, length);
+
+		//one write per record, so a power cut breaks at most the record being written
+		if (!m_storage.append(m_nHead, record, size))
+		{
+			m_nHeadSize = EVENTLOG_SEGMENT_SIZE;	//what was written of it is unknown - the next record starts a new segment
+			return false;
+		}
+		m_nHeadSize += size;
+		m_nBytesWritten += size;
+		return true;
+	}
+
+	//*****************************************************************************
+	//EventLog::readRecord()
+	//*****************************************************************************
+	bool EventLog::readRecord(byte segment, size_t offset, Record &record, char *text)
+	{
+		byte header[RECORD_HEADER];
+		if (m_storage.read(segment, offset, header, RECORD_HEADER) != RECORD_HEADER || header[0] != RECORD_MAGIC)
+		{
+			return false;
+		}
+		record.type = header[1];
+		record.length = getLE(header + 2, 2);
+		record.seq = getLE(header + 4, 4);
+		record.millis = getLE(header + 8, 4);
+		record.boot = getLE(header + 12, 2);
+		if (record.length > EVENTLOG_MAX_MESSAGE ||
+			m_storage.read(segment, offset + RECORD_HEADER, text, record.length) != record.length)
+		{
+			return false;
+		}
+		text[record.length] = 0;
+		return checksum(header, text, record.length) == getLE(header + 14, 2);
+	}
+
+	//*****************************************************************************
+	//EventLog::segmentSize()
+	//*****************************************************************************
+	size_t EventLog::segmentSize(byte segment)
+	{
+		if (segment == m_nHead)
+		{
+			return m_nHeadSize;
+		}
+		return m_nGeneration[segment] ? m_storage.size(segment) : 0;
+	}
+
+	//*****************************************************************************
+	//EventLog::startSegment()
+	//*****************************************************************************
+	void EventLog::startSegment()
+	{
+		byte next = (m_nHead + 1) % EVENTLOG_SEGMENTS;
+
+		//the oldest segment is reused - events in it that were never delivered are lost
+		if (m_nGeneration[next] != 0 && m_nLastSeq[next] > m_nDelivered)
+		{
+			m_nDropped += m_nLastSeq[next] - m_nDelivered;
+			m_nDelivered = m_nLastSeq[next];
+		}
+		if (m_nReadSegment == next)
+		{
+			m_nReadSegment = (next + 1) % EVENTLOG_SEGMENTS;
+			m_nReadOffset = 0;
+			m_nPeekSeq = 0;
+		}
+
+		unsigned long generation = m_nGeneration[m_nHead] + 1;
+		m_storage.erase(next);
+		m_nErases++;
+		m_nGeneration[next] = generation;
+		m_nLastSeq[next] = 0;
+		m_nHead = next;
+		m_nHeadSize = 0;
+
+		appendRecord(RECORD_SEGMENT, generation, "", 0);
+		writeCursor();		//the last cursor may have been in the segment just erased
+	}
+
+	//*****************************************************************************
+	//EventLog::writeCursor()
+	//*****************************************************************************
+	void EventLog::writeCursor()
+	{
+		m_nSinceCursor = 0;
+		appendRecord(RECORD_CURSOR, m_nDelivered, "", 0);
+	}
+}
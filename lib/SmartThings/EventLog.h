@@ -0,0 +1,192 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Store-and-Forward Event Log
+//
+//	Keeps the events that could not be delivered to the hub (WiFi down, hub
+//	unreachable) in flash, with the time they were captured, and hands them back
+//	in order once the hub can be reached again - at most one per replayInterval,
+//	so a long backlog does not flood the hub or starve loop().
+//
+//	The log is a ring of EVENTLOG_SEGMENTS segments of EVENTLOG_SEGMENT_SIZE bytes.
+//	Records are only ever appended; when the newest segment is full, the log
+//	moves on to the next one and erases it, so every segment is written and erased
+//	in turn (wear levelling across the ring).  If that segment still holds events
+//	that were never delivered, they are dropped - the oldest first - and counted.
+//	Delivery progress is recorded by appending a small cursor record, not by
+//	rewriting the events, every EVENTLOG_CURSOR_EVERY events and when the log
+//	has been emptied.  After a reset, begin() finds the newest segment and the
+//	last cursor, and replay resumes from there; a record torn by a power cut
+//	fails its checksum and is skipped.
+//
+//	Storage is an EventLogStorage.  On the ESP8266/ESP32 EventLogFS keeps each
+//	segment in its own file of LittleFS or SPIFFS:
+//		LittleFS.begin();
+//		static st::EventLogFS eventStorage(LittleFS);
+//		static st::EventLog eventLog(eventStorage);
+//		eventLog.begin();
+//		st::Everything::SmartThing->setEventLog(&eventLog);
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __EVENTLOG_H__
+#define __EVENTLOG_H__
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+#include <FS.h>
+#endif
+
+//Segments in the ring (at least 2)
+#ifndef EVENTLOG_SEGMENTS
+#define EVENTLOG_SEGMENTS 8
+#endif
+
+//Bytes per segment - a record is 16 bytes plus the event's text
+#ifndef EVENTLOG_SEGMENT_SIZE
+#define EVENTLOG_SEGMENT_SIZE 4096
+#endif
+
+//Longest event stored - longer ones are dropped and counted
+#ifndef EVENTLOG_MAX_MESSAGE
+#define EVENTLOG_MAX_MESSAGE 255
+#endif
+
+//Time between two replayed events (in milliseconds)
+#ifndef EVENTLOG_REPLAY_INTERVAL
+#define EVENTLOG_REPLAY_INTERVAL 100
+#endif
+
+//Time before trying again after the hub could not be reached (in milliseconds)
+#ifndef EVENTLOG_RETRY_INTERVAL
+#define EVENTLOG_RETRY_INTERVAL 5000
+#endif
+
+//Events delivered between two cursor records - after a reset, at most this many are sent again
+#ifndef EVENTLOG_CURSOR_EVERY
+#define EVENTLOG_CURSOR_EVERY 8
+#endif
+
+namespace st
+{
+	//*******************************************************************************
+	/// Flash behind an EventLog - EVENTLOG_SEGMENTS segments that are appended to and erased whole
+	//*******************************************************************************
+	class EventLogStorage
+	{
+	public:
+		virtual ~EventLogStorage() {}
+
+		virtual size_t size(byte segment) = 0;											//bytes appended since the segment was erased
+		virtual size_t read(byte segment, size_t offset, void *data, size_t length) = 0;	//returns the bytes read
+		virtual bool append(byte segment, const void *data, size_t length) = 0;
+		virtual void erase(byte segment) = 0;
+	};
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+	//*******************************************************************************
+	/// EventLogStorage in files <prefix>0 .. <prefix>N of a mounted LittleFS or SPIFFS
+	//*******************************************************************************
+	class EventLogFS : public EventLogStorage
+	{
+	private:
+		fs::FS &m_fs;
+		const char *m_pPrefix;
+
+		String path(byte segment) const;
+
+	public:
+		EventLogFS(fs::FS &fs, const char *prefix = "/stlog");
+
+		virtual size_t size(byte segment);
+		virtual size_t read(byte segment, size_t offset, void *data, size_t length);
+		virtual bool append(byte segment, const void *data, size_t length);
+		virtual void erase(byte segment);
+	};
+#endif
+
+	class EventLog
+	{
+	private:
+		//one record as it is read back
+		struct Record
+		{
+			byte type;
+			unsigned int length;		//of the text
+			unsigned long seq;			//event number, segment generation or last event delivered - see the RECORD_ types
+			unsigned long millis;		//capture time
+			unsigned int boot;
+		};
+
+		EventLogStorage &m_storage;
+		unsigned long m_nGeneration[EVENTLOG_SEGMENTS];	//order of the segments, 0 == unused
+		unsigned long m_nLastSeq[EVENTLOG_SEGMENTS];	//newest event in each segment, 0 == none
+		byte m_nHead;						//segment appended to
+		size_t m_nHeadSize;
+		byte m_nReadSegment;				//where the next event to replay is searched from
+		size_t m_nReadOffset;
+		unsigned long m_nNextSeq;			//number of the next event stored
+		unsigned long m_nDelivered;			//every event up to this number has been delivered (or dropped)
+		unsigned long m_nPeekSeq;			//event returned by peek(), 0 == none
+		size_t m_nPeekSize;
+		unsigned int m_nBoot;				//resets since the log was first written
+		byte m_nSinceCursor;
+
+		unsigned long m_nReplayInterval;
+		unsigned long m_nRetryInterval;
+		unsigned long m_nReplayMillis;		//time of the next replay
+
+		unsigned long m_nStored;			//events appended
+		unsigned long m_nReplayed;			//events delivered from the log
+		unsigned long m_nDropped;			//events overwritten before delivery, or too long to store
+		unsigned long m_nCorrupt;			//records begin() found broken (failed their checksum)
+		unsigned long m_nBytesWritten;
+		unsigned long m_nErases;
+
+		bool appendRecord(byte type, unsigned long seq, const char *text, unsigned int length);
+		bool readRecord(byte segment, size_t offset, Record &record, char *text);
+		size_t segmentSize(byte segment);
+		void startSegment();				//moves the head on to the next segment of the ring
+		void writeCursor();
+
+	public:
+		//*******************************************************************************
+		/// @brief  Event Log Constructor
+		///   @param[in] storage - flash the log is kept in
+		///   @param[in] replayInterval (optional) - time between two replayed events, in milliseconds
+		///   @param[in] retryInterval (optional) - time before trying again after a failed delivery, in milliseconds
+		//*******************************************************************************
+		EventLog(EventLogStorage &storage, unsigned long replayInterval = EVENTLOG_REPLAY_INTERVAL, unsigned long retryInterval = EVENTLOG_RETRY_INTERVAL);
+
+		//*******************************************************************************
+		/// Finds what the storage holds from before the last reset - call once, before anything else
+		//*******************************************************************************
+		void begin();
+
+		//*******************************************************************************
+		/// Stores one event, captured now.  While the log was empty, the first replay waits retryInterval.
+		//*******************************************************************************
+		bool append(const String &message);
+
+		//*******************************************************************************
+		/// Replay - when replayDue(), peek() the oldest event and report whether it was delivered
+		//*******************************************************************************
+		bool replayDue() const;
+		bool peek(String &message, long &ageMillis);	//ageMillis: time since capture, -1 if captured before the last reset
+		void replayed(bool delivered);
+
+		//gets
+		unsigned long getPending() const { return m_nNextSeq - 1 - m_nDelivered; }
+		unsigned long getStored() const { return m_nStored; }
+		unsigned long getReplayed() const { return m_nReplayed; }
+		unsigned long getDropped() const { return m_nDropped; }
+		unsigned long getCorrupt() const { return m_nCorrupt; }
+		unsigned long getBytesWritten() const { return m_nBytesWritten; }
+		unsigned long getErases() const { return m_nErases; }
+	};
+}
+
+#endif
@@ -0,0 +1,172 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - connections to the server transports
+//
+//	Keeps up to SLOTS open connections to st_server, each with its own
+//	HttpRequestParser, so that run() never waits for a request to arrive: poll()
+//	reads whatever each connection has available and returns at once.  A request
+//	that is not complete HTTP_READ_TIMEOUT milliseconds after its connection was
+//	accepted is answered with 408 and closed, so a slow or half-open client costs
+//	one slot for a while instead of stopping the loop.
+//
+//	Client is the client class of the network library (WiFiClient, EthernetClient,
+//	...).  Servers that hand out each new connection once (ESP8266, ESP32) can use
+//	several slots.  Servers whose available() hands out the same connection again
+//	while it has data (Ethernet, WiFi101, WiFiEsp) use one slot: accept() takes the
+//	connection the slot already holds as accepted, and ignores another one while the
+//	slot is busy - it is offered again later, and counted busy once.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  A connection offered again is not counted busy (one slot, Ethernet/WiFi101/WiFiEsp)
+//*******************************************************************************
+#ifndef __HTTPCONNECTIONS_H__
+#define __HTTPCONNECTIONS_H__
+
+#include "HttpRequestParser.h"
+
+//Number of connections served at the same time by transports whose server hands out each connection once
+#ifndef HTTP_MAX_CONNECTIONS
+#define HTTP_MAX_CONNECTIONS 4
+#endif
+
+//Time a client has to send its whole request (in milliseconds)
+#ifndef HTTP_READ_TIMEOUT
+#define HTTP_READ_TIMEOUT 2000
+#endif
+
+namespace st
+{
+	//whether two clients are the same connection - only asked of the one-slot servers that offer a
+	//connection again, so only their Client classes need operator==
+	template <class Client, bool OFFERED_AGAIN> struct SameConnection
+	{
+		static bool test(Client &, const Client &) { return false; }
+	};
+
+	template <class Client> struct SameConnection<Client, true>
+	{
+		static bool test(Client &held, const Client &offered) { return held == offered; }
+	};
+
+	template <class Client, byte SLOTS> class HttpConnections
+	{
+	public:
+		struct Connection
+		{
+			Client client;
+			HttpRequestParser request;
+			unsigned long acceptedMillis;
+			bool open;
+		};
+
+		HttpConnections() : m_bRefused(false), m_nTimeouts(0), m_nDropped(0), m_nBusy(0)
+		{
+			for (byte i = 0; i < SLOTS; i++)
+			{
+				m_Slots[i].open = false;
+			}
+		}
+
+		//takes a new connection - false if every slot is in use (counted in getBusy(), once per connection)
+		bool accept(const Client &client)
+		{
+			typedef SameConnection<Client, SLOTS == 1> Same;
+			for (byte i = 0; i < SLOTS; i++)
+			{
+				if (m_Slots[i].open && Same::test(m_Slots[i].client, client))
+				{
+					return true;	//offered again while it is being read
+				}
+			}
+			for (byte i = 0; i < SLOTS; i++)
+			{
+				if (!m_Slots[i].open)
+				{
+					m_Slots[i].client = client;
+					m_Slots[i].request.reset();
+					m_Slots[i].acceptedMillis = millis();
+					m_Slots[i].open = true;
+					return true;
+				}
+			}
+			if (SLOTS > 1 || !m_bRefused || !Same::test(m_Refused, client))
+			{
+				m_nBusy++;
+			}
+			if (SLOTS == 1)
+			{
+				m_Refused = client;		//offered again on the next passes - counted once
+				m_bRefused = true;
+			}
+			return false;
+		}
+
+		//reads what the open connections have available, closes those that timed out or went away, and
+		//returns one whose request is done (COMPLETE or FAILED) - the caller answers it and calls close().
+		//Returns NULL when no request is ready.
+		Connection *poll()
+		{
+			for (byte i = 0; i < SLOTS; i++)
+			{
+				Connection &connection = m_Slots[i];
+				if (!connection.open)
+				{
+					continue;
+				}
+				if (!connection.request.done())
+				{
+					connection.request.read(connection.client);
+				}
+				if (connection.request.done())
+				{
+					return &connection;
+				}
+				if (!connection.client.connected())
+				{
+					m_nDropped++;
+					close(connection);
+				}
+				else if (millis() - connection.acceptedMillis > HTTP_READ_TIMEOUT)
+				{
+					m_nTimeouts++;
+					connection.client.println(F("HTTP/1.1 408 Request Timeout"));
+					connection.client.println();
+					close(connection);
+				}
+			}
+			return NULL;
+		}
+
+		void close(Connection &connection)
+		{
+			connection.client.stop();
+			connection.open = false;	//request keeps its contents until the slot is used again
+		}
+
+		//gets
+		byte getOpen() const
+		{
+			byte count = 0;
+			for (byte i = 0; i < SLOTS; i++)
+			{
+				count += m_Slots[i].open ? 1 : 0;
+			}
+			return count;
+		}
+		unsigned long getTimeouts() const { return m_nTimeouts; }	//connections closed by HTTP_READ_TIMEOUT
+		unsigned long getDropped() const { return m_nDropped; }		//connections closed by the client before the request was complete
+		unsigned long getBusy() const { return m_nBusy; }			//connections refused by accept(), each counted once
+
+	private:
+		Connection m_Slots[SLOTS];
+		Client m_Refused;			//last connection refused, SLOTS == 1 - a server that offers it again
+		bool m_bRefused;
+		unsigned long m_nTimeouts;
+		unsigned long m_nDropped;
+		unsigned long m_nBusy;
+	};
+}
+#endif
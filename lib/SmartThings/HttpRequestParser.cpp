@@ -0,0 +1,307 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - HTTP request parser for the server transports
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+
+#include "HttpRequestParser.h"
+
+#include <ctype.h>
+
+namespace st
+{
+	//*******************************************************************************
+	// HttpRequestParser Constructor
+	//*******************************************************************************
+	HttpRequestParser::HttpRequestParser()
+	{
+		reset();
+	}
+
+	//*******************************************************************************
+	/// Start on a new request
+	//*******************************************************************************
+	void HttpRequestParser::reset()
+	{
+		m_Buffer[0] = 0;
+		m_nState = REQUEST_LINE;
+		m_nError = ERROR_NONE;
+		m_bKeepAlive = false;
+		m_nLineStart = 0;
+		m_nLineEnd = 0;
+		m_nPath = 0;
+		m_nPathLength = 0;
+		m_nBody = 0;
+		m_nBodyLength = 0;
+		m_nBodyRemaining = 0;
+	}
+
+	//*******************************************************************************
+	/// Parse len bytes of the request
+	//*******************************************************************************
+	size_t HttpRequestParser::feed(const char *data, size_t len)
+	{
+		size_t used = 0;
+		while (used < len && m_nState < COMPLETE)
+		{
+			if (m_nState == BODY)
+			{
+				size_t count = len - used;
+				if (count > m_nBodyRemaining)
+				{
+					count = m_nBodyRemaining;
+				}
+				memcpy(m_Buffer + m_nBody + m_nBodyLength, data + used, count);	//room was checked in endHeaders()
+				m_nBodyLength += count;
+				m_nBodyRemaining -= count;
+				used += count;
+				if (m_nBodyRemaining == 0)
+				{
+					finishBody();
+				}
+				continue;
+			}
+
+			//copy up to the end of the line in one go
+			const char *start = data + used;
+			const char *newline = (const char *)memchr(start, '\n', len - used);
+			size_t count = newline ? (size_t)(newline - start) : len - used;
+			size_t room = HTTP_REQUEST_BUFFER_SIZE - 1 - m_nLineEnd;
+			if (count > room)
+			{
+				if (m_nState == REQUEST_LINE)
+				{
+					fail(ERROR_LINE_TOO_LONG);
+					return used;
+				}
+				memcpy(m_Buffer + m_nLineEnd, start, room);	//only the start of a header line matters
+				m_nLineEnd += room;
+			}
+			else
+			{
+				memcpy(m_Buffer + m_nLineEnd, start, count);
+				m_nLineEnd += count;
+			}
+			used += count;
+
+			if (newline)
+			{
+				used++;
+				endLine();
+			}
+		}
+		return used;
+	}
+
+	//*******************************************************************************
+	/// A complete line is in m_Buffer[m_nLineStart..m_nLineEnd)
+	//*******************************************************************************
+	void HttpRequestParser::endLine()
+	{
+		size_t len = m_nLineEnd - m_nLineStart;
+		if (len > 0 && m_Buffer[m_nLineEnd - 1] == '\r')
+		{
+			len--;
+		}
+		m_Buffer[m_nLineStart + len] = 0;
+
+		if (m_nState == REQUEST_LINE)
+		{
+			if (len == 0)
+			{
+				m_nLineEnd = 0;		//empty lines before the request line are allowed
+				return;
+			}
+			parseRequestLine(len);
+		}
+		else if (len == 0)
+		{
+			endHeaders();
+		}
+		else
+		{
+			parseHeader(m_Buffer + m_nLineStart);
+			m_nLineEnd = m_nLineStart;	//the next header line overwrites this one
+		}
+	}
+
+	//*******************************************************************************
+	/// "METHOD /path?query HTTP/1.1" - keeps METHOD and the decoded path (a 0 byte is refused)
+	//*******************************************************************************
+	void HttpRequestParser::parseRequestLine(size_t len)
+	{
+		char *line = m_Buffer;
+		char *end = line + len;
+
+		char *space = (char *)memchr(line, ' ', len);
+		if (space == NULL || space == line || memchr(line, 0, len) != NULL)
+		{
+			fail(ERROR_BAD_REQUEST);
+			return;
+		}
+		*space = 0;
+
+		char *slash = (char *)memchr(space + 1, '/', end - (space + 1));
+		if (slash == NULL)
+		{
+			fail(ERROR_BAD_REQUEST);
+			return;
+		}
+		char *path = slash + 1;
+
+		//the version is the last word, if it is one - the Hub may leave spaces in the path unescaped
+		char *version = end;
+		while (version > path && *(version - 1) != ' ')
+		{
+			version--;
+		}
+		if (version > path && strncmp(version, "HTTP/", 5) == 0)
+		{
+			m_bKeepAlive = strncmp(version, "HTTP/1.0", 8) != 0;
+			end = version - 1;
+		}
+		else
+		{
+			m_bKeepAlive = false;	//HTTP/0.9 style request
+		}
+
+		char *query = (char *)memchr(path, '?', end - path);
+		if (query != NULL)
+		{
+			end = query;
+		}
+
+		m_nPath = path - m_Buffer;
+		m_nPathLength = decode(path, end - path);
+		m_Buffer[m_nPath + m_nPathLength] = 0;
+
+		m_nBody = m_nPath + m_nPathLength + 1;
+		m_nLineStart = m_nBody;
+		m_nLineEnd = m_nBody;
+		m_nState = HEADERS;
+	}
+
+	//*******************************************************************************
+	/// One header line - only Content-Length and Connection are used
+	//*******************************************************************************
+	void HttpRequestParser::parseHeader(const char *line)
+	{
+		if (strncasecmp(line, "Content-Length:", 15) == 0)
+		{
+			long length = atol(line + 15);
+			if (length < 0)
+			{
+				fail(ERROR_BAD_REQUEST);
+				return;
+			}
+			m_nBodyRemaining = length;
+		}
+		else if (strncasecmp(line, "Connection:", 11) == 0)
+		{
+			const char *value = line + 11;
+			while (*value == ' ' || *value == '\t')
+			{
+				value++;
+			}
+			if (strncasecmp(value, "close", 5) == 0)
+			{
+				m_bKeepAlive = false;
+			}
+			else if (strncasecmp(value, "keep-alive", 10) == 0)
+			{
+				m_bKeepAlive = true;
+			}
+		}
+	}
+
+	//*******************************************************************************
+	/// The empty line after the headers
+	//*******************************************************************************
+	void HttpRequestParser::endHeaders()
+	{
+		m_Buffer[m_nBody] = 0;
+		if (m_nBodyRemaining == 0)
+		{
+			m_nState = COMPLETE;
+		}
+		else if (m_nBodyRemaining > HTTP_REQUEST_BUFFER_SIZE - 1 - m_nBody)
+		{
+			fail(ERROR_BODY_TOO_LONG);
+		}
+		else
+		{
+			m_nState = BODY;
+		}
+	}
+
+	//*******************************************************************************
+	/// All of the body has arrived
+	//*******************************************************************************
+	void HttpRequestParser::finishBody()
+	{
+		while (m_nBodyLength > 0 && isspace((unsigned char)m_Buffer[m_nBody + m_nBodyLength - 1]))
+		{
+			m_nBodyLength--;
+		}
+		m_Buffer[m_nBody + m_nBodyLength] = 0;
+		m_nState = COMPLETE;
+	}
+
+	//*******************************************************************************
+	/// Status line for a request that failed
+	//*******************************************************************************
+	const __FlashStringHelper *HttpRequestParser::getErrorStatus() const
+	{
+		switch (m_nError)
+		{
+			case ERROR_LINE_TOO_LONG:
+				return F("HTTP/1.1 414 URI Too Long");
+			case ERROR_BODY_TOO_LONG:
+				return F("HTTP/1.1 413 Payload Too Large");
+			default:
+				return F("HTTP/1.1 400 Bad Request");
+		}
+	}
+
+	void HttpRequestParser::fail(Error error)
+	{
+		m_nError = error;
+		m_nState = FAILED;
+		m_bKeepAlive = false;
+	}
+
+	//*******************************************************************************
+	/// %xx escapes - a malformed escape, or %00, is left as it is
+	//*******************************************************************************
+	size_t HttpRequestParser::decode(char *text, size_t len)
+	{
+		char *in = (char *)memchr(text, '%', len);
+		if (in == NULL)
+		{
+			return len;
+		}
+
+		char *end = text + len;
+		char *out = in;
+		while (in < end)
+		{
+			if (*in == '%' && end - in >= 3 && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2]))
+			{
+				char hex[3] = { in[1], in[2], 0 };
+				char c = (char)strtol(hex, NULL, 16);
+				if (c != 0)
+				{
+					*out++ = c;
+					in += 3;
+					continue;
+				}
+			}
+			*out++ = *in++;
+		}
+		return out - text;
+	}
+}
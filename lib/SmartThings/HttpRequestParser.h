@@ -0,0 +1,136 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - HTTP request parser for the server transports
+//
+//	Incremental parser for the requests the Hub sends to st_server.  Bytes are fed
+//	in as they arrive (feed(), or read() straight from a client in bulk) into one
+//	fixed buffer - nothing is allocated.  The request line is kept, its path is
+//	percent-decoded in place, headers are looked at one line at a time and dropped
+//	(only Content-Length and Connection matter), and a body of Content-Length bytes
+//	is kept after the path.
+//
+//	command() is what the transports pass to the callout function: the path
+//	between the first '/' and the '?' (or the HTTP version), or the body when the
+//	path is empty, e.g. a POST / with "switch1 on" as its body.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __HTTPREQUESTPARSER_H__
+#define __HTTPREQUESTPARSER_H__
+
+#include <Arduino.h>
+
+//Size of the request buffer (request line, the longest header line looked at, and the body)
+#ifndef HTTP_REQUEST_BUFFER_SIZE
+#define HTTP_REQUEST_BUFFER_SIZE 256
+#endif
+
+//Size of the chunks read() takes from the client at a time
+#ifndef HTTP_READ_CHUNK_SIZE
+#define HTTP_READ_CHUNK_SIZE 64
+#endif
+
+namespace st
+{
+	class HttpRequestParser
+	{
+	public:
+		enum State
+		{
+			REQUEST_LINE,	//reading "METHOD /path?query HTTP/1.1"
+			HEADERS,		//reading header lines, up to the empty line
+			BODY,			//reading Content-Length bytes of body
+			COMPLETE,		//the whole request has been read
+			FAILED			//the request cannot be parsed - see getError()
+		};
+
+		enum Error
+		{
+			ERROR_NONE,
+			ERROR_BAD_REQUEST,		//no method or no path on the request line
+			ERROR_LINE_TOO_LONG,	//the request line does not fit the buffer (414)
+			ERROR_BODY_TOO_LONG		//the body does not fit the buffer (413)
+		};
+
+		HttpRequestParser();
+
+		//forget the current request and start on a new one (e.g. the next one on a kept-alive connection)
+		void reset();
+
+		//parse len bytes - returns the number of bytes used, which is less than len only when the
+		//request completed or failed before the end of data (the rest belongs to the next request)
+		size_t feed(const char *data, size_t len);
+
+		//parse what the client has available, reading it in chunks of HTTP_READ_CHUNK_SIZE bytes -
+		//anything read beyond the end of the request is dropped (the Hub sends one request at a time)
+		template <class Client> State read(Client &client)
+		{
+			char chunk[HTTP_READ_CHUNK_SIZE];
+			while (!done())
+			{
+				int available = client.available();
+				if (available <= 0)
+				{
+					break;
+				}
+				size_t want = (size_t)available < sizeof(chunk) ? (size_t)available : sizeof(chunk);
+				if (m_nState == BODY && m_nBodyRemaining < want)
+				{
+					want = m_nBodyRemaining;
+				}
+				int got = client.read((uint8_t *)chunk, want);
+				if (got <= 0)
+				{
+					break;
+				}
+				feed(chunk, got);
+			}
+			return m_nState;
+		}
+
+		//gets
+		State getState() const { return m_nState; }
+		Error getError() const { return m_nError; }
+		bool done() const { return m_nState >= COMPLETE; }
+		bool complete() const { return m_nState == COMPLETE; }
+		bool keepAlive() const { return m_bKeepAlive; }					//HTTP/1.1 without "Connection: close", or HTTP/1.0 with "Connection: keep-alive"
+		bool isMethod(const char *method) const { return strcmp(m_Buffer, method) == 0; }
+
+		const char *getMethod() const { return m_Buffer; }				//valid once the request line has been read
+		const char *getPath() const { return m_Buffer + m_nPath; }		//decoded, without the leading '/' and the query
+		size_t getPathLength() const { return m_nPathLength; }
+		const char *getBody() const { return m_Buffer + m_nBody; }		//trailing white space removed
+		size_t getBodyLength() const { return m_nBodyLength; }
+		const char *command() const { return m_nPathLength ? getPath() : getBody(); }
+		size_t commandLength() const { return m_nPathLength ? m_nPathLength : m_nBodyLength; }
+
+		//status line to answer a FAILED request with, e.g. "HTTP/1.1 414 URI Too Long"
+		const __FlashStringHelper *getErrorStatus() const;
+
+	private:
+		char m_Buffer[HTTP_REQUEST_BUFFER_SIZE];
+		State m_nState;
+		Error m_nError;
+		bool m_bKeepAlive;
+		size_t m_nLineStart;		//where the line being read starts in m_Buffer
+		size_t m_nLineEnd;			//where its next character goes
+		size_t m_nPath;
+		size_t m_nPathLength;
+		size_t m_nBody;
+		size_t m_nBodyLength;
+		size_t m_nBodyRemaining;	//body bytes still to come
+
+		void endLine();
+		void parseRequestLine(size_t len);
+		void parseHeader(const char *line);
+		void endHeaders();
+		void finishBody();
+		void fail(Error error);
+
+		static size_t decode(char *text, size_t len);	//percent-decodes text in place, returns the new length
+	};
+}
+#endif
@@ -0,0 +1,138 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Retry Queue
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#include <RetryQueue.h>
+
+namespace st
+{
+	//*******************************************************************************
+	// RetryQueue Constructor
+	//*******************************************************************************
+	RetryQueue::RetryQueue(byte maxAttempts, unsigned long baseDelay, unsigned long maxDelay) :
+		m_nHead(0),
+		m_nCount(0),
+		m_nMaxAttempts(maxAttempts),
+		m_nBaseDelay(baseDelay),
+		m_nMaxDelay(maxDelay),
+		m_nFailures(0),
+		m_nDueMillis(0),
+		m_nRetries(0),
+		m_nRecovered(0),
+		m_nDeadLetters(0)
+	{
+		for (byte i = 0; i < RETRY_QUEUE_SIZE; i++)
+		{
+			m_nAttempts[i] = 0;
+		}
+	}
+
+	//*****************************************************************************
+	//RetryQueue::setPolicy()
+	//*****************************************************************************
+	void RetryQueue::setPolicy(byte maxAttempts, unsigned long baseDelay, unsigned long maxDelay)
+	{
+		m_nMaxAttempts = maxAttempts;
+		m_nBaseDelay = baseDelay;
+		m_nMaxDelay = maxDelay > baseDelay ? maxDelay : baseDelay;
+	}
+
+	//*****************************************************************************
+	//RetryQueue::hold()
+	//*****************************************************************************
+	bool RetryQueue::hold(const String &message, bool attempted)
+	{
+		if (m_nMaxAttempts <= 1 || m_nCount >= RETRY_QUEUE_SIZE)
+		{
+			m_nDeadLetters++;
+			return false;
+		}
+
+		byte slot = (m_nHead + m_nCount) % RETRY_QUEUE_SIZE;
+		m_Messages[slot] = message;
+		m_nAttempts[slot] = attempted ? 1 : 0;
+		if (m_nCount++ == 0)
+		{
+			//the first message held - the hub just failed it, or nothing has been tried yet
+			m_nFailures = 0;
+			if (attempted)
+			{
+				backOff();
+			}
+			else
+			{
+				m_nDueMillis = millis();
+			}
+		}
+		return true;
+	}
+
+	//*****************************************************************************
+	//RetryQueue::due()
+	//*****************************************************************************
+	bool RetryQueue::due() const
+	{
+		return m_nCount > 0 && (long)(millis() - m_nDueMillis) >= 0;
+	}
+
+	//*****************************************************************************
+	//RetryQueue::attempted()
+	//*****************************************************************************
+	void RetryQueue::attempted(bool delivered)
+	{
+		m_nRetries++;
+		if (delivered)
+		{
+			m_nRecovered++;
+			pop();
+			m_nFailures = 0;
+			m_nDueMillis = millis();	//the hub is back - the next message need not wait
+			return;
+		}
+
+		if (++m_nAttempts[m_nHead] >= m_nMaxAttempts)
+		{
+			m_nDeadLetters++;
+			pop();
+		}
+		backOff();
+	}
+
+	//*****************************************************************************
+	//RetryQueue::backOff()
+	//*****************************************************************************
+	void RetryQueue::backOff()
+	{
+		if (m_nFailures < 255)
+		{
+			m_nFailures++;
+		}
+
+		unsigned long wait = m_nBaseDelay;
+		for (byte i = 1; i < m_nFailures && wait < m_nMaxDelay; i++)
+		{
+			wait <<= 1;
+		}
+		if (wait > m_nMaxDelay)
+		{
+			wait = m_nMaxDelay;
+		}
+		wait -= random(wait / 2 + 1);	//jitter
+		m_nDueMillis = millis() + wait;
+	}
+
+	//*****************************************************************************
+	//RetryQueue::pop()
+	//*****************************************************************************
+	void RetryQueue::pop()
+	{
+		m_Messages[m_nHead] = String();		//frees the text
+		m_nHead = (m_nHead + 1) % RETRY_QUEUE_SIZE;
+		m_nCount--;
+	}
+}
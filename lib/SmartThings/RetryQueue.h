@@ -0,0 +1,111 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Retry Queue
+//
+//	Holds the messages a transport could not deliver for another attempt, in
+//	order, instead of reconnecting at once and giving up.  Only the oldest message
+//	is tried; while it keeps failing, the wait before the next attempt doubles from
+//	baseDelay up to maxDelay, and each wait is shortened by a random part of up to
+//	half its length (jitter), so boards that lost the hub together do not all come
+//	back at the same moment.  New messages wait behind the held ones without an
+//	attempt of their own - a rebooting hub sees one connection per wait, not one
+//	per event.
+//
+//	A message is given up (a dead letter, counted) once it has been tried
+//	maxAttempts times, or when it comes while RETRY_QUEUE_SIZE messages are held
+//	already.  Once the oldest message goes through, the next one is tried at once.
+//
+//	SmartThings uses one for every transport that implements deliver(), unless
+//	an event log is set (see SmartThings::setRetryPolicy()).
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __RETRYQUEUE_H__
+#define __RETRYQUEUE_H__
+
+#include <Arduino.h>
+
+//Messages held for another attempt (the cap on retries in flight)
+#ifndef RETRY_QUEUE_SIZE
+	#if defined(ARDUINO_ARCH_AVR)
+		#define RETRY_QUEUE_SIZE 2
+	#else
+		#define RETRY_QUEUE_SIZE 8
+	#endif
+#endif
+
+//Attempts of one message, the first one included, before it is given up
+#ifndef RETRY_MAX_ATTEMPTS
+#define RETRY_MAX_ATTEMPTS 6
+#endif
+
+//Wait after the first failure (in milliseconds) - doubles with every failure in a row
+#ifndef RETRY_BASE_DELAY
+#define RETRY_BASE_DELAY 500
+#endif
+
+//Longest wait between two attempts (in milliseconds)
+#ifndef RETRY_MAX_DELAY
+#define RETRY_MAX_DELAY 8000
+#endif
+
+namespace st
+{
+	class RetryQueue
+	{
+	private:
+		String m_Messages[RETRY_QUEUE_SIZE];
+		byte m_nAttempts[RETRY_QUEUE_SIZE];
+		byte m_nHead;
+		byte m_nCount;
+
+		byte m_nMaxAttempts;
+		unsigned long m_nBaseDelay;
+		unsigned long m_nMaxDelay;
+		byte m_nFailures;					//failed attempts in a row
+		unsigned long m_nDueMillis;			//time of the next attempt
+
+		unsigned long m_nRetries;			//attempts made from the queue
+		unsigned long m_nRecovered;			//messages delivered from the queue
+		unsigned long m_nDeadLetters;		//messages given up
+
+		void backOff();						//schedules the next attempt after one more failure
+		void pop();
+
+	public:
+		//*******************************************************************************
+		/// @brief  Retry Queue Constructor
+		///   @param[in] maxAttempts (optional) - attempts of one message, the first one included - 1 turns retries off
+		///   @param[in] baseDelay (optional) - wait after the first failure, in milliseconds
+		///   @param[in] maxDelay (optional) - longest wait between two attempts, in milliseconds
+		//*******************************************************************************
+		RetryQueue(byte maxAttempts = RETRY_MAX_ATTEMPTS, unsigned long baseDelay = RETRY_BASE_DELAY, unsigned long maxDelay = RETRY_MAX_DELAY);
+
+		void setPolicy(byte maxAttempts, unsigned long baseDelay, unsigned long maxDelay);
+
+		//*******************************************************************************
+		/// Holds a message - after its first attempt failed (attempted == true), or unsent,
+		///   behind the ones held already.  Returns false if it was given up instead.
+		//*******************************************************************************
+		bool hold(const String &message, bool attempted);
+
+		//*******************************************************************************
+		/// Retry - when due(), try to deliver peek() and report whether it went through
+		//*******************************************************************************
+		bool due() const;
+		const String &peek() const { return m_Messages[m_nHead]; }
+		void attempted(bool delivered);
+
+		//gets
+		bool empty() const { return m_nCount == 0; }
+		byte getPending() const { return m_nCount; }
+		unsigned long getRetries() const { return m_nRetries; }
+		unsigned long getRecovered() const { return m_nRecovered; }
+		unsigned long getDeadLetters() const { return m_nDeadLetters; }
+	};
+}
+
+#endif
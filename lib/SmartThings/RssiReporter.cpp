@@ -0,0 +1,118 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - RSSI Reporter
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created
+//*******************************************************************************
+#include <RssiReporter.h>
+
+namespace st
+{
+	//*******************************************************************************
+	// RssiReporter Constructor
+	//*******************************************************************************
+	RssiReporter::RssiReporter(byte deltaDb, unsigned long maxInterval) :
+		m_nDeltaDb(deltaDb),
+		m_nMaxInterval(maxInterval),
+		m_nSmoothed16(0),
+		m_nSampleMillis(millis() - RSSI_SAMPLE_INTERVAL),	//the first sample is due at once
+		m_nSamples(0),
+		m_nReported(0),
+		m_nReportMillis(0),
+		m_nReports(0),
+		m_nPiggybacked(0)
+	{
+
+	}
+
+	//*****************************************************************************
+	//RssiReporter::setPolicy()
+	//*****************************************************************************
+	void RssiReporter::setPolicy(byte deltaDb, unsigned long maxInterval)
+	{
+		m_nDeltaDb = deltaDb > 0 ? deltaDb : 1;
+		m_nMaxInterval = maxInterval;
+	}
+
+	//*****************************************************************************
+	//RssiReporter::sampleDue()
+	//*****************************************************************************
+	bool RssiReporter::sampleDue() const
+	{
+		return millis() - m_nSampleMillis >= RSSI_SAMPLE_INTERVAL;
+	}
+
+	//*****************************************************************************
+	//RssiReporter::sample()
+	//*****************************************************************************
+	void RssiReporter::sample(long dBm)
+	{
+		m_nSampleMillis = millis();
+		if (dBm == 0)
+		{
+			return;
+		}
+
+		if (m_nSamples++ == 0)
+		{
+			m_nSmoothed16 = dBm * 16;
+		}
+		else
+		{
+			m_nSmoothed16 += (dBm * 16 - m_nSmoothed16) / 4;
+		}
+	}
+
+	//*****************************************************************************
+	//RssiReporter::reportDue()
+	//*****************************************************************************
+	bool RssiReporter::reportDue() const
+	{
+		if (m_nSamples == 0)
+		{
+			return false;
+		}
+		if (m_nReported == 0 || millis() - m_nReportMillis >= m_nMaxInterval)
+		{
+			return true;
+		}
+		long change = getSmoothed() - m_nReported;
+		return change >= m_nDeltaDb || -change >= m_nDeltaDb;
+	}
+
+	//*****************************************************************************
+	//RssiReporter::worthPiggybacking()
+	//*****************************************************************************
+	bool RssiReporter::worthPiggybacking() const
+	{
+		if (m_nSamples == 0)
+		{
+			return false;
+		}
+		if (m_nReported == 0 || millis() - m_nReportMillis >= m_nMaxInterval / 2)
+		{
+			return true;
+		}
+		long change = getSmoothed() - m_nReported;
+		long halfDelta = m_nDeltaDb > 1 ? m_nDeltaDb / 2 : 1;
+		return change >= halfDelta || -change >= halfDelta;
+	}
+
+	//*****************************************************************************
+	//RssiReporter::reported()
+	//*****************************************************************************
+	long RssiReporter::reported(bool piggybacked)
+	{
+		m_nReported = getSmoothed();
+		m_nReportMillis = millis();
+		m_nReports++;
+		if (piggybacked)
+		{
+			m_nPiggybacked++;
+		}
+		return m_nReported;
+	}
+}
@@ -0,0 +1,95 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - RSSI Reporter
+//
+//	Decides when a transport tells the Hub its WiFi signal strength ("rssi <dBm>").
+//	The RSSI is sampled every RSSI_SAMPLE_INTERVAL and smoothed (exponential moving
+//	average, a quarter of each new sample).  The smoothed value is reported when it
+//	has moved deltaDb or more since the last report, or when maxInterval has passed
+//	without one - not on a fixed schedule, so a node whose signal is steady sends a
+//	report every maxInterval instead of every minute.
+//
+//	Piggybacking: a report that is not due yet is still worth sending when it costs
+//	no connection of its own - while another message goes out anyway, half of deltaDb,
+//	or half of maxInterval without a report, is enough.
+//
+//	SmartThings keeps one for the transports that report the RSSI (see
+//	SmartThings::setRssiReporting()).
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created
+//*******************************************************************************
+#ifndef __RSSIREPORTER_H__
+#define __RSSIREPORTER_H__
+
+#include <Arduino.h>
+
+//Time between two readings of the RSSI (in milliseconds)
+#ifndef RSSI_SAMPLE_INTERVAL
+#define RSSI_SAMPLE_INTERVAL 5000
+#endif
+
+//Change of the smoothed RSSI that is reported at once (in dB)
+#ifndef RSSI_REPORT_DELTA
+#define RSSI_REPORT_DELTA 4
+#endif
+
+//Longest time without an RSSI report (in milliseconds)
+#ifndef RSSI_TX_INTERVAL
+#define RSSI_TX_INTERVAL 600000
+#endif
+
+namespace st
+{
+	class RssiReporter
+	{
+	private:
+		byte m_nDeltaDb;
+		unsigned long m_nMaxInterval;
+
+		long m_nSmoothed16;					//smoothed RSSI in 1/16 dB
+		unsigned long m_nSampleMillis;		//time of the last sample
+		unsigned long m_nSamples;
+
+		long m_nReported;					//value of the last report, 0 == none yet
+		unsigned long m_nReportMillis;		//time of the last report
+		unsigned long m_nReports;			//reports sent, piggybacked ones included
+		unsigned long m_nPiggybacked;		//reports sent along with another message
+
+	public:
+		//*******************************************************************************
+		/// @brief  RSSI Reporter Constructor
+		///   @param[in] deltaDb (optional) - change of the smoothed RSSI that is reported at once
+		///   @param[in] maxInterval (optional) - longest time without a report, in milliseconds
+		//*******************************************************************************
+		RssiReporter(byte deltaDb = RSSI_REPORT_DELTA, unsigned long maxInterval = RSSI_TX_INTERVAL);
+
+		void setPolicy(byte deltaDb, unsigned long maxInterval);
+
+		//*******************************************************************************
+		/// Sampling - when sampleDue(), read the RSSI and pass it to sample() (0 == no reading)
+		//*******************************************************************************
+		bool sampleDue() const;
+		void sample(long dBm);
+
+		//*******************************************************************************
+		/// Reporting - reportDue() when a report must go out on its own, worthPiggybacking()
+		///   when one may go along with another message.  Either way, reported() takes the
+		///   smoothed value as sent.
+		//*******************************************************************************
+		bool reportDue() const;
+		bool worthPiggybacking() const;
+		long reported(bool piggybacked);
+
+		//gets
+		long getSmoothed() const { return (m_nSmoothed16 - 8) / 16; }	//rounded to the nearest dB (the value is negative)
+		long getReported() const { return m_nReported; }
+		unsigned long getSamples() const { return m_nSamples; }
+		unsigned long getReports() const { return m_nReports; }
+		unsigned long getPiggybacked() const { return m_nPiggybacked; }
+	};
+}
+
+#endif
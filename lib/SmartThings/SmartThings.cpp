@@ -6,8 +6,14 @@
 //
 //	History
 //	2017-02-04  Dan Ogorchock  Created
+//	2026-10-16  Per Ivar Nerseth  Added batch mode
+//	2026-10-16  Per Ivar Nerseth  Added send/connect counters and writeMetrics()
+//	2026-10-16  Per Ivar Nerseth  Added the store-and-forward event log
+//	2026-10-16  Per Ivar Nerseth  Added deliverOrKeep() and retryKept() - the retry queue is shared by the transports
+//	2026-10-17  Per Ivar Nerseth  Added the RSSI reporter, shared by the WiFi transports
 //*******************************************************************************
 #include <SmartThings.h>
+#include <EventLog.h>
 
 namespace st
 {
@@ -18,7 +24,15 @@ namespace st
 		_calloutFunction(callout),
 		_shieldType(shieldType),
 		_isDebugEnabled(enableDebug),
-		m_nTransmitInterval(transmitInterval)
+		m_nTransmitInterval(transmitInterval),
+		m_bBatchMode(false),
+		_metricsFunction(0),
+		m_nSendCount(0),
+		m_nSendMicrosTotal(0),
+		m_nSendMicrosMax(0),
+		m_nConnectFailures(0),
+		m_nRSSI(0),
+		m_pEventLog(0)
 	{
 
 	}
@@ -31,4 +45,211 @@ namespace st
 
 	}
 
+	//*****************************************************************************
+	//SmartThings::recordSend()
+	//*****************************************************************************
+	void SmartThings::recordSend(unsigned long startMicros)
+	{
+		unsigned long elapsed = micros() - startMicros;
+		m_nSendCount++;
+		m_nSendMicrosTotal += elapsed;
+		if (elapsed > m_nSendMicrosMax)
+		{
+			m_nSendMicrosMax = elapsed;
+		}
+	}
+
+	//*****************************************************************************
+	//SmartThings::storeIfBacklogged()
+	//*****************************************************************************
+	bool SmartThings::storeIfBacklogged(const String &message)
+	{
+		if (m_pEventLog == 0 || m_pEventLog->getPending() == 0)
+		{
+			return false;
+		}
+		storeUndelivered(message);	//sending it now would overtake the events stored before it
+		return true;
+	}
+
+	//*****************************************************************************
+	//SmartThings::storeUndelivered()
+	//*****************************************************************************
+	void SmartThings::storeUndelivered(const String &message)
+	{
+		if (m_pEventLog == 0)
+		{
+			return;
+		}
+
+		//one record per event, so that a batch is replayed one event at a time
+		unsigned int start = 0;
+		while (start < message.length())
+		{
+			int end = message.indexOf('\n', start);
+			unsigned int length = (end < 0 ? message.length() : (unsigned int)end) - start;
+			if (length > 0)
+			{
+				m_pEventLog->append(message.substring(start, start + length));
+			}
+			start += length + 1;
+		}
+
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("SmartThings: stored for later, events waiting = "));
+			Serial.println(m_pEventLog->getPending());
+		}
+	}
+
+	//*****************************************************************************
+	//SmartThings::replayStored()
+	//*****************************************************************************
+	void SmartThings::replayStored()
+	{
+		if (m_pEventLog == 0 || !m_pEventLog->replayDue())
+		{
+			return;
+		}
+
+		String message;
+		long ageMillis;
+		if (m_pEventLog->peek(message, ageMillis))
+		{
+			m_pEventLog->replayed(deliver(message, ageMillis));
+		}
+	}
+
+	//*****************************************************************************
+	//SmartThings::deliverOrKeep()
+	//*****************************************************************************
+	bool SmartThings::deliverOrKeep(const String &message)
+	{
+		if (storeIfBacklogged(message))
+		{
+			return true;
+		}
+		if (m_pEventLog == 0 && !m_Retry.empty())
+		{
+			//the hub is failing - wait behind the held messages instead of opening another connection
+			return m_Retry.hold(message, false);
+		}
+		if (deliver(message, -1))
+		{
+			return true;
+		}
+		if (m_pEventLog)
+		{
+			storeUndelivered(message);
+			return true;
+		}
+
+		bool held = m_Retry.hold(message, true);
+		if (_isDebugEnabled)
+		{
+			Serial.print(held ? F("SmartThings: held for retry, messages waiting = ") : F("SmartThings: given up, dead letters = "));
+			Serial.println(held ? m_Retry.getPending() : m_Retry.getDeadLetters());
+		}
+		return held;
+	}
+
+	//*****************************************************************************
+	//SmartThings::retryKept()
+	//*****************************************************************************
+	void SmartThings::retryKept()
+	{
+		replayStored();
+		if (m_Retry.due())
+		{
+			m_Retry.attempted(deliver(m_Retry.peek(), -1));
+		}
+	}
+
+	//*****************************************************************************
+	//SmartThings::sampleRssi()
+	//*****************************************************************************
+	void SmartThings::sampleRssi(long dBm)
+	{
+		if (dBm != 0)
+		{
+			m_nRSSI = dBm;
+		}
+		m_Rssi.sample(dBm);
+	}
+
+	//*****************************************************************************
+	//SmartThings::takeRssiReport()
+	//*****************************************************************************
+	String SmartThings::takeRssiReport(bool piggybacked)
+	{
+		String report(F("rssi "));
+		report += m_Rssi.reported(piggybacked);
+		if (_isDebugEnabled)
+		{
+			Serial.println(report);
+		}
+		return report;
+	}
+
+	//*****************************************************************************
+	//SmartThings::appendRssi()
+	//*****************************************************************************
+	void SmartThings::appendRssi(String &message)
+	{
+		//one more line of the same POST - only the hub's batch handler splits a message on '\n'
+		if (m_bBatchMode && message.length() > 0 && m_Rssi.worthPiggybacking())
+		{
+			message += '\n';
+			message += takeRssiReport(true);
+		}
+	}
+
+	//*****************************************************************************
+	//SmartThings::writeMetrics()
+	//*****************************************************************************
+	void SmartThings::writeMetrics(Print &out)
+	{
+		out.print(F("st_send_count "));
+		out.println(m_nSendCount);
+		out.print(F("st_send_latency_us_sum "));
+		out.println(m_nSendMicrosTotal);
+		out.print(F("st_send_latency_us_max "));
+		out.println(m_nSendMicrosMax);
+		out.print(F("st_connect_failures "));
+		out.println(m_nConnectFailures);
+		if (m_nRSSI != 0)
+		{
+			out.print(F("st_rssi_dbm "));
+			out.println(m_nRSSI);
+			out.print(F("st_rssi_reports "));
+			out.println(m_Rssi.getReports());
+			out.print(F("st_rssi_piggybacked "));
+			out.println(m_Rssi.getPiggybacked());
+		}
+		out.print(F("st_retry_pending "));
+		out.println(m_Retry.getPending());
+		out.print(F("st_retry_attempts "));
+		out.println(m_Retry.getRetries());
+		out.print(F("st_retry_recovered "));
+		out.println(m_Retry.getRecovered());
+		out.print(F("st_retry_dead_letters "));
+		out.println(m_Retry.getDeadLetters());
+		if (m_pEventLog)
+		{
+			out.print(F("st_eventlog_pending "));
+			out.println(m_pEventLog->getPending());
+			out.print(F("st_eventlog_stored "));
+			out.println(m_pEventLog->getStored());
+			out.print(F("st_eventlog_replayed "));
+			out.println(m_pEventLog->getReplayed());
+			out.print(F("st_eventlog_dropped "));
+			out.println(m_pEventLog->getDropped());
+		}
+
+		if (_metricsFunction)
+		{
+			_metricsFunction(out);
+		}
+	}
+
 }
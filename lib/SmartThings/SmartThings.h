@@ -6,19 +6,35 @@
 //
 //	History
 //	2017-02-04  Dan Ogorchock  Created
+//	2026-10-16  Per Ivar Nerseth  Added batch mode - several queued messages sent as one, one message per line
+//	2026-10-16  Per Ivar Nerseth  Added keep-alive mode setting
+//	2026-10-16  Per Ivar Nerseth  Added send/connect counters and writeMetrics() for a /metrics page
+//	2026-10-16  Per Ivar Nerseth  Added the store-and-forward event log setting
+//	2026-10-16  Per Ivar Nerseth  Added isReady()
+//	2026-10-16  Per Ivar Nerseth  Added the retry policy - undelivered messages are retried with backoff (see RetryQueue.h)
+//	2026-10-17  Per Ivar Nerseth  Added RSSI reporting - smoothed, sent on change or after a max interval (see RssiReporter.h)
 //*******************************************************************************
 #ifndef __SMARTTHINGS_H__ 
 #define __SMARTTHINGS_H__
 
 #include <Arduino.h>
+#include <RetryQueue.h>
+#include <RssiReporter.h>
 
 //*******************************************************************************
 // Callout Function Definition for Messages Received from SmartThings 
 //*******************************************************************************
 typedef void SmartThingsCallout_t(String message);
 
+//*******************************************************************************
+// Callout Function Definition for writing the application's metrics (see SmartThings::writeMetrics)
+//*******************************************************************************
+typedef void SmartThingsMetrics_t(Print &out);
+
 namespace st
 {
+	class EventLog;
+
 	class SmartThings
 	{
 	private:
@@ -28,6 +44,35 @@ namespace st
 		bool _isDebugEnabled;
 		String _shieldType;
 		int m_nTransmitInterval;
+		bool m_bBatchMode;
+
+		//Transport statistics - kept by the derived classes, reported by writeMetrics()
+		SmartThingsMetrics_t *_metricsFunction;
+		unsigned long m_nSendCount;			//send() calls
+		unsigned long m_nSendMicrosTotal;	//time spent in send(), in microseconds (wraps after ~71 minutes in total)
+		unsigned long m_nSendMicrosMax;		//longest send(), in microseconds
+		unsigned long m_nConnectFailures;	//connections to the Hub that could not be opened
+		long m_nRSSI;						//last WiFi signal strength in dBm, 0 == unknown
+
+		void recordSend(unsigned long startMicros);	//counts one send() that started at micros() == startMicros
+
+		//Store-and-forward - see setEventLog()
+		EventLog *m_pEventLog;
+		virtual bool deliver(const String &message, long ageMillis) { return false; }	//one delivery attempt, ageMillis >= 0 for a replayed event
+		bool storeIfBacklogged(const String &message);	//while events wait in the log, new ones are stored behind them - true if stored
+		void storeUndelivered(const String &message);	//stores an event (or each line of a batch) that could not be delivered
+		void replayStored();							//delivers the oldest stored event, when the log's replay interval allows
+
+		//Retries - see setRetryPolicy()
+		RetryQueue m_Retry;
+		bool deliverOrKeep(const String &message);		//delivers, or keeps for later (event log or retry queue) - false if given up
+		void retryKept();								//replays or retries one kept message, if one is due - call from run()
+
+		//RSSI reports - see setRssiReporting()
+		RssiReporter m_Rssi;
+		void sampleRssi(long dBm);						//a reading of the signal strength, 0 == none
+		String takeRssiReport(bool piggybacked);		//"rssi <dBm>", counted as sent
+		void appendRssi(String &message);				//in batch mode, adds a report to an outgoing message if one is worth sending
 
 	public:
 
@@ -61,6 +106,66 @@ namespace st
 		//*******************************************************************************
 		virtual int getTransmitInterval() const { return m_nTransmitInterval; }
 
+		//*******************************************************************************
+		/// Ready - false while send() cannot deliver anything (e.g. WiFi is still joining the network).
+		///   st::Everything keeps its messages queued, and its devices running, until it is true.
+		//*******************************************************************************
+		virtual bool isReady() const { return true; }
+
+		//*******************************************************************************
+		/// Batch Mode - send() is passed every queued message at once, one per line
+		///   Only transports that can carry multi-line messages support it (returns false otherwise).
+		///   The hub's device handler must split the message on '\n'.
+		//*******************************************************************************
+		virtual bool setBatchMode(bool enable) { m_bBatchMode = false; return !enable; }
+		bool getBatchMode() const { return m_bBatchMode; }
+
+		//*******************************************************************************
+		/// Keep-Alive Mode - one persistent connection to the Hub is reused for every send()
+		///   Only transports that implement it accept it (returns false otherwise).
+		//*******************************************************************************
+		virtual bool setKeepAlive(bool enable) { return !enable; }
+
+		//*******************************************************************************
+		/// Event Log - events that cannot be delivered are kept in flash and replayed in order
+		///   once the hub can be reached again (see EventLog.h).  The log must have been begin()'d.
+		///   Only transports that implement deliver() accept it (returns false otherwise).
+		//*******************************************************************************
+		virtual bool setEventLog(EventLog *log) { return log == 0; }
+		EventLog *getEventLog() const { return m_pEventLog; }
+
+		//*******************************************************************************
+		/// Retry Policy - a message that cannot be delivered is held and tried again from run(),
+		///   waiting baseDelay, then twice as long after every further failure (with jitter) up to maxDelay.
+		///   After maxAttempts attempts, or when RETRY_QUEUE_SIZE messages are held already, it is given up
+		///   and counted as a dead letter.  maxAttempts = 1 turns retries off.  Applies to the transports
+		///   that implement deliver(), and only while no event log is set (the log keeps those messages).
+		//*******************************************************************************
+		void setRetryPolicy(byte maxAttempts, unsigned long baseDelay = RETRY_BASE_DELAY, unsigned long maxDelay = RETRY_MAX_DELAY) { m_Retry.setPolicy(maxAttempts, baseDelay, maxDelay); }
+		const RetryQueue &getRetryQueue() const { return m_Retry; }
+
+		//*******************************************************************************
+		/// RSSI Reporting - transports on WiFi sample the signal strength every RSSI_SAMPLE_INTERVAL,
+		///   smooth it, and send "rssi <dBm>" to the Hub when it has moved deltaDb or more since the
+		///   last report, or after maxInterval without one.  In batch mode half that change rides
+		///   along with the next outgoing message, as one more line, at no extra connection.
+		//*******************************************************************************
+		void setRssiReporting(byte deltaDb, unsigned long maxInterval = RSSI_TX_INTERVAL) { m_Rssi.setPolicy(deltaDb, maxInterval); }
+		const RssiReporter &getRssiReporter() const { return m_Rssi; }
+
+		//*******************************************************************************
+		/// Metrics - plain text, one "name value" line per metric (Prometheus text format)
+		///   writeMetrics() writes the transport's own counters, then calls the metrics callout,
+		///   which adds the application's.  Transports with an HTTP server serve it on GET /metrics.
+		//*******************************************************************************
+		void setMetricsCallout(SmartThingsMetrics_t *metrics) { _metricsFunction = metrics; }
+		void writeMetrics(Print &out);
+
+		unsigned long getSendCount() const { return m_nSendCount; }
+		unsigned long getSendMicrosMax() const { return m_nSendMicrosMax; }
+		unsigned long getConnectFailures() const { return m_nConnectFailures; }
+
+
 	};
 
 }
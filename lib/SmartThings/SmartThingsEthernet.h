@@ -8,6 +8,8 @@
 //	2017-02-04  Dan Ogorchock  Created
 //  2017-05-02  Dan Ogorchock  Add support for W5500 Ethernet2 Shield
 //  2018-01-06  Dan Ogorchock  Added RSSI Interval as user-definable interval
+//  2026-10-16  Per Ivar Nerseth  Batch mode supported - the batch is sent as the body of one HTTP POST
+//  2026-10-17  Per Ivar Nerseth  RSSI_TX_INTERVAL moved to RssiReporter.h - it is now the longest time between RSSI reports
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSETHERNET_H__ 
@@ -15,10 +17,7 @@
 
 #include "SmartThings.h"
 
-//Adjust the RSSI Transmit Interval below as you see fit (in milliseconds)
-//  Note:  When the board first boots, it transmits frequently, then slows over 
-//         time to the interval below.
-#define RSSI_TX_INTERVAL 60000
+//The RSSI is reported when it changes, and at least every RSSI_TX_INTERVAL - see RssiReporter.h
 
 //*******************************************************************************
 // Using Ethernet Shield
@@ -99,6 +98,10 @@ namespace st
 		//*******************************************************************************
 		virtual void send(String message) = 0; //all derived classes must implement this pure virtual function
 
+		//*******************************************************************************
+		/// Batch Mode - one HTTP POST per batch instead of one per message (off by default)
+		//*******************************************************************************
+		virtual bool setBatchMode(bool enable) { m_bBatchMode = enable; return true; }
 
 	};
 }
@@ -0,0 +1,535 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - HTTP transport core
+//
+//	The HTTP engine of the LAN transports - SmartThingsESP8266WiFi,
+//	SmartThingsESP32WiFi, SmartThingsWiFi101, SmartThingsWiFiEsp,
+//	SmartThingsEthernetW5100 and SmartThingsEthernetW5500, and SmartThingsNative
+//	on a Linux host.  It serves the Hub's requests on st_server (st_connections,
+//	GET /metrics), posts events to the Hub with st_client (one connection per
+//	message or keep-alive, EVENT-AGE for replayed events), reports the RSSI when it
+//	changes (RssiReporter), and retries or stores what it could not deliver.
+//
+//	Server and Client are the classes of the network library (WiFiServer and
+//	WiFiClient, EthernetServer and EthernetClient, ...).  SLOTS is the number of
+//	requests served at the same time - see HttpConnections.h: more than one only
+//	for servers that hand out each connection once (ESP8266, ESP32, the host),
+//	and only those are answered 503 when every slot is busy.
+//
+//	A transport derives from SmartThingsHttpCore<Server, Client, SLOTS>,
+//	implements init(), and overrides the hooks that apply to its network:
+//		linkUp()			- false while no connection to the Hub can be opened (e.g. WiFi not joined)
+//		readRSSI()			- signal strength reported to the Hub as "rssi <dBm>", 0 == none (Ethernet)
+//		hubConnected()		- after st_client connected, e.g. to turn Nagle's algorithm off
+//		hubUnreachable()	- after a failed connect, e.g. to restart the network module
+//		writeLinkMetrics()	- its own lines for GET /metrics
+//	A transport that overrides run() calls SmartThingsHttpCore::run() from it.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created from the copies of run() and send() in the transports
+//	2026-10-17  Per Ivar Nerseth  The RSSI is reported when it changes, not on a schedule, and rides along with batches
+//	2026-10-17  Per Ivar Nerseth  A POST counts as delivered only once written; no reply on a fresh keep-alive connection is a failure
+//*******************************************************************************
+#ifndef __SMARTTHINGSHTTPCORE_H__
+#define __SMARTTHINGSHTTPCORE_H__
+
+#include "SmartThingsEthernet.h"
+#include "HttpConnections.h"
+
+//Maximum time to wait for the Hub's reply to a POST in keep-alive mode (in milliseconds)
+#ifndef HUB_RESPONSE_TIMEOUT
+#define HUB_RESPONSE_TIMEOUT 1000
+#endif
+
+namespace st
+{
+	template <class Server, class Client, byte SLOTS> class SmartThingsHttpCore: public SmartThingsEthernet
+	{
+	public:
+		typedef HttpConnections<Client, SLOTS> Connections;
+
+	private:
+		//reply of the Hub to a POST on a kept-alive connection
+		enum HubResponse
+		{
+			RESPONSE_NONE,	//no reply - the connection is broken or timed out
+			RESPONSE_CLOSE,	//reply received, the Hub closes the connection
+			RESPONSE_KEEP	//reply received, the connection stays open
+		};
+
+		bool writeRequest(const String &message, long ageMillis);
+		HubResponse readResponse();
+		bool connectHub();
+		bool sendOnce(const String &message, long ageMillis);
+		bool sendKeepAlive(const String &message, long ageMillis);
+		void writeMetricsResponse(Client &client);
+
+	protected:
+		Server st_server; //server
+		Connections st_connections; //requests being read
+		Client st_client; //client
+		String st_request; //request to the Hub, reused
+		bool st_keepAlive;
+		unsigned long st_firstEventMillis; //first event delivered to the Hub, in milliseconds since power-on
+
+		//one delivery attempt - false if the Hub could not be reached
+		virtual bool deliver(const String &message, long ageMillis);
+
+		//hooks for the network - see the top of this file
+		virtual bool linkUp() { return true; }
+		virtual long readRSSI() { return 0; }
+		virtual void hubConnected() {}
+		virtual void hubUnreachable() {}
+		virtual void writeLinkMetrics(Print &out) {}
+
+	public:
+		//*******************************************************************************
+		/// Constructors - the arguments of the SmartThingsEthernet constructors (see SmartThingsEthernet.h)
+		//*******************************************************************************
+		SmartThingsHttpCore(IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval, bool DHCP = false) :
+			SmartThingsEthernet(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, DHCP),
+			st_server(serverPort), st_keepAlive(false), st_firstEventMillis(0)
+		{
+		}
+
+		SmartThingsHttpCore(IPAddress localIP, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval, bool DHCP = false) :
+			SmartThingsEthernet(localIP, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, DHCP),
+			st_server(serverPort), st_keepAlive(false), st_firstEventMillis(0)
+		{
+		}
+
+		SmartThingsHttpCore(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval, bool DHCP = true) :
+			SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, DHCP),
+			st_server(serverPort), st_keepAlive(false), st_firstEventMillis(0)
+		{
+		}
+
+		//*******************************************************************************
+		/// Run - RSSI and retries while the link is up, then the requests of st_connections
+		//*******************************************************************************
+		virtual void run(void);
+
+		//*******************************************************************************
+		/// Send Message to the Hub - what cannot be delivered is kept (event log) or held for a retry
+		//*******************************************************************************
+		virtual void send(String message);
+
+		//*******************************************************************************
+		/// Keep-Alive Mode - reuse st_client across sends instead of reconnecting for each (off by default)
+		//*******************************************************************************
+		virtual bool setKeepAlive(bool enable);
+
+		//*******************************************************************************
+		/// Event Log - events are stored while the Hub cannot be reached, and replayed from run() (see EventLog.h)
+		//*******************************************************************************
+		virtual bool setEventLog(EventLog *log)
+		{
+			m_pEventLog = log;
+			return true;
+		}
+
+		unsigned long getFirstEventMillis() const { return st_firstEventMillis; }
+	};
+
+	//*****************************************************************************
+	// Run
+	//*****************************************************************************
+	template <class Server, class Client, byte SLOTS> void SmartThingsHttpCore<Server, Client, SLOTS>::run(void)
+	{
+		if (linkUp())
+		{
+			//the signal strength - sent on its own only when it has moved, or not been sent for long (see RssiReporter)
+			if (m_Rssi.sampleDue())
+			{
+				sampleRssi(readRSSI());
+			}
+			if (m_Rssi.reportDue())
+			{
+				send(takeRssiReport(false));
+			}
+
+			//events stored, or held for a retry, while the Hub could not be reached
+			retryKept();
+		}
+
+		//new connections - a server that hands each one out once is answered 503 when every slot is busy,
+		//one that offers the same connection again (Ethernet, WiFi101, WiFiEsp) simply offers it later
+		Client newClient = st_server.available();
+		if (newClient && !st_connections.accept(newClient) && SLOTS > 1)
+		{
+			newClient.println(F("HTTP/1.1 503 Service Unavailable"));
+			newClient.println();
+			newClient.stop();
+		}
+
+		//answer the requests that are complete - nothing here waits for a client (see HttpConnections)
+		typename Connections::Connection *connection;
+		while ((connection = st_connections.poll()) != NULL)
+		{
+			Client &client = connection->client;
+			HttpRequestParser &request = connection->request;
+
+			bool isMetrics = request.complete() && request.isMethod("GET") && strcmp(request.getPath(), "metrics") == 0;
+			if (isMetrics)
+			{
+				//runtime statistics - answered here, not passed to the callout
+				writeMetricsResponse(client);
+			}
+			else if (request.complete())
+			{
+				//now output HTML data header
+				if (request.commandLength() > 0)
+				{
+					client.println(F("HTTP/1.1 200 OK")); //send new page
+					client.println();
+				}
+				else
+				{
+					client.println(F("HTTP/1.1 204 No Content"));
+					client.println();
+					client.println();
+					if (_isDebugEnabled)
+					{
+						Serial.println(F("No Valid Data Received"));
+					}
+				}
+			}
+			else if (request.getState() == HttpRequestParser::FAILED)
+			{
+				client.println(request.getErrorStatus());
+				client.println();
+				if (_isDebugEnabled)
+				{
+					Serial.print(F("SmartThings.run() - Request rejected: "));
+					Serial.println(request.getErrorStatus());
+				}
+			}
+
+			//stopping client
+			st_connections.close(*connection);
+
+			//Handle the received data after cleaning up the network connection
+			if (!isMetrics && request.complete() && request.commandLength() > 0)
+			{
+				if (_isDebugEnabled)
+				{
+					Serial.print(F("Handling request from ST. command = "));
+					Serial.println(request.command());
+				}
+				//Pass the message to user's SmartThings callout function
+				_calloutFunction(String(request.command()));
+			}
+		}
+	}
+
+	//*******************************************************************************
+	/// Answer GET /metrics with the transport's and the application's statistics
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> void SmartThingsHttpCore<Server, Client, SLOTS>::writeMetricsResponse(Client &client)
+	{
+		long rssi = linkUp() ? readRSSI() : 0;
+		if (rssi != 0)
+		{
+			m_nRSSI = rssi;
+		}
+		client.println(F("HTTP/1.1 200 OK"));
+		client.println(F("Content-Type: text/plain; version=0.0.4"));
+		client.println(F("Connection: close"));
+		client.println();
+		//connections to st_server - see HttpConnections
+		client.print(F("st_http_connections_open "));
+		client.println(st_connections.getOpen());
+		client.print(F("st_http_timeouts "));
+		client.println(st_connections.getTimeouts());
+		client.print(F("st_http_dropped "));
+		client.println(st_connections.getDropped());
+		client.print(F("st_http_busy "));
+		client.println(st_connections.getBusy());
+		client.print(F("st_first_event_ms "));
+		client.println(st_firstEventMillis);
+		writeLinkMetrics(client);
+		writeMetrics(client);
+	}
+
+	//*******************************************************************************
+	/// Send Message out over the network to the Hub
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> void SmartThingsHttpCore<Server, Client, SLOTS>::send(String message)
+	{
+		unsigned long start = micros();
+
+		//in batch mode, an RSSI report rides along
+		appendRssi(message);
+
+		//what cannot be delivered is kept in the event log, or held for a retry from run()
+		deliverOrKeep(message);
+
+		recordSend(start);
+	}
+
+	//*******************************************************************************
+	/// Deliver one message to the Hub
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> bool SmartThingsHttpCore<Server, Client, SLOTS>::deliver(const String &message, long ageMillis)
+	{
+		if (!linkUp())
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("***** SmartThings.send() - Network down, message kept for later *****"));
+			}
+			return false; //no connection can be opened - do not wait for connect() to fail
+		}
+
+		bool delivered = st_keepAlive ? sendKeepAlive(message, ageMillis) : sendOnce(message, ageMillis);
+		if (delivered && st_firstEventMillis == 0)
+		{
+			st_firstEventMillis = millis();
+			if (_isDebugEnabled)
+			{
+				Serial.print(F("SmartThings: first event delivered, ms after power-on = "));
+				Serial.println(st_firstEventMillis);
+			}
+		}
+		return delivered;
+	}
+
+	//*******************************************************************************
+	/// Open st_client to the Hub - false (counted) if it could not be opened
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> bool SmartThingsHttpCore<Server, Client, SLOTS>::connectHub()
+	{
+		//Make sure the client is stopped, to free up socket for new conenction
+		st_client.stop();
+
+		if (st_client.connect(st_hubIP, st_hubPort))
+		{
+			hubConnected();
+			return true;
+		}
+
+		//connection failed;
+		m_nConnectFailures++;
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("***********************************************************"));
+			Serial.println(F("***** SmartThings.send() - Ethernet Connection Failed *****"));
+			Serial.println(F("***********************************************************"));
+			Serial.print(F("hubIP = "));
+			Serial.print(st_hubIP);
+			Serial.print(F(" "));
+			Serial.print(F("hubPort = "));
+			Serial.println(st_hubPort);
+		}
+		hubUnreachable();
+		//no second connect here - the message is retried from run(), after a backoff
+		return false;
+	}
+
+	//*******************************************************************************
+	/// One POST on a new connection, which the Hub closes after its reply
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> bool SmartThingsHttpCore<Server, Client, SLOTS>::sendOnce(const String &message, long ageMillis)
+	{
+		//delivered once the whole request is written - a connection that breaks before is a failure
+		bool delivered = connectHub() && writeRequest(message, ageMillis);
+
+		// read any data returned from the POST
+		uint8_t discard[32];
+		while (st_client.connected())
+		{
+			st_client.read(discard, sizeof(discard)); //gets bytes from ethernet buffer
+		}
+
+		delay(1);
+		st_client.stop();
+		return delivered;
+	}
+
+	//*******************************************************************************
+	/// Keep-Alive Mode
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> bool SmartThingsHttpCore<Server, Client, SLOTS>::setKeepAlive(bool enable)
+	{
+		if (st_keepAlive && !enable)
+		{
+			st_client.stop();
+		}
+		st_keepAlive = enable;
+		return true;
+	}
+
+	//*******************************************************************************
+	/// Send one message on the kept-alive connection
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> bool SmartThingsHttpCore<Server, Client, SLOTS>::sendKeepAlive(const String &message, long ageMillis)
+	{
+		//Reuse the open connection.  If the Hub has dropped it since the last send, no reply comes back -
+		//reconnect and send once more.
+		for (byte attempt = 0; attempt < 2; attempt++)
+		{
+			bool reused = st_client.connected();
+			if (!reused && !connectHub())
+			{
+				return false;
+			}
+
+			HubResponse response = writeRequest(message, ageMillis) ? readResponse() : RESPONSE_NONE;
+			if (response == RESPONSE_KEEP)
+			{
+				return true;
+			}
+			st_client.stop();
+			if (response == RESPONSE_CLOSE)
+			{
+				return true;
+			}
+			if (!reused)
+			{
+				//no reply on a fresh connection either - not delivered.  If the Hub did get it, the event log
+				//replays it with its EVENT-AGE, and the retry queue holds it for one more attempt
+				return false;
+			}
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("***** SmartThings.send() - Keep-alive Connection Lost, Reconnecting *****"));
+			}
+		}
+		return false;
+	}
+
+	//*******************************************************************************
+	/// Write one POST of message to st_client - false if it was not written whole
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> bool SmartThingsHttpCore<Server, Client, SLOTS>::writeRequest(const String &message, long ageMillis)
+	{
+		//assembled first and written at once - with Nagle's algorithm off, each write to st_client is a packet of its own
+		st_request = F("POST / HTTP/1.1\r\nHOST: ");
+		for (byte i = 0; i < 4; i++)
+		{
+			if (i > 0)
+			{
+				st_request += '.';
+			}
+			st_request += st_hubIP[i];
+		}
+		st_request += ':';
+		st_request += st_hubPort;
+		st_request += F("\r\nCONTENT-TYPE: text\r\nCONTENT-LENGTH: ");
+		st_request += message.length();
+		if (ageMillis >= 0)
+		{
+			st_request += F("\r\nEVENT-AGE: "); //a replayed event - captured this many milliseconds ago
+			st_request += ageMillis;
+		}
+		if (st_keepAlive)
+		{
+			st_request += F("\r\nCONNECTION: keep-alive\r\n\r\n");
+			st_request += message; //nothing may follow the body on a connection that is reused
+		}
+		else
+		{
+			st_request += F("\r\n\r\n");
+			st_request += message;
+			st_request += F("\r\n");
+		}
+		return st_client.write((const uint8_t *)st_request.c_str(), st_request.length()) == st_request.length();
+	}
+
+	//*******************************************************************************
+	/// Read the Hub's reply to a POST - headers, then exactly Content-Length bytes of body
+	//*******************************************************************************
+	template <class Server, class Client, byte SLOTS> typename SmartThingsHttpCore<Server, Client, SLOTS>::HubResponse SmartThingsHttpCore<Server, Client, SLOTS>::readResponse()
+	{
+		unsigned long start = millis();
+		uint8_t chunk[64]; //read in chunks - the Hub sends nothing after its reply until the next request
+		int have = 0;
+		int pos = 0;
+		char line[64];
+		byte len = 0;
+		bool statusLine = true;
+		bool keepAlive = true;
+		long contentLength = 0;
+
+		//headers, one line at a time - an empty line ends them
+		while (true)
+		{
+			if (pos == have)
+			{
+				have = st_client.available() ? st_client.read(chunk, sizeof(chunk)) : 0;
+				pos = 0;
+				if (have <= 0)
+				{
+					have = 0;
+					if (!st_client.connected() || millis() - start > HUB_RESPONSE_TIMEOUT)
+					{
+						return RESPONSE_NONE;
+					}
+					yield();
+					continue;
+				}
+			}
+
+			char c = chunk[pos++];
+			if (c == '\r')
+			{
+				continue;
+			}
+			if (c != '\n')
+			{
+				if (len < sizeof(line) - 1)
+				{
+					line[len++] = c;
+				}
+				continue;
+			}
+
+			line[len] = 0;
+			if (len == 0)
+			{
+				break;
+			}
+			if (statusLine)
+			{
+				statusLine = false;
+				if (strncmp(line, "HTTP/1.0", 8) == 0)
+				{
+					keepAlive = false; //HTTP/1.0 closes unless asked otherwise
+				}
+			}
+			else if (strncasecmp(line, "Content-Length:", 15) == 0)
+			{
+				contentLength = atol(line + 15);
+			}
+			else if (strncasecmp(line, "Connection:", 11) == 0)
+			{
+				keepAlive = (strstr(line + 11, "close") == NULL) && (strstr(line + 11, "Close") == NULL);
+			}
+			len = 0;
+		}
+
+		//discard the body - what came with the headers first
+		contentLength -= have - pos;
+		while (contentLength > 0)
+		{
+			int n = st_client.available() ? st_client.read(chunk, contentLength < (long)sizeof(chunk) ? contentLength : sizeof(chunk)) : 0;
+			if (n > 0)
+			{
+				contentLength -= n;
+			}
+			else if (!st_client.connected() || millis() - start > HUB_RESPONSE_TIMEOUT)
+			{
+				return RESPONSE_CLOSE;
+			}
+			else
+			{
+				yield();
+			}
+		}
+
+		return keepAlive ? RESPONSE_KEEP : RESPONSE_CLOSE;
+	}
+}
+#endif
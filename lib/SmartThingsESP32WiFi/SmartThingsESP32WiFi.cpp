@@ -11,6 +11,12 @@
 //  2018-01-01  Dan Ogorchock  Added WiFi.RSSI() data collection
 //  2018-01-06  Dan Ogorchock  Simplified the MAC address printout to prevent confusion
 //  2018-02-03  Dan Ogorchock  Support for Hubitat
+//  2026-10-16  Per Ivar Nerseth  Serves GET /metrics on st_server; send latency, connect failures and RSSI are recorded
+//  2026-10-16  Per Ivar Nerseth  Requests are read in bulk by HttpRequestParser - percent-decoded path or POST body, no 200 character limit
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout, several connections at a time
+//  2026-10-16  Per Ivar Nerseth  A failed connect is no longer repeated at once - the message is held in the shared retry queue and retried from run() with backoff
+//  2026-10-17  Per Ivar Nerseth  Serving requests, sending and /metrics moved to SmartThingsHttpCore
+//  2026-10-17  Per Ivar Nerseth  The RSSI is sampled and reported by SmartThingsHttpCore when it changes - init() no longer starts a schedule
 //*******************************************************************************
 
 #include "SmartThingsESP32WiFi.h"
@@ -23,8 +29,7 @@ namespace st
 	// SmartThingsESP32WiFi Constructor - Static IP
 	//*******************************************************************************
 	SmartThingsESP32WiFi::SmartThingsESP32WiFi(String ssid, String password, IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
-		SmartThingsEthernet(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false),
-		st_server(serverPort)
+		SmartThingsHttpCore(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false)
 	{
 		ssid.toCharArray(st_ssid, sizeof(st_ssid));
 		password.toCharArray(st_password, sizeof(st_password));
@@ -34,8 +39,7 @@ namespace st
 	// SmartThingsESP32WiFI Constructor - DHCP
 	//*******************************************************************************
 	SmartThingsESP32WiFi::SmartThingsESP32WiFi(String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
-		SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
-		st_server(serverPort)
+		SmartThingsHttpCore(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true)
 	{
 		ssid.toCharArray(st_ssid, sizeof(st_ssid));
 		password.toCharArray(st_password, sizeof(st_password));
@@ -45,8 +49,7 @@ namespace st
 	// SmartThingsESP32WiFI Constructor - DHCP
 	//*******************************************************************************
 	SmartThingsESP32WiFi::SmartThingsESP32WiFi(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
-		SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
-		st_server(serverPort)
+		SmartThingsHttpCore(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true)
 	{
 		st_preExistingConnection = true;
 	}
@@ -166,9 +169,6 @@ namespace st
 		Serial.println(F("SmartThingsESP32WiFI: Intialized"));
 		Serial.println(F(""));
 
-		RSSIsendInterval = 5000;
-		previousMillis = millis() - RSSIsendInterval;
-
 	}
 
 	//*****************************************************************************
@@ -176,10 +176,6 @@ namespace st
 	//*****************************************************************************
 	void SmartThingsESP32WiFi::run(void)
 	{
-		String readString;
-		String tempString;
-		String strRSSI;
-
 		if (WiFi.isConnected() == false)
 		{
 			if (_isDebugEnabled)
@@ -191,195 +187,9 @@ namespace st
 			//WiFi.reconnect();
 			//init();
 		}
-		else
-		{
-			if (millis() - previousMillis > RSSIsendInterval)
-			{
-
-				previousMillis = millis();
-
-				if (RSSIsendInterval < RSSI_TX_INTERVAL)
-				{
-					RSSIsendInterval = RSSIsendInterval + 1000;
-				}
-
-				strRSSI = String("rssi ") + String(WiFi.RSSI());
-				send(strRSSI);
-
-				if (_isDebugEnabled)
-				{
-					Serial.println(strRSSI);
-				}
-			}
-		}
-
-		WiFiClient client = st_server.available();
-		if (client) {
-			boolean currentLineIsBlank = true;
-			while (client.connected()) {
-				if (client.available()) {
-					char c = client.read();
-					//read char by char HTTP request
-					if (readString.length() < 200) {
-						//store characters to string
-						readString += c;
-					}
-					else
-					{
-						if (_isDebugEnabled)
-						{
-							Serial.println(F(""));
-							Serial.println(F("SmartThings.run() - Exceeded 200 character limit"));
-							Serial.println(F(""));
-						}
-					}
-					// if you've gotten to the end of the line (received a newline
-					// character) and the line is blank, the http request has ended,
-					// so you can send a reply
-					if (c == '\n' && currentLineIsBlank) {
-						//now output HTML data header
-						tempString = readString.substring(readString.indexOf('/') + 1, readString.indexOf('?'));
-
-						if (tempString.length() > 0) {
-							client.println(F("HTTP/1.1 200 OK")); //send new page
-							client.println();
-						}
-						else {
-							client.println(F("HTTP/1.1 204 No Content"));
-							client.println();
-							client.println();
-							if (_isDebugEnabled)
-							{
-								Serial.println(F("No Valid Data Received"));
-							}
-						}
-						break;
-					}
-					if (c == '\n') {
-						// you're starting a new line
-						currentLineIsBlank = true;
-					}
-					else if (c != '\r') {
-						// you've gotten a character on the current line
-						currentLineIsBlank = false;
-					}
-				}
-			}
-
-			delay(1);
-			//stopping client
-			client.stop();
-
-			//Handle the received data after cleaning up the network connection
-			if (tempString.length() > 0) {
-				if (_isDebugEnabled)
-				{
-					Serial.print(F("Handling request from ST. tempString = "));
-					Serial.println(tempString);
-				}
-				//Pass the message to user's SmartThings callout function
-				tempString.replace("%20", " ");  //Clean up for Hubitat
-				_calloutFunction(tempString);
-			}
-
-			readString = "";
-			tempString = "";
-		}
-	}
-
-	//*******************************************************************************
-	/// Send Message out over Ethernet to the Hub
-	//*******************************************************************************
-	void SmartThingsESP32WiFi::send(String message)
-	{
-		if (WiFi.isConnected() == false)
-		{
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("**********************************************************"));
-				Serial.println(F("**** WiFi Disconnected.  ESP32 should auto-reconnect.  ***"));
-				Serial.println(F("**********************************************************"));
-			}
-
-			//WiFi.reconnect();
-			//init();
-		}
-
-		//Make sure the client is stopped, to free up socket for new conenction
-		st_client.stop();
-
-		if (st_client.connect(st_hubIP, st_hubPort))
-		{
-			st_client.println(F("POST / HTTP/1.1"));
-			st_client.print(F("HOST: "));
-			st_client.print(st_hubIP);
-			st_client.print(F(":"));
-			st_client.println(st_hubPort);
-			st_client.println(F("CONTENT-TYPE: text"));
-			st_client.print(F("CONTENT-LENGTH: "));
-			st_client.println(message.length());
-			st_client.println();
-			st_client.println(message);
-		}
-		else
-		{
-			//connection failed;
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("***** SmartThings.send() - Ethernet Connection Failed *****"));
-				Serial.println(F("***********************************************************"));
-				Serial.print(F("hubIP = "));
-				Serial.print(st_hubIP);
-				Serial.print(F(" "));
-				Serial.print(F("hubPort = "));
-				Serial.println(st_hubPort);
-
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("**** WiFi Disconnected.  ESP32 should auto-reconnect.  ***"));
-				Serial.println(F("***********************************************************"));
-			}
-
-			//WiFi.reconnect();
-			//init();      //Re-Init connection to get things working again
-
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("******        Attempting to resend missed data      *******"));
-				Serial.println(F("***********************************************************"));
-			}
-
-
-			st_client.flush();
-			st_client.stop();
-			if (st_client.connect(st_hubIP, st_hubPort))
-			{
-				st_client.println(F("POST / HTTP/1.1"));
-				st_client.print(F("HOST: "));
-				st_client.print(st_hubIP);
-				st_client.print(F(":"));
-				st_client.println(st_hubPort);
-				st_client.println(F("CONTENT-TYPE: text"));
-				st_client.print(F("CONTENT-LENGTH: "));
-				st_client.println(message.length());
-				st_client.println();
-				st_client.println(message);
-			}
-
-		}
-
-		//if (_isDebugEnabled) { Serial.println(F("WiFi.send(): Reading for reply data "));}
-		// read any data returned from the POST
-		while (st_client.connected()) {
-			//while (st_client.available()) {
-			char c = st_client.read(); //gets byte from ethernet buffer
-									   //if (_isDebugEnabled) { Serial.print(c); } //prints byte to serial monitor
-									   //}
-		}
 
-		delay(1);
-		st_client.stop();
+		//RSSI and retries while connected, and the requests of st_server
+		SmartThingsHttpCore::run();
 	}
 
 }
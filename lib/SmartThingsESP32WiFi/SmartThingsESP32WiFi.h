@@ -9,21 +9,25 @@
 //  2017-09-05  Dan Ogorchock  Added automatic WiFi reconnect logic as ESP32 
 //                             doesn't do this automatically currently
 //  2018-01-01  Dan Ogorchock  Added WiFi.RSSI() data collection
+//  2026-10-16  Per Ivar Nerseth  Serves GET /metrics on st_server; send latency, connect failures and RSSI are recorded
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout, several connections at a time
+//  2026-10-16  Per Ivar Nerseth  Added deliver() for the retry queue of the SmartThings base class
+//  2026-10-17  Per Ivar Nerseth  Derives from SmartThingsHttpCore - gains keep-alive mode and the event log
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSESP32WIFI_H__
 #define __SMARTTHINGSESP32WIFI_H__
 
-#include "SmartThingsEthernet.h"
-
 //*******************************************************************************
 // Using ESP32 WiFi
 //*******************************************************************************
 #include <WiFi.h>
 
+#include "SmartThingsHttpCore.h"
+
 namespace st
 {
-	class SmartThingsESP32WiFi: public SmartThingsEthernet
+	class SmartThingsESP32WiFi: public SmartThingsHttpCore<WiFiServer, WiFiClient, HTTP_MAX_CONNECTIONS>
 	{
 	private:
 		//ESP32 WiFi Specific
@@ -31,16 +35,18 @@ namespace st
 		char st_password[50];
         static int disconnectCounter;	
 		boolean st_preExistingConnection = false;
-		WiFiServer st_server; //server
-		WiFiClient st_client; //client
-		long previousMillis;
-		long RSSIsendInterval;
 
 		//**************************************************************************************
 		/// Event Handler for ESP32 WiFi Events (needed to implement reconnect logic for now...)
 		//**************************************************************************************
 		static void WiFiEvent(WiFiEvent_t event);
 
+	protected:
+		//SmartThingsHttpCore hooks
+		virtual bool linkUp() { return WiFi.isConnected(); }
+		virtual long readRSSI() { return WiFi.RSSI(); }
+		virtual void hubConnected() { st_client.setNoDelay(true); } //each request is one write (writeRequest()) - send it at once, without waiting for an ACK
+
 	public:
 		//*******************************************************************************
 		/// @brief  SmartThings ESP32 WiFi Constructor - Static IP
@@ -97,12 +103,6 @@ namespace st
 		/// Run SmartThingsESP32WiFI Library
 		//*******************************************************************************
 		virtual void run(void);
-
-		//*******************************************************************************
-		/// Send Message to the Hub
-		//*******************************************************************************
-		virtual void send(String message);
-
 	};
 }
 #endif
@@ -10,6 +10,15 @@
 //  2018-01-06  Dan Ogorchock  Simplified the MAC address printout to prevent confusion
 //  2018-01-06  Dan Ogorchock  Added OTA update capability
 //  2018-02-03  Dan Ogorchock  Support for Hubitat
+//  2026-10-16  Per Ivar Nerseth  Added HTTP/1.1 keep-alive mode - reuses st_client and reads the reply by its Content-Length
+//  2026-10-16  Per Ivar Nerseth  Serves GET /metrics on st_server; send latency, connect failures and RSSI are recorded
+//  2026-10-16  Per Ivar Nerseth  Requests are read in bulk by HttpRequestParser - percent-decoded path or POST body, no 200 character limit
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout, several connections at a time
+//  2026-10-16  Per Ivar Nerseth  Events that cannot be delivered go to the event log, if one is set, and are replayed from run()
+//  2026-10-16  Per Ivar Nerseth  Non-blocking join/rejoin state machine (runLink) with a BSSID/channel cache; time to the first event is recorded
+//  2026-10-16  Per Ivar Nerseth  A failed connect is no longer repeated at once - the message is held in the shared retry queue and retried from run() with backoff
+//  2026-10-17  Per Ivar Nerseth  Serving requests, sending, keep-alive and /metrics moved to SmartThingsHttpCore - this file keeps the WiFi join and OTA
+//  2026-10-17  Per Ivar Nerseth  The RSSI is sampled and reported by SmartThingsHttpCore when it changes - init() no longer starts a schedule
 //*******************************************************************************
 
 #include "SmartThingsESP8266WiFi.h"
@@ -19,8 +28,7 @@ namespace st
 //*******************************************************************************
 // SmartThingsESP8266WiFI Constructor - Static IP
 //*******************************************************************************
-SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(String ssid, String password, IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsEthernet(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false),
-																																																																																 st_server(serverPort)
+SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(String ssid, String password, IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsHttpCore(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false)
 {
 	ssid.toCharArray(st_ssid, sizeof(st_ssid));
 	password.toCharArray(st_password, sizeof(st_password));
@@ -29,8 +37,7 @@ SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(String ssid, String password, IPA
 //*******************************************************************************
 // SmartThingsESP8266WiFI Constructor - DHCP
 //*******************************************************************************
-SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
-																																																								 st_server(serverPort)
+SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsHttpCore(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true)
 {
 	ssid.toCharArray(st_ssid, sizeof(st_ssid));
 	password.toCharArray(st_password, sizeof(st_password));
@@ -39,8 +46,7 @@ SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(String ssid, String password, uin
 //*******************************************************************************
 // SmartThingsESP8266WiFI Constructor - DHCP
 //*******************************************************************************
-SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
-																																																   st_server(serverPort)
+SmartThingsESP8266WiFi::SmartThingsESP8266WiFi(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsHttpCore(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true)
 {
 	st_preExistingConnection = true;
 }
@@ -53,73 +59,49 @@ SmartThingsESP8266WiFi::~SmartThingsESP8266WiFi()
 }
 
 //*******************************************************************************
-/// Initialize SmartThingsESP8266WiFI Library
+/// Initialize SmartThingsESP8266WiFI Library - starts joining the network, without waiting for it (see runLink())
 //*******************************************************************************
 void SmartThingsESP8266WiFi::init(void)
 {
+	String strMAC(WiFi.macAddress());
+	strMAC.replace(":", "");
+	String("ESP8266_" + strMAC).toCharArray(st_devicename, sizeof(st_devicename));
+
 	if (!st_preExistingConnection)
 	{
 		Serial.println(F(""));
 		Serial.println(F("Initializing ESP8266 WiFi network.  Please be patient..."));
 
+		//station only (no Access Point), and run() - not the SDK - decides when to join again
+		WiFi.persistent(false);
+		WiFi.mode(WIFI_STA);
+		WiFi.setAutoReconnect(false);
+		WiFi.hostname(st_devicename);
+
 		if (st_DHCP == false)
 		{
 			WiFi.config(st_localIP, st_localGateway, st_localSubnetMask, st_localDNSServer);
 		}
 		// attempt to connect to WiFi network
-		WiFi.begin(st_ssid, st_password);
+		loadCache();
+		beginConnect();
 		Serial.print(F("Attempting to connect to WPA SSID: "));
 		Serial.println(st_ssid);
+		if (st_fastConnect)
+		{
+			Serial.print(F("Using the cached access point on channel "));
+			Serial.println(st_cache.channel);
+		}
 	}
-
-	while (WiFi.status() != WL_CONNECTED)
+	else
 	{
-		Serial.print(F("."));
-		delay(500); // wait for connection:
+		st_linkState = LINK_CONNECTING;
+		st_linkMillis = millis();
 	}
 
-	Serial.println();
-
 	st_server.begin();
 
-	Serial.println(F(""));
-	Serial.println(F("Enter the following three lines of data into ST App on your phone!"));
-	Serial.print(F("localIP = "));
-	Serial.println(WiFi.localIP());
-	Serial.print(F("serverPort = "));
-	Serial.println(st_serverPort);
-	Serial.print(F("MAC Address = "));
-	String strMAC(WiFi.macAddress());
-	strMAC.replace(":", "");
-	Serial.println(strMAC);
-	Serial.println(F(""));
-	Serial.print(F("SSID = "));
-	Serial.println(st_ssid);
-	Serial.print(F("PASSWORD = "));
-	Serial.println(st_password);
-	Serial.print(F("hubIP = "));
-	Serial.println(st_hubIP);
-	Serial.print(F("hubPort = "));
-	Serial.println(st_hubPort);
-	Serial.print(F("RSSI = "));
-	Serial.println(WiFi.RSSI());
-
-	String("ESP8266_" + strMAC).toCharArray(st_devicename, sizeof(st_devicename));
-	WiFi.hostname(st_devicename);
-
-	Serial.println(F(""));
-	Serial.println(F("SmartThingsESP8266WiFI: Intialized"));
-	Serial.println(F(""));
-
-	//Turn off Wirelss Access Point
-	Serial.println(F("Disabling ESP8266 WiFi Access Point"));
-	Serial.println(F(""));
-	WiFi.mode(WIFI_STA);
-
-	RSSIsendInterval = 5000;
-	previousMillis = millis() - RSSIsendInterval;
-
-	// Setup OTA Updates
+	// Setup OTA Updates - started once the network has been joined
 
 	// Port defaults to 8266
 	// ArduinoOTA.setPort(8266);
@@ -152,6 +134,45 @@ void SmartThingsESP8266WiFi::init(void)
 		else if (error == OTA_END_ERROR)
 			Serial.println("End Failed");
 	});
+
+	Serial.println(F(""));
+	Serial.println(F("SmartThingsESP8266WiFI: Intialized - joining the network in the background"));
+	Serial.println(F(""));
+}
+
+//*******************************************************************************
+/// Printout and OTA, once the network has been joined for the first time
+//*******************************************************************************
+void SmartThingsESP8266WiFi::startServices()
+{
+	st_servicesStarted = true;
+
+	Serial.println();
+	Serial.println(F(""));
+	Serial.println(F("Enter the following three lines of data into ST App on your phone!"));
+	Serial.print(F("localIP = "));
+	Serial.println(WiFi.localIP());
+	Serial.print(F("serverPort = "));
+	Serial.println(st_serverPort);
+	Serial.print(F("MAC Address = "));
+	String strMAC(WiFi.macAddress());
+	strMAC.replace(":", "");
+	Serial.println(strMAC);
+	Serial.println(F(""));
+	Serial.print(F("SSID = "));
+	Serial.println(st_ssid);
+	Serial.print(F("PASSWORD = "));
+	Serial.println(st_password);
+	Serial.print(F("hubIP = "));
+	Serial.println(st_hubIP);
+	Serial.print(F("hubPort = "));
+	Serial.println(st_hubPort);
+	Serial.print(F("RSSI = "));
+	Serial.println(WiFi.RSSI());
+	Serial.print(F("Joined in (ms after power-on) = "));
+	Serial.println(st_connectedMillis);
+	Serial.println(F(""));
+
 	ArduinoOTA.begin();
 	Serial.println("ArduinoOTA Ready");
 	Serial.print("IP address: ");
@@ -161,224 +182,231 @@ void SmartThingsESP8266WiFi::init(void)
 	Serial.println();
 }
 
-//*****************************************************************************
-// Run SmartThingsESP8266WiFI Library
-//*****************************************************************************
-void SmartThingsESP8266WiFi::run(void)
+//*******************************************************************************
+/// Start one attempt to join the network - with the cached access point if there is one
+//*******************************************************************************
+void SmartThingsESP8266WiFi::beginConnect()
 {
-
-	ArduinoOTA.handle();
-
-	String readString;
-	String tempString;
-	String strRSSI;
-
-	if (WiFi.isConnected() == false)
+	st_linkState = LINK_CONNECTING;
+	st_linkMillis = millis();
+	st_fastConnect = st_cacheValid;
+	if (st_fastConnect)
 	{
-		if (_isDebugEnabled)
-		{
-			Serial.println(F("**********************************************************"));
-			Serial.println(F("**** WiFi Disconnected.  ESP8266 should auto-reconnect ***"));
-			Serial.println(F("**********************************************************"));
-		}
-
-		//init();
+		WiFi.begin(st_ssid, st_password, st_cache.channel, st_cache.bssid); //no scan
 	}
 	else
 	{
-		if (millis() - previousMillis > RSSIsendInterval)
-		{
+		WiFi.begin(st_ssid, st_password);
+	}
+}
 
-			previousMillis = millis();
+//*******************************************************************************
+/// Network join state machine - called from run(), returns at once
+//*******************************************************************************
+void SmartThingsESP8266WiFi::runLink()
+{
+	unsigned long now = millis();
+	bool connected = WiFi.status() == WL_CONNECTED;
 
-			if (RSSIsendInterval < RSSI_TX_INTERVAL)
+	switch (st_linkState)
+	{
+	case LINK_UP:
+		if (!connected)
+		{
+			if (_isDebugEnabled)
 			{
-				RSSIsendInterval = RSSIsendInterval + 1000;
+				Serial.println(F("**********************************************************"));
+				Serial.println(F("**** WiFi Disconnected.  Rejoining in the background  ****"));
+				Serial.println(F("**********************************************************"));
 			}
-
-			strRSSI = String("rssi ") + String(WiFi.RSSI());
-			send(strRSSI);
-
-			if (_isDebugEnabled)
+			st_outageMillis = now;
+			st_retryInterval = WIFI_RETRY_INTERVAL;
+			if (st_preExistingConnection)
+			{
+				st_linkState = LINK_CONNECTING; //the sketch rejoins
+				st_linkMillis = now;
+			}
+			else
 			{
-				Serial.println(strRSSI);
+				beginConnect();
 			}
 		}
-	}
+		break;
 
-	WiFiClient client = st_server.available();
-	if (client)
-	{
-		boolean currentLineIsBlank = true;
-		while (client.connected())
+	case LINK_CONNECTING:
+		if (connected)
 		{
-			if (client.available())
+			onConnected();
+		}
+		else if (!st_preExistingConnection && now - st_linkMillis >= (st_fastConnect ? WIFI_FAST_CONNECT_TIMEOUT : WIFI_CONNECT_TIMEOUT))
+		{
+			if (st_fastConnect)
 			{
-				char c = client.read();
-				//read char by char HTTP request
-				if (readString.length() < 200)
-				{
-					//store characters to string
-					readString += c;
-				}
-				else
-				{
-					if (_isDebugEnabled)
-					{
-						Serial.println(F(""));
-						Serial.println(F("SmartThings.run() - Exceeded 200 character limit"));
-						Serial.println(F(""));
-					}
-				}
-				// if you've gotten to the end of the line (received a newline
-				// character) and the line is blank, the http request has ended,
-				// so you can send a reply
-				if (c == '\n' && currentLineIsBlank)
-				{
-					//now output HTML data header
-					tempString = readString.substring(readString.indexOf('/') + 1, readString.indexOf('?'));
-
-					if (tempString.length() > 0)
-					{
-						client.println(F("HTTP/1.1 200 OK")); //send new page
-						client.println();
-					}
-					else
-					{
-						client.println(F("HTTP/1.1 204 No Content"));
-						client.println();
-						client.println();
-						if (_isDebugEnabled)
-						{
-							Serial.println(F("No Valid Data Received"));
-						}
-					}
-					break;
-				}
-				if (c == '\n')
-				{
-					// you're starting a new line
-					currentLineIsBlank = true;
-				}
-				else if (c != '\r')
+				//the access point has moved (or is gone) - scan for it
+				st_cacheValid = false;
+				beginConnect();
+			}
+			else
+			{
+				WiFi.disconnect();
+				st_linkState = LINK_WAITING;
+				st_linkMillis = now;
+				if (_isDebugEnabled)
 				{
-					// you've gotten a character on the current line
-					currentLineIsBlank = false;
+					Serial.print(F("WiFi: could not join, next attempt in ms: "));
+					Serial.println(st_retryInterval);
 				}
 			}
 		}
+		break;
 
-		delay(1);
-		//stopping client
-		client.stop();
-
-		//Handle the received data after cleaning up the network connection
-		if (tempString.length() > 0)
+	case LINK_WAITING:
+		if (now - st_linkMillis >= st_retryInterval)
 		{
-			if (_isDebugEnabled)
-			{
-				Serial.print(F("Handling request from ST. tempString = "));
-				Serial.println(tempString);
-			}
-			//Pass the message to user's SmartThings callout function
-			tempString.replace("%20", " "); //Clean up for Hubitat
-			_calloutFunction(tempString);
+			st_retryInterval = st_retryInterval * 2 < WIFI_RETRY_MAX ? st_retryInterval * 2 : WIFI_RETRY_MAX;
+			beginConnect();
 		}
-
-		readString = "";
-		tempString = "";
+		break;
 	}
 }
 
 //*******************************************************************************
-/// Send Message out over Ethernet to the Hub
+/// The network has been joined
 //*******************************************************************************
-void SmartThingsESP8266WiFi::send(String message)
+void SmartThingsESP8266WiFi::onConnected()
 {
-	if (WiFi.isConnected() == false)
+	unsigned long now = millis();
+	st_linkState = LINK_UP;
+	st_retryInterval = WIFI_RETRY_INTERVAL;
+	if (st_fastConnect)
 	{
-		if (_isDebugEnabled)
-		{
-			Serial.println(F("**********************************************************"));
-			Serial.println(F("**** WiFi Disconnected.  ESP8266 should auto-reconnect ***"));
-			Serial.println(F("**********************************************************"));
-		}
-
-		//init();
+		st_fastConnects++;
+	}
+	if (!st_preExistingConnection)
+	{
+		saveCache();
 	}
 
-	//Make sure the client is stopped, to free up socket for new conenction
-	st_client.stop();
-
-	if (st_client.connect(st_hubIP, st_hubPort))
+	if (!st_servicesStarted)
 	{
-		st_client.println(F("POST / HTTP/1.1"));
-		st_client.print(F("HOST: "));
-		st_client.print(st_hubIP);
-		st_client.print(F(":"));
-		st_client.println(st_hubPort);
-		st_client.println(F("CONTENT-TYPE: text"));
-		st_client.print(F("CONTENT-LENGTH: "));
-		st_client.println(message.length());
-		st_client.println();
-		st_client.println(message);
+		st_connectedMillis = now;
+		startServices();
 	}
 	else
 	{
-		//connection failed;
+		st_reconnects++;
+		st_lastOutage = now - st_outageMillis;
 		if (_isDebugEnabled)
 		{
-			Serial.println(F("***********************************************************"));
-			Serial.println(F("***** SmartThings.send() - Ethernet Connection Failed *****"));
-			Serial.println(F("***********************************************************"));
-			Serial.print(F("hubIP = "));
-			Serial.print(st_hubIP);
-			Serial.print(F(" "));
-			Serial.print(F("hubPort = "));
-			Serial.println(st_hubPort);
-
-			Serial.println(F("***********************************************************"));
-			Serial.println(F("**** WiFi Disconnected.  ESP8266 should auto-reconnect ****"));
-			Serial.println(F("***********************************************************"));
+			Serial.print(F("WiFi: rejoined after ms: "));
+			Serial.println(st_lastOutage);
 		}
+	}
+}
 
-		//init();      //Re-Init connection to get things working again
+//*******************************************************************************
+/// Ready for send()
+//*******************************************************************************
+bool SmartThingsESP8266WiFi::isReady() const
+{
+	return st_linkState == LINK_UP || (m_pEventLog != NULL && st_servicesStarted);
+}
 
-		if (_isDebugEnabled)
+//*******************************************************************************
+/// Check byte of the BSSID/channel cache, over the SSID too
+//*******************************************************************************
+uint8_t SmartThingsESP8266WiFi::cacheCheck(const ConnectCache &cache) const
+{
+	uint8_t check = 0xA5 ^ cache.channel;
+	for (byte i = 0; i < sizeof(cache.bssid); i++)
+	{
+		check = (check << 1 | check >> 7) ^ cache.bssid[i];
+	}
+	for (const char *c = st_ssid; *c; c++)
+	{
+		check = (check << 1 | check >> 7) ^ (uint8_t)*c;
+	}
+	return check;
+}
+
+//*******************************************************************************
+/// Read the BSSID/channel of the last connection - RTC memory first, then the file
+//*******************************************************************************
+void SmartThingsESP8266WiFi::loadCache()
+{
+	const uint32_t magic = 0x57494649; //"WIFI"
+	st_cacheValid = ESP.rtcUserMemoryRead(WIFI_CACHE_RTC_BLOCK, (uint32_t *)&st_cache, sizeof(st_cache)) &&
+					st_cache.magic == magic && st_cache.check == cacheCheck(st_cache);
+
+	if (!st_cacheValid && st_cacheFS != NULL)
+	{
+		File file = st_cacheFS->open("/stwifi", "r");
+		if (file)
 		{
-			Serial.println(F("***********************************************************"));
-			Serial.println(F("******        Attempting to resend missed data      *******"));
-			Serial.println(F("***********************************************************"));
+			st_cacheValid = file.read((uint8_t *)&st_cache, sizeof(st_cache)) == sizeof(st_cache) &&
+							st_cache.magic == magic && st_cache.check == cacheCheck(st_cache);
+			file.close();
 		}
+	}
+}
 
-		st_client.flush();
-		st_client.stop();
-		if (st_client.connect(st_hubIP, st_hubPort))
+//*******************************************************************************
+/// Remember the access point just joined - written only when it has changed
+//*******************************************************************************
+void SmartThingsESP8266WiFi::saveCache()
+{
+	ConnectCache cache;
+	cache.magic = 0x57494649;
+	memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+	cache.channel = WiFi.channel();
+	cache.check = cacheCheck(cache);
+	if (st_cacheValid && memcmp(&cache, &st_cache, sizeof(cache)) == 0)
+	{
+		return;
+	}
+
+	st_cache = cache;
+	st_cacheValid = true;
+	ESP.rtcUserMemoryWrite(WIFI_CACHE_RTC_BLOCK, (uint32_t *)&st_cache, sizeof(st_cache));
+	if (st_cacheFS != NULL)
+	{
+		File file = st_cacheFS->open("/stwifi", "w");
+		if (file)
 		{
-			st_client.println(F("POST / HTTP/1.1"));
-			st_client.print(F("HOST: "));
-			st_client.print(st_hubIP);
-			st_client.print(F(":"));
-			st_client.println(st_hubPort);
-			st_client.println(F("CONTENT-TYPE: text"));
-			st_client.print(F("CONTENT-LENGTH: "));
-			st_client.println(message.length());
-			st_client.println();
-			st_client.println(message);
+			file.write((const uint8_t *)&st_cache, sizeof(st_cache));
+			file.close();
 		}
 	}
+}
 
-	//if (_isDebugEnabled) { Serial.println(F("WiFi.send(): Reading for reply data "));}
-	// read any data returned from the POST
-	while (st_client.connected())
+//*****************************************************************************
+// Run SmartThingsESP8266WiFI Library
+//*****************************************************************************
+void SmartThingsESP8266WiFi::run(void)
+{
+	runLink();
+
+	if (st_linkState == LINK_UP)
 	{
-		//while (st_client.available()) {
-		char c = st_client.read(); //gets byte from ethernet buffer
-								   //if (_isDebugEnabled) { Serial.print(c); } //prints byte to serial monitor
-								   //}
+		ArduinoOTA.handle();
 	}
 
-	delay(1);
-	st_client.stop();
+	//RSSI, retries and the requests of st_server
+	SmartThingsHttpCore::run();
+}
+
+//*******************************************************************************
+/// Network joins for GET /metrics - times in milliseconds after power-on
+//*******************************************************************************
+void SmartThingsESP8266WiFi::writeLinkMetrics(Print &out)
+{
+	out.print(F("st_wifi_connected_ms "));
+	out.println(st_connectedMillis);
+	out.print(F("st_wifi_reconnects "));
+	out.println(st_reconnects);
+	out.print(F("st_wifi_fast_connects "));
+	out.println(st_fastConnects);
+	out.print(F("st_wifi_last_outage_ms "));
+	out.println(st_lastOutage);
 }
 }
\ No newline at end of file
@@ -8,34 +8,108 @@
 //	2017-02-05  Dan Ogorchock  Created
 //  2017-12-29  Dan Ogorchock  Added WiFi.RSSI() data collection
 //  2018-01-06  Dan Ogorchock  Added OTA update capability
+//  2026-10-16  Per Ivar Nerseth  Added HTTP/1.1 keep-alive mode for the connection to the Hub
+//  2026-10-16  Per Ivar Nerseth  Serves GET /metrics on st_server; send latency, connect failures and RSSI are recorded
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout, several connections at a time
+//  2026-10-16  Per Ivar Nerseth  Supports the store-and-forward event log - undelivered events are replayed with an EVENT-AGE header
+//  2026-10-16  Per Ivar Nerseth  init() no longer waits for WiFi - run() joins and rejoins the network with a cached BSSID/channel
+//  2026-10-17  Per Ivar Nerseth  Derives from SmartThingsHttpCore, which serves requests and sends to the Hub for all LAN transports
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSESP8266WIFI_H__
 #define __SMARTTHINGSESP8266WIFI_H__
 
-#include "SmartThingsEthernet.h"
-
 //*******************************************************************************
 // Using ESP8266 WiFi
 //*******************************************************************************
 #include <ESP8266WiFi.h>
 #include <ArduinoOTA.h>
+#include <FS.h>
+
+#include "SmartThingsHttpCore.h"
+
+//Time allowed to join the network with the cached BSSID and channel, before scanning for the access point (in milliseconds)
+#ifndef WIFI_FAST_CONNECT_TIMEOUT
+#define WIFI_FAST_CONNECT_TIMEOUT 3000
+#endif
+
+//Time allowed to join the network after a scan (in milliseconds)
+#ifndef WIFI_CONNECT_TIMEOUT
+#define WIFI_CONNECT_TIMEOUT 15000
+#endif
+
+//Wait before joining again after a failed attempt (in milliseconds), doubled after each further failure up to WIFI_RETRY_MAX
+#ifndef WIFI_RETRY_INTERVAL
+#define WIFI_RETRY_INTERVAL 1000
+#endif
+
+#ifndef WIFI_RETRY_MAX
+#define WIFI_RETRY_MAX 60000
+#endif
+
+//RTC user memory block (of 4 bytes) the BSSID/channel cache is kept at - it survives a reset and deep sleep, not a power cycle
+#ifndef WIFI_CACHE_RTC_BLOCK
+#define WIFI_CACHE_RTC_BLOCK 96
+#endif
 
 namespace st
 {
-class SmartThingsESP8266WiFi : public SmartThingsEthernet
+class SmartThingsESP8266WiFi : public SmartThingsHttpCore<WiFiServer, WiFiClient, HTTP_MAX_CONNECTIONS>
 {
   private:
 	//ESP8266 WiFi Specific
 	char st_ssid[50];
 	char st_password[50];
 	boolean st_preExistingConnection = false;
-	WiFiServer st_server; //server
-	WiFiClient st_client; //client
-	long previousMillis;
-	long RSSIsendInterval;
 	char st_devicename[50];
 
+	//Network join state machine - run() advances it, nothing waits for it
+	enum LinkState
+	{
+		LINK_CONNECTING, //WiFi.begin() called, waiting for WL_CONNECTED
+		LINK_UP,
+		LINK_WAITING	 //an attempt failed - the next one starts after st_retryInterval
+	};
+	LinkState st_linkState = LINK_CONNECTING;
+	unsigned long st_linkMillis = 0; //when st_linkState was entered
+	unsigned long st_retryInterval = WIFI_RETRY_INTERVAL;
+	bool st_fastConnect = false;	 //the attempt in progress uses st_cache
+	bool st_servicesStarted = false; //OTA and the startup printout, once the network was first joined
+
+	//BSSID and channel of the last connection - kept in RTC memory, and in a file if setConnectCache() was called
+	struct ConnectCache
+	{
+		uint32_t magic;
+		uint8_t bssid[6];
+		uint8_t channel;
+		uint8_t check; //also covers the SSID, so a cache of another network is not used
+	};
+	ConnectCache st_cache;
+	bool st_cacheValid = false;
+	fs::FS *st_cacheFS = NULL;
+
+	//Startup and outage statistics, in milliseconds since power-on
+	unsigned long st_connectedMillis = 0;  //first connection
+	unsigned long st_outageMillis = 0;	 //start of the current outage
+	unsigned long st_lastOutage = 0;	   //duration of the last outage
+	unsigned long st_reconnects = 0;
+	unsigned long st_fastConnects = 0;
+
+	void beginConnect();
+	void runLink();
+	void onConnected();
+	void startServices();
+	uint8_t cacheCheck(const ConnectCache &cache) const;
+	void loadCache();
+	void saveCache();
+
+  protected:
+	//SmartThingsHttpCore hooks
+	virtual bool linkUp() { return st_linkState == LINK_UP; }
+	virtual long readRSSI() { return WiFi.RSSI(); }
+	virtual void hubConnected() { st_client.setNoDelay(true); } //each request is one write (writeRequest()) - send it at once, without waiting for an ACK
+	virtual void writeLinkMetrics(Print &out);
+
   public:
 	//*******************************************************************************
 	/// @brief  SmartThings ESP8266 WiFi Constructor - Static IP
@@ -94,9 +168,15 @@ class SmartThingsESP8266WiFi : public SmartThingsEthernet
 	virtual void run(void);
 
 	//*******************************************************************************
-	/// Send Message to the Hub
+	/// Ready once the network has been joined - and during later outages if an event log is set, which stores the events
+	//*******************************************************************************
+	virtual bool isReady() const;
+
+	//*******************************************************************************
+	/// Connect Cache - also keep the BSSID/channel in a file of a mounted LittleFS or SPIFFS, so a power cycle
+	///   joins without a scan too.  Call before init().  The file is written only when the access point changes.
 	//*******************************************************************************
-	virtual void send(String message);
+	void setConnectCache(fs::FS &fs) { st_cacheFS = &fs; }
 };
 }
 #endif
\ No newline at end of file
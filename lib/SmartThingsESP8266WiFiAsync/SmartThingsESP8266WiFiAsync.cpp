@@ -0,0 +1,702 @@
+//*******************************************************************************
+//	SmartThings NodeMCU ESP8266 Wifi Library - asynchronous TCP
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created from SmartThingsESP8266WiFi, on ESPAsyncTCP
+//	2026-10-17  Per Ivar Nerseth  The RSSI is sampled every RSSI_SAMPLE_INTERVAL and sent when it changes, or along with a batch
+//	2026-10-17  Per Ivar Nerseth  init() no longer waits for the WiFi join - runLink() joins and rejoins from run()
+//	2026-10-17  Per Ivar Nerseth  A failed message is no longer tried once more at once - it is held in the shared retry queue, or stored in the event log, and sent again from run()
+//*******************************************************************************
+
+#include "SmartThingsESP8266WiFiAsync.h"
+
+#include <EventLog.h>
+#include <StreamString.h>
+
+namespace st
+{
+//*******************************************************************************
+// SmartThingsESP8266WiFiAsync Constructor - Static IP
+//*******************************************************************************
+SmartThingsESP8266WiFiAsync::SmartThingsESP8266WiFiAsync(String ssid, String password, IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsEthernet(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false),
+																																																																																	   st_server(serverPort),
+																																																																																	   st_sendState(SEND_IDLE),
+																																																																																	   st_sendSource(FROM_OUTBOX),
+																																																																																	   st_sendAge(-1),
+																																																																																	   st_delivered(false),
+																																																																																	   st_outboxHead(0),
+																																																																																	   st_outboxCount(0),
+																																																																																	   st_outboxDrops(0)
+{
+	ssid.toCharArray(st_ssid, sizeof(st_ssid));
+	password.toCharArray(st_password, sizeof(st_password));
+}
+
+//*******************************************************************************
+// SmartThingsESP8266WiFiAsync Constructor - DHCP
+//*******************************************************************************
+SmartThingsESP8266WiFiAsync::SmartThingsESP8266WiFiAsync(String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
+																																																									 st_server(serverPort),
+																																																									 st_sendState(SEND_IDLE),
+																																																									 st_sendSource(FROM_OUTBOX),
+																																																									 st_sendAge(-1),
+																																																									 st_delivered(false),
+																																																									 st_outboxHead(0),
+																																																									 st_outboxCount(0),
+																																																									 st_outboxDrops(0)
+{
+	ssid.toCharArray(st_ssid, sizeof(st_ssid));
+	password.toCharArray(st_password, sizeof(st_password));
+}
+
+//*******************************************************************************
+// SmartThingsESP8266WiFiAsync Constructor - Pre-existing connection
+//*******************************************************************************
+SmartThingsESP8266WiFiAsync::SmartThingsESP8266WiFiAsync(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
+																																																	   st_server(serverPort),
+																																																	   st_sendState(SEND_IDLE),
+																																																	   st_sendSource(FROM_OUTBOX),
+																																																	   st_sendAge(-1),
+																																																	   st_delivered(false),
+																																																	   st_outboxHead(0),
+																																																	   st_outboxCount(0),
+																																																	   st_outboxDrops(0)
+{
+	st_preExistingConnection = true;
+}
+
+//*****************************************************************************
+//SmartThingsESP8266WiFiAsync::~SmartThingsESP8266WiFiAsync()
+//*****************************************************************************
+SmartThingsESP8266WiFiAsync::~SmartThingsESP8266WiFiAsync()
+{
+}
+
+//*******************************************************************************
+/// Initialize SmartThingsESP8266WiFiAsync Library - returns at once, run() joins the network
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::init(void)
+{
+	String strMAC(WiFi.macAddress());
+	strMAC.replace(":", "");
+	String("ESP8266_" + strMAC).toCharArray(st_devicename, sizeof(st_devicename));
+
+	setupCallbacks();
+
+	if (!st_preExistingConnection)
+	{
+		Serial.println(F(""));
+		Serial.println(F("Initializing ESP8266 WiFi network.  Please be patient..."));
+
+		//station only (no Access Point), and run() - not the SDK - decides when to join again
+		WiFi.persistent(false);
+		WiFi.mode(WIFI_STA);
+		WiFi.setAutoReconnect(false);
+		WiFi.hostname(st_devicename);
+
+		if (st_DHCP == false)
+		{
+			WiFi.config(st_localIP, st_localGateway, st_localSubnetMask, st_localDNSServer);
+		}
+		// attempt to connect to WiFi network
+		beginConnect();
+		Serial.print(F("Attempting to connect to WPA SSID: "));
+		Serial.println(st_ssid);
+	}
+	else
+	{
+		st_linkState = LINK_CONNECTING;
+		st_linkMillis = millis();
+	}
+
+	st_server.setNoDelay(true);
+	st_server.begin();
+
+	// Setup OTA Updates - started once the network has been joined
+
+	// Port defaults to 8266
+	// ArduinoOTA.setPort(8266);
+
+	// Hostname defaults to esp8266-[ChipID]
+	ArduinoOTA.setHostname(st_devicename);
+
+	// No authentication by default
+	//ArduinoOTA.setPassword((const char*)"123");
+
+	ArduinoOTA.onStart([]() {
+		Serial.println("Start");
+	});
+	ArduinoOTA.onEnd([]() {
+		Serial.println("\nEnd");
+	});
+	ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
+		Serial.printf("Progress: %u%%\r", (progress / (total / 100)));
+	});
+	ArduinoOTA.onError([](ota_error_t error) {
+		Serial.printf("Error[%u]: ", error);
+		if (error == OTA_AUTH_ERROR)
+			Serial.println("Auth Failed");
+		else if (error == OTA_BEGIN_ERROR)
+			Serial.println("Begin Failed");
+		else if (error == OTA_CONNECT_ERROR)
+			Serial.println("Connect Failed");
+		else if (error == OTA_RECEIVE_ERROR)
+			Serial.println("Receive Failed");
+		else if (error == OTA_END_ERROR)
+			Serial.println("End Failed");
+	});
+
+	Serial.println(F(""));
+	Serial.println(F("SmartThingsESP8266WiFiAsync: Intialized - joining the network in the background"));
+	Serial.println(F(""));
+}
+
+//*******************************************************************************
+/// Start an attempt to join the network - run() follows it
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::beginConnect()
+{
+	st_linkState = LINK_CONNECTING;
+	st_linkMillis = millis();
+	WiFi.begin(st_ssid, st_password);
+}
+
+//*******************************************************************************
+/// The WiFi join: joined, lost, timed out or due for another attempt - called from run(), never waits
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::runLink()
+{
+	unsigned long now = millis();
+	bool connected = WiFi.status() == WL_CONNECTED;
+
+	switch (st_linkState)
+	{
+	case LINK_UP:
+		if (!connected)
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("**********************************************************"));
+				Serial.println(F("**** WiFi Disconnected.  Rejoining in the background  ****"));
+				Serial.println(F("**********************************************************"));
+			}
+			st_retryInterval = WIFI_RETRY_INTERVAL;
+			if (st_preExistingConnection)
+			{
+				st_linkState = LINK_CONNECTING; //the sketch rejoins
+				st_linkMillis = now;
+			}
+			else
+			{
+				beginConnect();
+			}
+		}
+		break;
+
+	case LINK_CONNECTING:
+		if (connected)
+		{
+			st_linkState = LINK_UP;
+			st_retryInterval = WIFI_RETRY_INTERVAL;
+			if (!st_servicesStarted)
+			{
+				startServices();
+			}
+		}
+		else if (!st_preExistingConnection && now - st_linkMillis >= WIFI_CONNECT_TIMEOUT)
+		{
+			WiFi.disconnect();
+			st_linkState = LINK_WAITING;
+			st_linkMillis = now;
+			if (_isDebugEnabled)
+			{
+				Serial.print(F("WiFi: could not join, next attempt in ms: "));
+				Serial.println(st_retryInterval);
+			}
+		}
+		break;
+
+	case LINK_WAITING:
+		if (now - st_linkMillis >= st_retryInterval)
+		{
+			st_retryInterval = st_retryInterval * 2 < WIFI_RETRY_MAX ? st_retryInterval * 2 : WIFI_RETRY_MAX;
+			beginConnect();
+		}
+		break;
+	}
+}
+
+//*******************************************************************************
+/// First join - the startup printout and OTA
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::startServices()
+{
+	st_servicesStarted = true;
+
+	Serial.println();
+	Serial.println(F(""));
+	Serial.println(F("Enter the following three lines of data into ST App on your phone!"));
+	Serial.print(F("localIP = "));
+	Serial.println(WiFi.localIP());
+	Serial.print(F("serverPort = "));
+	Serial.println(st_serverPort);
+	Serial.print(F("MAC Address = "));
+	String strMAC(WiFi.macAddress());
+	strMAC.replace(":", "");
+	Serial.println(strMAC);
+	Serial.println(F(""));
+	Serial.print(F("SSID = "));
+	Serial.println(st_ssid);
+	Serial.print(F("PASSWORD = "));
+	Serial.println(st_password);
+	Serial.print(F("hubIP = "));
+	Serial.println(st_hubIP);
+	Serial.print(F("hubPort = "));
+	Serial.println(st_hubPort);
+	Serial.print(F("RSSI = "));
+	Serial.println(WiFi.RSSI());
+	Serial.println(F(""));
+
+	ArduinoOTA.begin();
+	Serial.println("ArduinoOTA Ready");
+	Serial.print("IP address: ");
+	Serial.println(WiFi.localIP());
+	Serial.print("ArduionOTA Host Name: ");
+	Serial.println(ArduinoOTA.getHostname());
+	Serial.println();
+}
+
+//*******************************************************************************
+/// Ready to send
+//*******************************************************************************
+bool SmartThingsESP8266WiFiAsync::isReady() const
+{
+	return st_linkState == LINK_UP || (m_pEventLog != NULL && st_servicesStarted);
+}
+
+//*******************************************************************************
+/// Register the callbacks of the server and of the connection to the Hub
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::setupCallbacks()
+{
+	for (byte i = 0; i < HTTP_MAX_CONNECTIONS; i++)
+	{
+		st_inbound[i].client = NULL;
+	}
+
+	st_server.onClient([this](void *, AsyncClient *client) {
+		onConnection(client);
+	}, NULL);
+
+	st_client.onConnect([this](void *, AsyncClient *) {
+		onHubConnect();
+	}, NULL);
+	st_client.onData([this](void *, AsyncClient *, void *, size_t) {
+		//any reply will do - the message has been taken
+		st_client.close();
+	}, NULL);
+	st_client.onDisconnect([this](void *, AsyncClient *) {
+		finishSend(st_sendState == SEND_WAITING);
+	}, NULL);
+}
+
+//*****************************************************************************
+// Run SmartThingsESP8266WiFiAsync Library
+//*****************************************************************************
+void SmartThingsESP8266WiFiAsync::run(void)
+{
+	runLink();
+
+	if (st_linkState == LINK_UP)
+	{
+		ArduinoOTA.handle();
+
+		//the signal strength - sent on its own only when it has moved, or not been sent for long (see RssiReporter)
+		if (m_Rssi.sampleDue())
+		{
+			sampleRssi(WiFi.RSSI());
+		}
+		if (m_Rssi.reportDue())
+		{
+			send(takeRssiReport(false));
+		}
+	}
+
+	//the Hub did not answer in time - onDisconnect finishes the message
+	if ((st_sendState == SEND_CONNECTING || st_sendState == SEND_WAITING) && millis() - st_sendStartMillis > ASYNC_SEND_TIMEOUT)
+	{
+		st_client.close(true);
+	}
+
+	//the result of the last message goes back where the message came from - here, not in the callback
+	if (st_sendState == SEND_DONE)
+	{
+		settleSend();
+	}
+
+	//the next message, stored, held or queued - started here rather than from the callback of the connection it reuses
+	if (st_sendState == SEND_IDLE)
+	{
+		startSend();
+	}
+}
+
+//*******************************************************************************
+/// A new connection from the Hub
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::onConnection(AsyncClient *client)
+{
+	Inbound *inbound = NULL;
+	for (byte i = 0; i < HTTP_MAX_CONNECTIONS && inbound == NULL; i++)
+	{
+		if (st_inbound[i].client == NULL)
+		{
+			inbound = &st_inbound[i];
+		}
+	}
+
+	if (inbound == NULL)
+	{
+		client->onDisconnect([](void *, AsyncClient *c) {
+			delete c;
+		}, NULL);
+		client->close(true);
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("SmartThings.run() - All connections busy, refused one"));
+		}
+		return;
+	}
+
+	inbound->client = client;
+	inbound->request.reset();
+	inbound->acceptedMillis = millis();
+	inbound->reply = String();
+	inbound->replySent = 0;
+
+	client->setNoDelay(true);
+	client->onData([this, inbound](void *, AsyncClient *, void *data, size_t len) {
+		onRequestData(*inbound, (const char *)data, len);
+	}, NULL);
+	client->onAck([this, inbound](void *, AsyncClient *, size_t, uint32_t) {
+		writeReply(*inbound);
+	}, NULL);
+	client->onPoll([this, inbound](void *, AsyncClient *) {
+		onRequestPoll(*inbound);
+	}, NULL);
+	client->onDisconnect([this, inbound](void *, AsyncClient *c) {
+		release(*inbound);
+		delete c;
+	}, NULL);
+}
+
+//*******************************************************************************
+/// Bytes of a request - parsed as they come, answered and handed to the callout once complete
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::onRequestData(Inbound &inbound, const char *data, size_t len)
+{
+	HttpRequestParser &request = inbound.request;
+	if (request.done())
+	{
+		return; //anything after the request is ignored
+	}
+	request.feed(data, len);
+	if (!request.done())
+	{
+		return;
+	}
+
+	if (request.complete() && request.isMethod("GET") && strcmp(request.getPath(), "metrics") == 0)
+	{
+		//runtime statistics - answered here, not passed to the callout
+		m_nRSSI = WiFi.RSSI();
+		StreamString page;
+		page.print(F("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n"));
+		page.print(F("st_async_outbox_depth "));
+		page.println(st_outboxCount);
+		page.print(F("st_async_outbox_drops "));
+		page.println(st_outboxDrops);
+		writeMetrics(page);
+		inbound.reply = page;
+		writeReply(inbound);
+		return;
+	}
+
+	if (request.complete())
+	{
+		if (request.commandLength() > 0)
+		{
+			inbound.reply = F("HTTP/1.1 200 OK\r\n\r\n");
+		}
+		else
+		{
+			inbound.reply = F("HTTP/1.1 204 No Content\r\n\r\n\r\n");
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("No Valid Data Received"));
+			}
+		}
+	}
+	else
+	{
+		inbound.reply = String(request.getErrorStatus()) + F("\r\n\r\n");
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("SmartThings.run() - Request rejected: "));
+			Serial.println(request.getErrorStatus());
+		}
+	}
+	writeReply(inbound);
+
+	//Handle the received data right away - the reply goes out on its own
+	if (request.complete() && request.commandLength() > 0)
+	{
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("Handling request from ST. command = "));
+			Serial.println(request.command());
+		}
+		//Pass the message to user's SmartThings callout function
+		_calloutFunction(String(request.command()));
+	}
+}
+
+//*******************************************************************************
+/// Called about twice a second for each connection - enforces the read timeout
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::onRequestPoll(Inbound &inbound)
+{
+	if (millis() - inbound.acceptedMillis <= HTTP_READ_TIMEOUT)
+	{
+		return;
+	}
+	if (!inbound.request.done())
+	{
+		inbound.request.reset();
+		inbound.reply = F("HTTP/1.1 408 Request Timeout\r\n\r\n");
+		inbound.replySent = 0;
+		inbound.acceptedMillis = millis(); //the reply gets another HTTP_READ_TIMEOUT
+		writeReply(inbound);
+	}
+	else
+	{
+		inbound.client->close(true); //the client does not take the reply
+	}
+}
+
+//*******************************************************************************
+/// Write as much of the reply as the connection takes - onAck writes the rest
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::writeReply(Inbound &inbound)
+{
+	if (inbound.client == NULL || inbound.replySent >= inbound.reply.length())
+	{
+		return;
+	}
+
+	size_t remaining = inbound.reply.length() - inbound.replySent;
+	size_t room = inbound.client->space();
+	size_t count = remaining < room ? remaining : room;
+	if (count > 0)
+	{
+		inbound.replySent += inbound.client->add(inbound.reply.c_str() + inbound.replySent, count, ASYNC_WRITE_FLAG_COPY);
+		inbound.client->send();
+	}
+	if (inbound.replySent >= inbound.reply.length())
+	{
+		inbound.client->close(); //queued data still goes out
+	}
+}
+
+//*******************************************************************************
+/// The connection has gone - the slot is free again
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::release(Inbound &inbound)
+{
+	inbound.client = NULL;
+	inbound.reply = String(); //give the memory back
+	inbound.replySent = 0;
+}
+
+//*******************************************************************************
+/// Queue a message for the Hub - returns at once
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::send(String message)
+{
+	if (st_outboxCount == ASYNC_SEND_QUEUE_SIZE)
+	{
+		st_outboxDrops++;
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("***** SmartThings.send() - Queue full, message dropped *****"));
+		}
+		return;
+	}
+
+	//in batch mode, an RSSI report rides along
+	appendRssi(message);
+
+	st_outbox[(st_outboxHead + st_outboxCount) % ASYNC_SEND_QUEUE_SIZE] = message;
+	st_outboxCount++;
+
+	if (st_sendState == SEND_IDLE)
+	{
+		startSend();
+	}
+}
+
+//*******************************************************************************
+/// Open the connection for the next message: a stored event, if its replay is due, a held one, if
+/// its retry is due, or the head of the queue - which is kept behind the others while they wait
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::startSend()
+{
+	if (st_sendState != SEND_IDLE)
+	{
+		return;
+	}
+
+	if (m_pEventLog != NULL && m_pEventLog->replayDue() && m_pEventLog->peek(st_sending, st_sendAge))
+	{
+		st_sendSource = FROM_LOG;
+	}
+	else if (m_Retry.due())
+	{
+		st_sending = m_Retry.peek();
+		st_sendAge = -1;
+		st_sendSource = FROM_RETRY;
+	}
+	else
+	{
+		bool found = false;
+		while (st_outboxCount > 0 && !found)
+		{
+			String message = st_outbox[st_outboxHead];
+			st_outbox[st_outboxHead] = String();
+			st_outboxHead = (st_outboxHead + 1) % ASYNC_SEND_QUEUE_SIZE;
+			st_outboxCount--;
+
+			if (storeIfBacklogged(message))
+			{
+				continue;
+			}
+			if (m_pEventLog == NULL && !m_Retry.empty())
+			{
+				//the hub is failing - wait behind the held messages instead of opening another connection
+				m_Retry.hold(message, false);
+				continue;
+			}
+			st_sending = message;
+			found = true;
+		}
+		if (!found)
+		{
+			return;
+		}
+		st_sendAge = -1;
+		st_sendSource = FROM_OUTBOX;
+	}
+
+	st_sendState = SEND_CONNECTING;
+	st_sendStartMillis = millis();
+	st_sendStartMicros = micros();
+	if (st_linkState != LINK_UP || !st_client.connect(st_hubIP, st_hubPort))
+	{
+		if (_isDebugEnabled)
+		{
+			Serial.println(st_linkState != LINK_UP ? F("***** SmartThings.send() - Network down, message kept for later *****") : F("***** SmartThings.send() - Ethernet Connection Failed *****"));
+		}
+		finishSend(false);
+		settleSend();
+	}
+}
+
+//*******************************************************************************
+/// Connected to the Hub - write the POST
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::onHubConnect()
+{
+	const String &message = st_sending;
+	String request;
+	request.reserve(message.length() + 120);
+	request += F("POST / HTTP/1.1\r\nHOST: ");
+	request += st_hubIP.toString();
+	request += ':';
+	request += st_hubPort;
+	request += F("\r\nCONTENT-TYPE: text\r\nCONTENT-LENGTH: ");
+	request += message.length();
+	if (st_sendAge >= 0)
+	{
+		request += F("\r\nEVENT-AGE: "); //a replayed event - captured this many milliseconds ago
+		request += st_sendAge;
+	}
+	request += F("\r\n\r\n");
+	request += message;
+	request += F("\r\n");
+
+	st_client.setNoDelay(true);
+	st_client.write(request.c_str(), request.length());
+	st_sendState = SEND_WAITING;
+}
+
+//*******************************************************************************
+/// The connection to the Hub has closed - run() settles the message
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::finishSend(bool delivered)
+{
+	if (st_sendState != SEND_CONNECTING && st_sendState != SEND_WAITING)
+	{
+		return;
+	}
+	st_delivered = delivered;
+	st_sendState = SEND_DONE;
+}
+
+//*******************************************************************************
+/// The result goes back where the message came from - a new one that failed is kept, as deliverOrKeep() keeps it
+//*******************************************************************************
+void SmartThingsESP8266WiFiAsync::settleSend()
+{
+	st_sendState = SEND_IDLE;
+	if (!st_delivered && st_linkState == LINK_UP)
+	{
+		m_nConnectFailures++;
+	}
+
+	switch (st_sendSource)
+	{
+	case FROM_LOG:
+		m_pEventLog->replayed(st_delivered);
+		break;
+
+	case FROM_RETRY:
+		m_Retry.attempted(st_delivered);
+		break;
+
+	case FROM_OUTBOX:
+		recordSend(st_sendStartMicros);
+		if (st_delivered)
+		{
+			break;
+		}
+		if (m_pEventLog != NULL)
+		{
+			storeUndelivered(st_sending);
+		}
+		else
+		{
+			bool held = m_Retry.hold(st_sending, true);
+			if (_isDebugEnabled)
+			{
+				Serial.print(held ? F("SmartThings: held for retry, messages waiting = ") : F("SmartThings: given up, dead letters = "));
+				Serial.println(held ? m_Retry.getPending() : m_Retry.getDeadLetters());
+			}
+		}
+		break;
+	}
+	st_sending = String();
+}
+}
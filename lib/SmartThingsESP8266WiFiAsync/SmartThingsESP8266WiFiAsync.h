@@ -0,0 +1,225 @@
+//*******************************************************************************
+//	SmartThings Arduino ESP8266 Wifi Library - asynchronous TCP
+//
+//	Same use as SmartThingsESP8266WiFi, built on the ESPAsyncTCP library instead of
+//	WiFiServer/WiFiClient.  Nothing here waits on a socket:
+//	-The Hub's requests are parsed (HttpRequestParser) in the receive callback of
+//	 the connection, and the callout function is called from there - a command
+//	 reaches its device as soon as the ESP8266 core runs the TCP stack, i.e. at
+//	 the next yield()/delay() of the sketch, even in the middle of a sensor's poll.
+//	-send() puts the message in a queue and returns; the connection to the Hub is
+//	 opened, written and closed by callbacks, one message at a time.  What cannot
+//	 be delivered is kept as the other transports keep it: in the event log, if one
+//	 is set (setEventLog()), or in the retry queue (setRetryPolicy()) - run()
+//	 replays and retries it, one message at a time with the new ones.
+//	-init() starts the WiFi join and returns; run() follows it and joins again after
+//	 an outage, as SmartThingsESP8266WiFi does.  isReady() is false until joined.
+//	Callbacks run outside loop(), so the callout must not block (st::Everything's
+//	receiveSmartString() does not - replies are queued in Everything::SendQueue).
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  The RSSI is reported when it changes (see RssiReporter.h)
+//	2026-10-17  Per Ivar Nerseth  Non-blocking WiFi join; undelivered messages go to the shared retry queue or event log
+//*******************************************************************************
+
+#ifndef __SMARTTHINGSESP8266WIFIASYNC_H__
+#define __SMARTTHINGSESP8266WIFIASYNC_H__
+
+#include "SmartThingsEthernet.h"
+#include "HttpConnections.h"
+
+//*******************************************************************************
+// Using ESP8266 WiFi with ESPAsyncTCP
+//*******************************************************************************
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ArduinoOTA.h>
+
+//Number of messages send() can hold while the connection to the Hub is busy
+#ifndef ASYNC_SEND_QUEUE_SIZE
+#define ASYNC_SEND_QUEUE_SIZE 8
+#endif
+
+//Maximum time for one message to the Hub: connect, POST and reply (in milliseconds)
+#ifndef ASYNC_SEND_TIMEOUT
+#define ASYNC_SEND_TIMEOUT 3000
+#endif
+
+//Maximum time for one attempt to join the WiFi network (in milliseconds)
+#ifndef WIFI_CONNECT_TIMEOUT
+#define WIFI_CONNECT_TIMEOUT 15000
+#endif
+
+//Wait before joining again after a failed attempt (in milliseconds), doubled after each further failure up to WIFI_RETRY_MAX
+#ifndef WIFI_RETRY_INTERVAL
+#define WIFI_RETRY_INTERVAL 1000
+#endif
+
+#ifndef WIFI_RETRY_MAX
+#define WIFI_RETRY_MAX 60000
+#endif
+
+namespace st
+{
+class SmartThingsESP8266WiFiAsync : public SmartThingsEthernet
+{
+  private:
+	//ESP8266 WiFi Specific
+	char st_ssid[50];
+	char st_password[50];
+	boolean st_preExistingConnection = false;
+	AsyncServer st_server; //server
+	char st_devicename[50];
+
+	//The WiFi join - run() moves from one state to the next, nothing waits
+	enum LinkState
+	{
+		LINK_CONNECTING, //WiFi.begin() called, waiting for WL_CONNECTED
+		LINK_UP,
+		LINK_WAITING	 //an attempt failed - the next one starts after st_retryInterval
+	};
+	LinkState st_linkState = LINK_CONNECTING;
+	unsigned long st_linkMillis = 0; //when st_linkState was entered
+	unsigned long st_retryInterval = WIFI_RETRY_INTERVAL;
+	bool st_servicesStarted = false; //OTA and the startup printout, once the network was first joined
+
+	void beginConnect();
+	void runLink();
+	void startServices();
+
+	//A connection from the Hub
+	struct Inbound
+	{
+		AsyncClient *client; //NULL == free
+		HttpRequestParser request;
+		unsigned long acceptedMillis;
+		String reply;		 //response still to be written
+		size_t replySent;
+	};
+	Inbound st_inbound[HTTP_MAX_CONNECTIONS];
+
+	//The connection to the Hub
+	enum SendState
+	{
+		SEND_IDLE,
+		SEND_CONNECTING,
+		SEND_WAITING, //request written, waiting for the reply
+		SEND_DONE	  //connection closed - run() settles the message
+	};
+	//where the message being sent came from - its result goes back there
+	enum SendSource
+	{
+		FROM_OUTBOX,
+		FROM_RETRY,	  //m_Retry
+		FROM_LOG	  //m_pEventLog
+	};
+	AsyncClient st_client; //client
+	SendState st_sendState;
+	SendSource st_sendSource;
+	String st_sending;	//the message being sent
+	long st_sendAge;	//EVENT-AGE of a replayed event, -1 if none
+	bool st_delivered;	//result of the connection, for run()
+	unsigned long st_sendStartMillis;
+	unsigned long st_sendStartMicros;
+	String st_outbox[ASYNC_SEND_QUEUE_SIZE];
+	byte st_outboxHead;
+	byte st_outboxCount;
+	unsigned long st_outboxDrops;
+
+	void setupCallbacks();
+
+	//inbound
+	void onConnection(AsyncClient *client);
+	void onRequestData(Inbound &inbound, const char *data, size_t len);
+	void onRequestPoll(Inbound &inbound);
+	void writeReply(Inbound &inbound);
+	void release(Inbound &inbound);
+
+	//outbound
+	void startSend();
+	void onHubConnect();
+	void finishSend(bool delivered);
+	void settleSend();
+
+  public:
+	//*******************************************************************************
+	/// @brief  SmartThings ESP8266 WiFi Async Constructor - Static IP
+	///   @param[in] ssid - Wifi Network SSID
+	///   @param[in] password - Wifi Network Password
+	///   @param[in] localIP - TCP/IP Address of the Arduino
+	///   @param[in] localGateway - TCP/IP Gateway Address of local LAN (your Router's LAN Address)
+	///   @param[in] localSubnetMask - Subnet Mask of the Arduino
+	///   @param[in] localDNSServer - DNS Server
+	///   @param[in] serverPort - TCP/IP Port of the Arduino
+	///   @param[in] hubIP - TCP/IP Address of the ST Hub
+	///   @param[in] hubPort - TCP/IP Port of the ST Hub
+	///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+	///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+	///   @param[in] enableDebug (optional) - Enable internal Library debug
+	//*******************************************************************************
+	SmartThingsESP8266WiFiAsync(String ssid, String password, IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType = "ESP8266Wifi", bool enableDebug = false, int transmitInterval = 100);
+
+	//*******************************************************************************
+	/// @brief  SmartThings ESP8266 WiFi Async Constructor - DHCP
+	///   @param[in] ssid - Wifi Network SSID
+	///   @param[in] password - Wifi Network Password
+	///   @param[in] serverPort - TCP/IP Port of the Arduino
+	///   @param[in] hubIP - TCP/IP Address of the ST Hub
+	///   @param[in] hubPort - TCP/IP Port of the ST Hub
+	///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+	///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+	///   @param[in] enableDebug (optional) - Enable internal Library debug
+	//*******************************************************************************
+	SmartThingsESP8266WiFiAsync(String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType = "ESP8266Wifi", bool enableDebug = false, int transmitInterval = 100);
+
+	//*******************************************************************************
+	/// @brief  SmartThings ESP8266 WiFi Async Constructor - Pre-existing connection
+	///   @param[in] serverPort - TCP/IP Port of the Arduino
+	///   @param[in] hubIP - TCP/IP Address of the ST Hub
+	///   @param[in] hubPort - TCP/IP Port of the ST Hub
+	///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+	///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+	///   @param[in] enableDebug (optional) - Enable internal Library debug
+	//*******************************************************************************
+	SmartThingsESP8266WiFiAsync(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType = "ESP8266Wifi", bool enableDebug = false, int transmitInterval = 100);
+
+	//*******************************************************************************
+	/// Destructor
+	//*******************************************************************************
+	~SmartThingsESP8266WiFiAsync();
+
+	//*******************************************************************************
+	/// Initialize SmartThingsESP8266WiFiAsync Library
+	//*******************************************************************************
+	virtual void init(void);
+
+	//*******************************************************************************
+	/// Run SmartThingsESP8266WiFiAsync Library - WiFi join, OTA, RSSI, retries and replays; the sockets are served by callbacks
+	//*******************************************************************************
+	virtual void run(void);
+
+	//*******************************************************************************
+	/// Ready once the WiFi network is joined - or, with an event log, once it was joined at least once
+	//*******************************************************************************
+	virtual bool isReady() const;
+
+	//*******************************************************************************
+	/// Store-and-forward - see SmartThings::setEventLog()
+	//*******************************************************************************
+	virtual bool setEventLog(EventLog *log)
+	{
+		m_pEventLog = log;
+		return true;
+	}
+
+	//*******************************************************************************
+	/// Send Message to the Hub - queued, returns at once
+	//*******************************************************************************
+	virtual void send(String message);
+};
+}
+#endif
@@ -7,29 +7,35 @@
 //	History
 //	2017-02-04  Dan Ogorchock  Created
 //  2017-05-02  Dan Ogorchock  Minor tweak to coexist peacefully with newer W5500 shield
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout
+//  2026-10-16  Per Ivar Nerseth  Added deliver() for the retry queue of the SmartThings base class
+//  2026-10-17  Per Ivar Nerseth  Derives from SmartThingsHttpCore - gains GET /metrics, keep-alive mode and the event log
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSETHERNETW5100_H__ 
 #define __SMARTTHINGSETHERNETW5100_H__
 
 
-#include "SmartThingsEthernet.h"
 #include <SPI.h>
 #include <Ethernet.h>
 
+#include "SmartThingsHttpCore.h"
+
 //*******************************************************************************
 // Using Ethernet Shield
 //*******************************************************************************
 
 namespace st
 {
-	class SmartThingsEthernetW5100: public SmartThingsEthernet
+	class SmartThingsEthernetW5100: public SmartThingsHttpCore<EthernetServer, EthernetClient, 1>
 	{
 	private:
 		//Ethernet W5100 Specific 
 		byte st_mac[6];
-		EthernetServer st_server; //server
-		EthernetClient st_client; //client
+
+	protected:
+		//SmartThingsHttpCore hook - restarts the shield when the Hub cannot be reached
+		virtual void hubUnreachable();
 
 	public:
 
@@ -75,12 +81,6 @@ namespace st
 		/// Run SmartThingsEthernet Library 
 		//*******************************************************************************
 		virtual void run(void);
-
-		//*******************************************************************************
-		/// Send Message to the Hub 
-		//*******************************************************************************
-		virtual void send(String message);
-
 	};
 }
 #endif
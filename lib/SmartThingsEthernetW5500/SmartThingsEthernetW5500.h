@@ -7,6 +7,9 @@
 //	History
 //	2017-02-04  Dan Ogorchock  Created
 //  2017-05-02  Dan Ogorchock  New version for the Arduino Ethernet 2 shield based on the W5500 chip 
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout
+//  2026-10-16  Per Ivar Nerseth  Added deliver() for the retry queue of the SmartThings base class
+//  2026-10-17  Per Ivar Nerseth  Derives from SmartThingsHttpCore - gains GET /metrics, keep-alive mode and the event log
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSETHERNETW5500_H__ 
@@ -14,7 +17,8 @@
 
 #include <SPI.h>
 #include <Ethernet2.h>
-#include "SmartThingsEthernet.h"
+
+#include "SmartThingsHttpCore.h"
 
 
 //*******************************************************************************
@@ -23,13 +27,15 @@
 
 namespace st
 {
-	class SmartThingsEthernetW5500: public SmartThingsEthernet
+	class SmartThingsEthernetW5500: public SmartThingsHttpCore<EthernetServer, EthernetClient, 1>
 	{
 	private:
 		//Ethernet W5500 Specific 
 		byte st_mac[6];
-		EthernetServer st_server; //server
-		EthernetClient st_client; //client
+
+	protected:
+		//SmartThingsHttpCore hook - restarts the shield when the Hub cannot be reached
+		virtual void hubUnreachable();
 
 	public:
 
@@ -75,12 +81,6 @@ namespace st
 		/// Run SmartThingsEthernet Library 
 		//*******************************************************************************
 		virtual void run(void);
-
-		//*******************************************************************************
-		/// Send Message to the Hub 
-		//*******************************************************************************
-		virtual void send(String message);
-
 	};
 }
 #endif
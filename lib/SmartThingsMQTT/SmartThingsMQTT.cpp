@@ -0,0 +1,657 @@
+//*******************************************************************************
+//	SmartThings Arduino MQTT Library
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  isReady() holds events in the SendQueue until CONNACK, and while the in-flight slots are taken
+//*******************************************************************************
+
+#include "SmartThingsMQTT.h"
+
+namespace st
+{
+namespace
+{
+//MQTT 3.1.1 control packet types (high nibble of the fixed header)
+const byte MQTT_CONNECT = 0x10;
+const byte MQTT_CONNACK = 0x20;
+const byte MQTT_PUBLISH = 0x30;
+const byte MQTT_PUBACK = 0x40;
+const byte MQTT_SUBSCRIBE = 0x82; //with the reserved flags 0010
+const byte MQTT_SUBACK = 0x90;
+const byte MQTT_PINGREQ = 0xC0;
+const byte MQTT_PINGRESP = 0xD0;
+const byte MQTT_DISCONNECT = 0xE0;
+
+const char MQTT_COMMAND_TOPIC[] = "/cmd";
+const char MQTT_STATUS_TOPIC[] = "/status";
+
+byte *putWord(byte *p, uint16_t value)
+{
+	*p++ = value >> 8;
+	*p++ = value & 0xFF;
+	return p;
+}
+
+byte *putString(byte *p, const String &value)
+{
+	p = putWord(p, value.length());
+	memcpy(p, value.c_str(), value.length());
+	return p + value.length();
+}
+}
+
+//*******************************************************************************
+// SmartThingsMQTT Constructor - broker by IP address
+//*******************************************************************************
+SmartThingsMQTT::SmartThingsMQTT(Client &client, IPAddress brokerIP, uint16_t brokerPort, String clientId, String topic, SmartThingsCallout_t *callout, byte qos, String shieldType, bool enableDebug, int transmitInterval) : SmartThings(callout, shieldType, enableDebug, transmitInterval),
+	st_client(client),
+	st_brokerIP(brokerIP),
+	st_brokerPort(brokerPort),
+	st_clientId(clientId),
+	st_topic(topic),
+	st_qos(qos ? 1 : 0),
+	st_state(MQTT_DISCONNECTED),
+	st_connectMillis(0),
+	st_lastOutbound(0),
+	st_lastInbound(0),
+	st_pingOutstanding(false),
+	st_rxLengthBytes(0),
+	st_rxLengthDone(false),
+	st_txUsed(0),
+	st_nextPacketId(1),
+	st_published(0),
+	st_acknowledged(0),
+	st_dropped(0),
+	st_downgraded(0),
+	st_reconnects(0),
+	st_commands(0)
+{
+	for (byte i = 0; i < MQTT_MAX_INFLIGHT; i++)
+	{
+		st_inflight[i].packetId = 0;
+	}
+}
+
+//*******************************************************************************
+// SmartThingsMQTT Constructor - broker by host name
+//*******************************************************************************
+SmartThingsMQTT::SmartThingsMQTT(Client &client, String brokerHost, uint16_t brokerPort, String clientId, String topic, SmartThingsCallout_t *callout, byte qos, String shieldType, bool enableDebug, int transmitInterval) : SmartThingsMQTT(client, IPAddress(), brokerPort, clientId, topic, callout, qos, shieldType, enableDebug, transmitInterval)
+{
+	st_brokerHost = brokerHost;
+}
+
+//*****************************************************************************
+//SmartThingsMQTT::~SmartThingsMQTT()
+//*****************************************************************************
+SmartThingsMQTT::~SmartThingsMQTT()
+{
+	if (st_state == MQTT_CONNECTED)
+	{
+		reservePacket(MQTT_DISCONNECT, 0);
+		flushPackets();
+	}
+	st_client.stop();
+}
+
+//*******************************************************************************
+/// User name and password for the broker
+//*******************************************************************************
+void SmartThingsMQTT::setCredentials(String user, String password)
+{
+	st_user = user;
+	st_password = password;
+}
+
+//*******************************************************************************
+/// Initialize SmartThingsMQTT Library
+//*******************************************************************************
+void SmartThingsMQTT::init(void)
+{
+	Serial.println(F(""));
+	Serial.print(F("MQTT broker: "));
+	if (st_brokerHost.length())
+	{
+		Serial.print(st_brokerHost);
+	}
+	else
+	{
+		Serial.print(st_brokerIP);
+	}
+	Serial.print(F(":"));
+	Serial.println(st_brokerPort);
+	Serial.print(F("MQTT topic: "));
+	Serial.println(st_topic);
+	Serial.print(F("MQTT QoS: "));
+	Serial.println(st_qos);
+
+	connectBroker();
+}
+
+//*****************************************************************************
+// Run SmartThingsMQTT
+//*****************************************************************************
+void SmartThingsMQTT::run(void)
+{
+	if (st_state != MQTT_DISCONNECTED && !st_client.connected())
+	{
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("MQTT: connection to the broker lost"));
+		}
+		disconnected();
+	}
+
+	if (st_state == MQTT_DISCONNECTED)
+	{
+		if (millis() - st_connectMillis >= MQTT_RECONNECT_INTERVAL)
+		{
+			connectBroker();
+		}
+		return;
+	}
+
+	readPackets();
+
+	unsigned long now = millis();
+	if (st_state == MQTT_CONNECTING)
+	{
+		if (now - st_connectMillis > MQTT_RECONNECT_INTERVAL)
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("MQTT: no CONNACK from the broker"));
+			}
+			m_nConnectFailures++;
+			st_client.stop();
+			disconnected();
+		}
+		return;
+	}
+
+	if (st_state == MQTT_CONNECTED && (now - st_lastOutbound > MQTT_KEEPALIVE * 1000UL || now - st_lastInbound > MQTT_KEEPALIVE * 1000UL))
+	{
+		if (st_pingOutstanding)
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("MQTT: no PINGRESP from the broker"));
+			}
+			st_client.stop();
+			disconnected();
+			return;
+		}
+		reservePacket(MQTT_PINGREQ, 0);
+		st_pingOutstanding = true;
+		st_lastInbound = now;
+	}
+
+	flushPackets(); //PUBACKs and PINGREQ
+}
+
+//*******************************************************************************
+/// Send Message to the Broker
+//*******************************************************************************
+void SmartThingsMQTT::send(String message)
+{
+	unsigned long startMicros = micros();
+
+	//in batch mode message holds several events, one per line
+	unsigned int start = 0;
+	while (start < message.length())
+	{
+		int end = message.indexOf('\n', start);
+		unsigned int length = (end < 0 ? message.length() : (unsigned int)end) - start;
+		if (length > 0)
+		{
+			publishEvent(message, start, length);
+		}
+		start += length + 1;
+	}
+	if (st_state == MQTT_CONNECTED)
+	{
+		flushPackets();
+	}
+
+	recordSend(startMicros);
+
+	if (_isDebugEnabled)
+	{
+		Serial.print(F("MQTT: published "));
+		Serial.println(message);
+	}
+}
+
+//*******************************************************************************
+/// Publishes one "<device> <value>" event, or keeps it for later (QoS 1)
+//*******************************************************************************
+void SmartThingsMQTT::publishEvent(const String &message, unsigned int start, unsigned int length)
+{
+	const char *event = message.c_str() + start;
+	if (st_qos == 0)
+	{
+		if (st_state != MQTT_CONNECTED || !writePublish(event, length, 0, 0, false))
+		{
+			st_dropped++;
+		}
+		return;
+	}
+
+	InFlight *slot = NULL;
+	for (byte i = 0; i < MQTT_MAX_INFLIGHT && slot == NULL; i++)
+	{
+		if (st_inflight[i].packetId == 0)
+		{
+			slot = &st_inflight[i];
+		}
+	}
+	if (slot == NULL)
+	{
+		if (st_state == MQTT_CONNECTED && writePublish(event, length, 0, 0, false))
+		{
+			st_downgraded++;
+		}
+		else
+		{
+			st_dropped++;
+		}
+		return;
+	}
+
+	slot->packetId = takePacketId();
+	slot->message = message.substring(start, start + length);
+	slot->sent = st_state == MQTT_CONNECTED && writePublish(event, length, 1, slot->packetId, false);
+}
+
+//*******************************************************************************
+/// Opens the connection and writes CONNECT - CONNACK is read by run()
+//*******************************************************************************
+void SmartThingsMQTT::connectBroker()
+{
+	st_connectMillis = millis();
+	st_rxLengthBytes = 0;
+	st_rxLengthDone = false;
+	st_txUsed = 0;
+	st_pingOutstanding = false;
+
+	int result = st_brokerHost.length() ? st_client.connect(st_brokerHost.c_str(), st_brokerPort) : st_client.connect(st_brokerIP, st_brokerPort);
+	if (!result)
+	{
+		m_nConnectFailures++;
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("MQTT: broker connection failed"));
+		}
+		return;
+	}
+
+	String willTopic = st_topic + MQTT_STATUS_TOPIC;
+	String willMessage = F("offline");
+	byte flags = 0x02 | 0x04 | (st_qos << 3) | 0x20; //clean session, will, will QoS, will retain
+	size_t length = 10 + 2 + st_clientId.length() + 2 + willTopic.length() + 2 + willMessage.length();
+	if (st_user.length())
+	{
+		flags |= 0x80;
+		length += 2 + st_user.length();
+		if (st_password.length())
+		{
+			flags |= 0x40;
+			length += 2 + st_password.length();
+		}
+	}
+
+	byte *p = reservePacket(MQTT_CONNECT, length);
+	if (p == NULL)
+	{
+		Serial.println(F("MQTT: client id, topic or credentials too long for MQTT_TX_BUFFER_SIZE"));
+		st_client.stop();
+		return;
+	}
+	p = putString(p, F("MQTT"));
+	*p++ = 4; //protocol level 3.1.1
+	*p++ = flags;
+	p = putWord(p, MQTT_KEEPALIVE);
+	p = putString(p, st_clientId);
+	p = putString(p, willTopic);
+	p = putString(p, willMessage);
+	if (flags & 0x80)
+	{
+		p = putString(p, st_user);
+	}
+	if (flags & 0x40)
+	{
+		p = putString(p, st_password);
+	}
+
+	st_state = MQTT_CONNECTING;
+	st_lastInbound = millis();
+	flushPackets();
+}
+
+//*******************************************************************************
+/// Forgets the connection - QoS 1 messages stay in flight for the next one
+//*******************************************************************************
+void SmartThingsMQTT::disconnected()
+{
+	if (st_state == MQTT_CONNECTED)
+	{
+		st_reconnects++;
+		st_connectMillis = millis() - MQTT_RECONNECT_INTERVAL; //first attempt at once
+	}
+	st_state = MQTT_DISCONNECTED;
+	st_txUsed = 0;
+}
+
+//*******************************************************************************
+/// Reads what the broker has sent, without waiting for more
+//*******************************************************************************
+void SmartThingsMQTT::readPackets()
+{
+	for (;;)
+	{
+		if (st_rxLengthDone && st_rxRead == st_rxLength)
+		{
+			handlePacket();
+			st_rxLengthBytes = 0;
+			st_rxLengthDone = false;
+			if (st_state == MQTT_DISCONNECTED)
+			{
+				return;
+			}
+		}
+
+		int available = st_client.available();
+		if (available <= 0)
+		{
+			return;
+		}
+
+		if (!st_rxLengthDone)
+		{
+			int c = st_client.read();
+			if (c < 0)
+			{
+				return;
+			}
+			if (st_rxLengthBytes == 0)
+			{
+				st_rxHeader = c;
+				st_rxLength = 0;
+				st_rxRead = 0;
+				st_rxLengthBytes = 1;
+				continue;
+			}
+			st_rxLength |= (unsigned long)(c & 0x7F) << (7 * (st_rxLengthBytes - 1));
+			st_rxLengthDone = (c & 0x80) == 0;
+			if (!st_rxLengthDone && ++st_rxLengthBytes > 4)
+			{
+				Serial.println(F("MQTT: malformed packet from the broker"));
+				st_client.stop();
+				disconnected();
+				return;
+			}
+			continue;
+		}
+
+		//body - what does not fit in st_rxBuffer is read and thrown away
+		byte discard[32];
+		byte *dest = discard;
+		unsigned long room = sizeof(discard);
+		if (st_rxRead < MQTT_PACKET_SIZE)
+		{
+			dest = st_rxBuffer + st_rxRead;
+			room = MQTT_PACKET_SIZE - st_rxRead;
+		}
+		unsigned long wanted = st_rxLength - st_rxRead;
+		wanted = wanted < room ? wanted : room;
+		wanted = wanted < (unsigned long)available ? wanted : available;
+		int count = st_client.read(dest, wanted);
+		if (count <= 0)
+		{
+			return;
+		}
+		st_rxRead += count;
+	}
+}
+
+//*******************************************************************************
+/// Acts on the packet in st_rxBuffer (its first MQTT_PACKET_SIZE bytes)
+//*******************************************************************************
+void SmartThingsMQTT::handlePacket()
+{
+	st_lastInbound = millis();
+	unsigned long length = st_rxLength < MQTT_PACKET_SIZE ? st_rxLength : MQTT_PACKET_SIZE;
+	const byte *body = st_rxBuffer;
+
+	switch (st_rxHeader & 0xF0)
+	{
+	case MQTT_CONNACK:
+		if (st_state != MQTT_CONNECTING)
+		{
+			break;
+		}
+		if (length < 2 || body[1] != 0)
+		{
+			Serial.print(F("MQTT: broker refused the connection, code "));
+			Serial.println(length < 2 ? -1 : body[1]);
+			m_nConnectFailures++;
+			st_client.stop();
+			disconnected();
+			break;
+		}
+		st_state = MQTT_CONNECTED;
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("MQTT: connected"));
+		}
+		{
+			String commandTopic = st_topic + MQTT_COMMAND_TOPIC;
+			byte *p = reservePacket(MQTT_SUBSCRIBE, 2 + 2 + commandTopic.length() + 1);
+			if (p)
+			{
+				p = putWord(p, takePacketId());
+				p = putString(p, commandTopic);
+				*p = st_qos;
+			}
+		}
+		writePublish("status online", 13, st_qos, st_qos ? takePacketId() : 0, false, true);
+		for (byte i = 0; i < MQTT_MAX_INFLIGHT; i++)
+		{
+			InFlight &slot = st_inflight[i];
+			if (slot.packetId)
+			{
+				writePublish(slot.message.c_str(), slot.message.length(), 1, slot.packetId, slot.sent);
+				slot.sent = true;
+			}
+		}
+		break;
+
+	case MQTT_PUBLISH:
+	{
+		byte qos = (st_rxHeader >> 1) & 0x03;
+		unsigned long topicLength = length < 2 ? length : (body[0] << 8) | body[1];
+		unsigned long payload = 2 + topicLength + (qos ? 2 : 0);
+		if (payload > length)
+		{
+			break; //topic longer than MQTT_PACKET_SIZE
+		}
+		if (qos == 1)
+		{
+			byte *p = reservePacket(MQTT_PUBACK, 2);
+			if (p)
+			{
+				p[0] = body[payload - 2];
+				p[1] = body[payload - 1];
+			}
+		}
+		if (st_rxLength > MQTT_PACKET_SIZE)
+		{
+			Serial.println(F("MQTT: command longer than MQTT_PACKET_SIZE ignored"));
+			break;
+		}
+		size_t prefix = st_topic.length();
+		if (topicLength == prefix + sizeof(MQTT_COMMAND_TOPIC) - 1 && memcmp(body + 2, st_topic.c_str(), prefix) == 0 &&
+			memcmp(body + 2 + prefix, MQTT_COMMAND_TOPIC, sizeof(MQTT_COMMAND_TOPIC) - 1) == 0)
+		{
+			st_rxBuffer[length] = 0;
+			st_commands++;
+			if (_isDebugEnabled)
+			{
+				Serial.print(F("MQTT: command "));
+				Serial.println((const char *)body + payload);
+			}
+			_calloutFunction(String((const char *)body + payload));
+		}
+		break;
+	}
+
+	case MQTT_PUBACK:
+		if (length >= 2)
+		{
+			uint16_t packetId = (body[0] << 8) | body[1];
+			for (byte i = 0; i < MQTT_MAX_INFLIGHT; i++)
+			{
+				if (st_inflight[i].packetId == packetId)
+				{
+					st_inflight[i].packetId = 0;
+					st_inflight[i].message = "";
+					st_acknowledged++;
+				}
+			}
+		}
+		break;
+
+	case MQTT_SUBACK:
+		if (length >= 3 && body[2] == 0x80)
+		{
+			Serial.println(F("MQTT: broker refused the command topic subscription"));
+		}
+		break;
+
+	case MQTT_PINGRESP:
+		st_pingOutstanding = false;
+		break;
+	}
+}
+
+//*******************************************************************************
+/// Appends the fixed header of a packet to st_txBuffer and returns where its
+/// length bytes go - NULL if it cannot fit
+//*******************************************************************************
+byte *SmartThingsMQTT::reservePacket(byte header, size_t length)
+{
+	size_t lengthBytes = length < 128 ? 1 : length < 16384 ? 2 : 3;
+	size_t needed = 1 + lengthBytes + length;
+	if (needed > MQTT_TX_BUFFER_SIZE)
+	{
+		return NULL;
+	}
+	if (st_txUsed + needed > MQTT_TX_BUFFER_SIZE && !flushPackets())
+	{
+		return NULL;
+	}
+
+	byte *p = st_txBuffer + st_txUsed;
+	st_txUsed += needed;
+	*p++ = header;
+	do
+	{
+		byte digit = length % 128;
+		length /= 128;
+		*p++ = length > 0 ? digit | 0x80 : digit;
+	} while (length > 0);
+	return p;
+}
+
+//*******************************************************************************
+/// Writes every packet collected in st_txBuffer - false if the connection broke
+//*******************************************************************************
+bool SmartThingsMQTT::flushPackets()
+{
+	if (st_txUsed == 0)
+	{
+		return true;
+	}
+	size_t written = st_client.write(st_txBuffer, st_txUsed);
+	bool ok = written == st_txUsed;
+	st_txUsed = 0;
+	st_lastOutbound = millis();
+	if (!ok)
+	{
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("MQTT: write to the broker failed"));
+		}
+		st_client.stop();
+		disconnected();
+	}
+	return ok;
+}
+
+//*******************************************************************************
+/// Appends a PUBLISH of "<device> <value>": <value> on <topic>/<device>
+//*******************************************************************************
+bool SmartThingsMQTT::writePublish(const char *message, size_t length, byte qos, uint16_t packetId, bool dup, bool retain)
+{
+	const char *space = (const char *)memchr(message, ' ', length);
+	size_t nameLength = space ? space - message : length;
+	const char *payload = space ? space + 1 : message + length;
+	size_t payloadLength = message + length - payload;
+	size_t topicLength = st_topic.length() + 1 + nameLength;
+
+	byte *p = reservePacket(MQTT_PUBLISH | (dup ? 0x08 : 0) | (qos << 1) | (retain ? 0x01 : 0), 2 + topicLength + (qos ? 2 : 0) + payloadLength);
+	if (p == NULL)
+	{
+		return false;
+	}
+	p = putWord(p, topicLength);
+	memcpy(p, st_topic.c_str(), st_topic.length());
+	p += st_topic.length();
+	*p++ = '/';
+	memcpy(p, message, nameLength);
+	p += nameLength;
+	if (qos)
+	{
+		p = putWord(p, packetId);
+	}
+	memcpy(p, payload, payloadLength);
+	st_published++;
+	return true;
+}
+
+//*******************************************************************************
+/// Next packet identifier (never 0)
+//*******************************************************************************
+uint16_t SmartThingsMQTT::takePacketId()
+{
+	if (st_nextPacketId == 0)
+	{
+		st_nextPacketId = 1;
+	}
+	return st_nextPacketId++;
+}
+
+//*******************************************************************************
+/// QoS 1 messages waiting for their PUBACK
+//*******************************************************************************
+byte SmartThingsMQTT::getInFlight() const
+{
+	byte count = 0;
+	for (byte i = 0; i < MQTT_MAX_INFLIGHT; i++)
+	{
+		count += st_inflight[i].packetId ? 1 : 0;
+	}
+	return count;
+}
+
+//*******************************************************************************
+/// Ready to publish - the SendQueue holds the events until then
+//*******************************************************************************
+bool SmartThingsMQTT::isReady() const
+{
+	return st_state == MQTT_CONNECTED && (st_qos == 0 || getInFlight() < MQTT_MAX_INFLIGHT);
+}
+}
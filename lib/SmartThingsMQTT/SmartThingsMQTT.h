@@ -0,0 +1,218 @@
+//*******************************************************************************
+//	SmartThings Arduino MQTT Library
+//
+//	Sends the events of ST_Anything to an MQTT broker instead of POSTing them to
+//	the Hub, over one persistent connection:
+//	-"temperature1 72.5" is published as "72.5" on <topic>/temperature1
+//	-every message received on <topic>/cmd ("switch1 on", "refresh", ...) is passed
+//	 to the callout function, i.e. st::receiveSmartString()
+//	-<topic>/status is "online" while connected, and "offline" (the broker's will
+//	 message) once the connection is lost - both retained
+//
+//	Works over any Client of the network library (WiFiClient, EthernetClient, ...):
+//	the sketch brings up the network itself, then passes its client, e.g.
+//		WiFiClient mqttClient;
+//		st::Everything::SmartThing = new st::SmartThingsMQTT(mqttClient, brokerIP, 1883,
+//			"esp8266-livingroom", "st/livingroom", st::receiveSmartString, 1);
+//
+//	QoS 0 publishes and forgets.  QoS 1 keeps up to MQTT_MAX_INFLIGHT messages until
+//	the broker acknowledges them, including while disconnected, and publishes them
+//	again (DUP) after a reconnect - the broker may then see an event twice.  The
+//	command topic is subscribed with the same QoS.
+//
+//	isReady() is true only once the broker has accepted the connection (CONNACK)
+//	and, at QoS 1, while an in-flight slot is free - until then the events wait in
+//	Everything's SendQueue, at startup and after every reconnect.
+//
+//	In batch mode (setBatchMode(true)) send() gets every queued event at once and
+//	writes all their PUBLISH packets in one go - each event still has its own
+//	topic, so nothing needs to split them.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  isReady() - no events before CONNACK, or while every in-flight slot is taken
+//*******************************************************************************
+
+#ifndef __SMARTTHINGSMQTT_H__
+#define __SMARTTHINGSMQTT_H__
+
+#include "SmartThings.h"
+
+#include <Client.h>
+#include <IPAddress.h>
+
+//Largest packet read from the broker (a command publish); larger ones are skipped
+#ifndef MQTT_PACKET_SIZE
+#define MQTT_PACKET_SIZE 256
+#endif
+
+//Packets are collected in this buffer and written to the broker together
+#ifndef MQTT_TX_BUFFER_SIZE
+#define MQTT_TX_BUFFER_SIZE 512
+#endif
+
+//QoS 1 messages that can wait for their PUBACK
+#ifndef MQTT_MAX_INFLIGHT
+#define MQTT_MAX_INFLIGHT 8
+#endif
+
+//Keep alive interval agreed with the broker (in seconds)
+#ifndef MQTT_KEEPALIVE
+#define MQTT_KEEPALIVE 60
+#endif
+
+//Time between two failed connection attempts, and the longest wait for CONNACK (in milliseconds) -
+//a connection that is lost is reopened at once
+#ifndef MQTT_RECONNECT_INTERVAL
+#define MQTT_RECONNECT_INTERVAL 5000
+#endif
+
+namespace st
+{
+class SmartThingsMQTT : public SmartThings
+{
+  private:
+	enum ConnectionState
+	{
+		MQTT_DISCONNECTED,
+		MQTT_CONNECTING, //CONNECT written, waiting for CONNACK
+		MQTT_CONNECTED
+	};
+
+	//a QoS 1 message waiting for its PUBACK
+	struct InFlight
+	{
+		uint16_t packetId; //0 == free
+		String message;	//"<device> <value>"
+		bool sent;		//published at least once - repeats carry the DUP flag
+	};
+
+	Client &st_client;
+	IPAddress st_brokerIP;
+	String st_brokerHost; //used instead of st_brokerIP when set
+	uint16_t st_brokerPort;
+	String st_clientId;
+	String st_topic;
+	String st_user;
+	String st_password;
+	byte st_qos;
+
+	ConnectionState st_state;
+	unsigned long st_connectMillis;	//last connection attempt
+	unsigned long st_lastOutbound;
+	unsigned long st_lastInbound;
+	bool st_pingOutstanding;
+
+	//packet being read
+	byte st_rxHeader;
+	unsigned long st_rxLength;
+	byte st_rxLengthBytes; //remaining length bytes read, 0 == reading the fixed header byte
+	bool st_rxLengthDone;
+	unsigned long st_rxRead;
+	byte st_rxBuffer[MQTT_PACKET_SIZE + 1]; //+1 for the terminating 0 of a command
+
+	byte st_txBuffer[MQTT_TX_BUFFER_SIZE];
+	size_t st_txUsed;
+
+	InFlight st_inflight[MQTT_MAX_INFLIGHT];
+	uint16_t st_nextPacketId;
+
+	unsigned long st_published;	  //PUBLISH packets written, including repeats
+	unsigned long st_acknowledged;  //PUBACKs received
+	unsigned long st_dropped;		  //events lost: QoS 0 while disconnected, QoS 1 with no free in-flight slot while disconnected
+	unsigned long st_downgraded;	  //QoS 1 events published at QoS 0 because every in-flight slot was taken
+	unsigned long st_reconnects;	  //connections lost after CONNACK
+	unsigned long st_commands;	  //commands passed to the callout
+
+	void connectBroker();
+	void disconnected();
+	void readPackets();
+	void handlePacket();
+
+	byte *reservePacket(byte header, size_t length);
+	bool flushPackets();
+	bool writePublish(const char *message, size_t length, byte qos, uint16_t packetId, bool dup, bool retain = false);
+	void publishEvent(const String &message, unsigned int start, unsigned int length);
+	uint16_t takePacketId();
+
+  public:
+	//*******************************************************************************
+	/// @brief  SmartThings MQTT Constructor - broker by IP address
+	///   @param[in] client - Client of the network library, used for the broker connection only
+	///   @param[in] brokerIP - TCP/IP Address of the MQTT broker
+	///   @param[in] brokerPort - TCP/IP Port of the MQTT broker (usually 1883)
+	///   @param[in] clientId - MQTT client identifier, unique per device
+	///   @param[in] topic - topic prefix of this device, e.g. "st/livingroom" (no trailing '/')
+	///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+	///   @param[in] qos (optional) - 0 or 1, for the events and the command topic
+	///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+	///   @param[in] enableDebug (optional) - Enable internal Library debug
+	//*******************************************************************************
+	SmartThingsMQTT(Client &client, IPAddress brokerIP, uint16_t brokerPort, String clientId, String topic, SmartThingsCallout_t *callout, byte qos = 0, String shieldType = "MQTT", bool enableDebug = false, int transmitInterval = 100);
+
+	//*******************************************************************************
+	/// @brief  SmartThings MQTT Constructor - broker by host name
+	///   @param[in] brokerHost - Host name of the MQTT broker
+	///   (other parameters as above)
+	//*******************************************************************************
+	SmartThingsMQTT(Client &client, String brokerHost, uint16_t brokerPort, String clientId, String topic, SmartThingsCallout_t *callout, byte qos = 0, String shieldType = "MQTT", bool enableDebug = false, int transmitInterval = 100);
+
+	//*******************************************************************************
+	/// Destructor
+	//*******************************************************************************
+	~SmartThingsMQTT();
+
+	//*******************************************************************************
+	/// User name and password for the broker - call before init()
+	//*******************************************************************************
+	void setCredentials(String user, String password);
+
+	//*******************************************************************************
+	/// Initialize SmartThingsMQTT Library - opens the connection to the broker
+	//*******************************************************************************
+	virtual void init(void);
+
+	//*******************************************************************************
+	/// Run SmartThingsMQTT Library - reads the broker's packets, keeps the connection alive and reconnects
+	//*******************************************************************************
+	virtual void run(void);
+
+	//*******************************************************************************
+	/// Send Message to the Broker - one PUBLISH per line
+	//*******************************************************************************
+	virtual void send(String message);
+
+	//*******************************************************************************
+	/// Batch mode is supported - every event keeps its own topic
+	//*******************************************************************************
+	virtual bool setBatchMode(bool enable)
+	{
+		m_bBatchMode = enable;
+		return true;
+	}
+
+	//*******************************************************************************
+	/// The broker connection is always persistent
+	//*******************************************************************************
+	virtual bool setKeepAlive(bool enable) { return enable; }
+
+	//*******************************************************************************
+	/// Ready once connected (CONNACK received) and, at QoS 1, with an in-flight slot free
+	//*******************************************************************************
+	virtual bool isReady() const;
+
+	//gets
+	bool connected() const { return st_state == MQTT_CONNECTED; }
+	byte getInFlight() const;
+	unsigned long getPublished() const { return st_published; }
+	unsigned long getAcknowledged() const { return st_acknowledged; }
+	unsigned long getDropped() const { return st_dropped; }
+	unsigned long getDowngraded() const { return st_downgraded; }
+	unsigned long getReconnects() const { return st_reconnects; }
+	unsigned long getCommands() const { return st_commands; }
+};
+}
+#endif
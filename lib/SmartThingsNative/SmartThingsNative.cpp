@@ -0,0 +1,49 @@
+//*******************************************************************************
+//	SmartThings Native Library - the LAN transport on a Linux host
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created
+//*******************************************************************************
+
+#include "SmartThingsNative.h"
+
+namespace st
+{
+	//*******************************************************************************
+	// SmartThingsNative Constructor
+	//*******************************************************************************
+	SmartThingsNative::SmartThingsNative(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
+		SmartThingsHttpCore(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true)
+	{
+	}
+
+	//*****************************************************************************
+	//SmartThingsNative::~SmartThingsNative()
+	//*****************************************************************************
+	SmartThingsNative::~SmartThingsNative()
+	{
+
+	}
+
+	//*******************************************************************************
+	/// Initialize SmartThingsNative Library
+	//*******************************************************************************
+	void SmartThingsNative::init(void)
+	{
+		st_server.begin();
+
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("serverPort = "));
+			Serial.println(st_server.port());
+			Serial.print(F("hubIP = "));
+			Serial.println(st_hubIP);
+			Serial.print(F("hubPort = "));
+			Serial.println(st_hubPort);
+			Serial.println(F("SmartThingsNative: Intialized"));
+		}
+	}
+}
@@ -0,0 +1,60 @@
+//*******************************************************************************
+//	SmartThings Native Library - the LAN transport on a Linux host
+//
+//	SmartThingsHttpCore on the POSIX sockets of lib/ArduinoNative (NativeServer,
+//	NativeClient): the same request handling, sending, keep-alive, retries and
+//	GET /metrics as SmartThingsESP8266WiFi, so the transport engine can be run
+//	and load-tested on the host ([env:native] in platformio.ini, bench suite "core").
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-17  Per Ivar Nerseth  Created
+//*******************************************************************************
+
+#ifndef __SMARTTHINGSNATIVE_H__
+#define __SMARTTHINGSNATIVE_H__
+
+//*******************************************************************************
+// Using POSIX sockets
+//*******************************************************************************
+#include <NativeSocket.h>
+
+#include "SmartThingsHttpCore.h"
+
+namespace st
+{
+	class SmartThingsNative: public SmartThingsHttpCore<NativeServer, NativeClient, HTTP_MAX_CONNECTIONS>
+	{
+	protected:
+		//SmartThingsHttpCore hook
+		virtual void hubConnected() { st_client.setNoDelay(true); } //each request is one write (writeRequest()) - send it at once, without waiting for an ACK
+
+	public:
+		//*******************************************************************************
+		/// @brief  SmartThings Native Constructor
+		///   @param[in] serverPort - TCP/IP Port requests are served on, 0 == any free port (see getServerPort())
+		///   @param[in] hubIP - TCP/IP Address of the ST Hub
+		///   @param[in] hubPort - TCP/IP Port of the ST Hub
+		///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+		///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+		///   @param[in] enableDebug (optional) - Enable internal Library debug
+		//*******************************************************************************
+		SmartThingsNative(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType = "Native", bool enableDebug = false, int transmitInterval = 100);
+
+		//*******************************************************************************
+		/// Destructor
+		//*******************************************************************************
+		~SmartThingsNative();
+
+		//*******************************************************************************
+		/// Initialize SmartThingsNative Library - listens on serverPort
+		//*******************************************************************************
+		virtual void init(void);
+
+		//port requests are served on - known after init()
+		uint16_t getServerPort() const { return st_server.port(); }
+	};
+}
+#endif
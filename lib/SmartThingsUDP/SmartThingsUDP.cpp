@@ -0,0 +1,374 @@
+//*******************************************************************************
+//	SmartThings Arduino UDP Library
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  Commands carry the receiver's session - a new session clears the command history
+//	2026-10-17  Per Ivar Nerseth  Datagrams are repeated until acknowledged; a full window waits in the retry queue instead of pushing out the oldest
+//*******************************************************************************
+
+#include "SmartThingsUDP.h"
+
+namespace st
+{
+namespace
+{
+//"E <session> <seq>\n" is at most this long
+const unsigned int UDP_HEADER_LENGTH = 24;
+}
+
+//*******************************************************************************
+// SmartThingsUDP Constructor
+//*******************************************************************************
+SmartThingsUDP::SmartThingsUDP(UDP &udp, IPAddress hubIP, uint16_t hubPort, uint16_t localPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) : SmartThings(callout, shieldType, enableDebug, transmitInterval),
+	st_udp(udp),
+	st_hubIP(hubIP),
+	st_hubPort(hubPort),
+	st_localPort(localPort),
+	st_session(0),
+	st_nextSeq(1),
+	st_commandSession(0),
+	st_commandNext(0),
+	st_datagrams(0),
+	st_retransmits(0),
+	st_acknowledged(0),
+	st_lost(0),
+	st_ackMicrosTotal(0),
+	st_ackMicrosMax(0),
+	st_ackSamples(0),
+	st_commands(0)
+{
+	for (byte i = 0; i < UDP_WINDOW_SIZE; i++)
+	{
+		st_window[i].seq = 0;
+	}
+	for (byte i = 0; i < UDP_COMMAND_HISTORY; i++)
+	{
+		st_commandIds[i] = 0;
+	}
+}
+
+//*****************************************************************************
+//SmartThingsUDP::~SmartThingsUDP()
+//*****************************************************************************
+SmartThingsUDP::~SmartThingsUDP()
+{
+	st_udp.stop();
+}
+
+//*******************************************************************************
+/// Initialize SmartThingsUDP Library
+//*******************************************************************************
+void SmartThingsUDP::init(void)
+{
+	//the time it took to get here varies from boot to boot - and a receiver also starts a session over at <seq> 1
+	st_session = micros();
+	if (st_session == 0)
+	{
+		st_session = 1;
+	}
+	st_nextSeq = 1;
+
+	if (!st_udp.begin(st_localPort))
+	{
+		Serial.println(F("UDP: could not open the local port"));
+	}
+
+	Serial.println(F(""));
+	Serial.print(F("UDP receiver: "));
+	Serial.print(st_hubIP);
+	Serial.print(F(":"));
+	Serial.println(st_hubPort);
+	Serial.print(F("UDP local port: "));
+	Serial.println(st_localPort);
+	Serial.print(F("UDP session: "));
+	Serial.println(st_session);
+}
+
+//*****************************************************************************
+// Run SmartThingsUDP
+//*****************************************************************************
+void SmartThingsUDP::run(void)
+{
+	readDatagrams();
+
+	//selective repeat - only the datagrams whose ack is overdue, for as long as it takes
+	unsigned long now = millis();
+	for (byte i = 0; i < UDP_WINDOW_SIZE; i++)
+	{
+		Pending &pending = st_window[i];
+		if (pending.seq == 0 || now - pending.sentMillis < pending.timeout)
+		{
+			continue;
+		}
+		if (pending.retries < 255)
+		{
+			pending.retries++;
+		}
+		pending.timeout = pending.timeout * 2 < UDP_RETRANSMIT_MAX ? pending.timeout * 2 : UDP_RETRANSMIT_MAX;
+		st_retransmits++;
+		transmit(pending);
+	}
+
+	//datagrams that found the window full take the places acks have freed, in order
+	while (!m_Retry.empty() && freeSlot() != NULL)
+	{
+		String events = m_Retry.peek();
+		m_Retry.attempted(true);
+		queueDatagram(events);
+	}
+}
+
+//*******************************************************************************
+/// Send Message to the Hub
+//*******************************************************************************
+void SmartThingsUDP::send(String message)
+{
+	unsigned long startMicros = micros();
+
+	if (message.indexOf('\n') < 0)
+	{
+		queueDatagram(message);
+	}
+	else
+	{
+		//batch mode - as many events per datagram as fit
+		String events;
+		unsigned int start = 0;
+		while (start < message.length())
+		{
+			int end = message.indexOf('\n', start);
+			unsigned int length = (end < 0 ? message.length() : (unsigned int)end) - start;
+			if (length > 0)
+			{
+				if (events.length() && UDP_HEADER_LENGTH + events.length() + 1 + length > UDP_MAX_DATAGRAM)
+				{
+					queueDatagram(events);
+					events = "";
+				}
+				if (events.length())
+				{
+					events += '\n';
+				}
+				events += message.substring(start, start + length);
+			}
+			start += length + 1;
+		}
+		if (events.length())
+		{
+			queueDatagram(events);
+		}
+	}
+
+	recordSend(startMicros);
+
+	if (_isDebugEnabled)
+	{
+		Serial.print(F("UDP: sent "));
+		Serial.println(message);
+	}
+}
+
+//*******************************************************************************
+/// Numbers the events, keeps them in the window and sends them
+//*******************************************************************************
+void SmartThingsUDP::queueDatagram(const String &events)
+{
+	Pending *slot = m_Retry.empty() ? freeSlot() : NULL;
+	if (slot == NULL)
+	{
+		//numbered once a place is free - run() takes it from the retry queue
+		if (!m_Retry.hold(events, false))
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.print(F("UDP: window and retry queue full, given up: "));
+				Serial.println(events);
+			}
+			st_lost++;
+		}
+		return;
+	}
+
+	slot->seq = st_nextSeq++;
+	slot->datagram = F("E ");
+	slot->datagram += st_session;
+	slot->datagram += ' ';
+	slot->datagram += slot->seq;
+	slot->datagram += '\n';
+	slot->datagram += events;
+	slot->sentMicros = micros();
+	slot->timeout = UDP_RETRANSMIT_TIMEOUT;
+	slot->retries = 0;
+	transmit(*slot);
+}
+
+//*******************************************************************************
+/// A free place in the window, NULL if every datagram waits for its ack
+//*******************************************************************************
+SmartThingsUDP::Pending *SmartThingsUDP::freeSlot()
+{
+	for (byte i = 0; i < UDP_WINDOW_SIZE; i++)
+	{
+		if (st_window[i].seq == 0)
+		{
+			return &st_window[i];
+		}
+	}
+	return NULL;
+}
+
+//*******************************************************************************
+/// Ready to send
+//*******************************************************************************
+bool SmartThingsUDP::isReady() const
+{
+	return getPending() < UDP_WINDOW_SIZE && m_Retry.empty();
+}
+
+//*******************************************************************************
+/// Sends one datagram of the window
+//*******************************************************************************
+void SmartThingsUDP::transmit(Pending &pending)
+{
+	pending.sentMillis = millis();
+	st_datagrams++;
+	if (!st_udp.beginPacket(st_hubIP, st_hubPort))
+	{
+		return; //repeated when its timeout expires
+	}
+	st_udp.write((const uint8_t *)pending.datagram.c_str(), pending.datagram.length());
+	if (!st_udp.endPacket() && _isDebugEnabled)
+	{
+		Serial.println(F("UDP: send failed"));
+	}
+}
+
+//*******************************************************************************
+/// Reads every datagram that has arrived, without waiting for more
+//*******************************************************************************
+void SmartThingsUDP::readDatagrams()
+{
+	char buffer[UDP_MAX_DATAGRAM + 1];
+	while (st_udp.parsePacket() > 0)
+	{
+		int length = st_udp.read(buffer, UDP_MAX_DATAGRAM);
+		if (length < 2)
+		{
+			continue;
+		}
+		buffer[length] = 0;
+		if (buffer[0] == 'A' && buffer[1] == ' ')
+		{
+			handleAck(buffer + 2);
+		}
+		else if (buffer[0] == 'C' && buffer[1] == ' ')
+		{
+			handleCommand(buffer + 2, length - 2);
+		}
+	}
+}
+
+//*******************************************************************************
+/// "A <session> <seq> [<all>]" - frees datagram <seq>, and every datagram up to <all>
+//*******************************************************************************
+void SmartThingsUDP::handleAck(const char *text)
+{
+	char *end;
+	unsigned long session = strtoul(text, &end, 10);
+	unsigned long seq = strtoul(end, &end, 10);
+	unsigned long all = strtoul(end, &end, 10);
+	if (session != st_session || seq == 0)
+	{
+		return;
+	}
+	for (byte i = 0; i < UDP_WINDOW_SIZE; i++)
+	{
+		Pending &pending = st_window[i];
+		if (pending.seq == 0 || (pending.seq != seq && pending.seq > all))
+		{
+			continue;
+		}
+		if (pending.seq == seq && pending.retries == 0)
+		{
+			//a repeated datagram's ack could be for any of its copies
+			unsigned long elapsed = micros() - pending.sentMicros;
+			st_ackMicrosTotal += elapsed;
+			st_ackSamples++;
+			if (elapsed > st_ackMicrosMax)
+			{
+				st_ackMicrosMax = elapsed;
+			}
+		}
+		pending.seq = 0;
+		pending.datagram = "";
+		st_acknowledged++;
+	}
+}
+
+//*******************************************************************************
+/// "C <session> <id>\n<command>" - acknowledged every time, passed to the callout once per session and id
+//*******************************************************************************
+void SmartThingsUDP::handleCommand(const char *text, size_t length)
+{
+	char *end;
+	unsigned long session = strtoul(text, &end, 10);
+	unsigned long id = strtoul(end, &end, 10);
+	const char *command = (const char *)memchr(end, '\n', length - (end - text));
+	if (command == NULL)
+	{
+		return;
+	}
+
+	st_udp.beginPacket(st_udp.remoteIP(), st_udp.remotePort());
+	st_udp.print(F("K "));
+	st_udp.print(session);
+	st_udp.print(F(" "));
+	st_udp.print(id);
+	st_udp.endPacket();
+
+	if (session != st_commandSession)
+	{
+		//a restarted receiver numbers its commands from 1 again
+		st_commandSession = session;
+		for (byte i = 0; i < UDP_COMMAND_HISTORY; i++)
+		{
+			st_commandIds[i] = 0;
+		}
+		st_commandNext = 0;
+	}
+	for (byte i = 0; i < UDP_COMMAND_HISTORY; i++)
+	{
+		if (st_commandIds[i] == id && id != 0)
+		{
+			return; //repeat - its ack was lost
+		}
+	}
+	st_commandIds[st_commandNext] = id;
+	st_commandNext = (st_commandNext + 1) % UDP_COMMAND_HISTORY;
+
+	st_commands++;
+	if (_isDebugEnabled)
+	{
+		Serial.print(F("UDP: command "));
+		Serial.println(command + 1);
+	}
+	_calloutFunction(String(command + 1));
+}
+
+//*******************************************************************************
+/// Datagrams waiting for their ack
+//*******************************************************************************
+byte SmartThingsUDP::getPending() const
+{
+	byte count = 0;
+	for (byte i = 0; i < UDP_WINDOW_SIZE; i++)
+	{
+		count += st_window[i].seq ? 1 : 0;
+	}
+	return count;
+}
+}
@@ -0,0 +1,178 @@
+//*******************************************************************************
+//	SmartThings Arduino UDP Library
+//
+//	Sends events to the hub in UDP datagrams instead of HTTP POSTs: no TCP
+//	connect and no request/reply before an event is delivered, so on a LAN an
+//	event arrives a few milliseconds after send().  Delivery stays at least once:
+//	every datagram carries a sequence number, the receiver acknowledges each one,
+//	and the datagrams that are not acknowledged in time are sent again (only
+//	those), every UDP_RETRANSMIT_MAX at most, until they are acknowledged - none
+//	is given up.  While UDP_WINDOW_SIZE datagrams wait for their ack, isReady() is
+//	false, so new events wait in Everything's SendQueue; a datagram that finds the
+//	window full all the same (a batch split over several) waits in the retry
+//	queue of the SmartThings base class and takes the next free place.
+//
+//	Works over any UDP class of the network library (WiFiUDP, EthernetUDP, ...):
+//	the sketch brings up the network itself, then passes its UDP object, e.g.
+//		WiFiUDP udp;
+//		st::Everything::SmartThing = new st::SmartThingsUDP(udp, hubIp, 39500, 8090, st::receiveSmartString);
+//
+//	Protocol (text, one datagram per message):
+//	  device -> hub     "E <session> <seq>\n<event>[\n<event>...]"
+//	  hub -> device     "A <session> <seq> <all>" ack - sent for repeats too; <all> is the
+//	                                              highest <seq> up to which every datagram
+//	                                              has arrived, so one lost ack costs no repeat
+//	  hub -> device     "C <session> <id>\n<command>"   e.g. "C 5123 17\nswitch1 on"
+//	  device -> hub     "K <session> <id>"        ack of a command
+//	<session> is chosen at init(), so the receiver can tell a rebooted device
+//	(whose <seq> starts over at 1) from a repeat; it drops events it has seen.
+//	Commands carry the receiver's own <session> the same way: the device passes
+//	each command <id> to the callout once, however often the hub sends it, and
+//	forgets the ids it has seen when the session changes (a restarted receiver
+//	starts over at <id> 1).  lib/SmartThingsUDP/extras/st_udp_receiver.py is a
+//	reference receiver.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  Per Ivar Nerseth  Created
+//	2026-10-17  Per Ivar Nerseth  Commands carry the receiver's session: "C <session> <id>", "K <session> <id>"
+//	2026-10-17  Per Ivar Nerseth  No datagram is given up: isReady() is false while the window is full, repeats go on until acknowledged
+//*******************************************************************************
+
+#ifndef __SMARTTHINGSUDP_H__
+#define __SMARTTHINGSUDP_H__
+
+#include "SmartThings.h"
+
+#include <Udp.h>
+#include <IPAddress.h>
+
+//Datagrams waiting for their ack - when all are taken, isReady() is false
+#ifndef UDP_WINDOW_SIZE
+#define UDP_WINDOW_SIZE 8
+#endif
+
+//Largest datagram sent or read; batched events are split over several datagrams
+#ifndef UDP_MAX_DATAGRAM
+#define UDP_MAX_DATAGRAM 512
+#endif
+
+//Time before the first repeat of a datagram (in milliseconds), doubled for each further repeat up to UDP_RETRANSMIT_MAX
+#ifndef UDP_RETRANSMIT_TIMEOUT
+#define UDP_RETRANSMIT_TIMEOUT 20
+#endif
+
+#ifndef UDP_RETRANSMIT_MAX
+#define UDP_RETRANSMIT_MAX 1000
+#endif
+
+//Command ids remembered (of the receiver's current session) to drop repeated commands
+#ifndef UDP_COMMAND_HISTORY
+#define UDP_COMMAND_HISTORY 8
+#endif
+
+namespace st
+{
+class SmartThingsUDP : public SmartThings
+{
+  private:
+	//a datagram waiting for its ack
+	struct Pending
+	{
+		unsigned long seq; //0 == free
+		String datagram;
+		unsigned long sentMillis;
+		unsigned long sentMicros; //of the first transmission
+		unsigned int timeout;
+		byte retries;
+	};
+
+	UDP &st_udp;
+	IPAddress st_hubIP;
+	uint16_t st_hubPort;
+	uint16_t st_localPort;
+	unsigned long st_session;
+	unsigned long st_nextSeq;
+
+	Pending st_window[UDP_WINDOW_SIZE];
+	unsigned long st_commandSession; //receiver session the command ids belong to
+	unsigned long st_commandIds[UDP_COMMAND_HISTORY];
+	byte st_commandNext;
+
+	unsigned long st_datagrams;	  //datagrams sent, including repeats
+	unsigned long st_retransmits;   //repeats
+	unsigned long st_acknowledged;  //datagrams acknowledged
+	unsigned long st_lost;		  //datagrams given up: the window and the retry queue were full (send() while !isReady())
+	unsigned long st_ackMicrosTotal; //send to ack, datagrams acknowledged without a repeat
+	unsigned long st_ackMicrosMax;
+	unsigned long st_ackSamples;
+	unsigned long st_commands;	  //commands passed to the callout
+
+	void queueDatagram(const String &events);
+	Pending *freeSlot();
+	void transmit(Pending &pending);
+	void readDatagrams();
+	void handleAck(const char *text);
+	void handleCommand(const char *text, size_t length);
+
+  public:
+	//*******************************************************************************
+	/// @brief  SmartThings UDP Constructor
+	///   @param[in] udp - UDP object of the network library, used by this transport only
+	///   @param[in] hubIP - TCP/IP Address of the receiver (the hub)
+	///   @param[in] hubPort - UDP Port of the receiver
+	///   @param[in] localPort - UDP Port the device receives acks and commands on
+	///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+	///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+	///   @param[in] enableDebug (optional) - Enable internal Library debug
+	//*******************************************************************************
+	SmartThingsUDP(UDP &udp, IPAddress hubIP, uint16_t hubPort, uint16_t localPort, SmartThingsCallout_t *callout, String shieldType = "UDP", bool enableDebug = false, int transmitInterval = 10);
+
+	//*******************************************************************************
+	/// Destructor
+	//*******************************************************************************
+	~SmartThingsUDP();
+
+	//*******************************************************************************
+	/// Initialize SmartThingsUDP Library - opens localPort and starts a new session
+	//*******************************************************************************
+	virtual void init(void);
+
+	//*******************************************************************************
+	/// Run SmartThingsUDP Library - reads acks and commands, repeats what is due
+	//*******************************************************************************
+	virtual void run(void);
+
+	//*******************************************************************************
+	/// Send Message to the Hub - returns once the datagram is sent, without waiting for its ack
+	//*******************************************************************************
+	virtual void send(String message);
+
+	//*******************************************************************************
+	/// Ready while the window has room - otherwise the events wait in Everything's SendQueue
+	//*******************************************************************************
+	virtual bool isReady() const;
+
+	//*******************************************************************************
+	/// Batch mode is supported - events are packed into as few datagrams as fit
+	//*******************************************************************************
+	virtual bool setBatchMode(bool enable)
+	{
+		m_bBatchMode = enable;
+		return true;
+	}
+
+	//gets
+	byte getPending() const;
+	unsigned long getDatagrams() const { return st_datagrams; }
+	unsigned long getRetransmits() const { return st_retransmits; }
+	unsigned long getAcknowledged() const { return st_acknowledged; }
+	unsigned long getLost() const { return st_lost; }
+	unsigned long getAckMicrosMax() const { return st_ackMicrosMax; }
+	unsigned long getAckMicrosMean() const { return st_ackSamples ? st_ackMicrosTotal / st_ackSamples : 0; }
+	unsigned long getCommands() const { return st_commands; }
+};
+}
+#endif
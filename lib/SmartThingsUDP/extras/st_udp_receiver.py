@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+# *******************************************************************************
+#  Reference receiver for SmartThingsUDP
+#
+#  Acknowledges every event datagram ("E <session> <seq>\n<events>") with
+#  "A <session> <seq> <all>", prints each event once (repeats are dropped), and sends
+#  the commands typed on stdin to the device ("C <session> <id>\n<command>"),
+#  repeating a command until the device answers "K <session> <id>".  <session> is
+#  drawn at start, so the device does not take the ids of a restarted receiver,
+#  which start over at 1, for repeats.
+#
+#    st_udp_receiver.py [--port 39500] [--device 192.168.1.50:8090]
+#
+#  Lines printed: "<time> <device ip> <event>", e.g.
+#    12:00:01.234 192.168.1.50 contact1 open
+#
+#  History
+#  2026-10-16  Per Ivar Nerseth  Created
+#  2026-10-17  Per Ivar Nerseth  Commands carry a session of the receiver
+# *******************************************************************************
+
+import argparse
+import random
+import select
+import socket
+import sys
+import time
+
+COMMAND_RETRANSMIT = 0.05  # seconds between repeats of an unacknowledged command
+COMMAND_RETRIES = 20
+SEEN_PER_SESSION = 1024    # sequence numbers remembered above a gap
+
+
+class Session:
+    def __init__(self):
+        self.seen = set()   # sequence numbers above self.all that have arrived
+        self.all = 0        # every sequence number up to here has arrived
+
+    def is_new(self, seq):
+        if seq == 1 and (self.all > 1 or self.seen):
+            self.__init__()  # device restarted with the same session number
+        if seq <= self.all or seq in self.seen:
+            return False
+        self.seen.add(seq)
+        if len(self.seen) > SEEN_PER_SESSION:
+            self.all = min(self.seen) - 1  # bounds the memory - the device keeps no more than UDP_WINDOW_SIZE in flight
+        while self.all + 1 in self.seen:
+            self.all += 1
+            self.seen.remove(self.all)
+        return True
+
+
+def timestamp():
+    now = time.time()
+    return time.strftime("%H:%M:%S", time.localtime(now)) + ".%03d" % (int(now * 1000) % 1000)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Reference receiver for SmartThingsUDP")
+    parser.add_argument("--port", type=int, default=39500, help="UDP port to listen on (the device's hubPort)")
+    parser.add_argument("--device", help="ip:port of the device, for commands typed on stdin")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", args.port))
+    device = None
+    if args.device:
+        host, port = args.device.rsplit(":", 1)
+        device = (host, int(port))
+
+    sessions = {}       # (device ip, session) -> Session
+    commands = {}       # id -> [datagram, next send time, tries]
+    command_session = random.SystemRandom().randint(1, 0xFFFFFFFF)
+    next_id = 1
+    inputs = [sock] + ([sys.stdin] if device else [])
+    print("listening on UDP port %d" % args.port, file=sys.stderr)
+
+    while True:
+        readable, _, _ = select.select(inputs, [], [], COMMAND_RETRANSMIT)
+        for source in readable:
+            if source is sys.stdin:
+                line = sys.stdin.readline()
+                if not line:
+                    inputs.remove(sys.stdin)
+                    continue
+                line = line.strip()
+                if line:
+                    commands[next_id] = [("C %d %d\n%s" % (command_session, next_id, line)).encode(), 0.0, 0]
+                    next_id += 1
+                continue
+
+            data, sender = sock.recvfrom(2048)
+            text = data.decode("utf-8", "replace")
+            header, _, body = text.partition("\n")
+            fields = header.split()
+            if len(fields) == 3 and fields[0] == "E":
+                session, seq = fields[1], int(fields[2])
+                state = sessions.setdefault((sender[0], session), Session())
+                new = state.is_new(seq)
+                sock.sendto(("A %s %d %d" % (session, seq, state.all)).encode(), sender)
+                if new:
+                    for event in body.split("\n"):
+                        if event:
+                            print("%s %s %s" % (timestamp(), sender[0], event), flush=True)
+            elif len(fields) == 3 and fields[0] == "K" and int(fields[1]) == command_session:
+                commands.pop(int(fields[2]), None)
+
+        now = time.monotonic()
+        for command_id, command in list(commands.items()):
+            if now >= command[1]:
+                if command[2] >= COMMAND_RETRIES:
+                    print("command %d not acknowledged" % command_id, file=sys.stderr)
+                    del commands[command_id]
+                    continue
+                sock.sendto(command[0], device)
+                command[1] = now + COMMAND_RETRANSMIT
+                command[2] += 1
+
+
+if __name__ == "__main__":
+    main()
@@ -8,33 +8,38 @@
 //	History
 //	2017-05-06  Dan Ogorchock  Created
 //  2018-01-01  Dan Ogorchock  Added WiFi.RSSI() data collection
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout
+//  2026-10-16  Per Ivar Nerseth  Added deliver() for the retry queue of the SmartThings base class
+//  2026-10-17  Per Ivar Nerseth  Derives from SmartThingsHttpCore - gains GET /metrics, keep-alive mode and the event log
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSWIFI101_H__ 
 #define __SMARTTHINGSWIFI101_H__
 
 
-#include "SmartThingsEthernet.h"
-
 //*******************************************************************************
 // Using WiFi101 library for the Arduino WiFi 101 shield or Adafruit ATWINC1500 
 //*******************************************************************************
 #include <SPI.h>
 #include <WiFi101.h>
 
+#include "SmartThingsHttpCore.h"
+
 
 namespace st
 {
-	class SmartThingsWiFi101: public SmartThingsEthernet
+	class SmartThingsWiFi101: public SmartThingsHttpCore<WiFiServer, WiFiClient, 1>
 	{
 	private:
 		//WiFi Specific
 		char st_ssid[50];
 		char st_password[50];
-		WiFiServer st_server; //server
-		WiFiClient st_client; //client
-		long previousMillis;
-		long RSSIsendInterval;
+
+	protected:
+		//SmartThingsHttpCore hooks
+		virtual bool linkUp() { return WiFi.status() == WL_CONNECTED; }
+		virtual long readRSSI() { return WiFi.RSSI(); }
+		virtual void hubUnreachable();
 
 	public:
 
@@ -82,12 +87,6 @@ namespace st
 		/// Run SmartThingsWiFi101 Library 
 		//*******************************************************************************
 		virtual void run(void);
-
-		//*******************************************************************************
-		/// Send Message to the Hub 
-		//*******************************************************************************
-		virtual void send(String message);
-
 	};
 }
 #endif
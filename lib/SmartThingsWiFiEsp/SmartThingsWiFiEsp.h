@@ -7,33 +7,36 @@
 //	History
 //	2017-02-20  Dan Ogorchock  Created
 //  2018-01-06  Dan Ogorchock  Added WiFi.RSSI() data collection
+//  2026-10-16  Per Ivar Nerseth  run() no longer waits for a request - st_connections reads what is available, with a read timeout
+//  2026-10-16  Per Ivar Nerseth  Added deliver() for the retry queue of the SmartThings base class
+//  2026-10-17  Per Ivar Nerseth  Derives from SmartThingsHttpCore - gains GET /metrics, keep-alive mode and the event log
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSWIFIESP_H__ 
 #define __SMARTTHINGSWIFIESP_H__
 
 
-#include "SmartThingsEthernet.h"
-
 //*******************************************************************************
 // Using WiFiEsp library for the ESP-01 board
 //*******************************************************************************
 #include <WiFiEsp.h>
 
+#include "SmartThingsHttpCore.h"
+
 
 namespace st
 {
-	class SmartThingsWiFiEsp: public SmartThingsEthernet
+	class SmartThingsWiFiEsp: public SmartThingsHttpCore<WiFiEspServer, WiFiEspClient, 1>
 	{
 	private:
 		//WiFi Specific
 		char st_ssid[50];
 		char st_password[50];
-		WiFiEspServer st_server; //server
-		WiFiEspClient st_client; //client
 		Stream* st_espSerial;    //Serial UART used to commincate with the ESP-01 board
-		long previousMillis;
-		long RSSIsendInterval;
+
+	protected:
+		//SmartThingsHttpCore hook
+		virtual long readRSSI() { return WiFi.RSSI(); }
 
 	public:
 
@@ -80,12 +83,6 @@ namespace st
 		/// Run SmartThingsWiFiEsp Library 
 		//*******************************************************************************
 		virtual void run(void);
-
-		//*******************************************************************************
-		/// Send Message to the Hub 
-		//*******************************************************************************
-		virtual void send(String message);
-
 	};
 }
 #endif
@@ -29,6 +29,12 @@
 //                               used with new Parent/Child Device Handlers (i.e. Composite DH)
 //    2017-05-25  Dan Ogorchock  Revised example sketch, taking into account limitations of NodeMCU GPIO pins
 //    2018-02-09  Dan Ogorchock  Added support for Hubitat Elevation Hub
+//    2026-10-16  Per Ivar Nerseth  Added the optional batch mode setting
+//    2026-10-16  Per Ivar Nerseth  Added the optional keep-alive setting
+//    2026-10-16  Per Ivar Nerseth  Added the optional edge capture setting for interrupt sensors
+//    2026-10-16  Per Ivar Nerseth  Added the optional reporting policy setting for polling sensors
+//    2026-10-16  Per Ivar Nerseth  Added the optional asynchronous transport
+//    2026-10-16  Per Ivar Nerseth  Added the optional store-and-forward event log
 //
 //******************************************************************************************
 #include <SPI.h>	 // Adafruit MAX31855 library requires SPI.h
@@ -38,6 +44,9 @@
 // SmartThings Library for ESP8266WiFi
 //******************************************************************************************
 #include <SmartThingsESP8266WiFi.h>
+//#include <SmartThingsESP8266WiFiAsync.h>	//event-driven alternative, needs the ESPAsyncTCP library
+//#include <EventLog.h>	//store-and-forward of the events sent while the hub cannot be reached
+//#include <LittleFS.h>
 
 //******************************************************************************************
 // ST_Anything Library
@@ -155,6 +164,9 @@ void setup()
 	static st::PS_Water sensor1(F("water1"), 60, 20, PIN_WATER_1, 200);
 	static st::PS_DS18B20_Temperature sensor2(F("temperature1"), 15, 0, PIN_TEMPERATURE_1, false, 10, 1);
 
+	//Send the temperature only when it moves by more than 0.5 degrees, but at least every 5 minutes
+	//sensor2.setReportPolicy(0.5, false, 0, 300);
+
 	//Interrupt Sensors
 	static st::IS_Contact sensor3(F("contact1"), PIN_CONTACT_1, LOW, true);
 	static st::IS_Button sensor4(F("button1"), PIN_BUTTON_1, 1000, LOW, true, 500);
@@ -162,6 +174,10 @@ void setup()
 	static st::IS_Motion sensor6(F("motion1"), PIN_MOTION_1, HIGH, false);
 	static st::IS_Smoke sensor7(F("smoke1"), PIN_SMOKE_1, HIGH, true, 500);
 
+	//Debounce the buttons on pin-change interrupts (5ms) instead of 500 checks of the pin in loop()
+	//sensor4.enableEdgeCapture(5000);
+	//sensor5.enableEdgeCapture(5000);
+
 	//Special sensors/executors (uses portions of both polling and executor classes)
 	static st::S_TimedRelay sensor8(F("relaySwitch1"), PIN_TIMEDRELAY_1, LOW, false, 3000, 0, 1);
 
@@ -204,6 +220,22 @@ void setup()
 	//DHCP IP Assigment - Must set your router's DHCP server to provice a static IP address for this device's MAC address
 	//st::Everything::SmartThing = new st::SmartThingsESP8266WiFi(str_ssid, str_password, serverPort, hubIp, hubPort, st::receiveSmartString);
 
+	//Or serve the hub's commands from ESPAsyncTCP callbacks, so they reach their device at the next yield()/delay() instead of the next pass of loop()
+	//st::Everything::SmartThing = new st::SmartThingsESP8266WiFiAsync(str_ssid, str_password, ip, gateway, subnet, dnsserver, serverPort, hubIp, hubPort, st::receiveSmartString, "ESP8266Wifi", debug);
+
+	//Send all queued events in one HTTP POST, one event per line (only if your hub's device handler splits the POST body on line breaks)
+	//st::Everything::SmartThing->setBatchMode(true);
+
+	//Keep one connection to the hub open and reuse it for every event, instead of reconnecting for each one
+	//st::Everything::SmartThing->setKeepAlive(true);
+
+	//Keep the events that cannot be delivered while WiFi or the hub is down in flash, and send them in order once it is back
+	//LittleFS.begin();
+	//static st::EventLogFS eventStorage(LittleFS);
+	//static st::EventLog eventLog(eventStorage);
+	//eventLog.begin();
+	//st::Everything::SmartThing->setEventLog(&eventLog);
+
 	//Run the Everything class' init() routine which establishes WiFi communications with SmartThings Hub
 	st::Everything::init();
 